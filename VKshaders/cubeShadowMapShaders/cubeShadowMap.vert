@@ -6,13 +6,33 @@
 #define CUBE_DEMENTIONS 6
 
 layout(set = 0, binding = 0) uniform UniformBufferObject {
-    mat4 model;
 	mat4 spaceMatrix;
 	vec3 lightPosition;
 	float farPlane;
-	mat4 jointMatrices[18];
 } ubo;
 
+struct InstanceData {
+	mat4  model;
+	vec3  ambient;
+	float shininess;
+	uint  paletteOffset;
+	uint  group;
+};
+
+/// Same instance buffer as main pass, ambient and shininess not used here.
+layout(std430, set = 1, binding = 0) readonly buffer InstanceBuffer {
+	InstanceData instances[];
+};
+
+layout(std430, set = 1, binding = 1) readonly buffer PaletteBuffer {
+	mat4 jointMatrices[];
+};
+
+/// Written by renderer for every light after culling, draw starts at first index of light, so gl_InstanceIndex indexes whole buffer.
+layout(std430, set = 1, binding = 2) readonly buffer VisibleBuffer {
+	uint visibleInstances[];
+};
+
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inNormal;
 layout(location = 2) in vec2 inTextureCoordinate;
@@ -24,13 +44,16 @@ layout(location = 1) out vec3 outLightPosition;
 layout(location = 2) out float outFarPlane;
 
 void main() {
+	InstanceData instance = instances[visibleInstances[gl_InstanceIndex]];
+	uint palette = instance.paletteOffset;
+
 	mat4 skinMatrix;
 	if (int(inJointIndices.x) != -1) {
 		skinMatrix =
-			inWeights.x * ubo.jointMatrices[int(inJointIndices.x)] +
-			inWeights.y * ubo.jointMatrices[int(inJointIndices.y)] +
-			inWeights.z * ubo.jointMatrices[int(inJointIndices.z)] +
-			inWeights.w * ubo.jointMatrices[int(inJointIndices.w)];
+			inWeights.x * jointMatrices[palette + int(inJointIndices.x)] +
+			inWeights.y * jointMatrices[palette + int(inJointIndices.y)] +
+			inWeights.z * jointMatrices[palette + int(inJointIndices.z)] +
+			inWeights.w * jointMatrices[palette + int(inJointIndices.w)];
 	} else {
 		skinMatrix = mat4(
 			1.0, 0.0, 0.0, 0.0,
@@ -40,7 +63,7 @@ void main() {
 			);
 	}
 
-	vec4 worldPosition = ubo.model * skinMatrix * vec4(inPosition, 1.0);
+	vec4 worldPosition = instance.model * skinMatrix * vec4(inPosition, 1.0);
     outFragmentPosition = worldPosition;
 //	outFragmentPosition = ubo.spaceMatrix * worldPosition;
 	outLightPosition = ubo.lightPosition;
@@ -0,0 +1 @@
+glslangValidator -V -g culling.comp -o compCulling.spv
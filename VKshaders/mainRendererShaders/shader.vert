@@ -6,13 +6,8 @@
 #define DIRECTIONAL_LIGHT_SPACE_MATRIX_CONTAINER_SIZE 2
 
 layout(set = 0, binding = 0) uniform UniformBufferObject {
-    mat4 model;
     mat4 view;
     mat4 proj;
-	mat4 jointMatrices[18];
-
-	vec3      ambient;
-    float     shininess;
 
 	mat4 spotSpaceMatrix[SPOT_LIGHT_SPACE_MATRIX_CONTAINER_SIZE];
 	int spotLightsNumber;
@@ -21,6 +16,27 @@ layout(set = 0, binding = 0) uniform UniformBufferObject {
 	int directionalLightsNumber;
 } ubo;
 
+struct InstanceData {
+	mat4  model;
+	vec3  ambient;
+	float shininess;
+	uint  paletteOffset;
+	uint  group;
+};
+
+layout(std430, set = 4, binding = 0) readonly buffer InstanceBuffer {
+	InstanceData instances[];
+};
+
+layout(std430, set = 4, binding = 1) readonly buffer PaletteBuffer {
+	mat4 jointMatrices[];
+};
+
+/// Written by culling shader, draw of group starts at firstInstance of group, so gl_InstanceIndex indexes whole buffer.
+layout(std430, set = 4, binding = 2) readonly buffer VisibleBuffer {
+	uint visibleInstances[];
+};
+
 layout(location = 5) out VS_OUT {
 	vec3 fragmentPosition;
 	vec3 normal;
@@ -51,13 +67,16 @@ layout(location = 2) out vec2 outFragmentTextureCoordinate;
 // } spaceMat;
 
 void main() {
+	InstanceData instance = instances[visibleInstances[gl_InstanceIndex]];
+	uint palette = instance.paletteOffset;
+
 	mat4 skinMatrix;
 	if (int(inJointIndices.x) != -1) {
 		skinMatrix =
-			inWeights.x * ubo.jointMatrices[int(inJointIndices.x)] +
-			inWeights.y * ubo.jointMatrices[int(inJointIndices.y)] +
-			inWeights.z * ubo.jointMatrices[int(inJointIndices.z)] +
-			inWeights.w * ubo.jointMatrices[int(inJointIndices.w)];
+			inWeights.x * jointMatrices[palette + int(inJointIndices.x)] +
+			inWeights.y * jointMatrices[palette + int(inJointIndices.y)] +
+			inWeights.z * jointMatrices[palette + int(inJointIndices.z)] +
+			inWeights.w * jointMatrices[palette + int(inJointIndices.w)];
 	} else {
 		skinMatrix = mat4(
 			1.0, 0.0, 0.0, 0.0,
@@ -67,11 +86,11 @@ void main() {
 			);
 	}
 
-	vec4 worldPosition = ubo.model * skinMatrix * vec4(inPosition, 1.0);
+	vec4 worldPosition = instance.model * skinMatrix * vec4(inPosition, 1.0);
 	
 	vs_out.fragmentPosition = worldPosition.xyz;
-//	vs_out.normal = transpose(inverse(mat3(ubo.model))) * vec3(skinMatrix * vec4(inNormal, 1.0));
-	vs_out.normal = mat3(transpose(inverse(ubo.model * skinMatrix))) * inNormal;
+//	vs_out.normal = transpose(inverse(mat3(instance.model))) * vec3(skinMatrix * vec4(inNormal, 1.0));
+	vs_out.normal = mat3(transpose(inverse(instance.model * skinMatrix))) * inNormal;
 	vs_out.textureCoords = inTextureCoordinate;
 	for (int i = 0; i < ubo.directionalLightsNumber; ++i) 
 		vs_out.fragmentPositionDirectionalLightSpace[i] = ubo.dirSpaceMatrix[i] * worldPosition;
@@ -79,11 +98,11 @@ void main() {
 	for (int i = 0; i < ubo.spotLightsNumber; ++i) 
 		vs_out.fragmentPositionSpotLightSpace[i] = ubo.spotSpaceMatrix[i] * worldPosition;
 
-	vs_out.ambient = ubo.ambient;
-	vs_out.shininess = ubo.shininess;
+	vs_out.ambient = instance.ambient;
+	vs_out.shininess = instance.shininess;
 	
     gl_Position = ubo.proj * ubo.view * worldPosition;
-//	gl_Position = worldPosition * ubo.model * ubo.view * ubo.proj;
+//	gl_Position = worldPosition * instance.model * ubo.view * ubo.proj;
 	outFragmentPosition = worldPosition.xyz;
     outFragmentNormal = inNormal;
     outFragmentTextureCoordinate = inTextureCoordinate;
@@ -0,0 +1,155 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#ifndef ARCHETYPE
+#define ARCHETYPE
+
+#include "Constants.hpp"
+#include "Vector.hpp"
+#include <atomic>
+#include <bitset>
+#include <cassert>
+#include <cstddef>
+
+typedef unsigned int Entity;
+
+namespace GLVM::ecs
+{
+	constexpr unsigned int MAX_COMPONENT_TYPES_NUMBER = 64;
+	constexpr unsigned int ARCHETYPE_CHUNK_SIZE       = 16 * 1024;    ///< Size of one chunk of archetype table in bytes (16 KiB).
+
+	typedef std::bitset<MAX_COMPONENT_TYPES_NUMBER> Signature;        ///< Bit per component type ID.
+
+	/*! Entity is a 32-bit handle: low bits are index of entity slot, high bits are generation
+	 *  of the slot. Generation changed on every removal of entity, so old handle of removed
+	 *  entity never match entity that reused the same slot.
+	 */
+	constexpr unsigned int ENTITY_INDEX_BITS      = 20;
+	constexpr unsigned int ENTITY_INDEX_MASK      = (1u << ENTITY_INDEX_BITS) - 1;     ///< Up to 1048575 simultaneously alive entities.
+	constexpr unsigned int ENTITY_GENERATION_MASK = (1u << (32 - ENTITY_INDEX_BITS)) - 1;
+
+	inline unsigned int GetEntityIndex(Entity entity) { return entity & ENTITY_INDEX_MASK; }
+	inline unsigned int GetEntityGeneration(Entity entity) { return entity >> ENTITY_INDEX_BITS; }
+	inline Entity MakeEntity(unsigned int index, unsigned int generation) {
+		return ((generation & ENTITY_GENERATION_MASK) << ENTITY_INDEX_BITS) | (index & ENTITY_INDEX_MASK);
+	}
+
+	/// Type-erased description of component type. Filled once on first use of the type.
+	struct ComponentInfo
+	{
+		unsigned int size;
+		unsigned int alignment;
+		void (*construct)(void* destination);
+		void (*moveConstruct)(void* destination, void* source);
+		void (*destroy)(void* component);
+		const char* name;
+	};
+
+	/*! Chunk keeps rows of one archetype in SoA layout: array of entities first and then
+	 *  one array per component type. Rows are packed, so every chunk before last used one is full.
+	 */
+	struct Chunk
+	{
+		unsigned char* data = nullptr;
+		unsigned int   count = 0;
+		std::atomic<unsigned int>* versions = nullptr;                   ///< Changed version of every column and then added version of every column.
+	};
+
+	/*! Archetype is a table for all entities with exactly the same set of component types.
+	 *  Components stored in 16 KiB chunks, so iteration over archetype is linear walk through
+	 *  contiguous arrays instead of jumping between sparse and dense containers.
+	 */
+	class Archetype
+	{
+		unsigned int chunkCapacity = 0;                                   ///< Number of rows in one chunk.
+		unsigned int chunkBytes = 0;
+		core::vector<ComponentInfo> columns;                              ///< Description of every column in order of component type IDs.
+		core::vector<unsigned int> columnOffsets;                         ///< Byte offset of every column inside chunk.
+		int columnIndices[MAX_COMPONENT_TYPES_NUMBER];                    ///< Component type ID to column index, -1 if archetype dont have this type.
+
+		void ComputeLayout();
+		void MoveRow(unsigned int sourceChunk, unsigned int sourceRow,
+					 unsigned int destinationChunk, unsigned int destinationRow);
+
+	public:
+		Signature signature;
+		core::vector<unsigned int> componentTypes;                        ///< Component type IDs in ascending order.
+		core::vector<Chunk> chunks;
+		unsigned int entitiesNumber = 0;
+
+		Archetype* addEdges[MAX_COMPONENT_TYPES_NUMBER];                  ///< Cached archetype transitions on component creation.
+		Archetype* removeEdges[MAX_COMPONENT_TYPES_NUMBER];               ///< Cached archetype transitions on component removal.
+
+		Archetype(const Signature& signature_, core::vector<ComponentInfo>& componentsInfo);
+		~Archetype();
+		Archetype(const Archetype& archetype) = delete;
+		void operator=(const Archetype& archetype) = delete;
+
+		/// Reserve row at the end of table for entity. Components on this row are not constructed.
+		void AllocateRow(Entity entity, unsigned int& chunkIndex, unsigned int& row);
+
+		/*! Fill hole at chosen row with last row of table. Components on chosen row must be already
+		 *  destroyed or moved out. Return false if chosen row was last one, otherwise write entity
+		 *  that was moved into the hole to movedEntity.
+		 */
+		bool VacateRow(unsigned int chunkIndex, unsigned int row, Entity& movedEntity);
+
+		/// Destroy all components on chosen row. Row itself stays in table, call VacateRow after.
+		void DestroyRow(unsigned int chunkIndex, unsigned int row);
+
+		/// Move components shared with destination archetype and destroy the rest.
+		void TransferRow(unsigned int chunkIndex, unsigned int row, Archetype& destination,
+						 unsigned int destinationChunk, unsigned int destinationRow);
+
+		bool HasComponent(unsigned int componentTypeID) const { return signature.test(componentTypeID); }
+
+		void* GetComponent(unsigned int componentTypeID, unsigned int chunkIndex, unsigned int row) {
+			int column = columnIndices[componentTypeID];
+			assert( column >= 0 );
+			return chunks[chunkIndex].data + columnOffsets[column] + row * columns[column].size;
+		}
+
+		template <typename componentType>
+		componentType* GetColumn(unsigned int componentTypeID, unsigned int chunkIndex) {
+			int column = columnIndices[componentTypeID];
+			assert( column >= 0 );
+			return reinterpret_cast<componentType*>(chunks[chunkIndex].data + columnOffsets[column]);
+		}
+
+		Entity* GetEntities(unsigned int chunkIndex) {
+			return reinterpret_cast<Entity*>(chunks[chunkIndex].data);
+		}
+
+		unsigned int GetChunkCapacity() const { return chunkCapacity; }
+
+		/*! Write versions of columns. Versions written by parallel systems and only compared with
+		 *  older versions, so relaxed atomics are enough.
+		 */
+		void MarkChanged(unsigned int componentTypeID, unsigned int chunkIndex, unsigned int version) {
+			chunks[chunkIndex].versions[columnIndices[componentTypeID]].store(version, std::memory_order_relaxed);
+		}
+
+		void MarkAdded(unsigned int componentTypeID, unsigned int chunkIndex, unsigned int version) {
+			MarkChanged(componentTypeID, chunkIndex, version);
+			chunks[chunkIndex].versions[columns.GetSize() + columnIndices[componentTypeID]].store(version, std::memory_order_relaxed);
+		}
+
+		/// Rows of chunk were moved, so every column counts as changed.
+		void MarkChunkChanged(unsigned int chunkIndex, unsigned int version) {
+			for ( unsigned int i = 0; i < columns.GetSize(); ++i )
+				chunks[chunkIndex].versions[i].store(version, std::memory_order_relaxed);
+		}
+
+		unsigned int GetChangedVersion(unsigned int componentTypeID, unsigned int chunkIndex) const {
+			return chunks[chunkIndex].versions[columnIndices[componentTypeID]].load(std::memory_order_relaxed);
+		}
+
+		unsigned int GetAddedVersion(unsigned int componentTypeID, unsigned int chunkIndex) const {
+			return chunks[chunkIndex].versions[columns.GetSize() + columnIndices[componentTypeID]].load(std::memory_order_relaxed);
+		}
+	};
+}
+
+#endif
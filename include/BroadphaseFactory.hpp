@@ -0,0 +1,26 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#ifndef BROADPHASE_FACTORY
+#define BROADPHASE_FACTORY
+
+#include "IBroadphase.hpp"
+
+namespace GLVM::ecs
+{
+/*!
+  \brief Create broadphase of collision system.
+
+  Type of broadphase picked once at startup. Caller owns returned object.
+*/
+
+    class CBroadphaseFactory
+    {
+    public:
+        IBroadphase* CreateBroadphase(EBroadphaseType type);
+    };
+}
+
+#endif
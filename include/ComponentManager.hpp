@@ -29,93 +29,150 @@
 #include <mutex>
 #include <assert.h>
 #include "Components/ControllerComponent.hpp"
+#include "Archetype.hpp"
+#include "Query.hpp"
+#include "JobSystem.hpp"
 #include <cstdlib>
-
-typedef unsigned int Entity;
+#include <new>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
 
 namespace GLVM::ecs
 {
+	/// Position of entity inside archetype tables. Entity without components has no archetype.
+	struct EntityLocation
+	{
+		Archetype*   archetype = nullptr;
+		unsigned int chunk = 0;
+		unsigned int row = 0;
+	};
+
+	/*! Components stored in archetype tables: every unique set of component types has own table
+	 *  of 16 KiB chunks (see Archetype.hpp). Creation or removal of component moves entity row to
+	 *  table of new set, so pointers returned by GetComponent become invalid after CreateComponent,
+	 *  RemoveComponent or RemoveAllComponents of the same entity and after any structural change
+	 *  of entities from the same table.
+	 *
+	 *  Every chunk keep write version of every column. Mutable access (GetComponent of non-const
+	 *  type, non-const query columns) stamp chunk column with current change version, const access
+	 *  dont. Reader that want to skip unchanged data store version returned by AdvanceChangeVersion
+	 *  and pass it as sinceVersion to Changed<T> and Added<T> filters on next update.
+	 */
 	class ComponentManager
 	{
         static ComponentManager* pInstance_;
         static std::mutex  Mutex_;
-		unsigned int numberOfBaseComponents;
 		
         ComponentManager();
         ~ComponentManager();
 
+		Archetype* GetArchetype(const Signature& signature);                  ///< Search table for signature or create new one.
+		Archetype* GetAddEdge(Archetype* source, unsigned int componentTypeID);
+		Archetype* GetRemoveEdge(Archetype* source, unsigned int componentTypeID);
+		void MoveEntity(Entity entity, Archetype* destination);               ///< Move entity row to destination table, nullptr means destroy all components.
+
+		std::mutex registryMutex;                                             ///< Guard registration of component types, tables and queries from parallel systems.
+		std::atomic<unsigned int> changeVersion{1};                           ///< Version stamped on written columns, zero means never written.
+		std::mutex entityContainersMutex;                                     ///< Guard snapshots of GetEntityContainer and their stale flags.
+		Signature staleEntityContainers;                                      ///< Types whose snapshot missed entities entering or leaving their tables.
+
 		template <typename componentType>
-		unsigned int CreateComponentContainer() {
-				static unsigned int localContainerID = 0;
-				static bool existComponentContainerFlag = false;
-				if(existComponentContainerFlag)  
-					return localContainerID;
-                                                                                                                
-				localContainerID = componentsContainerID;    ///< Give a value of global component container ID's counter to local container ID of current component type.
-				existComponentContainerFlag = true;
-            
-				core::vector<componentType>* componentContainer =
-					new core::vector<componentType>;    ///< Create component container of current type.
-				worldComponentsContainer.Push(componentContainer);
-            
-				core::vector<Entity>* sparseEntitiesMapToComponents =
-					new core::vector<Entity>;    ///< Create ID's component container.
-				worldSparseEntitiesMapToComponents.Push(sparseEntitiesMapToComponents);
-
-				core::vector<Entity>* denseEntitiesMapToComponents =
-					new core::vector<Entity>;    ///< Create ID's component container.
-				worldDenseComponentsMapToEntities.Push(denseEntitiesMapToComponents);
-				componentsTypes.Push(typeid(componentType).name());
-//				std::cout << typeid(Component_Type).name() << std::endl;			
-				++componentsContainerID;
-				return localContainerID;
+		unsigned int RegisterComponentType() {
+				std::lock_guard<std::mutex> lock(registryMutex);
+				assert( componentsTypeID < MAX_COMPONENT_TYPES_NUMBER );
+				unsigned int localComponentTypeID = componentsTypeID;    ///< Give a value of global component type ID's counter to local ID of current component type.
+
+				ComponentInfo componentInfo;
+				componentInfo.size          = sizeof(componentType);
+				componentInfo.alignment     = alignof(componentType);
+				componentInfo.construct     = [](void* destination) { new (destination) componentType(); };
+				componentInfo.moveConstruct = [](void* destination, void* source) {
+					new (destination) componentType(std::move(*static_cast<componentType*>(source)));
+				};
+				componentInfo.destroy       = [](void* component) { static_cast<componentType*>(component)->~componentType(); };
+				componentInfo.name          = typeid(componentType).name();
+				componentsInfo.Push(componentInfo);
+				entityContainers.Push(new core::vector<Entity>);
+				++componentsTypeID;
+				return localComponentTypeID;
 			}
+
+		template <typename... componentTypes>
+		Query<componentTypes...>* CreateQuery() {
+			Query<componentTypes...>* query = new Query<componentTypes...>(MakeSignature<componentTypes...>(),
+																			 { GetComponentTypeID<componentTypes>()... },
+																			 &changeVersion);
+			std::lock_guard<std::mutex> lock(registryMutex);
+			for ( unsigned int i = 0; i < archetypes.GetSize(); ++i )
+				query->TryMatch(archetypes[i]);
+
+			queries.Push(query);
+			return query;
+		}
         
 	public:
-		inline static unsigned int componentsContainerID = 0;
-		core::vector<core::IContainer*> worldComponentsContainer;    ///< Contains all local containers for diferent types of components.
-		core::vector<core::vector<Entity>*> worldSparseEntitiesMapToComponents;    ///< Contains all local container with IDs for diferent types of components.
-		core::vector<core::vector<Entity>*> worldDenseComponentsMapToEntities;
-
-		core::vector<const char*> componentsTypes;
+		inline static unsigned int componentsTypeID = 0;
+		core::vector<ComponentInfo> componentsInfo;    ///< Type-erased description of every component type, indexed by component type ID.
+		core::vector<Archetype*> archetypes;           ///< Contains all tables for diferent sets of components.
+		core::vector<EntityLocation> entityLocations;  ///< Location of every entity inside archetype tables, indexed by entity index.
+		core::vector<core::vector<Entity>*> entityContainers;    ///< Snapshots returned by GetEntityContainer, indexed by component type ID.
+		core::vector<QueryBase*> queries;              ///< All registered queries, new tables matched against them on creation.
 		
         ComponentManager(ComponentManager& componentManager) = delete;         ///< Dont need to make cope because of singleton property.
         void operator=(const ComponentManager& componentManager) = delete;      ///< Dont need assignment operator because of singleton property.
        static ComponentManager* GetInstance();                          ///< It possibly to get only one instance of this class whith this method.
 
+		/// Give unique ID to component type on first call and register its type-erased description.
+		/// Const types and Changed/Added filters share ID of plain component type.
 		template <typename componentType>
-		void CreateComponent(const Entity& entity)
-		{
-			unsigned int localContainerID = 0; ///< Index for world components and world ID's containers.
-			componentType Component;
-			localContainerID = CreateComponentContainer<componentType>();
-
-			core::vector<Entity>& sparse = *static_cast<core::vector<Entity>*>
-				(worldSparseEntitiesMapToComponents[localContainerID]);
-			core::vector<Entity>& dense = *static_cast<core::vector<Entity>*>
-				(worldDenseComponentsMapToEntities[localContainerID]);
-			core::vector<componentType>& components = *static_cast<core::vector<componentType>*>
-				(worldComponentsContainer[localContainerID]);
-//			std::cout << typeid(componentType).name() << std::endl;
-			if ( checkAvailability( sparse, dense, entity ) ) {
-				return;
-			}
-			
-			if ( entity >= sparse.GetSize() ) {
-				sparse.Resize(entity + 1);
+		unsigned int GetComponentTypeID() {
+			typedef typename ComponentAccess<componentType>::component plainType;
+			if constexpr ( !std::is_same_v<componentType, plainType> ) {
+				return GetComponentTypeID<plainType>();
+			} else {
+				static const unsigned int localComponentTypeID = RegisterComponentType<componentType>();    ///< Thread-safe one-time initialization.
+				return localComponentTypeID;
 			}
+		}
 
-			assert( dense.GetSize() == components.GetSize() );
-			
-			sparse[entity] = dense.GetSize();
-			dense.Push(entity);
-			components.Push(Component);
+		unsigned int GetChangeVersion() const { return changeVersion.load(std::memory_order_relaxed); }
+
+		/*! Start new change version and return it. Writes made after call stamped with returned
+		 *  version or newer one, so caller use it as sinceVersion on next update.
+		 */
+		unsigned int AdvanceChangeVersion() { return changeVersion.fetch_add(1, std::memory_order_relaxed) + 1; }
+
+		template <typename... componentTypes>
+		Signature MakeSignature() {
+			Signature signature;
+			(signature.set(GetComponentTypeID<componentTypes>()), ...);
+			return signature;
 		}
 
-		bool checkAvailability( core::vector<Entity>& sparse,
-								core::vector<Entity>& dense,
-								Entity entity );
+		/*! Return persistent query for listed component types. Query created and matched against
+		 *  existing tables on first call, after that it only updated when new table appears.
+		 */
 		
+		template <typename... componentTypes>
+		Query<componentTypes...>& GetQuery() {
+			static Query<componentTypes...>* const query = CreateQuery<componentTypes...>();
+			return *query;
+		}
+
+		/*! Type-erased creation of component. Value moved into component if it is not nullptr,
+		 *  otherwise component value-initialized. If entity already has component, it only
+		 *  assigned from value. Return pointer to component.
+		 */
+		void* CreateComponent(const Entity& entity, unsigned int componentTypeID, void* value);
+		void RemoveComponent(const Entity& entity, unsigned int componentTypeID);
+
+		template <typename componentType>
+		void CreateComponent(const Entity& entity)
+		{
+			CreateComponent(entity, GetComponentTypeID<componentType>(), nullptr);
+		}
+
         /// Allow to give a various components to chosen entity.
         
         template <typename componentType1, typename componentType2, typename... Args>
@@ -124,225 +181,188 @@ namespace GLVM::ecs
             CreateComponent<componentType1>(entity);
         }
 
+		/// Collect entities that have at least all listed components.
+		
         template <typename componentType, typename... Args>
 		core::vector<Entity> collectLinkedEntities() {
-			numberOfBaseComponents = 0;
-			unsigned int firstComponentArrayIndex = CreateComponentContainer<componentType>();
-			core::vector<Entity>& dense = *static_cast<core::vector<Entity>*>
-				( worldDenseComponentsMapToEntities[firstComponentArrayIndex] );
-
-			if ( dense.GetSize() > 0 ) {
-				++numberOfBaseComponents;
-				numberOfBaseComponents += sizeof...(Args);
-			}
-
+			core::vector<Archetype*>& matchedArchetypes = GetQuery<componentType, Args...>().matchedArchetypes;
 			core::vector<Entity> returnVector;
-			for ( unsigned int i = 0; i < dense.GetSize(); ++i ) {
-				if ( multiCheckAvailability<Args...>(dense[i]) )
-					returnVector.Push(dense[i]);
+			for ( unsigned int i = 0; i < matchedArchetypes.GetSize(); ++i ) {
+				Archetype* archetype = matchedArchetypes[i];
+				for ( unsigned int j = 0; j < archetype->chunks.GetSize(); ++j ) {
+					Entity* entities = archetype->GetEntities(j);
+					for ( unsigned int k = 0; k < archetype->chunks[j].count; ++k )
+						returnVector.Push(entities[k]);
+				}
 			}
 
 			return returnVector;
 		}
 
+		/// Collect entities that have exactly listed components and nothing else.
+		
 		template <typename componentType, typename... Args>
 		core::vector<Entity> collectUniqueLinkedEntities() {
-			core::vector<Entity> baseSubSetEntities;
-			baseSubSetEntities = collectLinkedEntities<componentType, Args...>();
-
-			unsigned int numberOfComponentArrays = 0;
-			for ( unsigned int j = 0; j < baseSubSetEntities.GetSize(); ++j ) {
-				numberOfComponentArrays = 0;
-				for ( unsigned int i = 0; i < worldDenseComponentsMapToEntities.GetSize(); ++i ) {
-					core::vector<Entity>& sparse = *static_cast<core::vector<Entity>*>
-						(worldSparseEntitiesMapToComponents[i]);
-					core::vector<Entity>& dense = *static_cast<core::vector<Entity>*>
-						(worldDenseComponentsMapToEntities[i]);
-
-						if ( checkAvailability(sparse, dense, baseSubSetEntities[j]) )
-							++numberOfComponentArrays;
-				}
+			QueryBase& query = GetQuery<componentType, Args...>();
+			core::vector<Entity> returnVector;
+			for ( unsigned int i = 0; i < query.matchedArchetypes.GetSize(); ++i ) {
+				Archetype* archetype = query.matchedArchetypes[i];
+				if ( archetype->signature != query.required )
+					continue;
 
-				if ( numberOfComponentArrays > numberOfBaseComponents ) {
-					baseSubSetEntities.Remove(baseSubSetEntities[j]);
-					--j;
+				for ( unsigned int j = 0; j < archetype->chunks.GetSize(); ++j ) {
+					Entity* entities = archetype->GetEntities(j);
+					for ( unsigned int k = 0; k < archetype->chunks[j].count; ++k )
+						returnVector.Push(entities[k]);
 				}
 			}
 			
-			return baseSubSetEntities;
+			return returnVector;
 		}
+
+		/*! Call function for every chunk of every table that contains all listed components:
+		 *  function(unsigned int count, Entity* entities, componentTypes*... components).
+		 *  Arrays are contiguous, so body can iterate them linearly. Chunks rejected by Changed and
+		 *  Added filters are skipped, non-const columns are marked changed. Dont create or remove
+		 *  components inside function, it moves rows between tables.
+		 */
 		
-		template <typename... Args>
-		bool multiCheckAvailability(Entity entity) {
-			return (multiCheckAvailabilityBase<Args>(entity) && ...);
+		template <typename... componentTypes, typename Function>
+		void forEachChunk(Function function, unsigned int sinceVersion = 0) {
+			core::vector<Archetype*>& matchedArchetypes = GetQuery<componentTypes...>().matchedArchetypes;
+			for ( unsigned int i = 0; i < matchedArchetypes.GetSize(); ++i ) {
+				Archetype* archetype = matchedArchetypes[i];
+				for ( unsigned int j = 0; j < archetype->chunks.GetSize(); ++j ) {
+					unsigned int count = archetype->chunks[j].count;
+					if ( count == 0 )
+						break;                                                       ///< Rows are packed, rest of chunks are empty.
+
+					if ( AcceptChunk<componentTypes...>(archetype, j, sinceVersion) )
+						function(count, archetype->GetEntities(j), LoadColumn<componentTypes>(archetype, j)...);
+				}
+			}
 		}
 
+		/*! Same as forEachChunk, but chunks are distributed between threads of job system and
+		 *  function called in parallel. Function must touch only rows of passed chunk.
+		 */
+		
+		template <typename... componentTypes, typename Function>
+		void parallelForEachChunk(Function function, unsigned int sinceVersion = 0) {
+			core::vector<Archetype*>& matchedArchetypes = GetQuery<componentTypes...>().matchedArchetypes;
+			core::vector<EntityLocation> filledChunks;                           ///< Row field is unused here.
+			for ( unsigned int i = 0; i < matchedArchetypes.GetSize(); ++i ) {
+				Archetype* archetype = matchedArchetypes[i];
+				for ( unsigned int j = 0; j < archetype->chunks.GetSize() && archetype->chunks[j].count > 0; ++j ) {
+					if ( AcceptChunk<componentTypes...>(archetype, j, sinceVersion) )
+						filledChunks.Push(EntityLocation{ archetype, j, 0 });
+				}
+			}
+
+			core::CJobSystem::GetInstance()->ParallelFor(filledChunks.GetSize(), 1,
+				[&](unsigned int begin, unsigned int end) {
+					for ( unsigned int i = begin; i < end; ++i ) {
+						Archetype* archetype = filledChunks[i].archetype;
+						unsigned int chunk = filledChunks[i].chunk;
+						function(archetype->chunks[chunk].count, archetype->GetEntities(chunk),
+								 LoadColumn<componentTypes>(archetype, chunk)...);
+					}
+				});
+		}
+
+		template <typename... componentTypes>
+		bool AcceptChunk(const Archetype* archetype, unsigned int chunk, unsigned int sinceVersion) {
+			return (ComponentAccess<componentTypes>::Accept(archetype, GetComponentTypeID<componentTypes>(), chunk, sinceVersion) && ...);
+		}
+
+		/// Column of chunk for chunk walk, written column marked changed.
 		template <typename componentType>
-		bool multiCheckAvailabilityBase(Entity entity) {
-			unsigned int componentArrayIndex = CreateComponentContainer<componentType>();
-			core::vector<Entity>& sparse = *static_cast<core::vector<Entity>*>
-				(worldSparseEntitiesMapToComponents[componentArrayIndex]);
-			core::vector<Entity>& dense = *static_cast<core::vector<Entity>*>
-				(worldDenseComponentsMapToEntities[componentArrayIndex]);
-
-			return checkAvailability(sparse, dense, entity);
+		typename ComponentAccess<componentType>::columnType* LoadColumn(Archetype* archetype, unsigned int chunk) {
+			unsigned int componentTypeID = GetComponentTypeID<componentType>();
+			if constexpr ( ComponentAccess<componentType>::write )
+				archetype->MarkChanged(componentTypeID, chunk, GetChangeVersion());
+
+			return archetype->GetColumn<typename ComponentAccess<componentType>::columnType>(componentTypeID, chunk);
+		}
+		
+		/// Set of component types owned by entity, empty for entity without components.
+		Signature GetSignature(Entity entity) const {
+			unsigned int entityIndex = GetEntityIndex(entity);
+			if ( entityIndex >= entityLocations.GetSize() || entityLocations[entityIndex].archetype == nullptr )
+				return Signature();
+
+			return entityLocations[entityIndex].archetype->signature;
+		}
+
+		template <typename... Args>
+		bool multiCheckAvailability(Entity entity) {
+			Signature required = MakeSignature<Args...>();
+			return (GetSignature(entity) & required) == required;
 		}
 		
+		/// Mutable access mark component changed, use const componentType for read only access.
+		
         template <typename componentType>
         componentType* GetComponent(const Entity& entity)
         {
-            unsigned int localContainerID;
-            localContainerID = CreateComponentContainer<componentType>();
-
-			core::vector<Entity>& sparse = *static_cast<core::vector<Entity>*>
-				(worldSparseEntitiesMapToComponents[localContainerID]);
-			core::vector<Entity>& dense = *static_cast<core::vector<Entity>*>
-				(worldDenseComponentsMapToEntities[localContainerID]);
-			core::vector<componentType>& components =
-				*static_cast<core::vector<componentType>*>(worldComponentsContainer[localContainerID]);
-
-			if ( checkAvailability( sparse, dense, entity ) ) {
-				Entity componentIndex = sparse[entity];
-				return &components[componentIndex];
+			unsigned int componentTypeID = GetComponentTypeID<componentType>();
+			unsigned int entityIndex = GetEntityIndex(entity);
+			assert( IsAlive(entity) );                                           ///< Stale handle of removed entity, checked unless NDEBUG defined.
+			if ( entityIndex >= entityLocations.GetSize() )
+				return nullptr;
+
+			EntityLocation& location = entityLocations[entityIndex];
+			if ( location.archetype != nullptr && location.archetype->HasComponent(componentTypeID) ) {
+				if constexpr ( !std::is_const_v<componentType> )
+					location.archetype->MarkChanged(componentTypeID, location.chunk, GetChangeVersion());
+
+				return static_cast<componentType*>(location.archetype->GetComponent(componentTypeID,
+																					  location.chunk, location.row));
 			} else {
 				return nullptr;
 			}
         }
 
-        /**************************************************************************************
-         * Dont need to delete real component in this method. Because systems dont work with
-         * component without indices for that component in ordered container.
-         **************************************************************************************/
-        
 		template <typename componentType>
 		void RemoveComponent(Entity& entity) {
-			unsigned int localContainerID;
-			localContainerID = CreateComponentContainer<componentType>();
-
-			core::vector<Entity>& sparse = *static_cast<core::vector<Entity>*>
-				(worldSparseEntitiesMapToComponents[localContainerID]);
-			core::vector<Entity>& dense = *static_cast<core::vector<Entity>*>
-				(worldDenseComponentsMapToEntities[localContainerID]);
-			core::vector<componentType>& components = *static_cast<core::vector<componentType>*>
-				(worldComponentsContainer[localContainerID]);
-
-			if ( checkAvailability( sparse, dense, entity ) ) {
-				assert( dense.GetSize() == components.GetSize() );
-//				std::cout << "DELETE: " << typeid(componentType).name() << std::endl;
-				Entity indexInDenseOfRemovableEntity = sparse[entity];
-				Entity indexInSparseOfSwapableEntity = dense.GetHead();
-				const componentType& componentFromLastIndex = components.GetHead();
-				dense[indexInDenseOfRemovableEntity] = indexInSparseOfSwapableEntity;
-				dense.Pop();
-				components[indexInDenseOfRemovableEntity] = componentFromLastIndex;
-				components.Pop();
-				sparse[indexInSparseOfSwapableEntity] = indexInDenseOfRemovableEntity;
-			}
+			RemoveComponent(entity, GetComponentTypeID<componentType>());
 		}
 		
-		void RemoveAllComponents(Entity& entity) {
-			// TODO: DYNAMIC CAST THAT CAN RETURN 0 IF CANT CAST
-			
-			// for ( unsigned int i = 0; i < worldComponentsContainer.GetSize(); ++i ) {
-			// 	core::vector<Entity>& sparse = *static_cast<core::vector<Entity>*>
-			// 		(worldSparseEntitiesMapToComponents[i]);
-			// 	core::vector<Entity>& dense = *static_cast<core::vector<Entity>*>
-			// 		(worldDenseComponentsMapToEntities[i]);
-			// 	core::vector<core::IContainer>& components = *static_cast<core::vector<core::IContainer>*>
-			// 		(worldComponentsContainer[i]);
-
-			// 	if ( checkAvailability( sparse, dense, entity ) ) {
-			// 		assert( dense.GetSize() == components.GetSize() );
-			// 		std::cout << "DELETE!" << std::endl;
-			// 		Entity indexInDenseOfRemovableEntity = sparse[entity];
-			// 		Entity indexInSparseOfSwapableEntity = dense.GetHead();
-			// 		const core::IContainer& componentFromLastIndex = components.GetHead();
-			// 		dense[indexInDenseOfRemovableEntity] = indexInSparseOfSwapableEntity;
-			// 		dense.Pop();
-			// 		components[indexInDenseOfRemovableEntity] = componentFromLastIndex;
-			// 		components.Pop();
-			// 		sparse[indexInSparseOfSwapableEntity] = indexInDenseOfRemovableEntity;
-			// 	}
-			// }
-			
-			for ( unsigned int i = 0; i < worldComponentsContainer.GetSize(); ++i ) {
-//				std::cout << "iteration: " << i << std::endl;
-				if ( componentsTypes[i] == typeid(components::transform).name() ) {
-					// std::cout << "transform from container: " << componentsTypes[i] << std::endl;
-					// std::cout << "transform from typeid: " << typeid(components::transform).name() << std::endl;
-					RemoveComponent<components::transform>(entity);
-//					std::cout << "Delete transform" << std::endl;
-				} else if ( componentsTypes[i] == typeid(components::beholder).name() ) {
-					RemoveComponent<components::beholder>(entity);
-//					std::cout << "Delete beholder" << std::endl;
-				} else if ( componentsTypes[i] == typeid(components::animation).name() ) {
-					RemoveComponent<components::animation>(entity);
-//					std::cout << "Delete animation" << std::endl;
-				} else if ( componentsTypes[i] == typeid(components::collider).name() ) {
-					RemoveComponent<components::collider>(entity);
-//					std::cout << "Delete collider" << std::endl;
-				} else if ( componentsTypes[i] == typeid(components::directionalLight).name() ) {
-					RemoveComponent<components::directionalLight>(entity);
-//					std::cout << "Delete directional light" << std::endl;
-				} else if ( componentsTypes[i] == typeid(components::pointLight).name() ) {
-					RemoveComponent<components::pointLight>(entity);
-//					std::cout << "Delete point light" << std::endl;
-				} else if ( componentsTypes[i] == typeid(components::spotLight).name() ) {
-					RemoveComponent<components::spotLight>(entity);
-//					std::cout << "Delete spot light" << std::endl;
-				} else if ( componentsTypes[i] == typeid(components::event).name() ) {
-					RemoveComponent<components::event>(entity);
-//					std::cout << "Delete event" << std::endl;
-				} else if ( componentsTypes[i] == typeid(components::material).name() ) {
-					RemoveComponent<components::material>(entity);
-//					std::cout << "Delete material" << std::endl;
-				} else if ( componentsTypes[i] == typeid(components::move).name() ) {
-					RemoveComponent<components::move>(entity);
-//					std::cout << "Delete move" << std::endl;
-				} else if ( componentsTypes[i] == typeid(components::mesh).name() ) {
-					RemoveComponent<components::mesh>(entity);
-//					std::cout << "Delete vertex" << std::endl;
-				} else if ( componentsTypes[i] == typeid(GLVM::ecs::components::controller).name() ) {
-					RemoveComponent<GLVM::ecs::components::controller>(entity);
-//					std::cout << "Delete controller" << std::endl;
-				} else if ( componentsTypes[i] == typeid(GAME_MECHANICS::ECS::components::attack).name() ) {
-					RemoveComponent<GAME_MECHANICS::ECS::components::attack>(entity);
-//				 	std::cout << "Delete attack" << std::endl;
-				} else if ( componentsTypes[i] == typeid(components::projectile).name() ) {
-					RemoveComponent<components::projectile>(entity);
-//				 	std::cout << "Delete projectile" << std::endl;
-				} else {
-					continue;
-				}
-			}
-		}
+		/*! Destroy every component of entity with destroy function registered for its type, so
+		 *  cost depend only on components entity owns and new component types need no changes here.
+		 */
+		void RemoveAllComponents(Entity& entity);
+
+		/// Check generation of handle with entity manager. Dont lock, so asserts of every component access stay cheap.
+		bool IsAlive(Entity entity);
+
+		/*! Return entities that have component of chosen type. Container is a snapshot kept per
+		 *  component type and rebuilt only after entity entered or left table with this type, so
+		 *  repeated calls in one frame are cheap. Dont change returned container.
+		 */
 		
-		unsigned int GetContainerID();
-
-		template <typename componentType>
-		core::VectorIterator<componentType> GetComponentContainerTest() {
-			core::vector<componentType>* componentVector = static_cast<core::vector<componentType>*>(worldComponentsContainer[CreateComponentContainer<componentType>()]);
-			core::VectorIterator<componentType> iterator(*componentVector);
-			return iterator;
-		}
-
-		// template <typename componentType>
-		// core::VectorIterator<Entity> GetEntityContainer() {
-		// 	core::vector<Entity>* entityVector = static_cast<core::vector<Entity>*>(worldDenseComponentsMapToEntities[CreateComponentContainer<componentType>()]);
-		// 	core::VectorIterator<Entity> iterator(*entityVector);
-		// 	return iterator;
-		// }
-
-		template <typename componentType>
-		core::vector<componentType>* GetComponentContainer()
-			{
-				return static_cast<core::vector<componentType>*>(worldComponentsContainer[CreateComponentContainer<componentType>()]);
-			}
-
 		template <typename componentType>
 		core::vector<Entity>* GetEntityContainer()
 			{
-				return static_cast<core::vector<Entity>*>(worldDenseComponentsMapToEntities[CreateComponentContainer<componentType>()]);
+				unsigned int componentTypeID = GetComponentTypeID<componentType>();
+				core::vector<Archetype*>& matchedArchetypes = GetQuery<componentType>().matchedArchetypes;
+				std::lock_guard<std::mutex> lock(entityContainersMutex);
+				core::vector<Entity>* entityContainer = entityContainers[componentTypeID];
+				if ( !staleEntityContainers.test(componentTypeID) )
+					return entityContainer;
+
+				staleEntityContainers.reset(componentTypeID);
+				entityContainer->clear();
+				for ( unsigned int i = 0; i < matchedArchetypes.GetSize(); ++i ) {
+					Archetype* archetype = matchedArchetypes[i];
+					for ( unsigned int j = 0; j < archetype->chunks.GetSize(); ++j ) {
+						Entity* entities = archetype->GetEntities(j);
+						for ( unsigned int k = 0; k < archetype->chunks[j].count; ++k )
+							entityContainer->Push(entities[k]);
+					}
+				}
+
+				return entityContainer;
 			}
 	};
 
@@ -8,9 +8,11 @@
 
 namespace GLVM::ecs::components
 {
+	/// Playback state of skeletal clip, skeleton itself shared by all instances of mesh.
 	struct animation
 	{
-		
+		float time  = 0.0f;                                              ///< Time of clip in seconds, wrapped by duration of clip.
+		float speed = 1.0f;                                              ///< Playback rate, negative plays clip backward.
 	};
 }
 
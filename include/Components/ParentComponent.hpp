@@ -0,0 +1,20 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#ifndef PARENT_COMPONENT
+#define PARENT_COMPONENT
+
+#include "Archetype.hpp"
+
+namespace GLVM::ecs::components
+{
+	/// Transform of entity is relative to parent, for example weapon attached to actor.
+	struct parent
+	{
+		Entity entity = 0;
+	};
+}
+
+#endif
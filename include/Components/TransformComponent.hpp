@@ -21,10 +21,37 @@ namespace GLVM::ecs::components
         float fScale = 1.0f;
         bool hud = false;
 		float GravityAccumulator = 0.0f;
-		unsigned int currentAnimationFrame = 0;
-		float frameAccumulator = 0.0f;
 		bool gltf = true;
+		vec3 previousPosition{ 0.0f, 0.0f, 0.0f };                       ///< State before last fixed simulation step.
+		float previousYaw = 0.0f;
+		float previousPitch = 0.0f;
+		bool previousValid = false;                                      ///< False until first step stored state, such transform rendered as is.
 	};
+
+	/// Rendering state between previous and current simulation step, alpha is part of step already passed.
+	inline transform InterpolateTransform(const transform& transformComponent, float alpha) {
+		transform result = transformComponent;
+		if ( !transformComponent.previousValid )
+			return result;
+
+		for ( int i = 0; i < 3; ++i )
+			result.tPosition[i] = transformComponent.previousPosition[i] +
+				(transformComponent.tPosition[i] - transformComponent.previousPosition[i]) * alpha;
+		result.yaw   = transformComponent.previousYaw + (transformComponent.yaw - transformComponent.previousYaw) * alpha;
+		result.pitch = transformComponent.previousPitch + (transformComponent.pitch - transformComponent.previousPitch) * alpha;
+
+		return result;
+	}
+
+	/// True if rendering state depends on alpha.
+	inline bool IsInterpolated(const transform& transformComponent) {
+		return transformComponent.previousValid &&
+			(transformComponent.previousPosition[0] != transformComponent.tPosition[0] ||
+			 transformComponent.previousPosition[1] != transformComponent.tPosition[1] ||
+			 transformComponent.previousPosition[2] != transformComponent.tPosition[2] ||
+			 transformComponent.previousYaw != transformComponent.yaw ||
+			 transformComponent.previousPitch != transformComponent.pitch);
+	}
 }
 
 #endif
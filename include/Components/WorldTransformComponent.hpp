@@ -0,0 +1,21 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#ifndef WORLD_TRANSFORM_COMPONENT
+#define WORLD_TRANSFORM_COMPONENT
+
+#include "VertexMath.hpp"
+
+namespace GLVM::ecs::components
+{
+	/// Cached matrices of transform component, written only by transform system.
+	struct worldTransform
+	{
+		mat4 local{ 1.0f };                                              ///< Scale, rotation and translation of interpolated transform.
+		mat4 world{ 1.0f };                                              ///< Local matrix combined with world matrices of all parents, read by renderers.
+	};
+}
+
+#endif
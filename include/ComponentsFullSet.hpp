@@ -17,6 +17,8 @@
 #include "Components/EventComponent.hpp"
 #include "Components/RigidBodyComponent.hpp"
 #include "Components/TransformComponent.hpp"
+#include "Components/WorldTransformComponent.hpp"
+#include "Components/ParentComponent.hpp"
 #include "Components/PointLightComponent.hpp"
 #include "Components/ControllerComponent.hpp"
 #include "Components/TextureComponent.hpp"
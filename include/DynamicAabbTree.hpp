@@ -0,0 +1,147 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#ifndef DYNAMIC_AABB_TREE
+#define DYNAMIC_AABB_TREE
+
+#include "IBroadphase.hpp"
+#include "Vector.hpp"
+#include "VertexMath.hpp"
+#include <cassert>
+
+namespace GLVM::ecs
+{
+	constexpr unsigned int AABB_TREE_NULL_NODE = ~0u;
+	constexpr float AABB_TREE_FAT_MARGIN = 0.1f;                         ///< Enlargement of leaf box on every side.
+	constexpr float AABB_TREE_DISPLACEMENT_MULTIPLIER = 2.0f;            ///< Leaf box also stretched along predicted movement.
+	constexpr unsigned int AABB_TREE_STACK_SIZE = 256;                   ///< Traversal stack, tree is balanced so its height stays far below.
+
+	/*! Dynamic bounding volume hierarchy. Every proxy is leaf with fat box, that is real box
+	 *  enlarged by margin. MoveProxy reinserts leaf only when real box leaves its fat box, so
+	 *  static geometry inserted once and slow actors touch tree rarely. New leaf placed by surface
+	 *  area heuristic and tree balanced by rotations on the way to root. Nodes live in one pool
+	 *  with free list, proxy ID is index of leaf node and stays valid until DestroyProxy.
+	 *
+	 *  Queries test fat boxes, so they may return proxies whose real box dont intersect, caller
+	 *  does exact test. Callbacks return false to stop query.
+	 */
+	class CDynamicAabbTree
+	{
+		struct Node
+		{
+			BroadphaseBox box;
+			unsigned int parent;                                         ///< Next free node while node is in free list.
+			unsigned int child1;
+			unsigned int child2;
+			int height;                                                  ///< Zero for leaf, -1 for free node.
+			unsigned int userData;
+
+			bool IsLeaf() const { return child1 == AABB_TREE_NULL_NODE; }
+		};
+
+		core::vector<Node> nodes;
+		unsigned int root = AABB_TREE_NULL_NODE;
+		unsigned int freeList = AABB_TREE_NULL_NODE;
+		unsigned int proxiesNumber = 0;
+
+		unsigned int AllocateNode();
+		void FreeNode(unsigned int node);
+		void InsertLeaf(unsigned int leaf);
+		void RemoveLeaf(unsigned int leaf);
+		unsigned int Balance(unsigned int node);
+		void Refit(unsigned int node);
+
+		static BroadphaseBox Combine(const BroadphaseBox& first, const BroadphaseBox& second);
+		static float Area(const BroadphaseBox& box);
+		static bool Contain(const BroadphaseBox& outer, const BroadphaseBox& inner);
+		static BroadphaseBox Fatten(const BroadphaseBox& box, const vec3& displacement);
+
+	public:
+		/// Return proxy ID.
+		unsigned int CreateProxy(const BroadphaseBox& box, unsigned int userData);
+		void DestroyProxy(unsigned int proxy);
+
+		/// Reinsert proxy only if box left its fat box. Return true if tree was changed.
+		bool MoveProxy(unsigned int proxy, const BroadphaseBox& box, const vec3& displacement = vec3(0.0f, 0.0f, 0.0f));
+
+		unsigned int GetUserData(unsigned int proxy) const { return nodes[proxy].userData; }
+		void SetUserData(unsigned int proxy, unsigned int userData) { nodes[proxy].userData = userData; }
+		const BroadphaseBox& GetFatBox(unsigned int proxy) const { return nodes[proxy].box; }
+		unsigned int GetProxiesNumber() const { return proxiesNumber; }
+		int GetHeight() const { return root == AABB_TREE_NULL_NODE ? 0 : nodes[root].height; }
+
+		/// Append every pair of proxies with overlapping fat boxes, pair holds user data, first less than second.
+		void CollectPairs(core::vector<BroadphasePair>& pairs) const;
+
+		/// callback(unsigned int proxy) -> bool.
+		template <typename Function>
+		void QueryBox(const BroadphaseBox& box, Function callback) const {
+			Traverse([&](const BroadphaseBox& nodeBox) { return BoxOverlap(nodeBox, box); }, callback);
+		}
+
+		/// Proxies whose fat box is crossed by segment from origin to origin + ray.
+		template <typename Function>
+		void QueryRay(const vec3& origin, const vec3& ray, Function callback) const {
+			vec3 inverseRay(1.0f / ray[0], 1.0f / ray[1], 1.0f / ray[2]);
+			Traverse([&](const BroadphaseBox& nodeBox) { return RayOverlap(nodeBox, origin, inverseRay); }, callback);
+		}
+
+		template <typename Function>
+		void QueryFrustum(const vec4* planes, unsigned int planesNumber, Function callback) const {
+			Traverse([&](const BroadphaseBox& nodeBox) { return FrustumOverlap(nodeBox, planes, planesNumber); }, callback);
+		}
+
+	private:
+		template <typename Test, typename Function>
+		void Traverse(Test test, Function callback) const {
+			if ( root == AABB_TREE_NULL_NODE )
+				return;
+
+			unsigned int stack[AABB_TREE_STACK_SIZE];
+			unsigned int stackSize = 0;
+			stack[stackSize++] = root;
+			while ( stackSize > 0 ) {
+				unsigned int nodeIndex = stack[--stackSize];
+				const Node& node = nodes[nodeIndex];
+				if ( !test(node.box) )
+					continue;
+
+				if ( node.IsLeaf() ) {
+					if ( !callback(nodeIndex) )
+						return;
+				} else {
+					assert( stackSize + 2 <= AABB_TREE_STACK_SIZE );
+					stack[stackSize++] = node.child1;
+					stack[stackSize++] = node.child2;
+				}
+			}
+		}
+	};
+
+	/// Tree as broadphase of collision system, proxy of every collider found by entity index.
+	class CAabbTreeBroadphase : public IBroadphase
+	{
+		struct ColliderProxy
+		{
+			unsigned int proxy = AABB_TREE_NULL_NODE;
+			unsigned int frame = 0;                                      ///< Last update that passed collider, older proxies destroyed.
+		};
+
+		CDynamicAabbTree tree;                                           ///< User data of proxy is entity handle.
+		core::vector<ColliderProxy> proxies;                             ///< Indexed by entity index.
+		unsigned int frame = 0;
+
+	public:
+		void BeginUpdate() override { ++frame; }
+		void UpdateProxy(Entity entity, const BroadphaseBox& box, const vec3& displacement) override;
+		void EndUpdate() override;
+		void CollectPairs(core::vector<BroadphasePair>& pairs) const override { tree.CollectPairs(pairs); }
+		void QueryRay(const vec3& origin, const vec3& ray, core::vector<Entity>& entities) const override;
+
+		const CDynamicAabbTree& GetTree() const { return tree; }
+	};
+}
+
+#endif
@@ -27,6 +27,7 @@
 #include <GL/gl.h>
 #include <GL/glext.h>
 #include "Constants.hpp"
+#include "FixedTimestep.hpp"
 #include <mutex>
 #include "TextureManager.hpp"
 
@@ -63,6 +64,10 @@ namespace GLVM::core
 		ecs::CMovementSystem   * movementSystem;
         ecs::CPhysicsSystem    * physicsSystem;
         ecs::CProjectileSystem * projectileSystem;
+		ecs::CInterpolationSystem * interpolationSystem;
+		ecs::CTransformSystem  * transformSystem;                       ///< Run once per rendered frame, not per simulation step.
+		ecs::CAnimationSystem  * animationSystem;                       ///< Run once per rendered frame, before renderer reads palettes.
+		CFixedTimestep       fixedTimestep;
 
 		/// For FPS counting
 		unsigned int fpsCounter = 0;
@@ -83,6 +88,7 @@ namespace GLVM::core
 		void EventQueueFlush();
 		void RenderOpengl();
 		void RenderVulkan();
+		void Simulate(float frameTime);
 		ecs::TextureHandle LoadTextureFromFile(const char* path_to_texture);
 		ecs::TextureHandle LoadTextureFromAddress(unsigned int iWidth, unsigned int iHeight,
 								  unsigned int dat_length, unsigned char* u_iData);
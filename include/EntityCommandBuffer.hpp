@@ -0,0 +1,118 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#ifndef ENTITY_COMMAND_BUFFER
+#define ENTITY_COMMAND_BUFFER
+
+#include "ComponentManager.hpp"
+#include "EntityManager.hpp"
+#include "Vector.hpp"
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace GLVM::ecs
+{
+	constexpr unsigned int COMMAND_PAYLOAD_BLOCK_SIZE = 16 * 1024;    ///< Size of one block for values of recorded components.
+
+	/*! Deferred structural changes. Systems record creation and removal of components and entities
+	 *  while they iterate tables, CSystemManager plays records back after stage of system is finished.
+	 *
+	 *  Ordering of playback:
+	 *  - commands are batched by component type and sorted by entity index, commands for the same
+	 *    component of the same entity keep order of recording;
+	 *  - add of component that entity already has works as set;
+	 *  - set of component that entity dont have is ignored;
+	 *  - destroyed entities are removed last and all other commands for them are dropped.
+	 *
+	 *  One buffer must be used by one thread at a time.
+	 */
+	class EntityCommandBuffer
+	{
+		enum ECommandType
+		{
+			eADD_COMPONENT,
+			eSET_COMPONENT,
+			eREMOVE_COMPONENT
+		};
+
+		struct Command
+		{
+			ECommandType type;
+			Entity       entity;
+			unsigned int componentTypeID;
+			unsigned int sequence;                                       ///< Order of recording, keep sort stable.
+			void*        payload;                                        ///< Recorded value of component, nullptr for value-initialized one.
+		};
+
+		std::vector<Command> commands;
+		core::vector<Entity> destroyedEntities;
+		core::vector<Entity> createdEntities;                            ///< Handles reserved by CreateEntity, released by Clear without playback.
+		core::vector<unsigned char*> payloadBlocks;                      ///< Blocks reused after every playback.
+		core::vector<unsigned char*> largePayloads;                      ///< Values that dont fit into block, freed after every playback.
+		unsigned int currentBlock = 0;
+		unsigned int currentBlockOffset = 0;
+
+		void* AllocatePayload(unsigned int size, unsigned int alignment);
+		void Record(ECommandType type, Entity entity, unsigned int componentTypeID, void* payload);
+		void DestroyPayloads();
+
+		template <typename componentType>
+		void* StoreValue(componentType&& value) {
+			typedef std::remove_cvref_t<componentType> valueType;
+			static_assert( alignof(valueType) <= alignof(std::max_align_t) );
+			void* payload = AllocatePayload(sizeof(valueType), alignof(valueType));
+			new (payload) valueType(std::forward<componentType>(value));
+			return payload;
+		}
+
+	public:
+		EntityCommandBuffer() = default;
+		~EntityCommandBuffer();
+		EntityCommandBuffer(const EntityCommandBuffer& commandBuffer) = delete;
+		void operator=(const EntityCommandBuffer& commandBuffer) = delete;
+
+		/// Handle is reserved immediately, components are added on playback. Clear without playback releases it.
+		[[nodiscard]] Entity CreateEntity();
+		void DestroyEntity(Entity entity);
+
+		template <typename componentType>
+		void AddComponent(Entity entity) {
+			Record(eADD_COMPONENT, entity, ComponentManager::GetInstance()->GetComponentTypeID<componentType>(), nullptr);
+		}
+
+		template <typename componentType>
+		void AddComponent(Entity entity, componentType&& value) {
+			typedef std::remove_cvref_t<componentType> valueType;
+			Record(eADD_COMPONENT, entity, ComponentManager::GetInstance()->GetComponentTypeID<valueType>(),
+				   StoreValue(std::forward<componentType>(value)));
+		}
+
+		template <typename componentType>
+		void SetComponent(Entity entity, componentType&& value) {
+			typedef std::remove_cvref_t<componentType> valueType;
+			Record(eSET_COMPONENT, entity, ComponentManager::GetInstance()->GetComponentTypeID<valueType>(),
+				   StoreValue(std::forward<componentType>(value)));
+		}
+
+		template <typename componentType>
+		void RemoveComponent(Entity entity) {
+			Record(eREMOVE_COMPONENT, entity, ComponentManager::GetInstance()->GetComponentTypeID<componentType>(), nullptr);
+		}
+
+		bool IsEmpty() const { return commands.empty() && destroyedEntities.GetSize() == 0; }
+
+		/// Apply all recorded commands and clear buffer.
+		void Playback(ComponentManager* componentManager, EntityManager* entityManager);
+
+		/// Drop all recorded commands without applying them and remove entities created through buffer.
+		void Clear();
+	};
+}
+
+#endif
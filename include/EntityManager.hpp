@@ -8,19 +8,49 @@
 
 #include "Vector.hpp"
 #include "ComponentManager.hpp"
+#include <atomic>
+#include <mutex>
 
 typedef unsigned int Entity_ID;  
 
 namespace GLVM::ecs
 {
+	constexpr unsigned int ENTITY_SLOTS_PAGE_BITS    = 12;
+	constexpr unsigned int ENTITY_SLOTS_PAGE_SIZE    = 1u << ENTITY_SLOTS_PAGE_BITS;
+	constexpr unsigned int ENTITY_SLOTS_PAGES_NUMBER = (ENTITY_INDEX_MASK >> ENTITY_SLOTS_PAGE_BITS) + 1;
+
+	/*! Removed slot reused only when more slots than this wait in free list, so one slot changes
+	 *  generation at most once per that many removals and old handles stay stale much longer.
+	 */
+	constexpr unsigned int MINIMUM_FREE_ENTITY_SLOTS = 1024;
+
+	/// Generation of retired slot, no handle has it, because handle keeps only ENTITY_GENERATION_MASK bits.
+	constexpr unsigned int RETIRED_SLOT_GENERATION = ENTITY_GENERATION_MASK + 1;
+
 	class EntityManager
 	{
         static EntityManager* pInstance_;
         static std::mutex  Mutex_;
 
-		inline static Entity_ID u_iID = 0;		
- 		core::vector<Entity_ID> tRemoved_Entity_Registry_;
-		core::vector<Entity_ID> tActive_Entity_Registry_;
+		/*! Slot of entity index. Removed slots form intrusive FIFO free list through nextFreeSlot,
+		 *  so creation and removal of entity dont move any data. Slots live in pages that never
+		 *  move, so IsAlive reads generation without lock while other thread creates entities.
+		 */
+		struct EntitySlot
+		{
+			std::atomic<unsigned int> generation{0};                     ///< Generation of current or next alive entity of the slot.
+			unsigned int nextFreeSlot = k_iUint_Max;
+		};
+
+		mutable std::mutex slotsMutex;                                   ///< Entities can be created from command buffers of parallel systems.
+		EntitySlot* slotPages[ENTITY_SLOTS_PAGES_NUMBER] = {};
+		std::atomic<unsigned int> slotsNumber{0};                        ///< Slots ever used, pages of them allocated before number grows.
+		unsigned int freeSlotsHead = k_iUint_Max;                         ///< Oldest free slot, k_iUint_Max if free list is empty.
+		unsigned int freeSlotsTail = k_iUint_Max;                         ///< Newest free slot.
+		unsigned int freeSlotsNumber = 0;
+		unsigned int aliveEntitiesNumber = 0;
+
+		EntitySlot& GetSlot(unsigned int index) const { return slotPages[index >> ENTITY_SLOTS_PAGE_BITS][index & (ENTITY_SLOTS_PAGE_SIZE - 1)]; }
 		
         EntityManager();
         ~EntityManager();
@@ -33,6 +63,15 @@ namespace GLVM::ecs
 		[[nodiscard]] Entity_ID CreateEntity();
 
         void RemoveEntity(Entity_ID& _Entity_ID, ComponentManager* _ComponentManager);
+
+		/// Return false for handle of removed entity, even if its slot already reused by new entity. Dont lock.
+		bool IsAlive(Entity_ID _Entity_ID) const {
+			unsigned int index = GetEntityIndex(_Entity_ID);
+			return index < slotsNumber.load(std::memory_order_acquire) &&
+				GetSlot(index).generation.load(std::memory_order_acquire) == GetEntityGeneration(_Entity_ID);
+		}
+
+		unsigned int GetAliveEntitiesNumber() const { return aliveEntitiesNumber; }
 	};
 }
 
@@ -16,6 +16,51 @@ namespace GLVM::core
 		int iHead_ = 0;
 		static const int iStack_Range_ = 6;
 		EEvents aStack_[iStack_Range_] = {};
+
+		/*! Press of one-shot event (jump, fire) latched until next simulation step. Release of
+		 *  latched event deferred to ReleaseLatched, so press and release inside of frame that ran
+		 *  no step still reach systems.
+		 */
+		EEvents aLatched_[iStack_Range_] = {};
+		int iLatched_ = 0;
+		EEvents aDeferredReleases_[iStack_Range_] = {};
+		int iDeferredReleases_ = 0;
+
+		static bool IsOneShot(EEvents _Event) { return _Event == eJUMP || _Event == eMOUSE_LEFT_BUTTON; }
+
+		static bool Contains(const EEvents* _aEvents, int _iSize, EEvents _Event) {
+			for ( int i = 0; i < _iSize; ++i )
+				if ( _aEvents[i] == _Event )
+					return true;
+
+			return false;
+		}
+
+		static void Erase(EEvents* _aEvents, int& _iSize, EEvents _Event) {
+			for ( int i = 0; i < _iSize; ++i )
+				if ( _aEvents[i] == _Event ) {
+					_aEvents[i] = _aEvents[--_iSize];
+					return;
+				}
+		}
+
+		void Press(EEvents _Event) {
+			Push(_Event);
+			if ( IsOneShot(_Event) && !Contains(aLatched_, iLatched_, _Event) && iLatched_ < iStack_Range_ )
+				aLatched_[iLatched_++] = _Event;
+		}
+
+		void Release(EEvents _Event) {
+			if ( Contains(aLatched_, iLatched_, _Event) ) {
+				if ( !Contains(aDeferredReleases_, iDeferredReleases_, _Event) )
+					aDeferredReleases_[iDeferredReleases_++] = _Event;
+
+				return;
+			}
+
+			Remove(_Event);
+		}
+
 	public:
 		void Push(const EEvents& _Event)
 		{
@@ -67,6 +112,7 @@ namespace GLVM::core
         
 		void ControlInput(CEvent& _eEvent)
 		{
+			Erase(aDeferredReleases_, iDeferredReleases_, _eEvent.GetEvent());    ///< Pressed again before step saw release.
             if(!(SearchElement(_eEvent.GetEvent()) == eEmpty))
                 return;
 			switch(_eEvent.GetEvent())
@@ -87,10 +133,10 @@ namespace GLVM::core
 				Remove(eMOVE_FORWARD); 
 				break;
             case eKEYRELEASE_JUMP:
-                Remove(eJUMP);
+                Release(eJUMP);
                 break;
             case eMOUSE_LEFT_BUTTON_RELEASE:
-                Remove(eMOUSE_LEFT_BUTTON);
+                Release(eMOUSE_LEFT_BUTTON);
                 break;
 			case eMOVE_LEFT:
                 Push(eMOVE_LEFT);
@@ -105,10 +151,10 @@ namespace GLVM::core
                 Push(eMOVE_FORWARD);
 				break;
             case eJUMP:
-                Push(eJUMP);
+                Press(eJUMP);
                 break;
             case eMOUSE_LEFT_BUTTON:
-                Push(eMOUSE_LEFT_BUTTON);
+                Press(eMOUSE_LEFT_BUTTON);
                 break;
 			default:
 				break;
@@ -147,6 +193,14 @@ namespace GLVM::core
             return false;
         }
 
+		/// Called after every simulation step: latched events were seen, deferred releases applied now.
+		void ReleaseLatched() {
+			iLatched_ = 0;
+			for ( int i = 0; i < iDeferredReleases_; ++i )
+				Remove(aDeferredReleases_[i]);
+			iDeferredReleases_ = 0;
+		}
+
 		void Clear() {
 			for ( int i = 0; i < iHead_; ++i)
 				aStack_[i] = EEvents::eDEFAULT;
@@ -0,0 +1,52 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#ifndef FIXED_TIMESTEP
+#define FIXED_TIMESTEP
+
+namespace GLVM::core
+{
+	constexpr float FIXED_TIME_STEP = 1.0f / 60.0f;                      ///< Duration of one simulation step in seconds.
+	constexpr unsigned int MAX_SIMULATION_SUBSTEPS = 5;                  ///< Steps allowed per frame, after that simulation slows down.
+
+	/*! Accumulator of frame time for fixed step simulation. Frame time added every frame, whole
+	 *  steps taken out of it and rest stays for next frame, so simulation always advanced by the
+	 *  same delta independently of frame rate. Alpha is part of step that rest makes, renderer
+	 *  use it to draw state between two last steps.
+	 *
+	 *  After long frame accumulator could keep more steps than cap, they are dropped instead of
+	 *  making next frame longer too.
+	 */
+	class CFixedTimestep
+	{
+		float step;
+		unsigned int maxSubsteps;
+		float accumulator = 0.0f;
+
+	public:
+		explicit CFixedTimestep(float step_ = FIXED_TIME_STEP, unsigned int maxSubsteps_ = MAX_SIMULATION_SUBSTEPS) :
+			step(step_), maxSubsteps(maxSubsteps_) {}
+
+		/// Add frame time and return number of steps to simulate now.
+		unsigned int Advance(float frameTime) {
+			accumulator += frameTime;
+			unsigned int substeps = 0;
+			while ( accumulator >= step && substeps < maxSubsteps ) {
+				accumulator -= step;
+				++substeps;
+			}
+
+			if ( accumulator >= step )
+				accumulator = 0.0f;
+
+			return substeps;
+		}
+
+		float GetAlpha() const { return accumulator / step; }
+		float GetStep() const { return step; }
+	};
+}
+
+#endif
@@ -0,0 +1,111 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#ifndef FRUSTUM
+#define FRUSTUM
+
+#include "VertexMath.hpp"
+#include <cmath>
+
+namespace GLVM::core
+{
+	constexpr unsigned int FRUSTUM_PLANES_NUMBER = 6;
+
+	/*! Planes of view frustum from matrix that renderer passes to shaders as view * projection.
+	 *  Rows of clip matrix are columns of mat4, because shaders read it column major. Plane is
+	 *  (normal, distance) with unit normal and inside is dot(normal, point) + distance >= 0, same
+	 *  as FrustumOverlap of broadphase. Near plane taken for -w <= z, so it is conservative for
+	 *  projections with depth range from zero.
+	 */
+	inline void ExtractFrustumPlanes(const mat4& viewProjection, vec4* planes) {
+		vec4 rows[4];
+		for ( unsigned int row = 0; row < 4; ++row )
+			for ( unsigned int column = 0; column < 4; ++column )
+				rows[row][column] = viewProjection[column][row];
+
+		for ( unsigned int i = 0; i < 3; ++i ) {
+			for ( unsigned int j = 0; j < 4; ++j ) {
+				planes[i * 2][j]     = rows[3][j] + rows[i][j];
+				planes[i * 2 + 1][j] = rows[3][j] - rows[i][j];
+			}
+		}
+
+		for ( unsigned int i = 0; i < FRUSTUM_PLANES_NUMBER; ++i ) {
+			vec4& plane = planes[i];
+			float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+			if ( length > 0.0f )
+				for ( unsigned int j = 0; j < 4; ++j )
+					plane[j] /= length;
+		}
+	}
+
+	/// Six planes of cube with half size range around center, for passes that see every direction like cube shadow map.
+	inline void ExtractRangePlanes(const vec3& center, float range, vec4* planes) {
+		for ( unsigned int i = 0; i < 3; ++i ) {
+			planes[i * 2]     = vec4(0.0f, 0.0f, 0.0f, range - center[i]);
+			planes[i * 2][i]  = 1.0f;
+			planes[i * 2 + 1] = vec4(0.0f, 0.0f, 0.0f, range + center[i]);
+			planes[i * 2 + 1][i] = -1.0f;
+		}
+	}
+
+	/// Sphere is (center, radius), outside if it lies fully behind any plane.
+	inline bool SphereInFrustum(const vec4& sphere, const vec4* planes, unsigned int planesNumber) {
+		for ( unsigned int i = 0; i < planesNumber; ++i ) {
+			const vec4& plane = planes[i];
+			if ( plane[0] * sphere[0] + plane[1] * sphere[1] + plane[2] * sphere[2] + plane[3] < -sphere[3] )
+				return false;
+		}
+
+		return true;
+	}
+
+	/// Bounds of mesh in its own space, computed once when mesh is loaded.
+	struct MeshBounds
+	{
+		vec3 min;
+		vec3 max;
+		vec4 sphere;                                                     ///< Center of box and radius to farthest vertex.
+	};
+
+	/// Position is first three floats of every vertex, stride is distance between vertices in bytes.
+	inline MeshBounds ComputeMeshBounds(const float* vertices, unsigned int verticesNumber, unsigned int stride) {
+		MeshBounds bounds;
+		if ( verticesNumber == 0 )
+			return bounds;
+
+		const char* bytes = reinterpret_cast<const char*>(vertices);
+		for ( unsigned int i = 0; i < 3; ++i ) {
+			bounds.min[i] = vertices[i];
+			bounds.max[i] = vertices[i];
+		}
+		for ( unsigned int v = 1; v < verticesNumber; ++v ) {
+			const float* position = reinterpret_cast<const float*>(bytes + v * stride);
+			for ( unsigned int i = 0; i < 3; ++i ) {
+				bounds.min[i] = Min(bounds.min[i], position[i]);
+				bounds.max[i] = Max(bounds.max[i], position[i]);
+			}
+		}
+
+		for ( unsigned int i = 0; i < 3; ++i )
+			bounds.sphere[i] = (bounds.min[i] + bounds.max[i]) * 0.5f;
+
+		float radiusSquared = 0.0f;
+		for ( unsigned int v = 0; v < verticesNumber; ++v ) {
+			const float* position = reinterpret_cast<const float*>(bytes + v * stride);
+			float distanceSquared = 0.0f;
+			for ( unsigned int i = 0; i < 3; ++i ) {
+				float offset = position[i] - bounds.sphere[i];
+				distanceSquared += offset * offset;
+			}
+			radiusSquared = Max(radiusSquared, distanceSquared);
+		}
+		bounds.sphere[3] = std::sqrt(radiusSquared);
+
+		return bounds;
+	}
+}
+
+#endif
@@ -0,0 +1,59 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#ifndef FRUSTUM_CULLER
+#define FRUSTUM_CULLER
+
+#include "Frustum.hpp"
+#include "IBroadphase.hpp"
+#include "Vector.hpp"
+#include "VertexMath.hpp"
+
+namespace GLVM::core
+{
+	/// Counters of one frame, or sum of all frames since reset. Object tested against several frusta counted once per frustum.
+	struct CullingStats
+	{
+		unsigned int tested = 0;
+		unsigned int visible = 0;
+		unsigned int culled = 0;
+	};
+
+	/*! World bounds of objects of one frame, tested against any number of frusta. Bounds
+	 *  transformed once per frame, so camera and every light reuse them. Spheres kept in separate
+	 *  arrays of coordinates and tested by simd::CullSpheres, objects whose sphere is inside
+	 *  tested again by world box, which fits long and flat meshes better.
+	 *
+	 *  SetBounds and SetUnbounded of different objects may run in parallel.
+	 */
+	class CFrustumCuller
+	{
+		core::vector<float> centersX;
+		core::vector<float> centersY;
+		core::vector<float> centersZ;
+		core::vector<float> radii;                                       ///< Infinity for objects that are never culled.
+		core::vector<ecs::BroadphaseBox> boxes;
+		core::vector<unsigned char> sphereVisibility;                    ///< Result of sphere test, one byte per object.
+		CullingStats frameStats;
+		CullingStats totalStats;
+
+	public:
+		void BeginFrame(unsigned int objectsNumber);                     ///< Resize arrays, bounds of every object must be set after that.
+
+		/// Box of mesh transformed by model matrix, sphere scaled by largest scale of axes.
+		void SetBounds(unsigned int object, const MeshBounds& bounds, const mat4& modelMatrix);
+		void SetUnbounded(unsigned int object);                          ///< Object always visible, like skinned mesh that leaves its bind pose box.
+
+		/// Indices of objects not fully behind any plane in ascending order.
+		void Cull(const vec4* planes, unsigned int planesNumber, core::vector<unsigned int>& visibleObjects);
+
+		unsigned int GetObjectsNumber() const { return radii.GetSize(); }
+		const CullingStats& GetFrameStats() const { return frameStats; }
+		const CullingStats& GetTotalStats() const { return totalStats; }
+		void ResetTotalStats() { totalStats = CullingStats(); }
+	};
+}
+
+#endif
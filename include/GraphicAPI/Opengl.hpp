@@ -7,19 +7,24 @@
 #define OPENGL
 
 #include "ComponentManager.hpp"
+#include "IBroadphase.hpp"
 #include "Components/AnimationMoveComponent.hpp"
 #include "Components/MaterialComponent.hpp"
 #include "Components/PointLightComponent.hpp"
 #include "Components/TransformComponent.hpp"
+#include "Components/WorldTransformComponent.hpp"
 #include "Components/VertexComponent.hpp"
 #include "Components/ViewComponent.hpp"
 #include "Components/DirectionalLightComponent.hpp"
 #include "Components/SpotLightComponent.hpp"
 #include "Constants.hpp"
 #include "Event.hpp"
+#include "Frustum.hpp"
+#include "FrustumCuller.hpp"
 #include "GLPointer.h"
 #include "IRenderer.hpp"
 #include "ISystem.hpp"
+#include "Systems/AnimationSystem.hpp"
 #include "Texture.hpp"
 #include "TextureManager.hpp"
 #include "Vector.hpp"
@@ -80,6 +85,10 @@ namespace GLVM::core {
 		GLuint quadVBO_;
 		float delta;
 		std::vector<ecs::Texture> textureVector;
+		const ecs::IBroadphase* colliderBroadphase = nullptr;          ///< Broadphase of collision system, used for projectile rays.
+		ecs::CAnimationSystem* animationSystem = nullptr;              ///< Gets skeletons of loaded meshes, gives finished palettes.
+		core::vector<Entity> rayCandidates;
+		float interpolationAlpha = 1.0f;                               ///< Part of fixed step passed since last simulation step.
 		std::vector<const char*> pathsArray_;
 		core::vector<const char*> pathsGLTF_;
 
@@ -135,8 +144,15 @@ namespace GLVM::core {
 		std::vector<std::vector<float>> aVertexes_;
 		std::vector<std::vector<unsigned int>> aIndices_;
 		uint32_t wavefrontObjCounter = 0;
-		core::vector<core::vector<core::vector<mat4>>> jointMatricesPerMesh;
-		core::vector<core::vector<float>> frames;
+		std::vector<mat4> unitPalette = std::vector<mat4>(MAX_JOINTS_NUMBER, mat4(1.0f));    ///< Palette of static meshes.
+		std::vector<core::MeshBounds> meshBounds;                        ///< Indexed by mesh id, same as VAOcontainer_.
+		bool frustumCulling = true;                                      ///< False draws every entity in every pass.
+		core::CFrustumCuller sceneCuller;
+		core::vector<Entity> sceneEntities;                              ///< Drawn entities of frame, object index of culler.
+		core::vector<mat4> sceneModelMatrices;
+		core::vector<unsigned int> visibleSceneEntities;                 ///< Result of last cull, indices in sceneEntities.
+		mat4 cameraViewMatrix;
+		mat4 cameraProjectionMatrix;
 		float frameAccumulator = 0.0f;
 		unsigned int currentFrame = 0;
 
@@ -174,14 +190,17 @@ namespace GLVM::core {
 		void EvaluateCubeShadowMap(unsigned int& shadowMapFBO, ecs::components::pointLight& pointLightComponent);
 		void EvaluateCoreShader();
 		void EvaluateFlatDebugShader();
-		void RenderScene(Shader* shaderProgram_);
+		void CollectSceneEntities();                                     ///< Model matrices and world bounds of drawn entities, before all passes.
+		void RenderScene(Shader* shaderProgram_, const vec4* planes, unsigned int planesNumber);    ///< Draw entities not fully behind any plane.
+		const core::CullingStats& GetCullingStats() const { return sceneCuller.GetFrameStats(); }   ///< Sum of all passes of last frame.
+		const mat4* getJointPalette(Entity entity) const;                ///< MAX_JOINTS_NUMBER matrices sampled by animation system.
 		void Raycasting();
 		void RaycastingDebug();                                                         ///< TODO: For debug only
 		void RenderQuad();
 		void SetVertices(std::vector<unsigned int>& _aIndices,
 						 std::vector<float>& _aVertices);
 		void loadWavefrontObj() override;
-		void EnlargeFrameAccumulator(float value) override;
+		void SetInterpolationAlpha(float alpha) override;
 		void SetTextureData(std::vector<ecs::Texture>& _texture_data) override;
 		void SetMeshData(std::vector<const char*> _pathsArray, core::vector<const char*> pathsGLTF_) override;
 		void LoadTextureData(GLVM::ecs::Texture& texture);
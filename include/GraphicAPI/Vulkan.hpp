@@ -23,11 +23,14 @@
 
 #include "Components/MaterialComponent.hpp"
 #include "Components/TransformComponent.hpp"
+#include "Components/WorldTransformComponent.hpp"
 #include "Components/TextureComponent.hpp"
 #include "IRenderer.hpp"
 #include "Texture.hpp"
 #include "Vector.hpp"
 #include "VertexMath.hpp"
+#include "Frustum.hpp"
+#include "FrustumCuller.hpp"
 #include "TextureManager.hpp"
 #include "ComponentManager.hpp"
 #include "WavefrontObjParser.hpp"
@@ -35,6 +38,7 @@
 #include "Globals.hpp"
 #include "ToString.hpp"
 #include "JsonParser.hpp"
+#include "Systems/AnimationSystem.hpp"
 
 #ifdef __linux__
 //#define VK_USE_PLATFORM_XLIB_KHR
@@ -181,6 +185,10 @@ namespace GLVM::core
 		LIGHT_DATA,
 		SPECULAR_SAMPLER,
 		LIGHT_SAMPLERS,
+
+		/// SSBO - shader storage buffer object
+		INSTANCE_DATA_SSBO,
+		INSTANCE_CULLING_SSBO,
 	};
 
 	struct VK_Image {
@@ -223,21 +231,26 @@ namespace GLVM::core
 		unsigned int globalDescriptorsNumber = 0;
 		unsigned int uboDescriptorsNumber = 0;
 		unsigned int combinedImageSamplersNumber = 0;
+		unsigned int ssboDescriptorsNumber = 0;
 		VkPipeline  pipeline;
 		VkPipelineLayout pipelineLayout;
 		const char* vertShader = nullptr;
 		const char* fragShader = nullptr;
+		const char* compShader = nullptr;
 		VkVertexInputBindingDescription bindingDescription;
 		std::array<VkVertexInputAttributeDescription, 5> attributeDescriptions;
 
 		void addDescriptor(VkDescriptorType vkType, DescriptorsTypes type, VkShaderStageFlags shaderStageFlag,
 						   core::vector<u32> descriptorsNumbers, core::vector<uint32_t> bindings) {
-			if (vkType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) {
+			if (vkType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER || vkType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC) {
 				descriptors.Push({vkType, type, bindings, shaderStageFlag, VkDescriptorSetLayout(), descriptorsNumbers, {}, {}, {}});
 				++uboDescriptorsNumber;
 			} else if (vkType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER) {
 				descriptors.Push({vkType, type, bindings, shaderStageFlag, VkDescriptorSetLayout(), descriptorsNumbers, {}, {}, {}});
 				++combinedImageSamplersNumber;
+			} else if (vkType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER) {
+				descriptors.Push({vkType, type, bindings, shaderStageFlag, VkDescriptorSetLayout(), descriptorsNumbers, {}, {}, {}});
+				++ssboDescriptorsNumber;
 			} else {
 				assert(!"unreachable");
 			}
@@ -254,24 +267,75 @@ namespace GLVM::core
 		}
 	};
 
-	struct LightSpaceMatrixUBO {
-		alignas(16) mat4 spotSpaceMatrix[SPOT_LIGHTS_NUMBER];
-		alignas(16) uint32_t spotLightsNumber;
-		
-		alignas(16) mat4 dirSpaceMatrix[DIRECTIONAL_LIGHTS_NUMBER];
-		alignas(16) uint32_t directionalLightsNumber;
+#define UNIFORM_POOL_CHUNKS 16           ///< Chunks that every added uniform descriptor pool has sets for.
+
+	/// Buffer of uniform ring, mapped once at creation and unmapped only at cleanup.
+	struct UniformChunk {
+		VkBuffer       buffer = VK_NULL_HANDLE;
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		char*          mapped = nullptr;
+		VkDeviceSize   allocationSize = 0;
+		bool           coherent = true;
+		std::vector<VkDescriptorSet> descriptorSets;                     ///< One per frame in flight, empty until ring gets set layout.
+	};
+
+	struct UniformAllocation {
+		uint32_t chunk;
+		uint32_t offset;                                                 ///< Dynamic offset inside chunk.
+	};
+
+	/*! Per frame uniform data written from start every frame. Every chunk split in
+	 *  MAX_FRAMES_IN_FLIGHT regions, frame writes only own region, so data still read by gpu is
+	 *  never overwritten. Slots of frame taken one after another over all chunks, stride of slot
+	 *  aligned to minUniformBufferOffsetAlignment. Offset of slot is dynamic offset for
+	 *  vkCmdBindDescriptorSets, so one descriptor set per frame covers every slot of chunk.
+	 *
+	 *  When frame needs more slots than chunks have, renderer adds chunk with own buffer and
+	 *  descriptor sets. Sets of old chunks stay untouched, so growth needs no vkDeviceWaitIdle.
+	 *  When uniform descriptor pool has no sets left, next pool added, old pool still valid.
+	 *  Chunks kept until cleanup, memory bounded by largest number of draws in one frame.
+	 */
+	struct UniformRing {
+		std::vector<UniformChunk> chunks;
+		VkDeviceSize   slotSize = 0;                                     ///< Range of descriptor.
+		VkDeviceSize   stride = 0;                                       ///< Aligned size of one slot.
+		VkDeviceSize   atomSize = 1;                                     ///< nonCoherentAtomSize, flushed range aligned to it.
+		uint32_t       slotsPerChunk = 0;                                ///< Slots of one frame in one chunk.
+		uint32_t       frame = 0;
+		uint32_t       head = 0;                                         ///< Slots taken in current frame over all chunks.
+		VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+		uint32_t       binding = 0;
+
+		void begin(uint32_t currentFrame) {
+			frame = currentFrame;
+			head = 0;
+		}
+
+		uint32_t getCapacity() const { return chunks.size() * slotsPerChunk; }
+
+		/// Copy data in next slot of current frame, ring must have free slot.
+		UniformAllocation allocate(const void* data, size_t size) {
+			assert(head < getCapacity() && "Uniform ring has no free slot");
+			uint32_t chunk = head / slotsPerChunk;
+			VkDeviceSize offset = (frame * slotsPerChunk + head % slotsPerChunk) * stride;
+			++head;
+			memcpy(chunks[chunk].mapped + offset, data, size);
+
+			return { chunk, static_cast<uint32_t>(offset) };
+		}
+
+		VkDescriptorSet* getDescriptorSet(const UniformAllocation& allocation) { return &chunks[allocation.chunk].descriptorSets[frame]; }
 	};
 
 #define MAX_JOINTS_NUMBER 18
-	
-    struct alignas(64) ModelMatrixUBO {
-        mat4 model;
+#define ACTORS_MATRICES_GRAIN 64    ///< Number of actors in one job of parallel computation of matrices.
+#define INSTANCE_PASSES_NUMBER 4    ///< Main pass and three shadow map passes, every one has own instance buffers.
+#define CULLING_GROUP_SIZE 64       ///< local_size_x of culling compute shader.
+
+	/// Data of main pass same for all instances, written once per frame.
+    struct alignas(64) ViewMatrixUBO {
         mat4 view;
         mat4 proj;
-		mat4 jointMatrices[MAX_JOINTS_NUMBER];
-
-		vec3  ambient;
-		float shininess;
 
 		alignas(16) mat4 spotSpaceMatrix[SPOT_LIGHTS_NUMBER];
 		alignas(16) uint32_t spotLightsNumber;
@@ -280,23 +344,105 @@ namespace GLVM::core
 		alignas(16) uint32_t directionalLightsNumber;
     };
 
+	/// One per light, instances of light taken from instance buffer.
 	struct alignas(16) ShadowMapMatrixUBO {
-		mat4 model;
 		mat4 lightSpaceMatrix;
-		mat4 jointMatrices[30];
 	};
 
-	struct alignas(16) SpotLightShadowMapMatrixUBO {
-		mat4 model;
-		mat4 lightSpaceMatrix;
-	};
-
-	struct alignas(64) PointLightShadowMapMatrixUBO {
-		mat4 model;
+	/// One per face of cube map.
+	struct alignas(16) PointLightShadowMapMatrixUBO {
 		mat4 lightSpaceMatrix;
 		vec3 lightPosition;
 		float farPlane;
-		mat4 jointMatrices[MAX_JOINTS_NUMBER];
+	};
+
+	/// Element of instance SSBO with std430 layout, indexed by gl_InstanceIndex in vertex shaders.
+	struct alignas(16) InstanceData {
+		mat4     model;
+		vec3     ambient;
+		float    shininess;
+		uint32_t paletteOffset;                                          ///< First joint matrix in palette SSBO, zero is unit palette of static meshes.
+		uint32_t group;                                                  ///< Indirect draw of instance group, culling shader counts visible instance in it.
+		uint32_t padding[2];
+	};
+
+	static_assert(sizeof(InstanceData) == 96, "InstanceData dont match std430 layout of shaders");
+
+	struct InstanceKey {
+		uint64_t key;                                                    ///< Mesh, diffuse and specular texture, so groups sorted by mesh first.
+		Entity   entity;
+		vec3     ambient;
+		float    shininess;
+	};
+
+	/// Instances of one mesh with one material, drawn by one instanced draw.
+	struct InstanceGroup {
+		uint32_t mesh;
+		uint32_t diffuseTexture;
+		uint32_t specularTexture;
+		uint32_t firstInstance;
+		uint32_t instancesNumber;
+	};
+
+	/// Storage buffer of one frame in flight, grows when instances of frame dont fit in it.
+	struct InstanceFrame {
+		VkBuffer        buffer = VK_NULL_HANDLE;
+		VkDeviceMemory  memory = VK_NULL_HANDLE;
+		char*           mapped = nullptr;
+		VkDeviceSize    size = 0;
+		bool            coherent = true;
+		VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+		VkDeviceSize    visibleOffset = 0;                               ///< Visible instance indices of shadow passes, after palettes.
+		uint32_t        visibleCapacity = 0;
+		uint32_t        visibleNumber = 0;                               ///< Indices written by lights already recorded in this frame.
+	};
+
+	/*! Indirect draw of one instance group with bounding sphere of its mesh. Renderer writes it
+	 *  with zero instanceCount every frame, culling shader adds every visible instance of group.
+	 *  Layout match std430 struct of culling shader, stride of vkCmdDrawIndexedIndirect is size
+	 *  of struct.
+	 */
+	struct alignas(16) IndirectDraw {
+		VkDrawIndexedIndirectCommand command;
+		uint32_t padding[3];
+		vec4     boundingSphere;                                         ///< Center and radius in mesh space.
+	};
+
+	static_assert(sizeof(IndirectDraw) == 48, "IndirectDraw dont match std430 layout of culling shader");
+
+	/// Push constants of culling shader.
+	struct CullingConstants {
+		vec4     frustumPlanes[6];
+		uint32_t instancesNumber;
+		uint32_t cullingEnabled;                                         ///< Zero makes every instance visible.
+	};
+
+	static_assert(sizeof(CullingConstants) == 104, "CullingConstants dont match push constants of culling shader");
+
+	/*! Draws and visible instance indices of main pass for one frame in flight. Draws written by
+	 *  cpu, so they are host visible, visible indices written and read only by gpu.
+	 */
+	struct IndirectFrame {
+		VkBuffer        drawsBuffer = VK_NULL_HANDLE;
+		VkDeviceMemory  drawsMemory = VK_NULL_HANDLE;
+		char*           drawsMapped = nullptr;
+		VkDeviceSize    drawsSize = 0;
+		bool            drawsCoherent = true;
+		VkBuffer        visibleBuffer = VK_NULL_HANDLE;
+		VkDeviceMemory  visibleMemory = VK_NULL_HANDLE;
+		VkDeviceSize    visibleSize = 0;
+		VkDescriptorSet descriptorSet = VK_NULL_HANDLE;                  ///< Set of culling pipeline.
+		uint32_t        drawsNumber = 0;                                 ///< Draws and instances of last upload, for culling counters.
+		uint32_t        instancesNumber = 0;
+	};
+
+	/*! Instance data and joint palettes of one pass. Frame writes only buffer of own frame in
+	 *  flight after fence of that frame was waited, so buffer and its descriptor set can be
+	 *  recreated and rewritten without vkDeviceWaitIdle.
+	 */
+	struct InstanceBuffer {
+		std::vector<InstanceFrame> frames;
+		VkDeviceSize offsetAlignment = 1;                                ///< minStorageBufferOffsetAlignment, palettes start aligned to it.
 	};
 
 	struct alignas(16) UniformBufferObjectLightUBO {
@@ -394,6 +540,8 @@ namespace GLVM::core
 	    float previousTime = 0;
 		float accumulator = 0;
 		bool animationFlag = false;
+		bool gpuCulling = true;                                          ///< Frustum culling of main pass in compute shader, false draws every instance.
+		bool shadowCulling = true;                                       ///< Frustum culling of shadow passes on cpu, false draws every instance for every light.
 		unsigned int actorsNumber = 0;
 		
         std::vector<ecs::Texture> initializeTextureData_;
@@ -407,8 +555,7 @@ namespace GLVM::core
         std::vector<std::vector<uint32_t>> aIndices_;                 ///< wavefront.obj indices
 		std::vector<std::vector<float>> aVertexesTemp_;                   ///< gltf indices
 		std::vector<std::vector<uint32_t>> aIndicesTemp_;             ///< Temp
-		core::vector<core::vector<core::vector<mat4>>> jointMatricesPerMesh;
-		core::vector<core::vector<float>> frames;
+		ecs::CAnimationSystem* animationSystem = nullptr;                ///< Gets skeletons of loaded meshes, gives finished palettes.
 
 		float fYaw   = -90.0f;
         float fPitch = 0.0f;
@@ -421,6 +568,8 @@ namespace GLVM::core
 
         const char* vertShaderCubeShadowMap = "../VKshaders/cubeShadowMapShaders/vertCubeShadowMap.spv";
         const char* fragShaderCubeShadowMap = "../VKshaders/cubeShadowMapShaders/fragCubeShadowMap.spv";
+
+        const char* compShaderCulling = "../VKshaders/cullingShaders/compCulling.spv";
 		
         unsigned int texturePool_;
 
@@ -443,7 +592,7 @@ namespace GLVM::core
         void recreateSwapChain();
         void draw() override;
         void loadWavefrontObj() override;
-		void EnlargeFrameAccumulator(float value) override;
+		void SetInterpolationAlpha(float alpha) override;
         void SetTextureData(std::vector<ecs::Texture>& _texture_data) override;
         void SetMeshData(std::vector<const char*> _pathsArray, core::vector<const char*> pathsGLTF) override;
         void SetViewMatrix(mat4 _viewMatrix) override;
@@ -451,6 +600,10 @@ namespace GLVM::core
 		void SetViewMatrix(ecs::components::transform& _Player, ecs::components::beholder& cameraComponent);
 		void SetProjectionMatrix();
         void run() override;
+
+		/// Main pass culled by gpu, its counters read back when fence of frame is waited, so they are late by MAX_FRAMES_IN_FLIGHT frames.
+		const core::CullingStats& getMainPassCullingStats() const { return mainPassCullingStats; }
+		const core::CullingStats& getShadowCullingStats() const { return shadowCuller.GetFrameStats(); }    ///< Sum of all lights of last frame.
     
     private:
         VkInstance instance;
@@ -491,6 +644,7 @@ namespace GLVM::core
 		Pipeline directionalLightPipeline;
 		Pipeline spotLightPipeline;
 		Pipeline pointLightPipeline;
+		Pipeline cullingPipeline;
 		
         VkPipelineLayout pipelineLayout;
         VkPipeline graphicsPipeline;
@@ -509,9 +663,7 @@ namespace GLVM::core
 		std::vector<VkFramebuffer> directionalLightShadowMapFrameBuffers;
 		VkRenderPass directionalLightShadowMapRenderPass;
 		std::vector<VkSampler> directionalLightShadowMapTextureSamplers;
-		std::vector<VkDescriptorSet> shadowMapDirectionalLightDescriptorSets;
-		std::vector<VkBuffer> shadowMapDirectionalLightModelMatrixUniformBuffers;
-		std::vector<VkDeviceMemory> shadowMapDirectionalLightModelMatrixUniformBuffersMemory;
+		UniformRing shadowMapDirectionalLightModelMatrixRing;
 
 		/*
 		===================================
@@ -520,19 +672,34 @@ namespace GLVM::core
 		*/
 		mat4 dirLightSpaceMatrix[DIRECTIONAL_LIGHTS_NUMBER];
 		mat4 spotLightSpaceMatrix[SPOT_LIGHTS_NUMBER];
-		std::vector<VkBuffer> lightSpaceMatrixBuffer;
-		std::vector<VkDeviceMemory> lightSpaceMatrixMemory;
-		std::vector<VkDescriptorSet> lightSpaceMatrixDescriptorSet;
+
+		std::vector<mat4> modelMatricesCache;                         ///< Model matrix of every actor, indexed by entity index.
+		unsigned int modelMatricesVersion = 0;                        ///< Change version of last cache update, zero rebuild all cache.
+		float interpolationAlpha = 1.0f;                              ///< Part of fixed step passed since last simulation step.
+		std::vector<mat4> unitPalette = std::vector<mat4>(MAX_JOINTS_NUMBER, mat4(1.0f));    ///< Palette of static meshes.
+		std::vector<InstanceKey> instanceKeys;                        ///< Actors sorted by mesh and material, position is instance index.
+		std::vector<InstanceData> instances;                          ///< Instances of all passes in this frame.
+		std::vector<const mat4*> instancePaletteSources;              ///< Palette copied in SSBO, nullptr for unit palette.
+		std::vector<mat4> instancePalettes;                           ///< Unit palette and then MAX_JOINTS_NUMBER matrices per animated instance.
+		std::vector<InstanceGroup> instanceGroups;
+		InstanceBuffer mainRenderInstanceBuffer;
+		InstanceBuffer directionalLightInstanceBuffer;
+		InstanceBuffer spotLightInstanceBuffer;
+		InstanceBuffer pointLightInstanceBuffer;
+		std::vector<core::MeshBounds> meshBounds;                     ///< Indexed by mesh id.
+		core::CFrustumCuller shadowCuller;                            ///< World bounds of instances, culled by frustum of every light.
+		core::vector<unsigned int> visibleShadowInstances;
+		core::CullingStats mainPassCullingStats;
+		std::vector<IndirectDraw> indirectDraws;                      ///< One per instance group, copied in draws buffer of frame.
+		std::vector<IndirectFrame> indirectFrames;
 		
 		unsigned int	pointLightNumber	   = 0;
 		std::vector<VK_Image> spotLightShadowMapImages;
 		std::vector<std::vector<VkFramebuffer>> pointLightShadowMapFrameBuffers;
 		VkRenderPass pointLightShadowMapRenderPass;
 		std::vector<VkSampler> pointLightShadowMapTextureSamplers;
-		std::vector<VkDescriptorSet> shadowMapPointLightDescriptorSets;
 		std::vector<VkDescriptorSet> shadowMapPointLightDataDescriptorSets;
-		std::vector<VkBuffer> shadowMapPointLightModelMatrixUniformBuffers;
-		std::vector<VkDeviceMemory> shadowMapPointLightModelMatrixUniformBuffersMemory;
+		UniformRing shadowMapPointLightModelMatrixRing;
 		std::vector<VkBuffer> shadowMapPointLightDataUniformBuffers;
 		std::vector<VkDeviceMemory> shadowMapPointLightDataUniformBuffersMemory;
 
@@ -542,9 +709,7 @@ namespace GLVM::core
 		std::vector<VkFramebuffer> spotLightShadowMapFrameBuffers;
 		VkRenderPass spotLightShadowMapRenderPass;
 		std::vector<VkSampler> spotLightShadowMapTextureSamplers;
-		std::vector<VkDescriptorSet> shadowMapSpotLightDescriptorSets;
-		std::vector<VkBuffer> shadowMapSpotLightModelMatrixUniformBuffers;
-		std::vector<VkDeviceMemory> shadowMapSpotLightModelMatrixUniformBuffersMemory;
+		UniformRing shadowMapSpotLightModelMatrixRing;
 
 		core::vector<mat4> shadowMapBasisMatrices;
 		std::vector<VkDescriptorSet> shadowMapMatrixUboDescriptorSets;
@@ -557,10 +722,8 @@ namespace GLVM::core
         std::vector<VkDeviceMemory> indexBufferMemoryContaner;
 		uint32_t wavefrontObjCounter = 0;
 
-        std::vector<VkBuffer> modelMatrixUniformBuffers;
-        std::vector<VkDeviceMemory> modelMatrixUniformBuffersMemory;
-        std::vector<VkBuffer> lightDataUniformBuffers;
-        std::vector<VkDeviceMemory> lightDataUniformBuffersMemory;
+		UniformRing viewMatrixRing;
+		UniformRing lightDataRing;
         std::vector<VkBuffer> materialUniformBuffers;
         std::vector<VkDeviceMemory> materialUniformBuffersMemory;
         std::vector<VkBuffer> directionalLightsUniformBuffers;
@@ -575,14 +738,14 @@ namespace GLVM::core
 		VkDescriptorImageInfo spotLightsImageInfo[SPOT_LIGHTS_NUMBER];
 		
         VkDescriptorPool descriptorPool;
+		std::vector<VkDescriptorPool> uniformDescriptorPools;           ///< Only sets of uniform chunks, last one used for new chunks.
+		uint32_t uniformPoolFreeChunks = 0;                              ///< Chunks that last uniform pool still has sets for.
 		unsigned int matrixUboDescriptorsNumber = 0;
 //		unsigned int viewPositionUboDescriptorsNumber = 0;
 		unsigned int directionalLightUboDescriptorsNumber = 0;
 		unsigned int pointLightUboDescriptorsNumber = 0;
 		unsigned int spotLightUboDescriptorsNumber = 0;
 		u32 lightDataSize;                                                        ///< Var for choose correct number of ds from dir, spot, point light and beholder number
-        std::vector<VkDescriptorSet> matrixUboDescriptorSets;
-		std::vector<VkDescriptorSet> lightDataUboDescriptorSets;
 		std::vector<VkDescriptorSet> materialUboDescriptorSets;
 		std::vector<VkDescriptorSet> directionalLightUboDescriptorSets;
 		std::vector<VkDescriptorSet> pointLightUboDescriptorSets;
@@ -649,6 +812,7 @@ namespace GLVM::core
 		void createPointLightShadowMapRenderPass();
         void createDescriptorSetLayout(core::vector<Descriptor>& descriptors);
         void createGraphicsPipeline(Pipeline& pipeline, VkRenderPass& renderPass);
+		void createComputePipeline(Pipeline& pipeline, uint32_t pushConstantsSize);
         void createRenderPassFramebuffers(std::vector<VkImageView>& attachments, VkRenderPass& renderPass_,
 										  VkFramebuffer& swapChainFramebuffer, uint32_t width,
 										  uint32_t height);
@@ -688,6 +852,31 @@ namespace GLVM::core
 		void updatePointLightShadowMapDescriptorSets();
 		void updateDescriptorSets();
         void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory);
+		void createUniformRing(UniformRing& ring, VkDeviceSize slotSize, uint32_t slotsPerChunk);
+		void addUniformChunk(UniformRing& ring);
+		UniformAllocation allocateUniform(UniformRing& ring, const void* data, size_t size);    ///< Add chunk when ring is full.
+		void flushUniformRing(const UniformRing& ring);                  ///< Make writes of current frame visible to gpu if memory is not coherent.
+		void destroyUniformRing(UniformRing& ring);
+		void allocateDescriptorSets(VkDescriptorSetLayout setLayout, std::vector<VkDescriptorSet>& descriptorSets, uint32_t setsNumber,
+									VkDescriptorPool pool = VK_NULL_HANDLE);    ///< Null pool means descriptorPool.
+		void createUniformDescriptorPool(uint32_t chunksNumber);
+		void allocateUniformChunkDescriptorSets(VkDescriptorSetLayout setLayout, UniformChunk& chunk);    ///< Add pool when last one is full.
+		void setUniformRingLayout(UniformRing& ring, VkDescriptorSetLayout setLayout, uint32_t binding);    ///< Allocate sets of chunks that have none.
+		void writeUniformChunkDescriptorSets(const UniformRing& ring, const UniformChunk& chunk);
+		void writeUniformRingDescriptorSets(const UniformRing& ring);
+		char* createMappedBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkBuffer& buffer, VkDeviceMemory& memory, bool& coherent);
+		void createInstanceBuffer(InstanceBuffer& instanceBuffer, VkDescriptorSetLayout setLayout);
+		/// Copy instances of frame, buffer of frame must be idle. Shadow passes reserve visibleCapacity indices for culled lights.
+		void uploadInstances(InstanceBuffer& instanceBuffer, uint32_t frame, uint32_t visibleCapacity);
+		void flushInstances(const InstanceBuffer& instanceBuffer, uint32_t frame);
+		void destroyInstanceBuffer(InstanceBuffer& instanceBuffer);
+		/// Instances inside frustum of light, one draw per mesh, material dont matter for depth.
+		void recordShadowMapInstances(VkCommandBuffer& commandBuffer, InstanceFrame& instanceFrame, const mat4& lightSpaceMatrix);
+		void createIndirectFrames();
+		void readIndirectDrawCounts(uint32_t frame);                     ///< Counters of main pass, after fence of frame.
+		void uploadIndirectDraws(uint32_t frame);                        ///< After uploadInstances of main pass, buffers of frame must be idle.
+		void recordInstanceCulling(VkCommandBuffer& commandBuffer);      ///< Before render pass of main pass.
+		void destroyIndirectFrames();
         VkCommandBuffer beginSingleTimeCommands(VkCommandPool& commandPool);
         void endSingleTimeCommands(VkCommandPool& commandPool, VkCommandBuffer& commandBuffer);
         void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
@@ -698,16 +887,16 @@ namespace GLVM::core
 							   std::vector<VkSemaphore>& renderFinishedSemaphores,
 							   std::vector<VkFence>& inFlightFences);
 		void updateDirectionalLightSpaceMatrixShadowMapUBO(ecs::components::directionalLight* directionalLightComponent, uint32_t currentLight);
-		void updateDirectionalLightShadowMapMatrixUBO(uint32_t currentImage, ecs::components::transform* _transformComponent, uint32_t currentLight, u32 meshID);
+		UniformAllocation updateDirectionalLightShadowMapMatrixUBO(uint32_t currentLight);
 		void updateSpotLightSpaceMatrixShadowMapUBO(ecs::components::spotLight* spotLightComponent,
 																		 uint32_t currentLight);
-		void updateSpotLightShadowMapMatrixUBO(uint32_t currentImage, ecs::components::transform* _transformComponent, uint32_t currentLight, u32 meshID);
-		void updatePointLightShadowMapMatrixUBO(uint32_t currentImage, ecs::components::transform* _transformComponent, ecs::components::pointLight* pointLightComponent, uint32_t layer, unsigned int meshID);
+		UniformAllocation updateSpotLightShadowMapMatrixUBO(uint32_t currentLight);
+		UniformAllocation updatePointLightShadowMapMatrixUBO(ecs::components::pointLight* pointLightComponent, uint32_t layer, mat4& lightSpaceMatrix);
 		void updatePointLightShadowMapDataUBO(uint32_t currentImage, ecs::components::pointLight* pointLightComponent, float farPlane);
-        void updateMatrixUniformBuffer(uint32_t currentImage, uint32_t offset, ecs::components::transform* _transformComponent,
-									   unsigned int meshID, ecs::components::material* materialComponent);
-		void updateViewPositionUniformBuffer(uint32_t currentImage, ecs::components::transform* transformComponent);
-		void updateDirSpaceMatrix(uint32_t currentImage);
+		void updateModelMatricesCache();    ///< Copy world matrices only for chunks changed by transform system, before all passes.
+		void buildInstanceGroups();    ///< Sort actors by mesh and material and fill instances of all passes, before all passes.
+        UniformAllocation updateViewMatrixUniformBuffer();
+		UniformAllocation updateViewPositionUniformBuffer(const ecs::components::transform* transformComponent);
         void mainRenderDrawFrame();
 		void directionalLightShadowMapDrawFrame();
 		void spotLightShadowMapDrawFrame();
@@ -727,8 +916,7 @@ namespace GLVM::core
         bool checkValidationLayerSupport();
         static std::vector<char> readFile(const std::string& filename);
         static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity, VkDebugUtilsMessageTypeFlagsEXT messageType, const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData, void* pUserData);
-		[[nodiscard]] mat4* updateAnimationFrames(ecs::components::transform* _transformComponent, unsigned int meshID);
-		mat4 computeModelMatrix(ecs::components::transform* _transformComponent);
+		const mat4* getJointPalette(Entity entity) const;    ///< MAX_JOINTS_NUMBER matrices sampled by animation system.
 		void setImageDebugObjectName(VK_Image image);
 		void setDebugObjectNames();
     };
@@ -3,163 +3,288 @@
 // Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
 // License: http://opensource.org/licenses/MIT
 
+#ifndef HASH_MAP
+#define HASH_MAP
+
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <new>
 #include <string>
-#include "Vector.hpp"
-#include <random>
+#include <string_view>
+#include <utility>
 
+/// Pair stored inside hash map. Names kept from old chained node.
 template <typename T>
 struct Node
 {
     std::string key_;
     T value_;
-    Node* next_ = nullptr;
+	std::size_t hash_;
 
-    Node(const char* _key) : key_(_key) {}
+    Node(std::string_view _key, std::size_t _hash) : key_(_key), value_(), hash_(_hash) {}
 };
 
+/*! Open-addressing map with string keys and Robin Hood probing. All pairs live in one flat
+ *  array, entry that is farther from its home slot takes place of closer one, so probe
+ *  sequences stay short and lookup stops early. Lookup takes string_view and dont allocate.
+ *  Table grows twice when load factor exceeds 7/8. References to values become invalid after
+ *  insertion of new key.
+ */
 template <typename S>
 class HashMap
 {
-    unsigned int capacity_ = 10;
+	static constexpr std::size_t minimalCapacity_ = 8;
+
+    std::size_t capacity_ = 0;                                           ///< Always zero or power of two.
+	std::size_t size_ = 0;
+	Node<S>* nodes_ = nullptr;
+	unsigned int* distances_ = nullptr;                                  ///< Probe distance plus one, zero means empty slot.
 
 public:
-    Node<S>** hashMap_ = nullptr;
-    
-    HashMap() {
-		hashMap_ = new Node<S>*[capacity_];
-		
-        for (unsigned int i = 0; i < capacity_; ++i) {
-            hashMap_[i] = nullptr;
-        }
-    }
+	/// Walk occupied slots in table order.
+	class Iterator
+	{
+		const HashMap* map_;
+		std::size_t index_;
+
+		void SeekOccupied() {
+			while ( index_ < map_->capacity_ && map_->distances_[index_] == 0 )
+				++index_;
+		}
+
+	public:
+		Iterator(const HashMap* _map, std::size_t _index) : map_(_map), index_(_index) { SeekOccupied(); }
+
+		Node<S>& operator*() const { return map_->nodes_[index_]; }
+		Node<S>* operator->() const { return &map_->nodes_[index_]; }
+		Iterator& operator++() { ++index_; SeekOccupied(); return *this; }
+		bool operator!=(const Iterator& _iterator) const { return index_ != _iterator.index_; }
+	};
+
+    HashMap() = default;
 
 	HashMap(const HashMap<S>& _map) {
-		capacity_ = _map.capacity_;
-		hashMap_ = new Node<S>*[capacity_];
-
-		for (unsigned int i = 0; i < capacity_; ++i) {
-            hashMap_[i] = nullptr;
-        }
-		
-		for (unsigned int i = 0; i < capacity_; ++i) {
-			Node<S>* currentNode = _map.hashMap_[i];
-			
-			while (currentNode != nullptr) {
-				unsigned int hash = HashFunction(currentNode->key_.c_str());
-				Link(hashMap_[hash], currentNode->key_.c_str()) = currentNode->value_;
-
-				currentNode = currentNode->next_;
-			}
+		if ( _map.capacity_ == 0 )
+			return;
+
+		Allocate(_map.capacity_);
+		for ( std::size_t i = 0; i < capacity_; ++i ) {
+			distances_[i] = _map.distances_[i];
+			if ( distances_[i] != 0 )
+				new (&nodes_[i]) Node<S>(_map.nodes_[i]);
 		}
+		size_ = _map.size_;
 	}
 
-	void operator=(const HashMap<S>& _map) {
-		capacity_ = _map.capacity_;
-		hashMap_ = new Node<S>*[capacity_];
-
-		for (int i = 0; i < capacity_; ++i) {
-            hashMap_[i] = nullptr;
-        }
-		
-		for (int i = 0; i < capacity_; ++i) {
-			Node<S>* currentNode = _map.hashMap_[i];
-			while (currentNode != nullptr) {
-				unsigned int hash = HashFunction(currentNode->key_.c_str());
-				Link(hashMap_[hash], currentNode->key_.c_str()) = currentNode->value_;
-
-				currentNode = currentNode->next_;
-			}
+	HashMap(HashMap<S>&& _map) noexcept :
+		capacity_(_map.capacity_), size_(_map.size_), nodes_(_map.nodes_), distances_(_map.distances_) {
+		_map.capacity_  = 0;
+		_map.size_      = 0;
+		_map.nodes_     = nullptr;
+		_map.distances_ = nullptr;
+	}
+
+	/// Copy and swap, so self-assignment and exception in copy leave map unchanged.
+	HashMap<S>& operator=(const HashMap<S>& _map) {
+		if ( this != &_map ) {
+			HashMap<S> copy(_map);
+			Swap(copy);
 		}
+
+		return *this;
 	}
-	
-    S& operator[](const char* _key) {
-        unsigned int hash = HashFunction(_key);
 
-        if (hash >= capacity_)
-            Rehash(hash);
+	HashMap<S>& operator=(HashMap<S>&& _map) noexcept {
+		if ( this != &_map ) {
+			HashMap<S> moved(std::move(_map));
+			Swap(moved);
+		}
+
+		return *this;
+	}
 
-        return Link(hashMap_[hash], _key);
+    ~HashMap() {
+		Release();
     }
 
-    bool Contain(const char* _key) {
-        unsigned int hash = HashFunction(_key);
-        Node<S>* node = hashMap_[hash];
+	/// Return value for key, value-initialized pair inserted if key is absent.
+    S& operator[](std::string_view _key) {
+		std::size_t hash = HashFunction(_key);
+		std::size_t index = FindIndex(_key, hash);
+		if ( index != capacity_ )
+			return nodes_[index].value_;
 
-        while(node != nullptr) {
-            if (node->key_ == _key)
-                return true;
-            else
-                node = node->next_;
-        }
+		if ( (size_ + 1) * 8 > capacity_ * 7 )
+			Rehash(capacity_ == 0 ? minimalCapacity_ : capacity_ * 2);
 
-        return false;
+		return nodes_[Insert(Node<S>(_key, hash))].value_;
     }
 
-    ~HashMap() {
-        for (unsigned int i = 0; i < capacity_; ++i) {
-            Node<S>* node = hashMap_[i];
-            while(node != nullptr) {
-                Node<S>* nodeTemp = node;
-                node = node->next_;
-                delete nodeTemp;
-            }
-        }
-        delete [] hashMap_;
-		hashMap_ = nullptr;
+	/// Return pointer to value or nullptr if key is absent.
+	S* Find(std::string_view _key) {
+		std::size_t index = FindIndex(_key, HashFunction(_key));
+		return index != capacity_ ? &nodes_[index].value_ : nullptr;
+	}
+
+	const S* Find(std::string_view _key) const {
+		std::size_t index = FindIndex(_key, HashFunction(_key));
+		return index != capacity_ ? &nodes_[index].value_ : nullptr;
+	}
+
+    bool Contain(std::string_view _key) const {
+		return FindIndex(_key, HashFunction(_key)) != capacity_;
     }
 
-	bool SearchKey(const char* key_) {
-		for ( int i = 0; i < capacity_; ++i ) {
-			if ( hashMap_[i] != nullptr && hashMap_[i]->key_ == key_ ) {
-				std::cout << "key: " << key_ << std::endl;
-				return true;
-			}
+	/// Remove key with backward shift, so no tombstones left in table. Return false if key is absent.
+	bool Erase(std::string_view _key) {
+		std::size_t index = FindIndex(_key, HashFunction(_key));
+		if ( index == capacity_ )
+			return false;
+
+		nodes_[index].~Node<S>();
+		distances_[index] = 0;
+		std::size_t mask = capacity_ - 1;
+		std::size_t next = (index + 1) & mask;
+		while ( distances_[next] > 1 ) {
+			new (&nodes_[index]) Node<S>(std::move(nodes_[next]));
+			nodes_[next].~Node<S>();
+			distances_[index] = distances_[next] - 1;
+			distances_[next] = 0;
+			index = next;
+			next = (next + 1) & mask;
+		}
+
+		--size_;
+		return true;
+	}
+
+	void Reserve(std::size_t _size) {
+		std::size_t capacity = minimalCapacity_;
+		while ( _size * 8 > capacity * 7 )
+			capacity *= 2;
+
+		if ( capacity > capacity_ )
+			Rehash(capacity);
+	}
+
+	bool SearchKey(const char* key_) const {
+		if ( Contain(key_) ) {
+			std::cout << "key: " << key_ << std::endl;
+			return true;
 		}
 
 		return false;
 	}
 
-	unsigned int GetCapacity() { return capacity_; }
-	
+	std::size_t GetSize() const { return size_; }
+	std::size_t GetCapacity() const { return capacity_; }
+
+	Iterator begin() const { return Iterator(this, 0); }
+	Iterator end() const { return Iterator(this, capacity_); }
+
+	void Swap(HashMap<S>& _map) noexcept {
+		std::swap(capacity_, _map.capacity_);
+		std::swap(size_, _map.size_);
+		std::swap(nodes_, _map.nodes_);
+		std::swap(distances_, _map.distances_);
+	}
+
 private:
-    S& Link(Node<S>*& _node, const char* _key) {
-        if (_node == nullptr) {
-            _node = new Node<S>(_key);
-            return _node->value_;
-        } else {
-            if (_node->key_ == _key) {
-                return _node->value_;
-            }
-            
-            return Link(_node->next_, _key);
-        }
-    }
-    
-    unsigned int HashFunction(const char* _key) {
-        unsigned int sum = 0;
-        unsigned int counter   = 0;
-        while (_key[counter] != '\0') {
-            sum += _key[counter];
-            ++counter;
-        }
-
-        unsigned int reminder = sum % capacity_;
-        return reminder;
-    }
+	/// FNV-1a, cheap for short keys of json objects.
+	static std::size_t HashFunction(std::string_view _key) {
+		std::uint64_t hash = 14695981039346656037ull;
+		for ( char symbol : _key ) {
+			hash ^= static_cast<unsigned char>(symbol);
+			hash *= 1099511628211ull;
+		}
+
+		return static_cast<std::size_t>(hash);
+	}
+
+	/// Return index of key or capacity_ if key is absent.
+	std::size_t FindIndex(std::string_view _key, std::size_t _hash) const {
+		if ( capacity_ == 0 )
+			return capacity_;
+
+		std::size_t mask = capacity_ - 1;
+		std::size_t index = _hash & mask;
+		for ( unsigned int distance = 1; ; ++distance ) {
+			if ( distances_[index] < distance )
+				return capacity_;                                    ///< Empty slot or richer entry, key would be placed before it.
+
+			if ( nodes_[index].hash_ == _hash && nodes_[index].key_ == _key )
+				return index;
 
-    void Rehash(unsigned int _hash) {
-        unsigned int reminder = _hash % 10;
-        capacity_ = _hash + (10 - reminder);
-        
-        Node<S>** temp = new Node<S>*[capacity_];
+			index = (index + 1) & mask;
+		}
+	}
 
-        for (unsigned int i = 0; i < capacity_; ++i)
-            temp[i] = hashMap_[i];
+	/// Place absent key into table with free slot. Return final index of inserted pair.
+	std::size_t Insert(Node<S>&& _node) {
+		std::size_t mask = capacity_ - 1;
+		std::size_t index = _node.hash_ & mask;
+		std::size_t insertedIndex = capacity_;
+		unsigned int distance = 1;
+		Node<S> carried(std::move(_node));
+		while ( true ) {
+			if ( distances_[index] == 0 ) {
+				new (&nodes_[index]) Node<S>(std::move(carried));
+				distances_[index] = distance;
+				++size_;
+				return insertedIndex == capacity_ ? index : insertedIndex;
+			}
 
-        delete [] hashMap_;
-        hashMap_ = nullptr;
-        hashMap_ = temp;
+			if ( distances_[index] < distance ) {
+				std::swap(carried, nodes_[index]);
+				std::swap(distance, distances_[index]);
+				if ( insertedIndex == capacity_ )
+					insertedIndex = index;
+			}
+
+			index = (index + 1) & mask;
+			++distance;
+		}
+	}
+
+	void Allocate(std::size_t _capacity) {
+		capacity_ = _capacity;
+		nodes_ = static_cast<Node<S>*>(::operator new(capacity_ * sizeof(Node<S>), std::align_val_t(alignof(Node<S>))));
+		distances_ = new unsigned int[capacity_]();
+	}
+
+	void Release() {
+		for ( std::size_t i = 0; i < capacity_; ++i ) {
+			if ( distances_[i] != 0 )
+				nodes_[i].~Node<S>();
+		}
+
+		if ( nodes_ != nullptr )
+			::operator delete(nodes_, std::align_val_t(alignof(Node<S>)));
+		delete [] distances_;
+		nodes_ = nullptr;
+		distances_ = nullptr;
+		capacity_ = 0;
+		size_ = 0;
+	}
+
+    void Rehash(std::size_t _capacity) {
+		Node<S>* oldNodes = nodes_;
+		unsigned int* oldDistances = distances_;
+		std::size_t oldCapacity = capacity_;
+
+		Allocate(_capacity);
+		size_ = 0;
+		for ( std::size_t i = 0; i < oldCapacity; ++i ) {
+			if ( oldDistances[i] != 0 ) {
+				Insert(std::move(oldNodes[i]));
+				oldNodes[i].~Node<S>();
+			}
+		}
+
+		if ( oldNodes != nullptr )
+			::operator delete(oldNodes, std::align_val_t(alignof(Node<S>)));
+		delete [] oldDistances;
     }
 };
 
@@ -174,3 +299,5 @@ private:
 //     Variant() {}
 //     ~Variant() {}
 // };
+
+#endif
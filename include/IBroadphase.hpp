@@ -0,0 +1,103 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#ifndef IBROADPHASE
+#define IBROADPHASE
+
+#include "Archetype.hpp"
+#include "Vector.hpp"
+#include "VertexMath.hpp"
+#include <cmath>
+
+namespace GLVM::ecs
+{
+	/// Axis-aligned box of one collider for broadphase.
+	struct BroadphaseBox
+	{
+		vec3 min;
+		vec3 max;
+	};
+
+	/// Two boxes that may overlap, first always less than second.
+	struct BroadphasePair
+	{
+		unsigned int first;
+		unsigned int second;
+	};
+
+	enum EBroadphaseType
+	{
+		eSPATIAL_HASH_BROADPHASE,
+		eAABB_TREE_BROADPHASE,
+		eSWEEP_AND_PRUNE_BROADPHASE
+	};
+
+	/// Boxes that touch by face overlap too.
+	inline bool BoxOverlap(const BroadphaseBox& first, const BroadphaseBox& second) {
+		return first.min[0] <= second.max[0] && first.max[0] >= second.min[0] &&
+			first.min[1] <= second.max[1] && first.max[1] >= second.min[1] &&
+			first.min[2] <= second.max[2] && first.max[2] >= second.min[2];
+	}
+
+	/// Slab test of segment origin + ray * t, t in [0, 1], inverseRay is 1 / ray per axis.
+	inline bool RayOverlap(const BroadphaseBox& box, const vec3& origin, const vec3& inverseRay) {
+		float min = 0.0f;
+		float max = 1.0f;
+		for ( int i = 0; i < 3; ++i ) {
+			if ( std::isinf(inverseRay[i]) ) {                               ///< Ray parallel to slab, 0 * inf would give NaN.
+				if ( origin[i] < box.min[i] || origin[i] > box.max[i] )
+					return false;
+
+				continue;
+			}
+
+			float delta1 = (box.min[i] - origin[i]) * inverseRay[i];
+			float delta2 = (box.max[i] - origin[i]) * inverseRay[i];
+			min = Max(min, Min(delta1, delta2));
+			max = Min(max, Max(delta1, delta2));
+			if ( max < min )
+				return false;
+		}
+
+		return true;
+	}
+
+	/// Box is outside if it lies fully behind any plane, plane is (normal, distance) and inside is dot(normal, point) + distance >= 0.
+	inline bool FrustumOverlap(const BroadphaseBox& box, const vec4* planes, unsigned int planesNumber) {
+		for ( unsigned int i = 0; i < planesNumber; ++i ) {
+			const vec4& plane = planes[i];
+			float distance = plane[3];
+			for ( int j = 0; j < 3; ++j )
+				distance += plane[j] * (plane[j] >= 0.0f ? box.max[j] : box.min[j]);   ///< Corner farthest along normal.
+
+			if ( distance < 0.0f )
+				return false;
+		}
+
+		return true;
+	}
+
+	/*! Broadphase of collision system. Every update starts with BeginUpdate, then box of every
+	 *  collider passed with its entity, EndUpdate drops colliders that were not passed. Persistent
+	 *  implementations keep their structure between updates and only patch it, others rebuild.
+	 *  Pairs and ray results hold entity handles and may contain boxes that dont overlap exactly,
+	 *  caller does narrowphase.
+	 */
+	class IBroadphase
+	{
+	public:
+		virtual ~IBroadphase() {}
+
+		virtual void BeginUpdate() = 0;
+		/// displacement is predicted movement of box during frame, may be used to enlarge it.
+		virtual void UpdateProxy(Entity entity, const BroadphaseBox& box, const vec3& displacement) = 0;
+		virtual void EndUpdate() = 0;
+		virtual void CollectPairs(core::vector<BroadphasePair>& pairs) const = 0;
+		/// Append entities whose box may be crossed by segment from origin to origin + ray.
+		virtual void QueryRay(const vec3& origin, const vec3& ray, core::vector<Entity>& entities) const = 0;
+	};
+}
+
+#endif
@@ -21,7 +21,8 @@ namespace GLVM::core
 
         virtual void draw() = 0;
         virtual void loadWavefrontObj() = 0;
-		virtual void EnlargeFrameAccumulator(float value) = 0;
+		/// Fraction of fixed step between previous and current simulation state to draw.
+		virtual void SetInterpolationAlpha(float alpha) = 0;
         virtual void SetTextureData(std::vector<ecs::Texture>& _texture_data) = 0;
         virtual void SetMeshData(std::vector<const char*> _pathsArray, core::vector<const char*> pathsGLTF_) = 0;
         virtual void SetViewMatrix(mat4 _viewMatrix) = 0;
@@ -7,15 +7,46 @@
 #define ISYSTEM
 
 #include "ComponentManager.hpp"
+#include "EntityCommandBuffer.hpp"
 #include "Event.hpp"
 
 namespace GLVM::ecs
 {
+	/*! Every system declares component types it reads and writes, so CSystemManager can run
+	 *  systems without conflicting access at the same time. Creation and removal of components
+	 *  and entities must be recorded into commandBuffer, CSystemManager applies it after stage
+	 *  of system is finished. System that touches shared state outside of components must declare
+	 *  exclusive execution.
+	 */
 	class ISystem
 	{
 	public:
+		Signature readComponents;
+		Signature writeComponents;
+		bool      exclusiveExecution = false;
+		EntityCommandBuffer commandBuffer;    ///< Deferred structural changes of this system.
+
 		virtual ~ISystem() {}
 		virtual void Update() = 0;
+
+		template <typename... componentTypes>
+		void DeclareRead() {
+			readComponents |= ComponentManager::GetInstance()->MakeSignature<componentTypes...>();
+		}
+
+		template <typename... componentTypes>
+		void DeclareWrite() {
+			writeComponents |= ComponentManager::GetInstance()->MakeSignature<componentTypes...>();
+		}
+
+		void DeclareExclusiveExecution() { exclusiveExecution = true; }
+
+		/// Two systems conflict if one of them writes component type that other one reads or writes.
+		bool ConflictsWith(const ISystem& system) const {
+			return exclusiveExecution || system.exclusiveExecution ||
+				(writeComponents & (system.readComponents | system.writeComponents)).any() ||
+				(system.writeComponents & readComponents).any();
+		}
 	};
 }
 
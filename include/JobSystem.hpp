@@ -0,0 +1,111 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#ifndef JOB_SYSTEM
+#define JOB_SYSTEM
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace GLVM::core
+{
+	/// Unit of work for job system. Job queued only after all its dependencies are finished.
+	struct Job
+	{
+		std::function<void()> function;
+		std::atomic<unsigned int> pendingDependencies{1};                ///< One extra count hold by Schedule until job fully registered.
+		std::atomic<bool> finished{false};
+		std::mutex dependentsMutex;                                      ///< Guard dependents and switch of finished flag.
+		std::vector<std::shared_ptr<Job>> dependents;                    ///< Jobs waiting for this one.
+	};
+
+	typedef std::shared_ptr<Job> JobHandle;
+
+	/*! Fixed-size pool of worker threads. Every worker has own deque of jobs: owner takes jobs
+	 *  from back, idle workers steal from front of other deques. Thread that waits for job dont
+	 *  sleep, it runs pending jobs itself, so waiting inside of job is allowed.
+	 */
+	class CJobSystem
+	{
+		/// Deque of one worker. Index workersNumber is shared queue for threads outside of pool.
+		struct WorkerQueue
+		{
+			std::mutex mutex;
+			std::deque<JobHandle> jobs;
+		};
+
+		static CJobSystem* pInstance_;
+		static std::mutex Mutex_;
+		inline static thread_local int workerIndex = -1;                 ///< Index of worker queue for current thread, -1 outside of pool.
+
+		unsigned int workersNumber = 0;                                  ///< Set before start of workers, so they can read it without lock.
+		std::vector<std::thread> workers;
+		std::vector<std::unique_ptr<WorkerQueue>> queues;
+		std::atomic<bool> stopping{false};
+		std::atomic<unsigned int> queuedJobsNumber{0};
+		std::mutex wakeMutex;
+		std::condition_variable wakeCondition;
+
+		CJobSystem();
+		~CJobSystem();
+
+		void WorkerLoop(int index);
+		void Enqueue(const JobHandle& job);
+		JobHandle PopJob();                                              ///< Take job from own deque or steal from other one.
+		void Execute(const JobHandle& job);
+
+	public:
+		CJobSystem(CJobSystem& jobSystem) = delete;                      ///< Dont need to make cope because of singleton property.
+		void operator=(const CJobSystem& jobSystem) = delete;            ///< Dont need assignment operator because of singleton property.
+		static CJobSystem* GetInstance();                                ///< It possibly to get only one instance of this class whith this method.
+
+		unsigned int GetWorkersNumber() const { return workersNumber; }
+
+		/// Queue function to run after all dependencies are finished. Return handle for waiting and chaining.
+		JobHandle Schedule(std::function<void()> function, const std::vector<JobHandle>& dependencies = {});
+
+		/// Block until job is finished. Calling thread runs pending jobs while waiting.
+		void Wait(const JobHandle& job);
+
+		/// Run one pending job on calling thread. Return false if there was nothing to run.
+		bool RunPendingJob();
+
+		/*! Split range [0, count) into pieces of grain elements and call function(begin, end) for
+		 *  every piece in parallel. Calling thread takes first piece and return when all pieces done.
+		 *  Pieces must not touch the same data.
+		 */
+		template <typename Function>
+		void ParallelFor(unsigned int count, unsigned int grain, Function function) {
+			if ( grain == 0 )
+				grain = 1;
+
+			if ( count <= grain || workersNumber == 0 ) {
+				if ( count > 0 )
+					function(0u, count);
+
+				return;
+			}
+
+			std::vector<JobHandle> pieces;
+			pieces.reserve((count - 1) / grain);
+			for ( unsigned int begin = grain; begin < count; begin += grain ) {
+				unsigned int end = begin + grain < count ? begin + grain : count;
+				pieces.push_back(Schedule([&function, begin, end]() { function(begin, end); }));
+			}
+
+			function(0u, grain);
+			for ( unsigned int i = 0; i < pieces.size(); ++i )
+				Wait(pieces[i]);
+		}
+	};
+}
+
+#endif
@@ -16,10 +16,13 @@
 #include <chrono>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <vector>
 #include <string.h>
 #include "stack.hpp"
 #include "typenames.hpp"
+#include "SkeletalAnimation.hpp"
 
 namespace GLVM::Core
 {
@@ -46,7 +49,7 @@ namespace GLVM::Core
         void* null;
         GLVM::core::vector<JsonValue>* array;
         HashMap<JsonValue>* object;
-        JsonVariant() {}
+        JsonVariant() : null(nullptr) {}
 		JsonVariant(const JsonVariant& object) {
 			memcpy(this, &object, sizeof(JsonVariant));
 		}
@@ -112,6 +115,11 @@ namespace GLVM::Core
 			type = _value.type;
 		}
 
+		/// Take ownership of value, source left invalid. Used when tables and arrays reallocate.
+		JsonValue(JsonValue&& _value) noexcept : value(_value.value), type(_value.type) {
+			_value.type = JSON_INVALID_VALUE;
+		}
+
 		~JsonValue() {
 			switch (type) {
 			case JSON_INVALID_VALUE:
@@ -187,11 +195,21 @@ namespace GLVM::Core
 			type = _value.type;
 		}
 
-		JsonValue& operator[](std::string key_) {
-			const char* key = key_.c_str();
+		/// Swap with source, so old value destroyed together with source.
+		JsonValue& operator=(JsonValue&& _value) noexcept {
+			JsonVariant tempValue(value);
+			JsonType tempType = type;
+			memcpy(static_cast<void*>(&value), &_value.value, sizeof(JsonVariant));
+			type = _value.type;
+			memcpy(static_cast<void*>(&_value.value), &tempValue, sizeof(JsonVariant));
+			_value.type = tempType;
+			return *this;
+		}
+
+		JsonValue& operator[](std::string_view key_) {
 			switch (type) {
 			case JSON_OBJECT:
-				return (*value.object)[key];
+				return (*value.object)[key_];
 				break;
 			default:
 				throw std::out_of_range("Type is not a json object");
@@ -256,13 +274,9 @@ namespace GLVM::Core
 		void LoadGLTF(const char* pathsGLTF_,
 					  std::vector<float>& aVertexes_,
 					  std::vector<uint32_t>& aIndices_,
-					  core::vector<core::vector<mat4>>& jointMatricesPerMesh,
-					  core::vector<float>& frames,
+					  core::CSkeletalAnimation& animation,
 					  bool& noAnimations);
-		void traversalBones(core::vector<core::vector<int>> children, Core::JsonValue joints,
-							core::stack<u32> node_stack, core::stack<u32> deepness_stack, core::vector<core::vector<u32>>& result);
-		core::vector<core::vector<unsigned int>> makeRenderJointsIndices(core::vector<core::vector<unsigned int>>& input);
-		bool containsElemnt(core::vector<core::vector<unsigned int>> container, unsigned int element);
+		core::vector<float> readAccessorFloats(const char* buffer, unsigned int accessorIndex);
 		unsigned int getJointIndex(Core::JsonValue joints, int searchingIndex);
     };
 }
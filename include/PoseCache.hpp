@@ -0,0 +1,62 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#ifndef POSE_CACHE
+#define POSE_CACHE
+
+#include "Vector.hpp"
+#include "VertexMath.hpp"
+#include <cstdint>
+
+namespace GLVM::core
+{
+	enum EPoseCacheResult
+	{
+		ePOSE_CACHE_HIT,                                                 ///< Palette of slot already holds pose.
+		ePOSE_CACHE_INSERTED,                                            ///< Free slot taken, pose must be evaluated into it.
+		ePOSE_CACHE_EVICTED,                                             ///< Least recently used slot taken, pose must be evaluated into it.
+		ePOSE_CACHE_FULL                                                 ///< All slots used in current frame, nothing taken.
+	};
+
+	/*! Fixed number of joint palettes addressed by 64 bit key, with least recently used slot
+	 *  evicted when key is not found. Open addressing hash table with linear probing, so lookup
+	 *  dont allocate. Slot touched in current frame is never evicted, so palette stays valid
+	 *  for everyone who got it until next frame.
+	 */
+	class CPoseCache
+	{
+		unsigned int capacity;
+		unsigned int paletteSize;
+		unsigned int usedSlots = 0;
+		core::vector<std::uint64_t> keys;
+		core::vector<unsigned int> slotFrames;                           ///< Frame of last touch.
+		core::vector<int> previousSlots;                                 ///< Usage list, head is least recently used.
+		core::vector<int> nextSlots;
+		core::vector<int> buckets;                                       ///< Slot or -1, power of two size.
+		core::vector<mat4> palettes;                                     ///< paletteSize matrices per slot.
+		int head = -1;
+		int tail = -1;
+
+		static unsigned int HashKey(std::uint64_t key);
+		unsigned int FindBucket(std::uint64_t key) const;                ///< Bucket of key or first empty bucket after it.
+		void RemoveKey(std::uint64_t key);
+		void Unlink(unsigned int slot);
+
+	public:
+		CPoseCache(unsigned int capacity_, unsigned int paletteSize_);
+
+		/// Find slot of key, take free or least recently used one if key is not cached.
+		EPoseCacheResult Acquire(std::uint64_t key, unsigned int frame, unsigned int& slot);
+		void Touch(unsigned int slot, unsigned int frame);               ///< Move slot to the end of usage list.
+		void Clear();
+
+		mat4* GetPalette(unsigned int slot) { return &palettes[slot * paletteSize]; }
+		const mat4* GetPalette(unsigned int slot) const { return &palettes[slot * paletteSize]; }
+		unsigned int GetCapacity() const { return capacity; }
+		unsigned int GetUsedSlotsNumber() const { return usedSlots; }
+	};
+}
+
+#endif
@@ -0,0 +1,206 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#ifndef QUERY
+#define QUERY
+
+#include "Archetype.hpp"
+#include "Vector.hpp"
+#include <array>
+#include <atomic>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace GLVM::ecs
+{
+	/*! Filters for queries and chunk walks. Changed<T> pass only chunks where column T was written
+	 *  at version sinceVersion or later, Added<T> pass only chunks where T was added at that version
+	 *  or later. Filtered column is given as const, so reading it dont mark it changed.
+	 */
+	template <typename componentType> struct Changed {};
+	template <typename componentType> struct Added {};
+
+	/*! Describe how query argument access its column. Non-const component is written, so every
+	 *  visited chunk marked changed. Const component and filters only read column.
+	 */
+	template <typename argumentType>
+	struct ComponentAccess
+	{
+		typedef std::remove_const_t<argumentType> component;
+		typedef argumentType columnType;
+		static constexpr bool write = !std::is_const_v<argumentType>;
+
+		static bool Accept(const Archetype*, unsigned int, unsigned int, unsigned int) { return true; }
+	};
+
+	template <typename componentType>
+	struct ComponentAccess<Changed<componentType>>
+	{
+		typedef std::remove_const_t<componentType> component;
+		typedef const component columnType;
+		static constexpr bool write = false;
+
+		static bool Accept(const Archetype* archetype, unsigned int componentTypeID, unsigned int chunkIndex, unsigned int sinceVersion) {
+			return archetype->GetChangedVersion(componentTypeID, chunkIndex) >= sinceVersion;
+		}
+	};
+
+	template <typename componentType>
+	struct ComponentAccess<Added<componentType>>
+	{
+		typedef std::remove_const_t<componentType> component;
+		typedef const component columnType;
+		static constexpr bool write = false;
+
+		static bool Accept(const Archetype* archetype, unsigned int componentTypeID, unsigned int chunkIndex, unsigned int sinceVersion) {
+			return archetype->GetAddedVersion(componentTypeID, chunkIndex) >= sinceVersion;
+		}
+	};
+
+	/*! Persistent list of archetype tables that contain all required components. ComponentManager
+	 *  matches every new table against registered queries, so query never searches tables again.
+	 */
+	class QueryBase
+	{
+	public:
+		Signature required;
+		core::vector<Archetype*> matchedArchetypes;
+
+		explicit QueryBase(const Signature& required_) : required(required_) {}
+		virtual ~QueryBase() {}
+
+		void TryMatch(Archetype* archetype) {
+			if ( (archetype->signature & required) == required )
+				matchedArchetypes.Push(archetype);
+		}
+
+		/// Number of entities that match query.
+		unsigned int GetSize() {
+			unsigned int size = 0;
+			for ( unsigned int i = 0; i < matchedArchetypes.GetSize(); ++i )
+				size += matchedArchetypes[i]->entitiesNumber;
+
+			return size;
+		}
+	};
+
+	/*! Range over all entities with listed components. Iteration walks chunks of matched tables
+	 *  and dont allocate anything:
+	 *
+	 *  for ( auto [entity, transform, mesh] : componentManager->GetQuery<cm::transform, const cm::mesh>() )
+	 *
+	 *  Use const component if system only read it, so other systems can skip unchanged chunks.
+	 *  Filtered iteration: GetQuery<Changed<cm::transform>, cm::mesh>().Since(lastVersion).
+	 *  Dont create or remove components while iterating, it moves rows between tables.
+	 */
+	template <typename... componentTypes>
+	class Query : public QueryBase
+	{
+		std::array<unsigned int, sizeof...(componentTypes)> componentTypeIDs;
+		const std::atomic<unsigned int>* changeVersion;                  ///< Current write version of component manager.
+
+	public:
+		Query(const Signature& required_, const std::array<unsigned int, sizeof...(componentTypes)>& componentTypeIDs_,
+			  const std::atomic<unsigned int>* changeVersion_) :
+			QueryBase(required_), componentTypeIDs(componentTypeIDs_), changeVersion(changeVersion_) {}
+
+		class Iterator
+		{
+			Query*       query;
+			unsigned int archetypeIndex;
+			unsigned int sinceVersion;
+			unsigned int chunkIndex = 0;
+			unsigned int row = 0;
+			Entity*      entities = nullptr;
+			std::tuple<typename ComponentAccess<componentTypes>::columnType*...> columns;
+
+			template <std::size_t... indices>
+			bool AcceptChunk(Archetype* archetype, std::index_sequence<indices...>) const {
+				return (ComponentAccess<componentTypes>::Accept(archetype, query->componentTypeIDs[indices], chunkIndex, sinceVersion) && ...);
+			}
+
+			/// Written columns marked once per chunk, before any row of chunk is given out.
+			template <std::size_t... indices>
+			void LoadColumns(Archetype* archetype, std::index_sequence<indices...>) {
+				unsigned int version = query->changeVersion->load(std::memory_order_relaxed);
+				((ComponentAccess<componentTypes>::write ?
+				  archetype->MarkChanged(query->componentTypeIDs[indices], chunkIndex, version) : void()), ...);
+				((std::get<indices>(columns) =
+				  archetype->GetColumn<typename ComponentAccess<componentTypes>::columnType>(query->componentTypeIDs[indices], chunkIndex)), ...);
+			}
+
+			template <std::size_t... indices>
+			std::tuple<Entity, typename ComponentAccess<componentTypes>::columnType&...> MakeRow(std::index_sequence<indices...>) const {
+				return std::tuple<Entity, typename ComponentAccess<componentTypes>::columnType&...>(entities[row], std::get<indices>(columns)[row]...);
+			}
+
+			/// Rows are packed inside table, so first empty chunk means end of table.
+			void SeekFilledChunk() {
+				while ( archetypeIndex < query->matchedArchetypes.GetSize() ) {
+					Archetype* archetype = query->matchedArchetypes[archetypeIndex];
+					if ( chunkIndex < archetype->chunks.GetSize() && archetype->chunks[chunkIndex].count > 0 ) {
+						if ( AcceptChunk(archetype, std::index_sequence_for<componentTypes...>{}) ) {
+							entities = archetype->GetEntities(chunkIndex);
+							LoadColumns(archetype, std::index_sequence_for<componentTypes...>{});
+							return;
+						}
+
+						++chunkIndex;
+						continue;
+					}
+
+					++archetypeIndex;
+					chunkIndex = 0;
+				}
+			}
+
+		public:
+			Iterator(Query* query_, unsigned int archetypeIndex_, unsigned int sinceVersion_ = 0) :
+				query(query_), archetypeIndex(archetypeIndex_), sinceVersion(sinceVersion_) {
+				SeekFilledChunk();
+			}
+
+			std::tuple<Entity, typename ComponentAccess<componentTypes>::columnType&...> operator*() const {
+				return MakeRow(std::index_sequence_for<componentTypes...>{});
+			}
+
+			Iterator& operator++() {
+				++row;
+				if ( row == query->matchedArchetypes[archetypeIndex]->chunks[chunkIndex].count ) {
+					row = 0;
+					++chunkIndex;
+					SeekFilledChunk();
+				}
+
+				return *this;
+			}
+
+			bool operator!=(const Iterator& iterator) const {
+				return archetypeIndex != iterator.archetypeIndex || chunkIndex != iterator.chunkIndex || row != iterator.row;
+			}
+		};
+
+		/// Range that skip chunks rejected by Changed and Added filters.
+		class FilteredRange
+		{
+			Query*       query;
+			unsigned int sinceVersion;
+
+		public:
+			FilteredRange(Query* query_, unsigned int sinceVersion_) : query(query_), sinceVersion(sinceVersion_) {}
+
+			Iterator begin() { return Iterator(query, 0, sinceVersion); }
+			Iterator end() { return Iterator(query, query->matchedArchetypes.GetSize(), sinceVersion); }
+		};
+
+		Iterator begin() { return Iterator(this, 0); }
+		Iterator end() { return Iterator(this, matchedArchetypes.GetSize()); }
+
+		FilteredRange Since(unsigned int sinceVersion) { return FilteredRange(this, sinceVersion); }
+	};
+}
+
+#endif
@@ -122,7 +122,7 @@ public:
 	void SetVec4(const std::string &name, int x, int y, int z, int w) const;
 	void SetUniformID(const char* _uniformIdentificator, int _id);
 	void SetMat4(const std::string &name, mat4 &mat) const;
-	void SetMat4(const std::string &name, unsigned int matrixNumber, mat4 &mat) const;
+	void SetMat4(const std::string &name, unsigned int matrixNumber, const mat4 &mat) const;
 //	void SetMat4(const std::string &name, glm::mat4 &mat) const;
 	
 private:
@@ -0,0 +1,117 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#ifndef SKELETAL_ANIMATION
+#define SKELETAL_ANIMATION
+
+#include "Vector.hpp"
+#include "VertexMath.hpp"
+
+namespace GLVM::core
+{
+	enum EInterpolation
+	{
+		eLINEAR,
+		eSTEP,
+		eCUBICSPLINE
+	};
+
+	enum EAnimationPath
+	{
+		eTRANSLATION,
+		eROTATION,
+		eSCALE
+	};
+
+	constexpr unsigned int MAX_CACHED_TIMELINES = 8;                     ///< Timelines searched once per pose, others searched per sampler.
+	constexpr unsigned int MAX_POSE_BATCH = 32;                          ///< Poses evaluated together, their cursors kept on stack.
+	constexpr unsigned int MAX_BAKED_MATRICES = 1 << 16;                 ///< 4 MB per clip, longer clips are sampled.
+	constexpr float BAKED_POSE_TOLERANCE = 1e-3f;                        ///< Largest error of blended baked matrix, relative to element.
+	constexpr unsigned int MAX_BAKED_SUBDIVISIONS = 4;                   ///< Keyframe split in up to 16 baked segments.
+
+	/*! Keyframes of one animated property of one joint as glTF sampler stores them. Rotation
+	 *  values are x, y, z, w. Cubic spline keyframe keeps in-tangent, value and out-tangent.
+	 */
+	struct AnimationSampler
+	{
+		EInterpolation interpolation = eLINEAR;
+		core::vector<float> times;
+		core::vector<float> values;
+		unsigned int timeline = 0;                                       ///< Set by skeleton, samplers with equal times share one.
+	};
+
+	/// Position of time between two keyframes of timeline.
+	struct KeyframeCursor
+	{
+		unsigned int keyframe;
+		unsigned int nextKeyframe;
+		float factor;
+		float keyframeDuration;
+	};
+
+	/*! Skeleton of one mesh with its animation clip. Clip stored as translation, rotation and
+	 *  scale channels of joints, not as baked matrices, so memory grows with number of keyframes
+	 *  of animated properties only. Pose sampled at any time of clip, joints without channel keep
+	 *  their rest transform.
+	 *
+	 *  Joint matrix is inverseBind * local * parentWorld, same row vector convention as
+	 *  rest of engine.
+	 *
+	 *  Clip with only linear or only step channels can be baked: joint matrices evaluated once at
+	 *  every keyframe, pose between two keyframes blended from them. Linear keyframe split in
+	 *  halves while blend in the middle is further than BAKED_POSE_TOLERANCE from sampled pose,
+	 *  clip that needs more than MAX_BAKED_SUBDIVISIONS splits keeps sampling.
+	 */
+	class CSkeletalAnimation
+	{
+		core::vector<int> parents;                                       ///< Parent joint, -1 for root.
+		core::vector<unsigned int> evaluationOrder;                      ///< Parents go before their children.
+		core::vector<mat4> inverseBindMatrices;
+		core::vector<vec3> restTranslations;
+		core::vector<Quaternion> restRotations;
+		core::vector<vec3> restScales;
+		core::vector<int> translationSamplers;                           ///< Sampler of joint, -1 keep rest value.
+		core::vector<int> rotationSamplers;
+		core::vector<int> scaleSamplers;
+		core::vector<AnimationSampler> samplers;
+		core::vector<unsigned int> timelines;                            ///< Sampler that keeps times of timeline, others drop their copy.
+		float duration = 0.0f;
+		core::vector<float> bakedTimes;                                  ///< Keyframes of all timelines, empty if clip not baked.
+		core::vector<mat4> bakedPalettes;                                ///< Joint matrices of every baked keyframe.
+		EInterpolation bakedInterpolation = eLINEAR;
+
+		bool BakeSegment(float fromTime, const mat4* fromPalette, float toTime, const mat4* toPalette, unsigned int depth,
+						 core::vector<float>& times, core::vector<mat4>& palettes) const;
+		void EvaluateBakedPoses(const float* times, mat4* const* palettes, unsigned int count, unsigned int paletteSize) const;
+		static void SampleComponents(const AnimationSampler& sampler, const KeyframeCursor& cursor, unsigned int components, float* result);
+
+	public:
+		unsigned int AddJoint(const mat4& inverseBindMatrix, vec3 restTranslation, Quaternion restRotation, vec3 restScale);
+		void SetParent(unsigned int joint, int parent);
+		void AddChannel(unsigned int joint, EAnimationPath path, AnimationSampler&& sampler);
+		void BuildEvaluationOrder();                                     ///< Call after all parents set.
+		bool Bake();                                                     ///< Call after evaluation order built, false if clip stays sampled.
+
+		unsigned int GetJointsNumber() const { return parents.GetSize(); }
+		float GetDuration() const { return duration; }
+		bool IsAnimated() const { return parents.GetSize() > 0; }
+		bool IsBaked() const { return bakedTimes.GetSize() > 0; }
+
+		/// Write joint matrices for time of clip, rest of palette filled by unit matrices. Dont allocate.
+		void EvaluatePose(float time, mat4* palette, unsigned int paletteSize) const;
+
+		/*! Same as EvaluatePose for count instances of this skeleton. Joints walked in outer loop, so
+		 *  keyframes and rest values of joint are read once for whole batch of instances. Baked clip
+		 *  only copies or blends matrices of keyframes.
+		 */
+		void EvaluatePoses(const float* times, mat4* const* palettes, unsigned int count, unsigned int paletteSize) const;
+
+		static KeyframeCursor FindKeyframe(const core::vector<float>& times, float time);    ///< Time outside of clip clamped.
+		static vec3 SampleVector(const AnimationSampler& sampler, const KeyframeCursor& cursor);
+		static Quaternion SampleRotation(const AnimationSampler& sampler, const KeyframeCursor& cursor);
+	};
+}
+
+#endif
@@ -0,0 +1,66 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#ifndef SPATIAL_HASH_BROADPHASE
+#define SPATIAL_HASH_BROADPHASE
+
+#include "IBroadphase.hpp"
+#include "Vector.hpp"
+#include "VertexMath.hpp"
+#include <cstdint>
+
+namespace GLVM::ecs
+{
+	constexpr float SPATIAL_HASH_OVERSIZED_CELLS = 4.0f;                 ///< Box wider than this number of cells is tested against all boxes instead of inserting into grid.
+
+	/*! Uniform grid stored as spatial hash. Boxes inserted into every cell they cover, cells
+	 *  bucketed by hash with counting sort, so rebuild is O(n) and dont allocate after warm up.
+	 *  Pair found in several shared cells reported only from cell that contains minimum corner of
+	 *  boxes overlap, so every overlapping pair reported exactly once. Pair of boxes that only
+	 *  touch by face may be reported too, narrowphase decide. Grid is rebuilt on every EndUpdate.
+	 */
+	class CSpatialHashBroadphase : public IBroadphase
+	{
+		struct CellEntry
+		{
+			std::int32_t x;
+			std::int32_t y;
+			std::int32_t z;
+			unsigned int box;
+		};
+
+		float cellSize;                                                  ///< Zero means computed from average box size on every build.
+		float currentCellSize = 1.0f;
+		core::vector<BroadphaseBox> boxes;
+		core::vector<Entity> entities;                                   ///< Entity of box with the same index.
+		core::vector<CellEntry> entries;
+		core::vector<CellEntry> sortedEntries;
+		core::vector<unsigned int> bucketStarts;                         ///< Start of every bucket inside sortedEntries, one extra element at the end.
+		core::vector<unsigned int> oversizedBoxes;
+
+		std::int32_t CellCoordinate(float coordinate) const;
+		static unsigned int HashCell(std::int32_t x, std::int32_t y, std::int32_t z);
+		bool IsOwnerCell(const CellEntry& entry, const BroadphaseBox& first, const BroadphaseBox& second) const;
+		void PushPair(core::vector<BroadphasePair>& pairs, unsigned int first, unsigned int second) const;
+		void Build();
+
+	public:
+		explicit CSpatialHashBroadphase(float cellSize_ = 0.0f) : cellSize(cellSize_) {}
+
+		void BeginUpdate() override;
+		void UpdateProxy(Entity entity, const BroadphaseBox& box, const vec3& displacement) override;
+		void EndUpdate() override;
+
+		/// Append every pair of overlapping boxes to pairs.
+		void CollectPairs(core::vector<BroadphasePair>& pairs) const override;
+
+		/// Grid is not walked along ray, every box tested, used rarely for few projectiles.
+		void QueryRay(const vec3& origin, const vec3& ray, core::vector<Entity>& entities) const override;
+
+		float GetCellSize() const { return currentCellSize; }
+	};
+}
+
+#endif
@@ -0,0 +1,69 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#ifndef SWEEP_AND_PRUNE_BROADPHASE
+#define SWEEP_AND_PRUNE_BROADPHASE
+
+#include "IBroadphase.hpp"
+#include "Vector.hpp"
+#include "VertexMath.hpp"
+
+namespace GLVM::ecs
+{
+	/*! Sweep and prune on one axis. Start and end of every box projected on axis are kept in one
+	 *  sorted array between updates. Boxes move little from frame to frame, so array stays nearly
+	 *  sorted and insertion sort fixes it in about O(n). New boxes sorted separately and merged.
+	 *  Sweep along array keeps list of boxes whose interval is open, every opened box tested
+	 *  against them on all axes. Pairs found on EndUpdate and cached until next one.
+	 *
+	 *  Best for actors spread along axis, for example crowd walking on plane. Many boxes with the
+	 *  same projection on axis make active list long, other broadphases fit better there.
+	 */
+	class CSweepAndPruneBroadphase : public IBroadphase
+	{
+		struct Endpoint
+		{
+			float value;
+			unsigned int data;                                           ///< Entity index shifted by one, low bit set for end of box.
+		};
+
+		struct Proxy
+		{
+			BroadphaseBox box;
+			Entity entity = 0;
+			unsigned int frame = 0;                                      ///< Last update that passed box, older proxies removed.
+			unsigned int activeIndex = 0;                                ///< Position inside active list during sweep.
+			bool used = false;
+		};
+
+		int axis;
+		core::vector<Proxy> proxies;                                     ///< Indexed by entity index.
+		core::vector<Endpoint> endpoints;
+		core::vector<Endpoint> insertedEndpoints;                        ///< Endpoints of boxes added since last update.
+		core::vector<unsigned int> activeProxies;
+		core::vector<BroadphasePair> currentPairs;
+		unsigned int frame = 0;
+
+		/// End of box placed after start at the same value, so boxes that touch overlap.
+		static bool Less(const Endpoint& first, const Endpoint& second) {
+			return first.value < second.value || (first.value == second.value && (first.data & 1u) < (second.data & 1u));
+		}
+
+		void RemoveStaleProxies();
+		void SortEndpoints();
+		void Sweep();
+
+	public:
+		explicit CSweepAndPruneBroadphase(int axis_ = 0) : axis(axis_) {}
+
+		void BeginUpdate() override { ++frame; }
+		void UpdateProxy(Entity entity, const BroadphaseBox& box, const vec3& displacement) override;
+		void EndUpdate() override;
+		void CollectPairs(core::vector<BroadphasePair>& pairs) const override;
+		void QueryRay(const vec3& origin, const vec3& ray, core::vector<Entity>& entities) const override;
+	};
+}
+
+#endif
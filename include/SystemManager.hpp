@@ -7,8 +7,10 @@
 #define SYSTEM_MANAGER
 
 #include "ISystem.hpp"
+#include "JobSystem.hpp"
 #include "Vector.hpp"
 #include <mutex>
+#include <vector>
 
 namespace GLVM::ecs
 {
@@ -27,9 +29,17 @@ namespace GLVM::ecs
         
 		inline static unsigned int s_iSystem_ID = 0;
 		core::vector<ISystem*> tSystemContainer;
+		core::vector<unsigned int> systemStages;    ///< Stage of every activated system in current frame.
+		bool serialExecution = false;               ///< Deterministic mode for debugging: run systems of every stage one by one in activation order.
 
 		void ActivateSystem(ISystem* _System);
 
+		/*! Build dependency graph of activated systems: system depends on every earlier activated
+		 *  system it conflicts with. Systems are placed on stage after all their dependencies, so
+		 *  systems of the same stage never conflict. Return number of stages.
+		 */
+		unsigned int BuildSchedule();
+
 		void Update() override;
 	};
 }
@@ -6,166 +6,109 @@
 #ifndef ANIMATION_SYSTEM
 #define ANIMATION_SYSTEM
 
-#include "ComponentManager.hpp"
-#include "Event.hpp"
-#include "Vector.hpp"
-#include "VertexData.hpp"
-#include "Stack.hpp"
 #include "ISystem.hpp"
-#include "GLPointer.h"
+#include "PoseCache.hpp"
+#include "SkeletalAnimation.hpp"
+#include "Vector.hpp"
+#include "VertexMath.hpp"
 #include "Components/AnimationMoveComponent.hpp"
 #include "Components/VertexComponent.hpp"
-#include "ComponentManager.hpp"
-
-#define ANIM_PER_AXIS_NUMBER 4
 
 namespace GLVM::ecs
 {
+	constexpr unsigned int PALETTE_JOINTS_NUMBER = 18;                   ///< Same as MAX_JOINTS_NUMBER of shaders.
+	constexpr unsigned int ANIMATION_BATCHES_GRAIN = 4;                  ///< Batches in one job, less jobs for scheduler to switch.
+	constexpr unsigned int POSE_CACHE_CAPACITY = 512;                    ///< Cached palettes, about 590 KB with 18 joints.
+
+	/// Counters of one update, or sum of all updates since reset.
+	struct AnimationStats
+	{
+		unsigned int animatedEntities = 0;
+		unsigned int decimatedEntities = 0;                              ///< Distant entities that kept pose of earlier frame.
+		unsigned int cacheHits = 0;
+		unsigned int cacheMisses = 0;                                    ///< Include misses that found cache full.
+		unsigned int cacheEvictions = 0;
+		unsigned int evaluatedPoses = 0;
+
+		float GetHitRate() const { return cacheHits + cacheMisses > 0 ? static_cast<float>(cacheHits) / (cacheHits + cacheMisses) : 0.0f; }
+	};
+
+	/// Instances of one skeleton evaluated by one job.
+	struct AnimationBatch
+	{
+		unsigned int skeleton;
+		unsigned int first;                                              ///< First pose in batchTimes and batchPalettes.
+		unsigned int count;
+	};
 
-	class CAnimationSystem : public ecs::ISystem
+	/*! Sample pose of every animated entity once per rendered frame, before renderer runs, so
+	 *  renderer only reads finished palettes. Skeleton and clip stored once per mesh and shared by
+	 *  all its instances. Adds animation component to entities whose mesh has skeleton.
+	 *
+	 *  Instances grouped by skeleton and split into batches of core::MAX_POSE_BATCH poses,
+	 *  batches evaluated in parallel by job system. Every batch writes only palettes of own
+	 *  entities.
+	 *
+	 *  Optional pose cache keyed by skeleton and clip time quantised to poseSampleRate, so
+	 *  entities that sample the same frame of the same clip share one palette. Every loaded mesh has one
+	 *  skeleton with one clip, so skeleton index identifies clip too. Entities further from
+	 *  beholder than decimationDistance get new pose only every decimationInterval frame, frames
+	 *  spread over entities by entity index.
+	 *
+	 *  Runs outside of CSystemManager once per frame, so it plays back its own command buffer.
+	 */
+	class CAnimationSystem : public ISystem
 	{
+		core::vector<core::CSkeletalAnimation> skeletons;                ///< Indexed by mesh id, empty for static meshes.
+		core::vector<mat4> palettes;                                     ///< PALETTE_JOINTS_NUMBER matrices per entity index.
+		core::vector<unsigned int> paletteFrames;                        ///< Frame when palette was written, indexed by entity index.
+		core::vector<int> paletteSlots;                                  ///< Slot of pose cache or -1 for own palette, indexed by entity index.
+		core::vector<Entity> paletteEntities;                            ///< Owner of palette, new entity on recycled index dont inherit pose.
+		core::CPoseCache poseCache;
+		core::vector<unsigned int> instanceSkeletons;                    ///< Entities that need new pose in this frame.
+		core::vector<unsigned int> instanceEntities;
+		core::vector<float> instanceTimes;
+		core::vector<unsigned int> requestSkeletons;                     ///< Poses to evaluate in this frame in order of chunks.
+		core::vector<float> requestTimes;
+		core::vector<mat4*> requestPalettes;
+		core::vector<unsigned int> skeletonOffsets;                      ///< First pose of skeleton in batch arrays.
+		core::vector<float> batchTimes;                                  ///< Poses sorted by skeleton.
+		core::vector<mat4*> batchPalettes;
+		core::vector<AnimationBatch> batches;
+		unsigned int frame = 0;
+		AnimationStats frameStats;
+		AnimationStats totalStats;
+
+		bool IsAnimated(unsigned int meshID) const { return meshID < skeletons.GetSize() && skeletons[meshID].IsAnimated(); }
+		void AttachAnimations();
+		bool FindBeholder(vec3& position) const;
+		void CollectPoses();
+		void RequestPose(unsigned int skeleton, float time, unsigned int entityIndex);
+		void BuildBatches();
+
 	public:
-		core::EEvents eSave_Event_;
-		static const int anim_index_array = 3;
-		int anim_count = 0;
-//		core::CStack& _Inputs;
-		core::EEvents eEvent_;
-		double Animation_Delta;
-		double Delta_Time;
-		float* Vertex_Animation[ANIM_PER_AXIS_NUMBER][anim_index_array] =
-		{
-			{vertices, vertices2, vertices3},
-			{vertices4, vertices5, vertices6},
-			{vertices7, vertices8, vertices9},
-			{vertices10, vertices11, vertices12}
-		};
-
-        ///< Write one side of cube(if vertex component had vertices for 3D cube).
-		void ArrayCopy(float* _aArray_Source, float* _aArray_Destination, unsigned int _u_iRange)
-		{
-			for(unsigned int i = 0; i < _u_iRange; ++i)
-				_aArray_Destination[i] = _aArray_Source[i];
-		}
-		
-		void Update() override
-		{
-            CComponentManager* pComponent_Manager = CComponentManager::GetInstance();
-            core::vector<unsigned int>* pEntity_Container_refAnimationMove =
-                ecs::GetEntityContainer<ecs::animation>(*pComponent_Manager);
-            unsigned int uiVector_AnimationMove_Size = pEntity_Container_refAnimationMove->GetSize();
-
-            
-			for(int i = 0, iSize = uiVector_AnimationMove_Size; i < iSize; ++i)
-			{
-                unsigned int uiEntity_refAnimationMove = (*pEntity_Container_refAnimationMove)[i];
-                                
-				if(eEvent_ != eSave_Event_)
-					Animation_Delta = 0.31f;
-				eSave_Event_ = eEvent_;
-				if(eEvent_ == core::eMOVE_BACKWARD)
-				{
-					Animation_Delta += Delta_Time;
-					if(Animation_Delta > 0.3f)
-					{
-						switch(anim_count)
-						{
-						case 0:
-							ArrayCopy(Vertex_Animation[0][anim_count], pComponent_Manager->GetComponent<ecs::vertex>(uiEntity_refAnimationMove).aVertex_.data(), 30);
-							break;
-						case 1:
-							ArrayCopy(Vertex_Animation[0][anim_count], pComponent_Manager->GetComponent<ecs::vertex>(uiEntity_refAnimationMove).aVertex_.data(), 30);
-							break;
-						case 2:
-							ArrayCopy(Vertex_Animation[0][anim_count], pComponent_Manager->GetComponent<ecs::vertex>(uiEntity_refAnimationMove).aVertex_.data(), 30);
-							break;
-						default:
-							break;
-						}
-						++anim_count;
-						if(anim_count == 3)
-							anim_count = 0;
-						Animation_Delta = 0;
-						}
-					}
-					else if(eEvent_ == core::EEvents::eMOVE_LEFT)
-					{
-						Animation_Delta += Delta_Time;
-						if(Animation_Delta > 0.3f)
-						{
-							switch(anim_count)
-							{
-							case 0:
-								ArrayCopy(Vertex_Animation[1][anim_count], pComponent_Manager->GetComponent<ecs::vertex>(uiEntity_refAnimationMove).aVertex_.data(), 30);
-								break;
-							case 1:
-								ArrayCopy(Vertex_Animation[1][anim_count], pComponent_Manager->GetComponent<ecs::vertex>(uiEntity_refAnimationMove).aVertex_.data(), 30);
-								break;
-							case 2:
-								ArrayCopy(Vertex_Animation[1][anim_count], pComponent_Manager->GetComponent<ecs::vertex>(uiEntity_refAnimationMove).aVertex_.data(), 30);
-								break;
-							default:
-								break;
-							}
-							++anim_count;
-							if(anim_count == 3)
-								anim_count = 0;
-							Animation_Delta = 0;
-						}
-					}
-					else if(eEvent_ == core::EEvents::eMOVE_RIGHT)
-					{
-						Animation_Delta += Delta_Time;
-						if(Animation_Delta > 0.3f)
-						{
-							switch(anim_count)
-							{
-							case 0:
-								ArrayCopy(Vertex_Animation[2][anim_count], pComponent_Manager->GetComponent<ecs::vertex>(uiEntity_refAnimationMove).aVertex_.data(), 30);
-								break;
-							case 1:
-								ArrayCopy(Vertex_Animation[2][anim_count], pComponent_Manager->GetComponent<ecs::vertex>(uiEntity_refAnimationMove).aVertex_.data(), 30);
-								break;
-							case 2:
-								ArrayCopy(Vertex_Animation[2][anim_count], pComponent_Manager->GetComponent<ecs::vertex>(uiEntity_refAnimationMove).aVertex_.data(), 30);
-								break;
-							default:
-								break;
-							}
-							++anim_count;
-							if(anim_count == 3)
-								anim_count = 0;
-							Animation_Delta = 0;
-						}
-					}
-					else if(eEvent_ == core::EEvents::eMOVE_FORWARD)
-					{
-						Animation_Delta += Delta_Time;
-						if(Animation_Delta > 0.3f)
-						{
-							switch(anim_count)
-							{
-							case 0:
-								ArrayCopy(Vertex_Animation[3][anim_count], pComponent_Manager->GetComponent<ecs::vertex>(uiEntity_refAnimationMove).aVertex_.data(), 30);
-								break;
-							case 1:
-								ArrayCopy(Vertex_Animation[3][anim_count], pComponent_Manager->GetComponent<ecs::vertex>(uiEntity_refAnimationMove).aVertex_.data(), 30);
-								break;
-							case 2:
-								ArrayCopy(Vertex_Animation[3][anim_count], pComponent_Manager->GetComponent<ecs::vertex>(uiEntity_refAnimationMove).aVertex_.data(), 30);
-								break;
-							default:
-								break;
-							}
-							++anim_count;
-							if(anim_count == 3)
-								anim_count = 0;
-							Animation_Delta = 0;
-						}
-					}
-				}
-			}
-		};
-
-	}
+		float deltaFrameTime = 0.0f;
+		float poseSampleRate = 0.0f;                                     ///< Cached poses per second of clip, zero disables pose cache.
+		float decimationDistance = 0.0f;                                 ///< Zero disables decimation.
+		unsigned int decimationInterval = 4;
+
+		CAnimationSystem();
+
+		void Update() override;
+
+		void SetSkeleton(unsigned int meshID, core::CSkeletalAnimation&& skeleton);    ///< Called by renderer when mesh is loaded.
+
+		/// PALETTE_JOINTS_NUMBER joint matrices of entity, nullptr if entity was not animated in last update.
+		const mat4* GetPalette(Entity entity) const;
+
+		/// Poses evaluated during last update.
+		unsigned int GetPosesNumber() const { return batchTimes.GetSize(); }
+		unsigned int GetBatchesNumber() const { return batches.GetSize(); }    ///< Every batch evaluates poses of one skeleton.
+
+		const AnimationStats& GetFrameStats() const { return frameStats; }
+		const AnimationStats& GetTotalStats() const { return totalStats; }
+		void ResetTotalStats() { totalStats = AnimationStats(); }
+	};
+}
 
 #endif
@@ -28,6 +28,7 @@ namespace GLVM::ecs
         float fLast_Y = 1080.0f / 2.0f;
         bool bFirst_Mouse = true;
 
+        CCameraSystem();
         void Update() override;
         void SetViewMatrix(components::transform& _Player, components::beholder& _view_Component);
         void SetProjectionMatrix();
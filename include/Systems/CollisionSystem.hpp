@@ -20,18 +20,37 @@
 #include "Components/ViewComponent.hpp"
 #include <mutex>
 #include "Globals.hpp"
+#include "IBroadphase.hpp"
 
 namespace GLVM::ecs
 {
 	class CCollisionSystem : public ISystem
-	{   
+	{
+		/// Collider state gathered once per update for broadphase and box tests.
+		struct CollisionBody
+		{
+			components::collider* collider;
+			vec3 position;
+			vec3 predictedPosition;                                      ///< Position after applying move component.
+			float scale;
+		};
+
+		IBroadphase* broadphase;
+		core::vector<unsigned int> bodyIndices;                          ///< Body of entity in current update, indexed by entity index.
+		core::vector<CollisionBody> bodies;
+		core::vector<BroadphasePair> pairs;
+
 	public:
         
 		float fDelta_Time_;
 		float gravity;
         core::CStack& Input_Stack_;
 
-        CCollisionSystem(core::CStack& _input_Stack) : Input_Stack_(_input_Stack) {}
+        CCollisionSystem(core::CStack& _input_Stack, EBroadphaseType broadphaseType = eAABB_TREE_BROADPHASE);
+		~CCollisionSystem();
+		CCollisionSystem(const CCollisionSystem& collisionSystem) = delete;
+		void operator=(const CCollisionSystem& collisionSystem) = delete;
+
 		void Repel(components::transform& _transform_Component,
                    components::move& _move_Component,
 				   float& _fDelta_Time,
@@ -45,6 +64,9 @@ namespace GLVM::ecs
 							 float backtrackingScale, float comparedScale);
 		bool RayCast(vec3 rayCasterPosition, vec3 receiverPosition,
 					 float rayCasterScale, float receiverScale);
+
+		/// Boxes of all colliders, valid after Update until next one.
+		const IBroadphase& GetBroadphase() const { return *broadphase; }
     };
 }
 	
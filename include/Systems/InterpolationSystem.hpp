@@ -0,0 +1,26 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#ifndef INTERPOLATION_SYSTEM
+#define INTERPOLATION_SYSTEM
+
+#include "ISystem.hpp"
+#include "Components/TransformComponent.hpp"
+
+namespace GLVM::ecs
+{
+	/*! Store state of every transform before fixed simulation step, renderer interpolate between
+	 *  stored and current state. Must be activated before systems that move transforms.
+	 */
+	class CInterpolationSystem : public ISystem
+	{
+	public:
+		CInterpolationSystem();
+
+		void Update() override;
+	};
+}
+
+#endif
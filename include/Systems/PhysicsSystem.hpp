@@ -10,6 +10,8 @@
 #include "../ComponentManager.hpp"
 #include "../Event.hpp"
 #include "Components/EventComponent.hpp"
+#include "Components/MoveComponent.hpp"
+#include "Components/RigidBodyComponent.hpp"
 #include "ISystem.hpp"
 #include "Components/TransformComponent.hpp"
 #include "Vector.hpp"
@@ -27,7 +29,9 @@ namespace GLVM::ecs
         core::CStack& Input_Stack_;
 
         CPhysicsSystem(float& gravity_, core::CStack& _input_Stack) : gravity(gravity_),
-																	  Input_Stack_(_input_Stack) {}
+																	  Input_Stack_(_input_Stack) {
+			DeclareWrite<components::collider, components::move, components::transform, components::rigidBody>();
+		}
         
         ///< Set Y-axis of transform component of backtracking entity to upper Y-axis of ground entity.
         
@@ -0,0 +1,56 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#ifndef TRANSFORM_SYSTEM
+#define TRANSFORM_SYSTEM
+
+#include "ISystem.hpp"
+#include "Vector.hpp"
+#include "VertexMath.hpp"
+#include "Components/TransformComponent.hpp"
+#include "Components/WorldTransformComponent.hpp"
+#include "Components/ParentComponent.hpp"
+#include <atomic>
+
+namespace GLVM::ecs
+{
+	constexpr unsigned int MAX_HIERARCHY_DEPTH = 32;                     ///< Deeper chains and cycles of parents are cut off.
+
+	/*! Compute world matrix of every transform once per rendered frame, so all passes of renderer
+	 *  only read it. Adds world transform component to entities that dont have it. Local matrix
+	 *  recomputed only for chunks with changed transforms and for entities that move between two
+	 *  simulation steps when interpolation alpha changed. World matrix of child recomputed when its
+	 *  local matrix or world matrix of any parent was recomputed.
+	 *
+	 *  Runs outside of CSystemManager after simulation steps of frame, so it plays back its own
+	 *  command buffer.
+	 */
+	class CTransformSystem : public ISystem
+	{
+		unsigned int transformsVersion = 0;                              ///< Change version of last update, zero recompute all.
+		float updatedAlpha = -1.0f;
+		unsigned int frame = 0;
+		core::vector<unsigned int> updatedFrames;                        ///< Frame when world matrix was recomputed, indexed by entity index.
+		core::vector<unsigned int> resolvedFrames;                       ///< Frame when child was visited, indexed by entity index.
+		std::atomic<unsigned int> matricesNumber{0};
+
+		void AttachWorldTransforms();
+		bool ResolveChild(Entity entity, unsigned int depth);
+
+	public:
+		float interpolationAlpha = 1.0f;
+
+		CTransformSystem();
+
+		void Update() override;
+
+		/// Local matrices computed during last update.
+		unsigned int GetMatricesNumber() const { return matricesNumber.load(std::memory_order_relaxed); }
+
+		static mat4 ComputeLocalMatrix(const components::transform& transformComponent);
+	};
+}
+
+#endif
@@ -12,5 +12,8 @@
 #include "Systems/GUISystem.hpp"
 #include "Systems/CollisionSystem.hpp"
 #include "Systems/MovementSystem.hpp"
+#include "Systems/InterpolationSystem.hpp"
+#include "Systems/TransformSystem.hpp"
+#include "Systems/AnimationSystem.hpp"
 
 #endif
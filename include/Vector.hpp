@@ -9,7 +9,11 @@
 #include "Constants.hpp"
 #include "IContainer.hpp"
 #include <cstddef>
+#include <cstring>
 #include <iostream>
+#include <new>
+#include <type_traits>
+#include <utility>
 #include "VertexMath.hpp"
 #include <assert.h>
 #include "Iterator.hpp"
@@ -52,38 +56,119 @@ namespace GLVM::core
 		}
 	};
 	
+	/*! Dynamic array. Capacity grows geometrically (1.5x), so N pushes cost O(N). Elements
+	 *  moved on reallocation if move cant throw, otherwise copied so failed growth leaves
+	 *  container as it was. Trivially copyable types copied with memcpy. Storage aligned
+	 *  for T, so over-aligned math types can be stored too.
+	 */
 	template<class T>
 	class vector : public IContainer
 	{
-		unsigned int size = 0;
-		unsigned int capacity = 0;
-		static constexpr int expander = 10;
+		std::size_t size = 0;
+		std::size_t capacity = 0;
+		static constexpr std::size_t minimalCapacity = 8;
 		unsigned char* rowInnerData = nullptr;
+
+		static unsigned char* Allocate(std::size_t capacity_);
+		static void Deallocate(unsigned char* data);
+		static void MoveElements(T* destination, T* source, std::size_t count);    ///< Move count elements into raw storage and destroy sources.
+		std::size_t GrowCapacity(std::size_t requiredCapacity) const;
+		void Reallocate(std::size_t newCapacity);
 	public:
         vector() = default;
         vector(const vector<T>& _vector);
+        vector(vector<T>&& _vector) noexcept;
         ~vector() override;
-		void Push(T item);
+		void Push(const T& item);
+		void Push(T&& item);
+		template <typename... Args>
+		T& EmplaceBack(Args&&... args);
 		void Pop();
 		void Swap(T& firstElement, T& secondElement);
 		VectorIterator<T> Find(T& element);
-		void Resize(const unsigned int index);
-		void Remove(unsigned int index);
+		void Reserve(const std::size_t capacity_);                      ///< Allocate storage for at least capacity_ elements, size not changed.
+		void Resize(const std::size_t index);
+		void Remove(std::size_t index);                                  ///< Keep order of elements, O(N).
+		void SwapRemove(std::size_t index);                              ///< Move last element into removed cell, O(1) but order not kept.
 		void RemoveFirstItem();
 		T& GetFirstItem();
 		T& GetHead();
 		T* GetVectorContainer();
-		[[nodiscard]] unsigned int GetSize() const;
-		int GetCapacity();
-		const T& operator[](const unsigned int _iIndex) const;
-		T& operator[](const unsigned int _iIndex);
+		[[nodiscard]] std::size_t GetSize() const;
+		std::size_t GetCapacity() const;
+		const T& operator[](const std::size_t _iIndex) const;
+		T& operator[](const std::size_t _iIndex);
 		void clear();
         void Print();
         vector& operator=(const vector<T>& _vector);
+        vector& operator=(vector<T>&& _vector) noexcept;
         bool operator==(const char* string_);
 		bool empty();
 	};
 
+	template <class T>
+	unsigned char* vector<T>::Allocate(std::size_t capacity_) {
+		if ( capacity_ == 0 )
+			return nullptr;
+
+		return static_cast<unsigned char*>(::operator new(capacity_ * sizeof(T), std::align_val_t(alignof(T))));
+	}
+
+	template <class T>
+	void vector<T>::Deallocate(unsigned char* data) {
+		if ( data != nullptr )
+			::operator delete(data, std::align_val_t(alignof(T)));
+	}
+
+	template <class T>
+	void vector<T>::MoveElements(T* destination, T* source, std::size_t count) {
+		if constexpr ( std::is_trivially_copyable_v<T> ) {
+			if ( count > 0 )
+				std::memcpy(static_cast<void*>(destination), static_cast<const void*>(source), count * sizeof(T));
+		} else if constexpr ( std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T> ) {
+			for ( std::size_t i = 0; i < count; ++i ) {
+				new (&destination[i]) T(std::move(source[i]));
+				source[i].~T();
+			}
+		} else {
+			std::size_t copied = 0;
+			try {
+				for ( ; copied < count; ++copied )
+					new (&destination[copied]) T(source[copied]);
+			} catch ( ... ) {
+				for ( std::size_t i = 0; i < copied; ++i )                ///< Sources untouched, container stays as it was.
+					destination[i].~T();
+				throw;
+			}
+
+			for ( std::size_t i = 0; i < count; ++i )
+				source[i].~T();
+		}
+	}
+
+	template <class T>
+	std::size_t vector<T>::GrowCapacity(std::size_t requiredCapacity) const {
+		std::size_t newCapacity = capacity + capacity / 2;
+		if ( newCapacity < minimalCapacity )
+			newCapacity = minimalCapacity;
+
+		return newCapacity < requiredCapacity ? requiredCapacity : newCapacity;
+	}
+
+	template <class T>
+	void vector<T>::Reallocate(std::size_t newCapacity) {
+		unsigned char* newData = Allocate(newCapacity);
+		try {
+			MoveElements(reinterpret_cast<T*>(newData), reinterpret_cast<T*>(rowInnerData), size);
+		} catch ( ... ) {
+			Deallocate(newData);
+			throw;
+		}
+		Deallocate(rowInnerData);
+		rowInnerData = newData;
+		capacity = newCapacity;
+	}
+
     template <class T>
     bool vector<T>::operator==(const char* string_) {
 		char tempSymbol = '2';
@@ -93,7 +178,7 @@ namespace GLVM::core
 			++strSize;
 		}
 		
-        for (unsigned int i = 0; i < size; ++i) {
+        for (std::size_t i = 0; i < size; ++i) {
 			T& element = *(T*)&rowInnerData[i * sizeof(T)];
             if (element == string_[i])
                 continue;
@@ -110,67 +195,107 @@ namespace GLVM::core
         if(this == &_vector)
             return *this;
 
-		for(unsigned int j = 0; j < this->size; ++j) {
-			T& destinationElement = *(T*)&this->rowInnerData[j * sizeof(T)];
-			destinationElement.~T();
+		clear();
+		if ( capacity < _vector.size ) {
+			Deallocate(rowInnerData);
+			rowInnerData = Allocate(_vector.size);
+			capacity     = _vector.size;
 		}
 
-		delete [] this->rowInnerData;
-
-		capacity = _vector.capacity;
-		size     = _vector.size;
-		this->rowInnerData = new unsigned char[capacity * sizeof(T)];
-		
-        for(unsigned int i = 0; i < _vector.size; ++i) {
-			T& sourceElement = *(T*)&_vector.rowInnerData[i * sizeof(T)];
-			new (&rowInnerData[i * sizeof(T)]) T(sourceElement);
+		if constexpr ( std::is_trivially_copyable_v<T> ) {
+			if ( _vector.size > 0 )
+				std::memcpy(static_cast<void*>(rowInnerData), static_cast<const void*>(_vector.rowInnerData), _vector.size * sizeof(T));
+		} else {
+			for(std::size_t i = 0; i < _vector.size; ++i) {
+				const T& sourceElement = reinterpret_cast<const T*>(_vector.rowInnerData)[i];
+				new (&rowInnerData[i * sizeof(T)]) T(sourceElement);
+			}
 		}
+		size = _vector.size;
+
+        return *this;
+    }
+
+    template <class T>
+    vector<T>& vector<T>::operator=(vector<T>&& _vector) noexcept
+    {
+        if(this == &_vector)
+            return *this;
+
+		clear();
+		Deallocate(rowInnerData);
+		rowInnerData = _vector.rowInnerData;
+		size         = _vector.size;
+		capacity     = _vector.capacity;
+		_vector.rowInnerData = nullptr;
+		_vector.size         = 0;
+		_vector.capacity     = 0;
 
         return *this;
     }
 
     template <class T>
     vector<T>::vector(const vector<T>& _vector) {
-		size     = _vector.size;
+		rowInnerData = Allocate(_vector.size);
 	    capacity = _vector.size;
-		this->rowInnerData = new unsigned char[capacity * sizeof(T)];
-		
-        for(unsigned int i = 0; i < _vector.size; ++i) {
-			T& sourceElement = *(T*)&_vector.rowInnerData[i * sizeof(T)];
-			new (&rowInnerData[i * sizeof(T)]) T(sourceElement);
-		}
+		*this = _vector;
+    }
+
+    template <class T>
+    vector<T>::vector(vector<T>&& _vector) noexcept :
+		size(_vector.size), capacity(_vector.capacity), rowInnerData(_vector.rowInnerData) {
+		_vector.rowInnerData = nullptr;
+		_vector.size         = 0;
+		_vector.capacity     = 0;
     }
     
 	template<class T>
 	vector<T>::~vector() {
-		for ( unsigned int i = 0; i < size; ++i) {
-			T& element = *(T*)&rowInnerData[i * sizeof(T)];
-			element.~T();
-		}
-		delete [] rowInnerData;
+		clear();
+		Deallocate(rowInnerData);
 		rowInnerData = nullptr;
 	}
 
     /// Push element on top of the container.
     
 	template<class T>
-	void vector<T>::Push(T item) {
-		if(size == capacity) {
-				unsigned char* aTemp_Vector_Container = new unsigned char[(capacity + expander) * sizeof(T)];
-				for(unsigned int i = 0; i < size; ++i) {
-					T& element = *(T*)&rowInnerData[i * sizeof(T)];
-					new (&aTemp_Vector_Container[i * sizeof(T)]) T(element);
-					element.~T();
-				}
+	void vector<T>::Push(const T& item) {
+		EmplaceBack(item);
+	}
 
-				delete [] rowInnerData;
-				rowInnerData = aTemp_Vector_Container;
+	template<class T>
+	void vector<T>::Push(T&& item) {
+		EmplaceBack(std::move(item));
+	}
 
-				capacity += expander;
+	/// Construct element on top of the container. Arguments may refer to elements of this container.
+	
+	template<class T>
+	template<typename... Args>
+	T& vector<T>::EmplaceBack(Args&&... args) {
+		if ( size == capacity ) {
+			std::size_t newCapacity = GrowCapacity(size + 1);
+			unsigned char* newData = Allocate(newCapacity);
+			T* newElement = nullptr;
+			try {
+				newElement = new (&newData[size * sizeof(T)]) T(std::forward<Args>(args)...);    ///< Construct before old storage released.
+				MoveElements(reinterpret_cast<T*>(newData), reinterpret_cast<T*>(rowInnerData), size);
+			} catch ( ... ) {
+				if ( newElement != nullptr )
+					newElement->~T();
+				Deallocate(newData);
+				throw;
 			}
+			Deallocate(rowInnerData);
+			rowInnerData = newData;
+			capacity = newCapacity;
+			++size;
+			return *newElement;
+		}
 
-		new (&rowInnerData[size * sizeof(T)]) T(item);
+		T* newElement = new (&rowInnerData[size * sizeof(T)]) T(std::forward<Args>(args)...);
 		++size;
+		return *newElement;
 	}
 
 	template <class T>
@@ -195,9 +320,9 @@ namespace GLVM::core
 		    return;
 		}
 		
-		T tempElement = firstElement;
-		firstElement  = secondElement;
-		secondElement  = tempElement;
+		T tempElement  = std::move(firstElement);
+		firstElement   = std::move(secondElement);
+		secondElement  = std::move(tempElement);
 	}
 
 	template <class T>
@@ -217,33 +342,31 @@ namespace GLVM::core
 		return iterator;
 	}
 	
-    /// Insert element into chosen cell.
+	template<typename T>
+	void vector<T>::Reserve(const std::size_t capacity_)
+	{
+		if ( capacity_ > capacity )
+			Reallocate(capacity_);
+	}
+
+    /// Change number of elements, new elements value-initialized.
     
 	template<typename T>
-	void vector<T>::Resize(const unsigned int index)
+	void vector<T>::Resize(const std::size_t index)
 	{
 		if ( index < size ) {
-			for(unsigned int j = index; j < size; ++j) {
-				(*(T*)&rowInnerData[j * sizeof(T)]).~T();
+			if constexpr ( !std::is_trivially_destructible_v<T> ) {
+				for(std::size_t j = index; j < size; ++j) {
+					(*(T*)&rowInnerData[j * sizeof(T)]).~T();
+				}
 			}
 
 			size = index;
 		} else if( index > size ) {
-			if ( index > capacity ) {
-				unsigned char* aTemp_Vector_Container_ = new unsigned char[index * sizeof(T)];
+			if ( index > capacity )
+				Reallocate(GrowCapacity(index));
 
-				for(unsigned int j = 0; j < size; ++j) {
-					T& element = *(T*)&rowInnerData[j * sizeof(T)];
-					new (&aTemp_Vector_Container_[j * sizeof(T)]) T(element);
-					element.~T();
-				}
-
-				delete [] rowInnerData;
-				rowInnerData = aTemp_Vector_Container_;
-				capacity = index;
-			}
-
-			for ( unsigned int i = size; i < index; ++i) {
+			for ( std::size_t i = size; i < index; ++i) {
 				new (&rowInnerData[i * sizeof(T)]) T{};
 			}
 
@@ -252,49 +375,45 @@ namespace GLVM::core
 	}
 	
  	template<class T>
-	void vector<T>::Remove(unsigned int index)
+	void vector<T>::Remove(std::size_t index)
 	{
-		if(size < 1)
+		if(index >= size)
 			return;
 
-		for(unsigned int j = index; j < size - 1; ++j) {
-			T& element = *(T*)&rowInnerData[(j + 1) * sizeof(T)];
-			T& previousElement = *(T*)&rowInnerData[j * sizeof(T)];
-			previousElement.~T();
-			new (&rowInnerData[j * sizeof(T)]) T(element);
+		T* elements = reinterpret_cast<T*>(rowInnerData);
+		if constexpr ( std::is_trivially_copyable_v<T> ) {
+			std::memmove(static_cast<void*>(&elements[index]), static_cast<const void*>(&elements[index + 1]),
+						 (size - index - 1) * sizeof(T));
+		} else {
+			for(std::size_t j = index; j < size - 1; ++j) {
+				elements[j].~T();
+				new (&elements[j]) T(std::move_if_noexcept(elements[j + 1]));
+			}
+			elements[size - 1].~T();
 		}
 
-		/// FIXME: FOR DEBUG ONLY!
-		// if ( typeid(T).name() == typeid(unsigned int).name() ) {
-		// 	T& element = *(T*)&rowInnerData[(size - 1) * sizeof(T)];
-		// 	element = 0;                                                     ///< For debug purpouses only!!!
-		// }
-		
 	    --size;
 	}
-    
-	template<class T>
-	void vector<T>::RemoveFirstItem()
+
+ 	template<class T>
+	void vector<T>::SwapRemove(std::size_t index)
 	{
-		if(size < 1)
+		if(index >= size)
 			return;
-		
-		unsigned char* aTemp_Vector_Container = new unsigned char[size * sizeof(T)];
-		for(unsigned int i = 0; i < size; ++i) {
-			T& element = *(T*)&rowInnerData[i * sizeof(T)];
-			new (&aTemp_Vector_Container[i * sizeof(T)]) T(element);
-			element.~T();
-		}
 
-		delete [] this->rowInnerData;
-		this->rowInnerData = nullptr;
-
-		--size;				
-		rowInnerData = new unsigned char[size * sizeof(T)];
-        for(unsigned int i = 0; i < size; ++i) {
-			T& sourceElement = *(T*)&aTemp_Vector_Container[(i + 1) * sizeof(T)];
-			new (&rowInnerData[i * sizeof(T)]) T(sourceElement);
+		T* elements = reinterpret_cast<T*>(rowInnerData);
+		if ( index != size - 1 ) {
+			elements[index].~T();
+			new (&elements[index]) T(std::move_if_noexcept(elements[size - 1]));
 		}
+		elements[size - 1].~T();
+	    --size;
+	}
+    
+	template<class T>
+	void vector<T>::RemoveFirstItem()
+	{
+		Remove(0);
 	}
 	
 	template<class T>
@@ -307,41 +426,27 @@ namespace GLVM::core
 	T* vector<T>::GetVectorContainer() { return (T*)rowInnerData; }
 
 	template<typename T>
-	unsigned int vector<T>::GetSize() const { return size; }
+	std::size_t vector<T>::GetSize() const { return size; }
 	
 	template<typename T>
-	int vector<T>::GetCapacity() { return capacity; }
+	std::size_t vector<T>::GetCapacity() const { return capacity; }
 	template<typename T>
-	const T& vector<T>::operator[](const unsigned int _iIndex) const { return reinterpret_cast<const T*>(rowInnerData)[_iIndex]; }
+	const T& vector<T>::operator[](const std::size_t _iIndex) const { return reinterpret_cast<const T*>(rowInnerData)[_iIndex]; }
 	template<typename T>
-	T& vector<T>::operator[](const unsigned int _iIndex) { return reinterpret_cast<T*>(rowInnerData)[_iIndex]; }
+	T& vector<T>::operator[](const std::size_t _iIndex) { return reinterpret_cast<T*>(rowInnerData)[_iIndex]; }
 
+	/// Destroy all elements, capacity kept for reuse.
+	
 	template<typename T>
 	void vector<T>::clear() {
-		if(size < 1)
-			return;
-
-		/// FIXME: FOR DEBUG ONLY!
-		if ( typeid(T).name() == typeid(unsigned int).name() ) {
-			for ( unsigned int i = 0; i < capacity; ++i ) {
+		if constexpr ( !std::is_trivially_destructible_v<T> ) {
+			for(std::size_t i = 0; i < size; ++i) {
 				T& element = *(T*)&rowInnerData[i * sizeof(T)];
-				element = 0;                                                     ///< For debug purpouses only!!!
+				element.~T();
 			}
 		}
-
-		for(unsigned int i = 0; i < size; ++i) {
-			T& element = *(T*)&rowInnerData[i * sizeof(T)];
-			element.~T();
-		}
-		
-		/// FIXME: DEBUG ONLY!
-		// unsigned int sizeOfType = sizeof(T);
-		// for (unsigned int j = 0; j < capacity * sizeOfType; ++j) {
-		// 	*(unsigned char*)&rowInnerData[j] = 0;
-		// }
 		
 		size     = 0;
-//		capacity = 0;
 	}
 
  	template<class T>
@@ -350,7 +455,7 @@ namespace GLVM::core
     template<class T>
     void vector<T>::Print()
     {
-        for(unsigned int i = 0; i < size; ++i)
+        for(std::size_t i = 0; i < size; ++i)
             std::cout << *(T*)&rowInnerData[i * sizeof(T)] << std::endl;
 
         std::cout << "End of container" << std::endl;
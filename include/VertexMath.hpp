@@ -9,6 +9,8 @@
 #include <iostream>
 #include <cmath>
 #include <ostream>
+#include <type_traits>
+#include "VertexMathSimd.hpp"
 
 #define PI 3.14159265
 
@@ -18,7 +20,9 @@ class Vector;
 template <class T, int var>
 class Matrix
 {
-	T m_matrix[var][var] {};
+	alignas(var == 4 ? 16 : alignof(T)) T m_matrix[var][var] {};    ///< Rows of 4x4 matrix loaded to SIMD registers directly.
+
+	static constexpr bool simdMatrix = std::is_same_v<T, float> && var == 4;
 public:
 	Matrix(T arg = 0)
 	{
@@ -56,6 +60,11 @@ public:
 
     void SelfTensorTranspose()
     {
+		if constexpr ( simdMatrix ) {
+			GLVM::core::simd::TransposeMatrix4(&m_matrix[0][0], &m_matrix[0][0]);
+			return;
+		}
+
         T tempMatrix[var][var];
         for(int p = 0; p < var; ++p)
             for(int u = 0; u < var; ++u)
@@ -83,11 +92,11 @@ public:
 
 	Matrix<T, var> operator+(Matrix matrix);
 	Matrix<T, var> operator*(T scalar);
-	Matrix<T, var> operator*(Matrix& matrix);
+	Matrix<T, var> operator*(const Matrix& matrix) const;
 	T* operator[](const int index);
 	const T* operator[](const int index) const;
 	template<class T2, int var2>
-	Vector<T2, var2> operator*(Vector<T2, var2>& vector);
+	Vector<T2, var2> operator*(const Vector<T2, var2>& vector) const;
 };
 
 typedef Vector<float, 1> vec1;
@@ -121,9 +130,14 @@ Matrix<T, var> Matrix<T, var>::operator*(T scalar) {
 }
 
 template<class T, int var>
-Matrix<T, var> Matrix<T, var>::operator*(Matrix& matrix)
+Matrix<T, var> Matrix<T, var>::operator*(const Matrix& matrix) const
 {
 	Matrix<T, var> tempMatrix;
+	if constexpr ( simdMatrix ) {
+		GLVM::core::simd::MultiplyMatrix4(&m_matrix[0][0], &matrix.m_matrix[0][0], &tempMatrix.m_matrix[0][0]);
+		return tempMatrix;
+	}
+
 	for(int i = 0; i < var; ++i)
 		for(int j = 0; j < var; ++j)
 			for(int n = 0; n < var; ++n)
@@ -158,10 +172,15 @@ std::ostream& operator<<(std::ostream& ostream, const Matrix<float, var2>& matri
 
 template <class T, int var>
 template <class T2, int var2>
-Vector<T2, var2> Matrix<T, var>::operator*(Vector<T2, var2>& vector)
+Vector<T2, var2> Matrix<T, var>::operator*(const Vector<T2, var2>& vector) const
 {
 	static_assert(var == var2, "Size error");
 	Vector<T2, var2> tempVector;
+	if constexpr ( simdMatrix && std::is_same_v<T2, float> ) {
+		GLVM::core::simd::MultiplyMatrixVector4(&m_matrix[0][0], &vector.m_vector[0], &tempVector.m_vector[0]);
+		return tempVector;
+	}
+
 	for(int i = 0; i < var2; ++i)
 		for(int j = 0; j < var; ++j)
 		{
@@ -237,6 +256,11 @@ Vector<T2, var2> Vector<T2, var2>::operator*(const Matrix<T, var>& matrix)
 {
 	static_assert(var == var2, "Size error");
 	Vector<T2, var2> tempVector;
+	if constexpr ( std::is_same_v<T, float> && std::is_same_v<T2, float> && var == 4 ) {
+		GLVM::core::simd::MultiplyVectorMatrix4(&m_vector[0], matrix[0], &tempVector.m_vector[0]);
+		return tempVector;
+	}
+
 	for(int i = 0; i < var2; ++i)
 		for(int j = 0; j < var; ++j)
 		{
@@ -316,6 +340,22 @@ Vector<T2, var2> Vector<T2, var2>::operator*(T2 _scalar)
     return temp_vec;
 }
 
+template <class T, int var>
+Matrix<T, var> Transpose(Matrix<T, var> matrix)
+{
+	matrix.SelfTensorTranspose();
+	return matrix;
+}
+
+/// Zero matrix returned for singular matrix.
+inline mat4 Inverse(const mat4& matrix)
+{
+	mat4 result(0.0f);
+	GLVM::core::simd::InverseMatrix4(matrix[0], result[0]);
+
+	return result;
+}
+
 template <class T, class T2,int var, int var2>
 Matrix<T, var> LookAt(Matrix<T, var> matrix, Vector<T2, var2> vector)
 {
@@ -830,10 +870,7 @@ inline Quaternion linkedQuaternionValue(Quaternion quaternion) {
 
 inline Quaternion multiplyQuaternion(Quaternion a, Quaternion b) {
 	Quaternion result;
-	result.w = a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z;
-	result.x = a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y;
-	result.y = a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x;
-	result.z = a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w;
+	GLVM::core::simd::MultiplyQuaternion(&a.w, &b.w, &result.w);
 
 	return result;
 }
@@ -866,6 +903,48 @@ inline Quaternion inverseQuaternion(Quaternion quaternion) {
 	return quaternion;
 }
 
+/// Linear interpolation along shortest arc with normalization, precise enough for near quaternions.
+inline Quaternion nlerpQuaternion(Quaternion a, Quaternion b, float factor) {
+	float dot = a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
+	float sign = dot < 0.0f ? -1.0f : 1.0f;
+
+	Quaternion result;
+	result.w = a.w + (sign * b.w - a.w) * factor;
+	result.x = a.x + (sign * b.x - a.x) * factor;
+	result.y = a.y + (sign * b.y - a.y) * factor;
+	result.z = a.z + (sign * b.z - a.z) * factor;
+
+	return normalizeQuaternion(result);
+}
+
+/// Spherical interpolation along shortest arc, falls back to nlerp when quaternions almost equal.
+inline Quaternion slerpQuaternion(Quaternion a, Quaternion b, float factor) {
+	float dot = a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
+	if ( dot < 0.0f ) {
+		dot = -dot;
+		b.w = -b.w;
+		b.x = -b.x;
+		b.y = -b.y;
+		b.z = -b.z;
+	}
+
+	if ( dot > 0.9995f )
+		return nlerpQuaternion(a, b, factor);
+
+	float theta = std::acos(dot);
+	float sinTheta = std::sin(theta);
+	float weightA = std::sin((1.0f - factor) * theta) / sinTheta;
+	float weightB = std::sin(factor * theta) / sinTheta;
+
+	Quaternion result;
+	result.w = a.w * weightA + b.w * weightB;
+	result.x = a.x * weightA + b.x * weightB;
+	result.y = a.y * weightA + b.y * weightB;
+	result.z = a.z * weightA + b.z * weightB;
+
+	return result;
+}
+
 inline Quaternion eulerToQuaternion(float roll, float pitch, float yaw) {
 	float cr = cos(roll * 0.5);
     float sr = sin(roll * 0.5);
@@ -0,0 +1,319 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#ifndef VERTEX_MATH_SIMD
+#define VERTEX_MATH_SIMD
+
+/*! Kernels for 4x4 float matrices, 4 float vectors, quaternions and frustum test of packed
+ *  spheres. Matrices are row major arrays of 16 floats aligned to 16 bytes, vectors and
+ *  quaternions may be unaligned. Instruction set chosen at compile time: AVX if compiler allowed
+ *  it, SSE2 on every x86-64, scalar code on other processors or when GLVM_NO_SIMD defined. Products and sums made in the same order as
+ *  in scalar code and without fused multiply-add, so every path gives bit-identical result.
+ *  Only inverse differs from scalar one in last bits.
+ */
+
+#if defined(GLVM_NO_SIMD)
+#elif defined(__AVX__)
+#define GLVM_SIMD_AVX
+#define GLVM_SIMD_SSE
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GLVM_SIMD_SSE
+#include <emmintrin.h>
+#endif
+
+namespace GLVM::core::simd
+{
+	/// result = first * second, result may not alias arguments.
+	inline void MultiplyMatrix4(const float* first, const float* second, float* result) {
+#if defined(GLVM_SIMD_AVX)
+		/// Two rows of result per iteration, every half of register hold one row.
+		__m256 row0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(second));
+		__m256 row1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(second + 4));
+		__m256 row2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(second + 8));
+		__m256 row3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(second + 12));
+		for ( int i = 0; i < 16; i += 8 ) {
+			__m256 rows = _mm256_loadu_ps(first + i);
+			__m256 sum = _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, 0x00), row0);
+			sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, 0x55), row1));
+			sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, 0xAA), row2));
+			sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, 0xFF), row3));
+			_mm256_storeu_ps(result + i, sum);
+		}
+#elif defined(GLVM_SIMD_SSE)
+		__m128 row0 = _mm_load_ps(second);
+		__m128 row1 = _mm_load_ps(second + 4);
+		__m128 row2 = _mm_load_ps(second + 8);
+		__m128 row3 = _mm_load_ps(second + 12);
+		for ( int i = 0; i < 16; i += 4 ) {
+			__m128 sum = _mm_mul_ps(_mm_set1_ps(first[i]), row0);
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(first[i + 1]), row1));
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(first[i + 2]), row2));
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(first[i + 3]), row3));
+			_mm_store_ps(result + i, sum);
+		}
+#else
+		for ( int i = 0; i < 4; ++i )
+			for ( int j = 0; j < 4; ++j )
+				result[i * 4 + j] = first[i * 4] * second[j] + first[i * 4 + 1] * second[4 + j] +
+					first[i * 4 + 2] * second[8 + j] + first[i * 4 + 3] * second[12 + j];
+#endif
+	}
+
+	/// Row vector multiplied by matrix, result = vector * matrix.
+	inline void MultiplyVectorMatrix4(const float* vector, const float* matrix, float* result) {
+#if defined(GLVM_SIMD_SSE)
+		__m128 sum = _mm_mul_ps(_mm_set1_ps(vector[0]), _mm_load_ps(matrix));
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(vector[1]), _mm_load_ps(matrix + 4)));
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(vector[2]), _mm_load_ps(matrix + 8)));
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(vector[3]), _mm_load_ps(matrix + 12)));
+		_mm_storeu_ps(result, sum);
+#else
+		for ( int i = 0; i < 4; ++i )
+			result[i] = vector[0] * matrix[i] + vector[1] * matrix[4 + i] + vector[2] * matrix[8 + i] + vector[3] * matrix[12 + i];
+#endif
+	}
+
+	/// Column vector multiplied by matrix, result = matrix * vector.
+	inline void MultiplyMatrixVector4(const float* matrix, const float* vector, float* result) {
+#if defined(GLVM_SIMD_SSE)
+		__m128 column0 = _mm_load_ps(matrix);
+		__m128 column1 = _mm_load_ps(matrix + 4);
+		__m128 column2 = _mm_load_ps(matrix + 8);
+		__m128 column3 = _mm_load_ps(matrix + 12);
+		_MM_TRANSPOSE4_PS(column0, column1, column2, column3);
+		__m128 sum = _mm_mul_ps(column0, _mm_set1_ps(vector[0]));
+		sum = _mm_add_ps(sum, _mm_mul_ps(column1, _mm_set1_ps(vector[1])));
+		sum = _mm_add_ps(sum, _mm_mul_ps(column2, _mm_set1_ps(vector[2])));
+		sum = _mm_add_ps(sum, _mm_mul_ps(column3, _mm_set1_ps(vector[3])));
+		_mm_storeu_ps(result, sum);
+#else
+		for ( int i = 0; i < 4; ++i )
+			result[i] = matrix[i * 4] * vector[0] + matrix[i * 4 + 1] * vector[1] + matrix[i * 4 + 2] * vector[2] + matrix[i * 4 + 3] * vector[3];
+#endif
+	}
+
+	/// result may alias matrix.
+	inline void TransposeMatrix4(const float* matrix, float* result) {
+#if defined(GLVM_SIMD_SSE)
+		__m128 row0 = _mm_load_ps(matrix);
+		__m128 row1 = _mm_load_ps(matrix + 4);
+		__m128 row2 = _mm_load_ps(matrix + 8);
+		__m128 row3 = _mm_load_ps(matrix + 12);
+		_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+		_mm_store_ps(result, row0);
+		_mm_store_ps(result + 4, row1);
+		_mm_store_ps(result + 8, row2);
+		_mm_store_ps(result + 12, row3);
+#else
+		float temp[16];
+		for ( int i = 0; i < 4; ++i )
+			for ( int j = 0; j < 4; ++j )
+				temp[j * 4 + i] = matrix[i * 4 + j];
+		for ( int i = 0; i < 16; ++i )
+			result[i] = temp[i];
+#endif
+	}
+
+	/// Inverse by cofactors, scalar version for any processor. Return false and leave result untouched for singular matrix.
+	inline bool InverseMatrix4Scalar(const float* m, float* result) {
+		float inverse[16];
+		inverse[0]  =  m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+		inverse[4]  = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+		inverse[8]  =  m[4] * m[9]  * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+		inverse[12] = -m[4] * m[9]  * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+		inverse[1]  = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+		inverse[5]  =  m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+		inverse[9]  = -m[0] * m[9]  * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+		inverse[13] =  m[0] * m[9]  * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+		inverse[2]  =  m[1] * m[6]  * m[15] - m[1] * m[7]  * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7]  - m[13] * m[3] * m[6];
+		inverse[6]  = -m[0] * m[6]  * m[15] + m[0] * m[7]  * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7]  + m[12] * m[3] * m[6];
+		inverse[10] =  m[0] * m[5]  * m[15] - m[0] * m[7]  * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7]  - m[12] * m[3] * m[5];
+		inverse[14] = -m[0] * m[5]  * m[14] + m[0] * m[6]  * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6]  + m[12] * m[2] * m[5];
+		inverse[3]  = -m[1] * m[6]  * m[11] + m[1] * m[7]  * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9]  * m[2] * m[7]  + m[9]  * m[3] * m[6];
+		inverse[7]  =  m[0] * m[6]  * m[11] - m[0] * m[7]  * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8]  * m[2] * m[7]  - m[8]  * m[3] * m[6];
+		inverse[11] = -m[0] * m[5]  * m[11] + m[0] * m[7]  * m[9]  + m[4] * m[1] * m[11] - m[4] * m[3] * m[9]  - m[8]  * m[1] * m[7]  + m[8]  * m[3] * m[5];
+		inverse[15] =  m[0] * m[5]  * m[10] - m[0] * m[6]  * m[9]  - m[4] * m[1] * m[10] + m[4] * m[2] * m[9]  + m[8]  * m[1] * m[6]  - m[8]  * m[2] * m[5];
+
+		float determinant = m[0] * inverse[0] + m[1] * inverse[4] + m[2] * inverse[8] + m[3] * inverse[12];
+		if ( determinant == 0.0f )
+			return false;
+
+		float inverseDeterminant = 1.0f / determinant;
+		for ( int i = 0; i < 16; ++i )
+			result[i] = inverse[i] * inverseDeterminant;
+
+		return true;
+	}
+
+#if defined(GLVM_SIMD_SSE)
+	/// 2x2 matrices packed in register as (m00, m01, m10, m11).
+	#define GLVM_SHUFFLE_MASK(x, y, z, w) ((x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+	#define GLVM_SWIZZLE(vector, x, y, z, w) _mm_shuffle_ps(vector, vector, GLVM_SHUFFLE_MASK(x, y, z, w))
+
+	/// first * second.
+	inline __m128 Multiply2x2(__m128 first, __m128 second) {
+		return _mm_add_ps(_mm_mul_ps(first, GLVM_SWIZZLE(second, 0, 3, 0, 3)),
+						  _mm_mul_ps(GLVM_SWIZZLE(first, 1, 0, 3, 2), GLVM_SWIZZLE(second, 2, 1, 2, 1)));
+	}
+
+	/// adjugate(first) * second.
+	inline __m128 AdjugateMultiply2x2(__m128 first, __m128 second) {
+		return _mm_sub_ps(_mm_mul_ps(GLVM_SWIZZLE(first, 3, 3, 0, 0), second),
+						  _mm_mul_ps(GLVM_SWIZZLE(first, 1, 1, 2, 2), GLVM_SWIZZLE(second, 2, 3, 0, 1)));
+	}
+
+	/// first * adjugate(second).
+	inline __m128 MultiplyAdjugate2x2(__m128 first, __m128 second) {
+		return _mm_sub_ps(_mm_mul_ps(first, GLVM_SWIZZLE(second, 3, 0, 3, 0)),
+						  _mm_mul_ps(GLVM_SWIZZLE(first, 1, 0, 3, 2), GLVM_SWIZZLE(second, 2, 1, 2, 1)));
+	}
+#endif
+
+	/// Return false and leave result untouched for singular matrix, result may alias matrix.
+	inline bool InverseMatrix4(const float* matrix, float* result) {
+#if defined(GLVM_SIMD_SSE)
+		/// Blockwise inverse, matrix split into 2x2 blocks A B on top and C D on bottom.
+		__m128 row0 = _mm_load_ps(matrix);
+		__m128 row1 = _mm_load_ps(matrix + 4);
+		__m128 row2 = _mm_load_ps(matrix + 8);
+		__m128 row3 = _mm_load_ps(matrix + 12);
+		__m128 a = _mm_movelh_ps(row0, row1);
+		__m128 b = _mm_movehl_ps(row1, row0);
+		__m128 c = _mm_movelh_ps(row2, row3);
+		__m128 d = _mm_movehl_ps(row3, row2);
+
+		/// Determinants of all four blocks at once.
+		__m128 subDeterminants = _mm_sub_ps(
+			_mm_mul_ps(_mm_shuffle_ps(row0, row2, GLVM_SHUFFLE_MASK(0, 2, 0, 2)), _mm_shuffle_ps(row1, row3, GLVM_SHUFFLE_MASK(1, 3, 1, 3))),
+			_mm_mul_ps(_mm_shuffle_ps(row0, row2, GLVM_SHUFFLE_MASK(1, 3, 1, 3)), _mm_shuffle_ps(row1, row3, GLVM_SHUFFLE_MASK(0, 2, 0, 2))));
+		__m128 determinantA = GLVM_SWIZZLE(subDeterminants, 0, 0, 0, 0);
+		__m128 determinantB = GLVM_SWIZZLE(subDeterminants, 1, 1, 1, 1);
+		__m128 determinantC = GLVM_SWIZZLE(subDeterminants, 2, 2, 2, 2);
+		__m128 determinantD = GLVM_SWIZZLE(subDeterminants, 3, 3, 3, 3);
+
+		__m128 adjugateDC = AdjugateMultiply2x2(d, c);
+		__m128 adjugateAB = AdjugateMultiply2x2(a, b);
+		__m128 x = _mm_sub_ps(_mm_mul_ps(determinantD, a), Multiply2x2(b, adjugateDC));
+		__m128 w = _mm_sub_ps(_mm_mul_ps(determinantA, d), Multiply2x2(c, adjugateAB));
+		__m128 y = _mm_sub_ps(_mm_mul_ps(determinantB, c), MultiplyAdjugate2x2(d, adjugateAB));
+		__m128 z = _mm_sub_ps(_mm_mul_ps(determinantC, b), MultiplyAdjugate2x2(a, adjugateDC));
+
+		__m128 determinant = _mm_add_ps(_mm_mul_ps(determinantA, determinantD), _mm_mul_ps(determinantB, determinantC));
+		__m128 trace = _mm_mul_ps(adjugateAB, GLVM_SWIZZLE(adjugateDC, 0, 2, 1, 3));
+		trace = _mm_add_ps(trace, GLVM_SWIZZLE(trace, 1, 0, 3, 2));
+		trace = _mm_add_ps(trace, GLVM_SWIZZLE(trace, 2, 3, 0, 1));
+		determinant = _mm_sub_ps(determinant, trace);
+		if ( _mm_cvtss_f32(determinant) == 0.0f )
+			return false;
+
+		__m128 inverseDeterminant = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), determinant);
+		x = _mm_mul_ps(x, inverseDeterminant);
+		y = _mm_mul_ps(y, inverseDeterminant);
+		z = _mm_mul_ps(z, inverseDeterminant);
+		w = _mm_mul_ps(w, inverseDeterminant);
+
+		_mm_store_ps(result,      _mm_shuffle_ps(x, y, GLVM_SHUFFLE_MASK(3, 1, 3, 1)));
+		_mm_store_ps(result + 4,  _mm_shuffle_ps(x, y, GLVM_SHUFFLE_MASK(2, 0, 2, 0)));
+		_mm_store_ps(result + 8,  _mm_shuffle_ps(z, w, GLVM_SHUFFLE_MASK(3, 1, 3, 1)));
+		_mm_store_ps(result + 12, _mm_shuffle_ps(z, w, GLVM_SHUFFLE_MASK(2, 0, 2, 0)));
+		return true;
+#else
+		return InverseMatrix4Scalar(matrix, result);
+#endif
+	}
+
+	/// Hamilton product of quaternions stored as (w, x, y, z).
+	inline void MultiplyQuaternion(const float* first, const float* second, float* result) {
+#if defined(GLVM_SIMD_SSE)
+		/// Every component of first scales permutation of second with signs of product table.
+		__m128 rhs = _mm_loadu_ps(second);
+		__m128 sum = _mm_mul_ps(_mm_set1_ps(first[0]), rhs);
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(first[1]),
+										 _mm_xor_ps(GLVM_SWIZZLE(rhs, 1, 0, 3, 2), _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f))));
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(first[2]),
+										 _mm_xor_ps(GLVM_SWIZZLE(rhs, 2, 3, 0, 1), _mm_setr_ps(-0.0f, 0.0f, 0.0f, -0.0f))));
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(first[3]),
+										 _mm_xor_ps(GLVM_SWIZZLE(rhs, 3, 2, 1, 0), _mm_setr_ps(-0.0f, -0.0f, 0.0f, 0.0f))));
+		_mm_storeu_ps(result, sum);
+#else
+		float w = first[0] * second[0] - first[1] * second[1] - first[2] * second[2] - first[3] * second[3];
+		float x = first[0] * second[1] + first[1] * second[0] + first[2] * second[3] - first[3] * second[2];
+		float y = first[0] * second[2] - first[1] * second[3] + first[2] * second[0] + first[3] * second[1];
+		float z = first[0] * second[3] + first[1] * second[2] - first[2] * second[1] + first[3] * second[0];
+		result[0] = w;
+		result[1] = x;
+		result[2] = y;
+		result[3] = z;
+#endif
+	}
+
+	/*! Spheres given by separate arrays of center coordinates and radii, planes are (normal, distance)
+	 *  by four floats. visible[i] is 1 if sphere i is not fully behind any plane, else 0. Eight or four
+	 *  spheres tested at once, rest by scalar code with the same order of operations.
+	 */
+	inline void CullSpheres(const float* centersX, const float* centersY, const float* centersZ, const float* radii,
+							unsigned int count, const float* planes, unsigned int planesNumber, unsigned char* visible) {
+		unsigned int i = 0;
+#if defined(GLVM_SIMD_AVX)
+		for ( ; i + 8 <= count; i += 8 ) {
+			__m256 x = _mm256_loadu_ps(centersX + i);
+			__m256 y = _mm256_loadu_ps(centersY + i);
+			__m256 z = _mm256_loadu_ps(centersZ + i);
+			__m256 negativeRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(radii + i));
+			int mask = 0xFF;
+			for ( unsigned int p = 0; p < planesNumber && mask != 0; ++p ) {
+				const float* plane = planes + p * 4;
+				__m256 distance = _mm256_mul_ps(_mm256_set1_ps(plane[0]), x);
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane[1]), y));
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane[2]), z));
+				distance = _mm256_add_ps(distance, _mm256_set1_ps(plane[3]));
+				mask &= _mm256_movemask_ps(_mm256_cmp_ps(distance, negativeRadius, _CMP_GE_OQ));
+			}
+
+			for ( unsigned int j = 0; j < 8; ++j )
+				visible[i + j] = (mask >> j) & 1;
+		}
+#endif
+#if defined(GLVM_SIMD_SSE)
+		for ( ; i + 4 <= count; i += 4 ) {
+			__m128 x = _mm_loadu_ps(centersX + i);
+			__m128 y = _mm_loadu_ps(centersY + i);
+			__m128 z = _mm_loadu_ps(centersZ + i);
+			__m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radii + i));
+			int mask = 0xF;
+			for ( unsigned int p = 0; p < planesNumber && mask != 0; ++p ) {
+				const float* plane = planes + p * 4;
+				__m128 distance = _mm_mul_ps(_mm_set1_ps(plane[0]), x);
+				distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane[1]), y));
+				distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane[2]), z));
+				distance = _mm_add_ps(distance, _mm_set1_ps(plane[3]));
+				mask &= _mm_movemask_ps(_mm_cmpge_ps(distance, negativeRadius));
+			}
+
+			for ( unsigned int j = 0; j < 4; ++j )
+				visible[i + j] = (mask >> j) & 1;
+		}
+#endif
+		for ( ; i < count; ++i ) {
+			float negativeRadius = 0.0f - radii[i];
+			unsigned char inside = 1;
+			for ( unsigned int p = 0; p < planesNumber && inside; ++p ) {
+				const float* plane = planes + p * 4;
+				float distance = plane[0] * centersX[i] + plane[1] * centersY[i] + plane[2] * centersZ[i] + plane[3];
+				inside = distance >= negativeRadius;
+			}
+
+			visible[i] = inside;
+		}
+	}
+
+#if defined(GLVM_SIMD_SSE)
+	#undef GLVM_SWIZZLE
+	#undef GLVM_SHUFFLE_MASK
+#endif
+}
+
+#endif
@@ -0,0 +1,139 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "Archetype.hpp"
+
+namespace GLVM::ecs
+{
+	Archetype::Archetype(const Signature& signature_, core::vector<ComponentInfo>& componentsInfo) :
+		signature(signature_) {
+		for ( unsigned int i = 0; i < MAX_COMPONENT_TYPES_NUMBER; ++i ) {
+			columnIndices[i] = -1;
+			addEdges[i]      = nullptr;
+			removeEdges[i]   = nullptr;
+		}
+
+		for ( unsigned int typeID = 0; typeID < componentsInfo.GetSize(); ++typeID ) {
+			if ( !signature.test(typeID) )
+				continue;
+
+			columnIndices[typeID] = columns.GetSize();
+			componentTypes.Push(typeID);
+			columns.Push(componentsInfo[typeID]);
+		}
+
+		ComputeLayout();
+	}
+
+	Archetype::~Archetype() {
+		for ( unsigned int i = 0; i < entitiesNumber; ++i ) {
+			DestroyRow(i / chunkCapacity, i % chunkCapacity);
+		}
+
+		for ( unsigned int j = 0; j < chunks.GetSize(); ++j ) {
+			delete [] chunks[j].data;
+			delete [] chunks[j].versions;
+			chunks[j].data = nullptr;
+			chunks[j].versions = nullptr;
+		}
+	}
+
+	/*! Find the biggest number of rows that fits into one chunk with all columns aligned.
+	 *  If even one row bigger than ARCHETYPE_CHUNK_SIZE chunk holds exactly one row.
+	 */
+	void Archetype::ComputeLayout() {
+		unsigned int rowSize = sizeof(Entity);
+		for ( unsigned int i = 0; i < columns.GetSize(); ++i ) {
+			assert( columns[i].alignment <= alignof(std::max_align_t) );
+			rowSize += columns[i].size;
+		}
+
+		chunkCapacity = ARCHETYPE_CHUNK_SIZE / rowSize;
+		if ( chunkCapacity == 0 )
+			chunkCapacity = 1;
+
+		while ( true ) {
+			columnOffsets.clear();
+			unsigned int offset = sizeof(Entity) * chunkCapacity;
+			for ( unsigned int i = 0; i < columns.GetSize(); ++i ) {
+				unsigned int alignment = columns[i].alignment;
+				offset = (offset + alignment - 1) / alignment * alignment;
+				columnOffsets.Push(offset);
+				offset += columns[i].size * chunkCapacity;
+			}
+
+			if ( offset <= ARCHETYPE_CHUNK_SIZE || chunkCapacity == 1 ) {
+				chunkBytes = offset > ARCHETYPE_CHUNK_SIZE ? offset : ARCHETYPE_CHUNK_SIZE;
+				break;
+			}
+
+			--chunkCapacity;
+		}
+	}
+
+	void Archetype::AllocateRow(Entity entity, unsigned int& chunkIndex, unsigned int& row) {
+		chunkIndex = entitiesNumber / chunkCapacity;
+		row        = entitiesNumber % chunkCapacity;
+
+		if ( chunkIndex == chunks.GetSize() ) {                           ///< Chunks are never released, so only grow when all of them full.
+			Chunk chunk;
+			chunk.data = new unsigned char[chunkBytes];
+			chunk.versions = new std::atomic<unsigned int>[columns.GetSize() * 2]();
+			chunks.Push(chunk);
+		}
+
+		GetEntities(chunkIndex)[row] = entity;
+		++chunks[chunkIndex].count;
+		++entitiesNumber;
+	}
+
+	void Archetype::MoveRow(unsigned int sourceChunk, unsigned int sourceRow,
+							unsigned int destinationChunk, unsigned int destinationRow) {
+		for ( unsigned int i = 0; i < columns.GetSize(); ++i ) {
+			unsigned int componentTypeID = componentTypes[i];
+			void* source = GetComponent(componentTypeID, sourceChunk, sourceRow);
+			columns[i].moveConstruct(GetComponent(componentTypeID, destinationChunk, destinationRow), source);
+			columns[i].destroy(source);
+		}
+
+		GetEntities(destinationChunk)[destinationRow] = GetEntities(sourceChunk)[sourceRow];
+	}
+
+	bool Archetype::VacateRow(unsigned int chunkIndex, unsigned int row, Entity& movedEntity) {
+		assert( entitiesNumber > 0 );
+		unsigned int lastIndex = entitiesNumber - 1;
+		unsigned int lastChunk = lastIndex / chunkCapacity;
+		unsigned int lastRow   = lastIndex % chunkCapacity;
+
+		bool moved = false;
+		if ( lastChunk != chunkIndex || lastRow != row ) {
+			MoveRow(lastChunk, lastRow, chunkIndex, row);
+			movedEntity = GetEntities(chunkIndex)[row];
+			moved = true;
+		}
+
+		--chunks[lastChunk].count;
+		--entitiesNumber;
+		return moved;
+	}
+
+	void Archetype::DestroyRow(unsigned int chunkIndex, unsigned int row) {
+		for ( unsigned int i = 0; i < columns.GetSize(); ++i ) {
+			columns[i].destroy(GetComponent(componentTypes[i], chunkIndex, row));
+		}
+	}
+
+	void Archetype::TransferRow(unsigned int chunkIndex, unsigned int row, Archetype& destination,
+								unsigned int destinationChunk, unsigned int destinationRow) {
+		for ( unsigned int i = 0; i < columns.GetSize(); ++i ) {
+			unsigned int componentTypeID = componentTypes[i];
+			void* source = GetComponent(componentTypeID, chunkIndex, row);
+			if ( destination.HasComponent(componentTypeID) )
+				columns[i].moveConstruct(destination.GetComponent(componentTypeID, destinationChunk, destinationRow), source);
+
+			columns[i].destroy(source);
+		}
+	}
+}
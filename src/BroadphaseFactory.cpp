@@ -0,0 +1,25 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "BroadphaseFactory.hpp"
+#include "DynamicAabbTree.hpp"
+#include "SpatialHashBroadphase.hpp"
+#include "SweepAndPruneBroadphase.hpp"
+
+namespace GLVM::ecs
+{
+    IBroadphase* CBroadphaseFactory::CreateBroadphase(EBroadphaseType type)
+    {
+        switch ( type ) {
+        case eSPATIAL_HASH_BROADPHASE:
+            return new CSpatialHashBroadphase;
+        case eSWEEP_AND_PRUNE_BROADPHASE:
+            return new CSweepAndPruneBroadphase;
+        case eAABB_TREE_BROADPHASE:
+        default:
+            return new CAabbTreeBroadphase;
+        }
+    }
+}
@@ -4,6 +4,7 @@
 // License: http://opensource.org/licenses/MIT
 
 #include "ComponentManager.hpp"
+#include "EntityManager.hpp"
 
 namespace GLVM::ecs
 {
@@ -13,26 +14,159 @@ namespace GLVM::ecs
     ComponentManager::ComponentManager() = default;
     
     ComponentManager::~ComponentManager() {
-        for(int i = 0, iSize_Main = worldComponentsContainer.GetSize(); i < iSize_Main; ++i) {
-            delete worldComponentsContainer[i];
-            worldComponentsContainer[i] = nullptr;
+        for(unsigned int i = 0, iSize_Main = archetypes.GetSize(); i < iSize_Main; ++i) {
+            delete archetypes[i];
+            archetypes[i] = nullptr;
         }
-        for(int j = 0, iSize_Ordered = worldSparseEntitiesMapToComponents.GetSize(); j < iSize_Ordered; ++j) {
-            delete worldSparseEntitiesMapToComponents[j];
-            worldSparseEntitiesMapToComponents[j] = nullptr;
+        for(unsigned int j = 0, iSize_Containers = entityContainers.GetSize(); j < iSize_Containers; ++j) {
+            delete entityContainers[j];
+            entityContainers[j] = nullptr;
+        }
+        for(unsigned int k = 0, iSize_Queries = queries.GetSize(); k < iSize_Queries; ++k) {
+            delete queries[k];
+            queries[k] = nullptr;
         }
     }
 
-	bool ComponentManager::checkAvailability( core::vector<Entity>& sparse,
-											   core::vector<Entity>& dense,
-											   Entity entity ) {
-		return entity < sparse.GetSize() && sparse[entity] < dense.GetSize() && dense[sparse[entity]] == entity;
+	Archetype* ComponentManager::GetArchetype(const Signature& signature) {
+		std::lock_guard<std::mutex> lock(registryMutex);
+		for ( unsigned int i = 0; i < archetypes.GetSize(); ++i ) {
+			if ( archetypes[i]->signature == signature )
+				return archetypes[i];
+		}
+
+		Archetype* archetype = new Archetype(signature, componentsInfo);
+		archetypes.Push(archetype);
+		for ( unsigned int j = 0; j < queries.GetSize(); ++j )
+			queries[j]->TryMatch(archetype);
+
+		return archetype;
 	}
-	
-    unsigned int ComponentManager::GetContainerID() {
-        return componentsContainerID;
-    }
 
+	Archetype* ComponentManager::GetAddEdge(Archetype* source, unsigned int componentTypeID) {
+		if ( source == nullptr ) {
+			Signature signature;
+			signature.set(componentTypeID);
+			return GetArchetype(signature);
+		}
+
+		if ( source->addEdges[componentTypeID] == nullptr ) {
+			Signature signature = source->signature;
+			signature.set(componentTypeID);
+			Archetype* destination = GetArchetype(signature);
+			source->addEdges[componentTypeID]         = destination;
+			destination->removeEdges[componentTypeID] = source;
+		}
+
+		return source->addEdges[componentTypeID];
+	}
+
+	Archetype* ComponentManager::GetRemoveEdge(Archetype* source, unsigned int componentTypeID) {
+		if ( source->removeEdges[componentTypeID] == nullptr ) {
+			Signature signature = source->signature;
+			signature.reset(componentTypeID);
+			if ( signature.none() )
+				return nullptr;                                    ///< Last component removed, entity leave all tables.
+
+			Archetype* destination = GetArchetype(signature);
+			source->removeEdges[componentTypeID]   = destination;
+			destination->addEdges[componentTypeID] = source;
+		}
+
+		return source->removeEdges[componentTypeID];
+	}
+
+	void ComponentManager::MoveEntity(Entity entity, Archetype* destination) {
+		EntityLocation source = entityLocations[GetEntityIndex(entity)];
+		EntityLocation target;
+		target.archetype = destination;
+
+		{
+			std::lock_guard<std::mutex> lock(entityContainersMutex);
+			if ( source.archetype != nullptr )
+				staleEntityContainers |= source.archetype->signature;
+			if ( destination != nullptr )
+				staleEntityContainers |= destination->signature;
+		}
+
+		unsigned int version = GetChangeVersion();
+		if ( destination != nullptr ) {
+			destination->AllocateRow(entity, target.chunk, target.row);
+			destination->MarkChunkChanged(target.chunk, version);
+		}
+
+		if ( source.archetype != nullptr ) {
+			if ( destination != nullptr )
+				source.archetype->TransferRow(source.chunk, source.row, *destination, target.chunk, target.row);
+			else
+				source.archetype->DestroyRow(source.chunk, source.row);
+
+			Entity movedEntity;
+			if ( source.archetype->VacateRow(source.chunk, source.row, movedEntity) ) {    ///< Any 32-bit value is valid generational handle, so no sentinel.
+				entityLocations[GetEntityIndex(movedEntity)].chunk = source.chunk;
+				entityLocations[GetEntityIndex(movedEntity)].row   = source.row;
+				source.archetype->MarkChunkChanged(source.chunk, version);    ///< Other entity now in vacated row.
+			}
+		}
+
+		entityLocations[GetEntityIndex(entity)] = target;
+	}
+
+	void* ComponentManager::CreateComponent(const Entity& entity, unsigned int componentTypeID, void* value) {
+		unsigned int entityIndex = GetEntityIndex(entity);
+		assert( IsAlive(entity) );
+		if ( entityIndex >= entityLocations.GetSize() ) {
+			unsigned int doubledSize = entityLocations.GetSize() * 2;
+			entityLocations.Resize(entityIndex + 1 > doubledSize ? entityIndex + 1 : doubledSize);
+		}
+
+		ComponentInfo& info = componentsInfo[componentTypeID];
+		Archetype* source = entityLocations[entityIndex].archetype;
+		if ( source != nullptr && source->HasComponent(componentTypeID) ) {
+			EntityLocation& location = entityLocations[entityIndex];
+			void* component = source->GetComponent(componentTypeID, location.chunk, location.row);
+			if ( value != nullptr ) {
+				info.destroy(component);
+				info.moveConstruct(component, value);
+			}
+			source->MarkChanged(componentTypeID, location.chunk, GetChangeVersion());
+			return component;
+		}
+
+		MoveEntity(entity, GetAddEdge(source, componentTypeID));
+		EntityLocation& location = entityLocations[entityIndex];
+		void* component = location.archetype->GetComponent(componentTypeID, location.chunk, location.row);
+		if ( value != nullptr )
+			info.moveConstruct(component, value);
+		else
+			info.construct(component);
+
+		location.archetype->MarkAdded(componentTypeID, location.chunk, GetChangeVersion());
+		return component;
+	}
+
+	void ComponentManager::RemoveComponent(const Entity& entity, unsigned int componentTypeID) {
+		unsigned int entityIndex = GetEntityIndex(entity);
+		if ( entityIndex >= entityLocations.GetSize() )
+			return;
+
+		Archetype* source = entityLocations[entityIndex].archetype;
+		if ( source != nullptr && source->HasComponent(componentTypeID) ) {
+			MoveEntity(entity, GetRemoveEdge(source, componentTypeID));
+		}
+	}
+
+	void ComponentManager::RemoveAllComponents(Entity& entity) {
+		unsigned int entityIndex = GetEntityIndex(entity);
+		if ( entityIndex < entityLocations.GetSize() && entityLocations[entityIndex].archetype != nullptr )
+			MoveEntity(entity, nullptr);
+	}
+
+	bool ComponentManager::IsAlive(Entity entity) {
+		static EntityManager* entityManager = EntityManager::GetInstance();    ///< Mutex of singleton locked once, not on every component access.
+		return entityManager->IsAlive(entity);
+	}
+	
     ComponentManager* ComponentManager::GetInstance() {
         std::lock_guard<std::mutex> lock(Mutex_);
         if(pInstance_ == nullptr) {
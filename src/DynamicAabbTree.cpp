@@ -0,0 +1,342 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "DynamicAabbTree.hpp"
+
+namespace GLVM::ecs
+{
+	BroadphaseBox CDynamicAabbTree::Combine(const BroadphaseBox& first, const BroadphaseBox& second) {
+		BroadphaseBox box;
+		for ( int i = 0; i < 3; ++i ) {
+			box.min[i] = Min(first.min[i], second.min[i]);
+			box.max[i] = Max(first.max[i], second.max[i]);
+		}
+
+		return box;
+	}
+
+	float CDynamicAabbTree::Area(const BroadphaseBox& box) {
+		float x = box.max[0] - box.min[0];
+		float y = box.max[1] - box.min[1];
+		float z = box.max[2] - box.min[2];
+		return 2.0f * (x * y + y * z + z * x);
+	}
+
+	bool CDynamicAabbTree::Contain(const BroadphaseBox& outer, const BroadphaseBox& inner) {
+		return outer.min[0] <= inner.min[0] && outer.min[1] <= inner.min[1] && outer.min[2] <= inner.min[2] &&
+			inner.max[0] <= outer.max[0] && inner.max[1] <= outer.max[1] && inner.max[2] <= outer.max[2];
+	}
+
+	BroadphaseBox CDynamicAabbTree::Fatten(const BroadphaseBox& box, const vec3& displacement) {
+		BroadphaseBox fatBox;
+		for ( int i = 0; i < 3; ++i ) {
+			fatBox.min[i] = box.min[i] - AABB_TREE_FAT_MARGIN;
+			fatBox.max[i] = box.max[i] + AABB_TREE_FAT_MARGIN;
+
+			float stretch = displacement[i] * AABB_TREE_DISPLACEMENT_MULTIPLIER;
+			if ( stretch < 0.0f )
+				fatBox.min[i] += stretch;
+			else
+				fatBox.max[i] += stretch;
+		}
+
+		return fatBox;
+	}
+
+	unsigned int CDynamicAabbTree::AllocateNode() {
+		unsigned int node;
+		if ( freeList == AABB_TREE_NULL_NODE ) {
+			node = nodes.GetSize();
+			nodes.Push(Node());
+		} else {
+			node = freeList;
+			freeList = nodes[node].parent;
+		}
+
+		nodes[node].parent   = AABB_TREE_NULL_NODE;
+		nodes[node].child1   = AABB_TREE_NULL_NODE;
+		nodes[node].child2   = AABB_TREE_NULL_NODE;
+		nodes[node].height   = 0;
+		nodes[node].userData = 0;
+		return node;
+	}
+
+	void CDynamicAabbTree::FreeNode(unsigned int node) {
+		nodes[node].parent = freeList;
+		nodes[node].height = -1;
+		freeList = node;
+	}
+
+	/// Descend to sibling with the least growth of area, stop where new parent here is cheaper than going deeper.
+	void CDynamicAabbTree::InsertLeaf(unsigned int leaf) {
+		if ( root == AABB_TREE_NULL_NODE ) {
+			root = leaf;
+			nodes[leaf].parent = AABB_TREE_NULL_NODE;
+			return;
+		}
+
+		BroadphaseBox leafBox = nodes[leaf].box;
+		unsigned int index = root;
+		while ( !nodes[index].IsLeaf() ) {
+			const Node& node = nodes[index];
+			float area = Area(node.box);
+			float combinedArea = Area(Combine(node.box, leafBox));
+			float cost = 2.0f * combinedArea;                            ///< New parent for this node and leaf.
+			float inheritanceCost = 2.0f * (combinedArea - area);       ///< Growth of all ancestors when going deeper.
+
+			float childCosts[2];
+			unsigned int children[2] = { node.child1, node.child2 };
+			for ( int i = 0; i < 2; ++i ) {
+				const Node& child = nodes[children[i]];
+				float childCombinedArea = Area(Combine(leafBox, child.box));
+				childCosts[i] = (child.IsLeaf() ? childCombinedArea : childCombinedArea - Area(child.box)) + inheritanceCost;
+			}
+
+			if ( cost < childCosts[0] && cost < childCosts[1] )
+				break;
+
+			index = childCosts[0] < childCosts[1] ? children[0] : children[1];
+		}
+
+		unsigned int sibling = index;
+		unsigned int oldParent = nodes[sibling].parent;
+		unsigned int newParent = AllocateNode();                        ///< May move pool, no references above are used after.
+		nodes[newParent].parent = oldParent;
+		nodes[newParent].box    = Combine(leafBox, nodes[sibling].box);
+		nodes[newParent].height = nodes[sibling].height + 1;
+		nodes[newParent].child1 = sibling;
+		nodes[newParent].child2 = leaf;
+		nodes[sibling].parent   = newParent;
+		nodes[leaf].parent      = newParent;
+
+		if ( oldParent == AABB_TREE_NULL_NODE ) {
+			root = newParent;
+		} else if ( nodes[oldParent].child1 == sibling ) {
+			nodes[oldParent].child1 = newParent;
+		} else {
+			nodes[oldParent].child2 = newParent;
+		}
+
+		Refit(newParent);
+	}
+
+	void CDynamicAabbTree::RemoveLeaf(unsigned int leaf) {
+		if ( leaf == root ) {
+			root = AABB_TREE_NULL_NODE;
+			return;
+		}
+
+		unsigned int parent = nodes[leaf].parent;
+		unsigned int grandParent = nodes[parent].parent;
+		unsigned int sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+		nodes[sibling].parent = grandParent;
+		FreeNode(parent);
+		if ( grandParent == AABB_TREE_NULL_NODE ) {
+			root = sibling;
+			return;
+		}
+
+		if ( nodes[grandParent].child1 == parent )
+			nodes[grandParent].child1 = sibling;
+		else
+			nodes[grandParent].child2 = sibling;
+
+		Refit(grandParent);
+	}
+
+	/// Walk to root, balance every ancestor and recompute its box and height.
+	void CDynamicAabbTree::Refit(unsigned int node) {
+		while ( node != AABB_TREE_NULL_NODE ) {
+			node = Balance(node);
+
+			Node& current = nodes[node];
+			const Node& child1 = nodes[current.child1];
+			const Node& child2 = nodes[current.child2];
+			current.height = 1 + (child1.height > child2.height ? child1.height : child2.height);
+			current.box    = Combine(child1.box, child2.box);
+			node = current.parent;
+		}
+	}
+
+	/*! If one child of node is higher than other by more than one level, higher child rotated up
+	 *  and takes place of node. Return index of node that is on place of old one now.
+	 */
+	unsigned int CDynamicAabbTree::Balance(unsigned int indexA) {
+		Node& a = nodes[indexA];
+		if ( a.IsLeaf() || a.height < 2 )
+			return indexA;
+
+		unsigned int indexB = a.child1;
+		unsigned int indexC = a.child2;
+		Node& b = nodes[indexB];
+		Node& c = nodes[indexC];
+		int balance = c.height - b.height;
+
+		if ( balance > 1 || balance < -1 ) {
+			bool rotateC = balance > 1;
+			unsigned int indexUp = rotateC ? indexC : indexB;             ///< Child moved up.
+			Node& up   = rotateC ? c : b;
+			Node& stay = rotateC ? b : c;                               ///< Child left under node.
+			unsigned int indexF = up.child1;
+			unsigned int indexG = up.child2;
+			Node& f = nodes[indexF];
+			Node& g = nodes[indexG];
+
+			up.child1 = indexA;
+			up.parent = a.parent;
+			a.parent  = indexUp;
+			if ( up.parent == AABB_TREE_NULL_NODE ) {
+				root = indexUp;
+			} else if ( nodes[up.parent].child1 == indexA ) {
+				nodes[up.parent].child1 = indexUp;
+			} else {
+				nodes[up.parent].child2 = indexUp;
+			}
+
+			/// Higher grandchild stays with moved child, lower one goes under old node.
+			bool keepF = f.height > g.height;
+			unsigned int indexKept  = keepF ? indexF : indexG;
+			unsigned int indexMoved = keepF ? indexG : indexF;
+			Node& kept  = keepF ? f : g;
+			Node& moved = keepF ? g : f;
+
+			up.child2 = indexKept;
+			if ( rotateC )
+				a.child2 = indexMoved;
+			else
+				a.child1 = indexMoved;
+			moved.parent = indexA;
+
+			a.box     = Combine(stay.box, moved.box);
+			a.height  = 1 + (stay.height > moved.height ? stay.height : moved.height);
+			up.box    = Combine(a.box, kept.box);
+			up.height = 1 + (a.height > kept.height ? a.height : kept.height);
+			return indexUp;
+		}
+
+		return indexA;
+	}
+
+	unsigned int CDynamicAabbTree::CreateProxy(const BroadphaseBox& box, unsigned int userData) {
+		unsigned int proxy = AllocateNode();
+		nodes[proxy].box      = Fatten(box, vec3(0.0f, 0.0f, 0.0f));
+		nodes[proxy].userData = userData;
+		InsertLeaf(proxy);
+		++proxiesNumber;
+		return proxy;
+	}
+
+	void CDynamicAabbTree::DestroyProxy(unsigned int proxy) {
+		assert( proxy < nodes.GetSize() && nodes[proxy].height == 0 );
+		RemoveLeaf(proxy);
+		FreeNode(proxy);
+		--proxiesNumber;
+	}
+
+	bool CDynamicAabbTree::MoveProxy(unsigned int proxy, const BroadphaseBox& box, const vec3& displacement) {
+		assert( proxy < nodes.GetSize() && nodes[proxy].height == 0 );
+		BroadphaseBox fatBox = Fatten(box, displacement);
+		const BroadphaseBox& treeBox = nodes[proxy].box;
+		if ( Contain(treeBox, box) ) {
+			/// Leaf box grown by fast movement shrinks back when actor slows down.
+			BroadphaseBox hugeBox = fatBox;
+			for ( int i = 0; i < 3; ++i ) {
+				hugeBox.min[i] -= 4.0f * AABB_TREE_FAT_MARGIN;
+				hugeBox.max[i] += 4.0f * AABB_TREE_FAT_MARGIN;
+			}
+
+			if ( Contain(hugeBox, treeBox) )
+				return false;
+		}
+
+		RemoveLeaf(proxy);
+		nodes[proxy].box = fatBox;
+		InsertLeaf(proxy);
+		return true;
+	}
+
+	/*! Descend tree against itself. Pair of nodes pushed only if their boxes overlap, so whole
+	 *  subtrees far from each other are skipped by one test instead of querying every leaf.
+	 */
+	void CDynamicAabbTree::CollectPairs(core::vector<BroadphasePair>& pairs) const {
+		if ( root == AABB_TREE_NULL_NODE || nodes[root].IsLeaf() )
+			return;
+
+		struct NodePair
+		{
+			unsigned int first;
+			unsigned int second;                                         ///< Equal to first for test of subtree against itself.
+		};
+
+		NodePair stack[AABB_TREE_STACK_SIZE];
+		unsigned int stackSize = 0;
+		stack[stackSize++] = NodePair{ root, root };
+		while ( stackSize > 0 ) {
+			NodePair pair = stack[--stackSize];
+			const Node& first = nodes[pair.first];
+			const Node& second = nodes[pair.second];
+			assert( stackSize + 3 <= AABB_TREE_STACK_SIZE );
+
+			if ( pair.first == pair.second ) {
+				if ( first.IsLeaf() )
+					continue;
+
+				stack[stackSize++] = NodePair{ first.child1, first.child2 };
+				stack[stackSize++] = NodePair{ first.child1, first.child1 };
+				stack[stackSize++] = NodePair{ first.child2, first.child2 };
+				continue;
+			}
+
+			if ( !BoxOverlap(first.box, second.box) )
+				continue;
+
+			if ( first.IsLeaf() && second.IsLeaf() ) {
+				pairs.Push(first.userData < second.userData ? BroadphasePair{ first.userData, second.userData } :
+						   BroadphasePair{ second.userData, first.userData });
+			} else if ( second.IsLeaf() || (!first.IsLeaf() && first.height >= second.height) ) {
+				stack[stackSize++] = NodePair{ first.child1, pair.second };
+				stack[stackSize++] = NodePair{ first.child2, pair.second };
+			} else {
+				stack[stackSize++] = NodePair{ pair.first, second.child1 };
+				stack[stackSize++] = NodePair{ pair.first, second.child2 };
+			}
+		}
+	}
+
+	/// Create leaf for new collider, otherwise refit it. Static collider never leaves its fat box, so tree stays untouched.
+	void CAabbTreeBroadphase::UpdateProxy(Entity entity, const BroadphaseBox& box, const vec3& displacement) {
+		unsigned int entityIndex = GetEntityIndex(entity);
+		while ( proxies.GetSize() <= entityIndex )
+			proxies.Push(ColliderProxy());
+
+		ColliderProxy& colliderProxy = proxies[entityIndex];
+		if ( colliderProxy.proxy == AABB_TREE_NULL_NODE ) {
+			colliderProxy.proxy = tree.CreateProxy(box, entity);
+		} else {
+			tree.MoveProxy(colliderProxy.proxy, box, displacement);
+			tree.SetUserData(colliderProxy.proxy, entity);               ///< Index may be reused by new entity.
+		}
+
+		colliderProxy.frame = frame;
+	}
+
+	/// Entity removed or lost collider since last update.
+	void CAabbTreeBroadphase::EndUpdate() {
+		for ( unsigned int i = 0; i < proxies.GetSize(); ++i ) {
+			if ( proxies[i].proxy != AABB_TREE_NULL_NODE && proxies[i].frame != frame ) {
+				tree.DestroyProxy(proxies[i].proxy);
+				proxies[i].proxy = AABB_TREE_NULL_NODE;
+			}
+		}
+	}
+
+	void CAabbTreeBroadphase::QueryRay(const vec3& origin, const vec3& ray, core::vector<Entity>& entities) const {
+		tree.QueryRay(origin, ray, [&](unsigned int proxy) {
+			entities.Push(tree.GetUserData(proxy));
+			return true;
+		});
+	}
+}
@@ -67,17 +67,22 @@ namespace GLVM::core
 		chrono                   = Time::CTimerCreator().Create();
 		soundEngine              = Sound::CSoundEngineFactory().CreateSoundEngine();
 
-		collisionSystem          = new ecs::CCollisionSystem(Input_Stack_);
+		collisionSystem          = new ecs::CCollisionSystem(Input_Stack_, ecs::eAABB_TREE_BROADPHASE);
 		movementSystem           = new ecs::CMovementSystem(Input_Stack_);
 		physicsSystem            = new ecs::CPhysicsSystem(gravity, Input_Stack_);
 		projectileSystem         = new ecs::CProjectileSystem(Input_Stack_);
+		interpolationSystem      = new ecs::CInterpolationSystem();
+		transformSystem          = new ecs::CTransformSystem();
+		animationSystem          = new ecs::CAnimationSystem();
         
 		deltaFrameTime             = 0.0;
+		gravity                    = 0.0f;
 		g_eEvent.SetEvent(eDEFAULT);
 
 		ecs::CSystemManager* pSystem_Manager = ecs::CSystemManager::GetInstance();
 
 		///< Call of ActivateSystem function must be in this order.
+		pSystem_Manager->ActivateSystem(interpolationSystem);
 		pSystem_Manager->ActivateSystem(movementSystem);
 		pSystem_Manager->ActivateSystem(projectileSystem);
 		pSystem_Manager->ActivateSystem(collisionSystem);
@@ -109,15 +114,38 @@ namespace GLVM::core
 
 	void Engine::EventQueueFlush() {
 	}
+
+	/// Run as many fixed steps as frame time allows, systems never see variable delta.
+	void Engine::Simulate(float frameTime) {
+		ecs::CSystemManager* pSystem_Manager = ecs::CSystemManager::GetInstance();
+		float step = fixedTimestep.GetStep();
+
+		unsigned int substeps = fixedTimestep.Advance(frameTime);
+		for ( unsigned int i = 0; i < substeps; ++i ) {
+			gravity += step;
+			movementSystem->deltaFrameTime            = step;
+			movementSystem->gravity                   = gravity;
+			collisionSystem->fDelta_Time_             = step;
+			collisionSystem->gravity                  = gravity;
+			projectileSystem->deltaFrameTime          = step;
+			projectileSystem->soundEngine             = soundEngine;
+			physicsSystem->fDelta_Time_               = step;
+			physicsSystem->fAcceleration_of_Gravity_ += (step / 20);
+			physicsSystem->gravity                    = gravity;
+			pSystem_Manager->Update();
+			Input_Stack_.ReleaseLatched();
+		}
+	}
 	
 	void Engine::RenderOpengl() {
-		ecs::CSystemManager* pSystem_Manager = ecs::CSystemManager::GetInstance();
 		bool bGame_Loop_Active = true;
 
 		projectileSystem->textureHandlers = textureHandlers;
 		
 		openglRenderer = new COpenglRenderer();
 		openglRenderer->textureVector = textureVector;
+		openglRenderer->colliderBroadphase = &collisionSystem->GetBroadphase();
+		openglRenderer->animationSystem    = animationSystem;
 		openglRenderer->pathsArray_            = pathsArray_;
 		openglRenderer->pathsGLTF_             = pathsGLTF_;
 		openglRenderer->run();
@@ -146,7 +174,6 @@ namespace GLVM::core
 		while(bGame_Loop_Active) {
 			deltaFrameTime = chrono->GetElapsed();
 			chrono->Reset();
-		    gravity += deltaFrameTime;
 
 			openglRenderer->Window.ClearDisplay();
              
@@ -162,17 +189,12 @@ namespace GLVM::core
 								  &g_eEvent.mousePointerPosition.offset_X,
 								  &g_eEvent.mousePointerPosition.offset_Y);
 
-			movementSystem->deltaFrameTime            = deltaFrameTime;
-			movementSystem->gravity                   = gravity;
-			collisionSystem->fDelta_Time_             = deltaFrameTime;
-			collisionSystem->gravity                  = gravity;
-			projectileSystem->deltaFrameTime          = deltaFrameTime;
-			projectileSystem->soundEngine             = soundEngine;
-			physicsSystem->fDelta_Time_               = deltaFrameTime;
-			physicsSystem->fAcceleration_of_Gravity_ += (deltaFrameTime / 20);
-			physicsSystem->gravity                    = gravity;
-			openglRenderer->EnlargeFrameAccumulator(deltaFrameTime);
-			pSystem_Manager->Update();
+			Simulate(deltaFrameTime);
+			transformSystem->interpolationAlpha       = fixedTimestep.GetAlpha();
+			transformSystem->Update();
+			animationSystem->deltaFrameTime           = deltaFrameTime;
+			animationSystem->Update();
+			openglRenderer->SetInterpolationAlpha(fixedTimestep.GetAlpha());
 			openglRenderer->draw();
 			openglRenderer->Window.SwapBuffers();
 		}
@@ -181,7 +203,6 @@ namespace GLVM::core
 	}
 	
 	void Engine::RenderVulkan() {
-		ecs::CSystemManager* pSystem_Manager = ecs::CSystemManager::GetInstance();
 		bool bGame_Loop_Active = true;
 
 		projectileSystem->textureHandlers = textureHandlers;
@@ -189,6 +210,7 @@ namespace GLVM::core
 		
 		vulkanRenderer = new CVulkanRenderer();
 		vulkanRenderer->initializeTextureData_ = textureVector;
+		vulkanRenderer->animationSystem        = animationSystem;
 		vulkanRenderer->pathsArray_            = pathsArray_;
 		vulkanRenderer->pathsGLTF_             = pathsGLTF_;
 		vulkanRenderer->run();
@@ -222,7 +244,6 @@ namespace GLVM::core
 		while(bGame_Loop_Active) {
 			deltaFrameTime = chrono->GetElapsed();
 			chrono->Reset();
-		    gravity += deltaFrameTime;
 
 			vulkanRenderer->Window.ClearDisplay();
              
@@ -238,17 +259,12 @@ namespace GLVM::core
 								  &g_eEvent.mousePointerPosition.offset_X,
 								  &g_eEvent.mousePointerPosition.offset_Y);
 
-			movementSystem->deltaFrameTime            = deltaFrameTime;
-			movementSystem->gravity                   = gravity;
-			collisionSystem->fDelta_Time_             = deltaFrameTime;
-			collisionSystem->gravity                  = gravity;
-			projectileSystem->deltaFrameTime          = deltaFrameTime;
-			projectileSystem->soundEngine             = soundEngine;
-			physicsSystem->fDelta_Time_               = deltaFrameTime;
-			physicsSystem->fAcceleration_of_Gravity_ += (deltaFrameTime / 20);
-			physicsSystem->gravity                    = gravity;
-			vulkanRenderer->EnlargeFrameAccumulator(deltaFrameTime);
-			pSystem_Manager->Update();
+			Simulate(deltaFrameTime);
+			transformSystem->interpolationAlpha       = fixedTimestep.GetAlpha();
+			transformSystem->Update();
+			animationSystem->deltaFrameTime           = deltaFrameTime;
+			animationSystem->Update();
+			vulkanRenderer->SetInterpolationAlpha(fixedTimestep.GetAlpha());
 			vulkanRenderer->draw();
 			vulkanRenderer->Window.SwapBuffers();
 		}
@@ -0,0 +1,146 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "EntityCommandBuffer.hpp"
+#include <algorithm>
+
+namespace GLVM::ecs
+{
+	EntityCommandBuffer::~EntityCommandBuffer() {
+		Clear();
+		for ( unsigned int i = 0; i < payloadBlocks.GetSize(); ++i ) {
+			delete [] payloadBlocks[i];
+			payloadBlocks[i] = nullptr;
+		}
+	}
+
+	void* EntityCommandBuffer::AllocatePayload(unsigned int size, unsigned int alignment) {
+		if ( size > COMMAND_PAYLOAD_BLOCK_SIZE ) {
+			unsigned char* largePayload = new unsigned char[size];
+			largePayloads.Push(largePayload);
+			return largePayload;
+		}
+
+		unsigned int offset = (currentBlockOffset + alignment - 1) / alignment * alignment;
+		if ( currentBlock < payloadBlocks.GetSize() && offset + size > COMMAND_PAYLOAD_BLOCK_SIZE ) {
+			++currentBlock;
+			offset = 0;
+		}
+
+		if ( currentBlock == payloadBlocks.GetSize() ) {
+			payloadBlocks.Push(new unsigned char[COMMAND_PAYLOAD_BLOCK_SIZE]);
+			offset = 0;
+		}
+
+		currentBlockOffset = offset + size;
+		return payloadBlocks[currentBlock] + offset;
+	}
+
+	void EntityCommandBuffer::Record(ECommandType type, Entity entity, unsigned int componentTypeID, void* payload) {
+		Command command;
+		command.type            = type;
+		command.entity          = entity;
+		command.componentTypeID = componentTypeID;
+		command.sequence        = commands.size();
+		command.payload         = payload;
+		commands.push_back(command);
+	}
+
+	void EntityCommandBuffer::DestroyPayloads() {
+		ComponentManager* componentManager = ComponentManager::GetInstance();
+		for ( unsigned int i = 0; i < commands.size(); ++i ) {
+			if ( commands[i].payload != nullptr ) {
+				componentManager->componentsInfo[commands[i].componentTypeID].destroy(commands[i].payload);
+				commands[i].payload = nullptr;
+			}
+		}
+	}
+
+	Entity EntityCommandBuffer::CreateEntity() {
+		Entity entity = EntityManager::GetInstance()->CreateEntity();
+		createdEntities.Push(entity);
+		return entity;
+	}
+
+	void EntityCommandBuffer::DestroyEntity(Entity entity) {
+		destroyedEntities.Push(entity);
+	}
+
+	void EntityCommandBuffer::Playback(ComponentManager* componentManager, EntityManager* entityManager) {
+		Command* begin = commands.data();
+		Command* end = begin + commands.size();
+		Entity* destroyedBegin = destroyedEntities.GetVectorContainer();
+		Entity* destroyedEnd = destroyedBegin + destroyedEntities.GetSize();
+
+		/// Batch by component type, so one table transition edge used for all entities in a row.
+		std::sort(begin, end, [](const Command& first, const Command& second) {
+			if ( first.componentTypeID != second.componentTypeID )
+				return first.componentTypeID < second.componentTypeID;
+			if ( GetEntityIndex(first.entity) != GetEntityIndex(second.entity) )
+				return GetEntityIndex(first.entity) < GetEntityIndex(second.entity);
+			return first.sequence < second.sequence;
+		});
+		std::sort(destroyedBegin, destroyedEnd);
+
+		for ( Command* command = begin; command != end; ++command ) {
+			if ( !entityManager->IsAlive(command->entity) ||
+				 std::binary_search(destroyedBegin, destroyedEnd, command->entity) )
+				continue;                                                    ///< Payload destroyed below.
+
+			switch ( command->type ) {
+			case eADD_COMPONENT:
+				componentManager->CreateComponent(command->entity, command->componentTypeID, command->payload);
+				break;
+			case eSET_COMPONENT:
+			{
+				unsigned int entityIndex = GetEntityIndex(command->entity);
+				if ( entityIndex >= componentManager->entityLocations.GetSize() )
+					break;
+
+				Archetype* archetype = componentManager->entityLocations[entityIndex].archetype;
+				if ( archetype != nullptr && archetype->HasComponent(command->componentTypeID) )
+					componentManager->CreateComponent(command->entity, command->componentTypeID, command->payload);
+			}
+				break;
+			case eREMOVE_COMPONENT:
+				componentManager->RemoveComponent(command->entity, command->componentTypeID);
+				break;
+			default:
+				break;
+			}
+		}
+
+		for ( Entity* entity = destroyedBegin; entity != destroyedEnd; ++entity )
+			entityManager->RemoveEntity(*entity, componentManager);
+
+		createdEntities.clear();                                         ///< Played back, so created entities stay.
+		Clear();
+	}
+
+	void EntityCommandBuffer::Clear() {
+		DestroyPayloads();
+		commands.clear();
+		destroyedEntities.clear();
+
+		if ( createdEntities.GetSize() > 0 ) {
+			EntityManager* entityManager = EntityManager::GetInstance();
+			ComponentManager* componentManager = ComponentManager::GetInstance();
+			for ( unsigned int i = 0; i < createdEntities.GetSize(); ++i ) {
+				Entity entity = createdEntities[i];
+				if ( entityManager->IsAlive(entity) )
+					entityManager->RemoveEntity(entity, componentManager);
+			}
+			createdEntities.clear();
+		}
+
+		for ( unsigned int i = 0; i < largePayloads.GetSize(); ++i ) {
+			delete [] largePayloads[i];
+			largePayloads[i] = nullptr;
+		}
+		largePayloads.clear();
+		currentBlock = 0;
+		currentBlockOffset = 0;
+	}
+}
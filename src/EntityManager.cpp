@@ -13,7 +13,11 @@ namespace GLVM::ecs
     std::mutex EntityManager::Mutex_;
     
     EntityManager::EntityManager() {}
-    EntityManager::~EntityManager() {}
+    EntityManager::~EntityManager()
+    {
+		for ( unsigned int i = 0; i < ENTITY_SLOTS_PAGES_NUMBER; ++i )
+			delete[] slotPages[i];
+    }
     
     EntityManager* EntityManager::GetInstance()
     {
@@ -27,47 +31,64 @@ namespace GLVM::ecs
     
     [[nodiscard]] Entity_ID EntityManager::CreateEntity()
     {
-		Entity_ID _Entity_ID;
-		
-        if(tRemoved_Entity_Registry_.GetSize() > k_iNull)    ///< Check out wether or not free ID in removed entities registry.
+		std::lock_guard<std::mutex> lock(slotsMutex);
+		unsigned int index;
+		unsigned int usedSlotsNumber = slotsNumber.load(std::memory_order_relaxed);
+
+        if(freeSlotsNumber > MINIMUM_FREE_ENTITY_SLOTS ||
+		   (freeSlotsNumber > 0 && usedSlotsNumber > ENTITY_INDEX_MASK))    ///< Take oldest removed slot from free list.
         {
-            _Entity_ID = tRemoved_Entity_Registry_.GetFirstItem();
-            tActive_Entity_Registry_.Push(tRemoved_Entity_Registry_.GetFirstItem());
-            tRemoved_Entity_Registry_.RemoveFirstItem();
+			index = freeSlotsHead;
+			freeSlotsHead = GetSlot(index).nextFreeSlot;
+			if ( freeSlotsHead == k_iUint_Max )
+				freeSlotsTail = k_iUint_Max;
+			GetSlot(index).nextFreeSlot = k_iUint_Max;
+			--freeSlotsNumber;
         }
         else
         {
-            tActive_Entity_Registry_.Push(u_iID);
-            _Entity_ID = u_iID;
-            ++u_iID;
-
+			index = usedSlotsNumber;
+			assert( index <= ENTITY_INDEX_MASK );
+			EntitySlot*& page = slotPages[index >> ENTITY_SLOTS_PAGE_BITS];
+			if ( page == nullptr )
+				page = new EntitySlot[ENTITY_SLOTS_PAGE_SIZE];
+			slotsNumber.store(index + 1, std::memory_order_release);      ///< Page visible to IsAlive before slot is counted.
         }
-		return _Entity_ID;
+
+		++aliveEntitiesNumber;
+		return MakeEntity(index, GetSlot(index).generation.load(std::memory_order_relaxed));
     }
 
     /**************************************************************************************
-     * Dont need to delete real component in this method. Because systems dont work with
-     * component without indices for that component in ordered container.
+     * Removal changes generation of slot, so all existing handles of removed entity become
+     * stale and IsAlive return false for them. Removal of stale handle is ignored. Slot that
+     * used its last generation is retired instead of going to free list, so generation never
+     * wraps and old handle never match new entity.
      **************************************************************************************/
         
     void EntityManager::RemoveEntity(Entity_ID& _Entity_ID, ComponentManager* _ComponentManager)
     {
-        // for(int i = 0, iSize = _ComponentManager->worldSparseEntitiesMapToComponents.GetSize(); i < iSize; ++i) {
-        //     // static_cast<core::vector<unsigned int>*>(_ComponentManager->tWorld_IDs_Container[i])->RemoveItem(_Entity_ID);
-		// 	core::vector<unsigned int>& vector =
-		// 		*(static_cast<core::vector<unsigned int>*>
-		// 		  (_ComponentManager->worldSparseEntitiesMapToComponents[i]));
-		// 	core::VectorIterator<unsigned int> iterator = vector.Find(_Entity_ID);
-		// 	if ( !iterator.ValidStatus() )
-		// 		continue;
-
-		// 	vector.Swap(iterator.Current(), vector.GetHead());
-		// 	vector.Pop();
-        // }
+		if ( !IsAlive(_Entity_ID) )
+			return;
 
 		_ComponentManager->RemoveAllComponents(_Entity_ID);
-		tActive_Entity_Registry_[_Entity_ID] = k_iUint_Max;  
-		tRemoved_Entity_Registry_.Push(_Entity_ID);
+
+		std::lock_guard<std::mutex> lock(slotsMutex);
+		unsigned int index = GetEntityIndex(_Entity_ID);
+		EntitySlot& slot = GetSlot(index);
+		unsigned int generation = slot.generation.load(std::memory_order_relaxed);
+		--aliveEntitiesNumber;
+		if ( generation == ENTITY_GENERATION_MASK ) {
+			slot.generation.store(RETIRED_SLOT_GENERATION, std::memory_order_release);
+			return;
+		}
+
+		slot.generation.store(generation + 1, std::memory_order_release);
+		if ( freeSlotsTail == k_iUint_Max )
+			freeSlotsHead = index;
+		else
+			GetSlot(freeSlotsTail).nextFreeSlot = index;
+		freeSlotsTail = index;
+		++freeSlotsNumber;
     }
 }
-
@@ -0,0 +1,82 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "FrustumCuller.hpp"
+#include "VertexMathSimd.hpp"
+#include <cmath>
+#include <limits>
+
+namespace GLVM::core
+{
+	void CFrustumCuller::BeginFrame(unsigned int objectsNumber) {
+		centersX.Resize(objectsNumber);
+		centersY.Resize(objectsNumber);
+		centersZ.Resize(objectsNumber);
+		radii.Resize(objectsNumber);
+		boxes.Resize(objectsNumber);
+		sphereVisibility.Resize(objectsNumber);
+		frameStats = CullingStats();
+	}
+
+	/// modelMatrix[i] is axis i of mesh in world and modelMatrix[3] is translation, same as shaders read it.
+	void CFrustumCuller::SetBounds(unsigned int object, const MeshBounds& bounds, const mat4& modelMatrix) {
+		ecs::BroadphaseBox& box = boxes[object];
+		float sphereCenter[3];
+		for ( unsigned int j = 0; j < 3; ++j ) {
+			float boxCenter = modelMatrix[3][j];
+			float boxExtent = 0.0f;
+			sphereCenter[j] = modelMatrix[3][j];
+			for ( unsigned int i = 0; i < 3; ++i ) {
+				boxCenter += modelMatrix[i][j] * (bounds.min[i] + bounds.max[i]) * 0.5f;
+				boxExtent += std::fabs(modelMatrix[i][j]) * (bounds.max[i] - bounds.min[i]) * 0.5f;
+				sphereCenter[j] += modelMatrix[i][j] * bounds.sphere[i];
+			}
+
+			box.min[j] = boxCenter - boxExtent;
+			box.max[j] = boxCenter + boxExtent;
+		}
+
+		float scaleSquared = 0.0f;
+		for ( unsigned int i = 0; i < 3; ++i )
+			scaleSquared = Max(scaleSquared, modelMatrix[i][0] * modelMatrix[i][0] + modelMatrix[i][1] * modelMatrix[i][1] +
+							   modelMatrix[i][2] * modelMatrix[i][2]);
+
+		centersX[object] = sphereCenter[0];
+		centersY[object] = sphereCenter[1];
+		centersZ[object] = sphereCenter[2];
+		radii[object] = bounds.sphere[3] * std::sqrt(scaleSquared);
+	}
+
+	void CFrustumCuller::SetUnbounded(unsigned int object) {
+		centersX[object] = 0.0f;
+		centersY[object] = 0.0f;
+		centersZ[object] = 0.0f;
+		radii[object] = std::numeric_limits<float>::infinity();
+	}
+
+	/// Box test only for objects that passed sphere test, most culled objects never touch their box.
+	void CFrustumCuller::Cull(const vec4* planes, unsigned int planesNumber, core::vector<unsigned int>& visibleObjects) {
+		visibleObjects.clear();
+		unsigned int objectsNumber = radii.GetSize();
+		if ( objectsNumber == 0 )
+			return;
+
+		simd::CullSpheres(&centersX[0], &centersY[0], &centersZ[0], &radii[0], objectsNumber,
+						  &planes[0][0], planesNumber, &sphereVisibility[0]);
+
+		float infinity = std::numeric_limits<float>::infinity();
+		for ( unsigned int i = 0; i < objectsNumber; ++i )
+			if ( sphereVisibility[i] && (radii[i] == infinity || ecs::FrustumOverlap(boxes[i], planes, planesNumber)) )
+				visibleObjects.Push(i);
+
+		unsigned int visibleNumber = visibleObjects.GetSize();
+		frameStats.tested  += objectsNumber;
+		frameStats.visible += visibleNumber;
+		frameStats.culled  += objectsNumber - visibleNumber;
+		totalStats.tested  += objectsNumber;
+		totalStats.visible += visibleNumber;
+		totalStats.culled  += objectsNumber - visibleNumber;
+	}
+}
@@ -108,6 +108,8 @@ namespace GLVM::core
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 		
 		coreShaderProgram->Use();
+		Raycasting();                                                        ///< Once per frame, so removed projectiles dont get in sceneEntities.
+		CollectSceneEntities();
 		
 		core::vector<unsigned int>* pEntityContainerRefDirectionalLight =
 			pComponent_Manager->GetEntityContainer<cm::directionalLight>();
@@ -199,7 +201,9 @@ namespace GLVM::core
 		ComputeSpotLight();
 
 	    EvaluateCoreShader();
-		RenderScene(coreShaderProgram);
+		vec4 cameraPlanes[core::FRUSTUM_PLANES_NUMBER];
+		core::ExtractFrustumPlanes(cameraViewMatrix * cameraProjectionMatrix, cameraPlanes);
+		RenderScene(coreShaderProgram, cameraPlanes, core::FRUSTUM_PLANES_NUMBER);
 	}
 
 	void COpenglRenderer::AllocateTextureMemory(std::vector<unsigned int>& shadowMapFBOcontainer,
@@ -281,7 +285,9 @@ namespace GLVM::core
 		glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
 		pGLBind_Framebuffer(GL_FRAMEBUFFER, shadowMapFBO);
 		glClear(GL_DEPTH_BUFFER_BIT);
-		RenderScene(flatShadowMapShaderProgram);
+		vec4 lightPlanes[core::FRUSTUM_PLANES_NUMBER];
+		core::ExtractFrustumPlanes(lightSpaceMatrix, lightPlanes);
+		RenderScene(flatShadowMapShaderProgram, lightPlanes, core::FRUSTUM_PLANES_NUMBER);
 		pGLBind_Framebuffer(GL_FRAMEBUFFER, 0);
 
 		return lightSpaceMatrix;
@@ -301,7 +307,9 @@ namespace GLVM::core
 			glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
 			pGLBind_Framebuffer(GL_FRAMEBUFFER, shadowMapFBO);
 			glClear(GL_DEPTH_BUFFER_BIT);
-			RenderScene(flatShadowMapShaderProgram);
+			vec4 lightPlanes[core::FRUSTUM_PLANES_NUMBER];
+			core::ExtractFrustumPlanes(lightSpaceMatrix, lightPlanes);
+			RenderScene(flatShadowMapShaderProgram, lightPlanes, core::FRUSTUM_PLANES_NUMBER);
 			pGLBind_Framebuffer(GL_FRAMEBUFFER, 0);
 
 			return lightSpaceMatrix;
@@ -326,7 +334,10 @@ namespace GLVM::core
 					cubeShadowMapShaderProgram->SetMat4("shadowMatrices[" + std::to_string(j) + "]", cubeShadowMapTransforms[j]);
 				cubeShadowMapShaderProgram->SetFloat("farPlane", farPlaneCubeShadowMap);
 				cubeShadowMapShaderProgram->SetVec3("lightPosition", positionVectorPointLight);
-				RenderScene(cubeShadowMapShaderProgram);
+				/// All six faces drawn by one pass, so entity is culled only if it is out of range of light.
+				vec4 rangePlanes[core::FRUSTUM_PLANES_NUMBER];
+				core::ExtractRangePlanes(positionVectorPointLight, farPlaneCubeShadowMap, rangePlanes);
+				RenderScene(cubeShadowMapShaderProgram, rangePlanes, core::FRUSTUM_PLANES_NUMBER);
 				pGLBind_Framebuffer(GL_FRAMEBUFFER, 0);
 	}
 
@@ -339,7 +350,7 @@ namespace GLVM::core
 		cm::beholder* playerViewComponent = pComponent_Manager->GetComponent<cm::beholder>(uiPlayerEntity);
 		cm::transform* playerTransformComponent = pComponent_Manager->GetComponent<cm::transform>(uiPlayerEntity);
 		
-		vec3 viewPosition = playerTransformComponent->tPosition;
+		vec3 viewPosition = cm::InterpolateTransform(*playerTransformComponent, interpolationAlpha).tPosition;
 		bool reverseNormalsFlag = false;
 		
 		// Render scene as normal
@@ -478,25 +489,58 @@ namespace GLVM::core
 		}
 	}
 	
-	void COpenglRenderer::RenderScene(Shader* shaderProgram_) {
+	/*! Entities and their world bounds collected once, so camera and every light cull the same
+	 *  bounds. Skinned entities never culled, their pose may leave box of bind pose.
+	 */
+	void COpenglRenderer::CollectSceneEntities() {
 		namespace cm = GLVM::ecs::components;
 		ecs::ComponentManager* pComponent_Manager = GLVM::ecs::ComponentManager::GetInstance();
-		mat4 modelMatrix(1.0f);
 
-		Raycasting();
-
-
-		
+		sceneEntities = pComponent_Manager->collectLinkedEntities<cm::transform,
+																  cm::material,
+																  cm::mesh>();
+
+		unsigned int sceneEntitiesSize = sceneEntities.GetSize();
+		sceneModelMatrices.Resize(sceneEntitiesSize);
+		sceneCuller.BeginFrame(sceneEntitiesSize);
+		for(unsigned int i = 0; i < sceneEntitiesSize; ++i) {
+			Entity entity = sceneEntities[i];
+			mat4 modelMatrix(1.0f);
+
+			/// World matrix cached by transform system, shadow and main passes only read it.
+			const cm::worldTransform* worldTransformComponent = pComponent_Manager->GetComponent<const cm::worldTransform>(entity);
+			if ( worldTransformComponent != nullptr )
+				modelMatrix = worldTransformComponent->world;
+			else if ( pComponent_Manager->multiCheckAvailability<cm::transform>(entity) )
+				modelMatrix = SetModelMatrix(*pComponent_Manager->GetComponent<cm::transform>(entity));
+			sceneModelMatrices[i] = modelMatrix;
+
+			const cm::mesh* vertexComponent = pComponent_Manager->GetComponent<const cm::mesh>(entity);
+			unsigned int uiVertexId = vertexComponent != nullptr ? vertexComponent->handle.id : 0;
+			if ( uiVertexId < meshBounds.size() && getJointPalette(entity) == unitPalette.data() )
+				sceneCuller.SetBounds(i, meshBounds[uiVertexId], modelMatrix);
+			else
+				sceneCuller.SetUnbounded(i);
+		}
+	}
 
+	void COpenglRenderer::RenderScene(Shader* shaderProgram_, const vec4* planes, unsigned int planesNumber) {
 		namespace cm = GLVM::ecs::components;
-		core::vector<Entity> linkedEntities      = pComponent_Manager->collectLinkedEntities<cm::transform,
-																							 cm::material,
-																							 cm::mesh>();
+		ecs::ComponentManager* pComponent_Manager = GLVM::ecs::ComponentManager::GetInstance();
+
+		if ( frustumCulling ) {
+			sceneCuller.Cull(planes, planesNumber, visibleSceneEntities);
+		} else {
+			visibleSceneEntities.Resize(sceneEntities.GetSize());
+			for ( unsigned int i = 0; i < sceneEntities.GetSize(); ++i )
+				visibleSceneEntities[i] = i;
+		}
 
-		unsigned int linkedEntitiesVectorSize      = linkedEntities.GetSize();			
+		unsigned int visibleEntitiesVectorSize = visibleSceneEntities.GetSize();
 
-		for(unsigned int i = 0; i < linkedEntitiesVectorSize; ++i) {
-			unsigned int uiEntity_refTexture = linkedEntities[i];
+		for(unsigned int i = 0; i < visibleEntitiesVectorSize; ++i) {
+			unsigned int sceneIndex = visibleSceneEntities[i];
+			unsigned int uiEntity_refTexture = sceneEntities[sceneIndex];
 
 			cm::mesh* vertexComponent = pComponent_Manager->GetComponent<cm::mesh>(uiEntity_refTexture);
 			unsigned int uiVertexId = 0;
@@ -511,51 +555,10 @@ namespace GLVM::core
 				specularTextureID = material->specularTextureID_.id;
 			}
 
-			cm::mesh* mesh = pComponent_Manager->GetComponent<cm::mesh>(uiEntity_refTexture);
-			unsigned int meshID = mesh->handle.id;
-			cm::transform* _transformComponent = pComponent_Manager->GetComponent<cm::transform>(uiEntity_refTexture);
-			
-			if ( jointMatricesPerMesh.GetSize() > 0 && jointMatricesPerMesh[meshID].GetSize() > 0 &&
-				 _transformComponent->frameAccumulator >= frames[meshID][_transformComponent->currentAnimationFrame] * 1.0f ) {
-				++_transformComponent->currentAnimationFrame;
-				if ( jointMatricesPerMesh[meshID].GetSize() > 0 && _transformComponent->currentAnimationFrame == frames[meshID].GetSize() ) {
-					_transformComponent->currentAnimationFrame = 0;
-					_transformComponent->frameAccumulator = 0.0f;
-				}
-			}
-		
-			unsigned int joinMatricesDataSize{};
-			if ( jointMatricesPerMesh.GetSize() > 0 )
-				joinMatricesDataSize = jointMatricesPerMesh[meshID].GetSize();
-			mat4* jointMatricesData = nullptr;
-			if ( joinMatricesDataSize == 0 ) {
-				jointMatricesData = new mat4[MAX_JOINTS_NUMBER];
-				for ( unsigned int i = 0; i < MAX_JOINTS_NUMBER; ++i ) {
-					mat4 unitMatrix(1.0f);
-					jointMatricesData[i] = unitMatrix;
-				}
-				
-			} else {
-				jointMatricesData = new mat4[MAX_JOINTS_NUMBER];
-				for ( unsigned int i = 0; i < joinMatricesDataSize; ++i ) {
-					jointMatricesData[i] = jointMatricesPerMesh[meshID][i][_transformComponent->currentAnimationFrame];
-				}
-
-				for ( unsigned int i = joinMatricesDataSize; i < MAX_JOINTS_NUMBER; ++i ) {
-					mat4 unitMatrix(1.0f);
-					jointMatricesData[i] = unitMatrix;
-				}
-			}
-		
+			const mat4* jointMatricesData = getJointPalette(uiEntity_refTexture);
 			shaderProgram_->SetMat4("jointMatrices", MAX_JOINTS_NUMBER, jointMatricesData[0]);
-			delete [] jointMatricesData;
-			jointMatricesData = nullptr;
-			
-			cm::transform* transformComponent = pComponent_Manager->GetComponent<cm::transform>(uiEntity_refTexture);
-			if ( transformComponent != nullptr )
-				modelMatrix = SetModelMatrix(*transformComponent);
 
-			shaderProgram_->SetMat4("modelMatrix", modelMatrix);
+			shaderProgram_->SetMat4("modelMatrix", sceneModelMatrices[sceneIndex]);
 			pGLActive_Texture(GL_TEXTURE28);
 			glBindTexture(GL_TEXTURE_2D, textureVector[diffuseTextureID].iTexture_);
 			pGLActive_Texture(GL_TEXTURE29);
@@ -568,58 +571,56 @@ namespace GLVM::core
 		}
 	}
 
+	/// Ray of every projectile tested only against colliders that broadphase found along it.
 	void COpenglRenderer::Raycasting() {
 		namespace cm = GLVM::ecs::components;
+		if ( colliderBroadphase == nullptr )
+			return;
+
 		ecs::ComponentManager* componentManager  = ecs::ComponentManager::GetInstance();
+		ecs::EntityManager* entityManager        = ecs::EntityManager::GetInstance();
 		core::vector<Entity> linkedEntities      = componentManager->collectUniqueLinkedEntities<cm::projectile,
 																								 cm::transform,
 																								 cm::material,
 																								 cm::mesh,
 																								 cm::collider>();
-		
-		core::vector<Entity> otherLinkedEntities = componentManager->collectUniqueLinkedEntities<cm::material,
-																								 cm::collider,
-																								 cm::mesh,
-																								 cm::transform>();
+		ecs::Signature geometrySignature         = componentManager->MakeSignature<cm::material,
+																				   cm::collider,
+																				   cm::mesh,
+																				   cm::transform>();
 
-		unsigned int linkedEntitiesVectorSize      = linkedEntities.GetSize();
-		unsigned int otherLinkedEntitiesVectorSize = otherLinkedEntities.GetSize();
+		unsigned int linkedEntitiesVectorSize    = linkedEntities.GetSize();
 
         for(unsigned int x = 0; x < linkedEntitiesVectorSize; ++x) {
-          unsigned int uiEntity_refProjectile = linkedEntities[x];
-          cm::transform* rTransformProjectile = componentManager->GetComponent<cm::transform>(uiEntity_refProjectile);
-		  float rayLength = 1.0f;
-		  vec3 ray        = rTransformProjectile->tForward * rayLength;
-
-			for(unsigned int j = 0; j < otherLinkedEntitiesVectorSize; ++j) {
-				unsigned int entityOther = otherLinkedEntities[j];
-				cm::transform* transformOther = componentManager->GetComponent<cm::transform>(entityOther);
+			unsigned int uiEntity_refProjectile = linkedEntities[x];
+			const cm::transform* rTransformProjectile = componentManager->GetComponent<const cm::transform>(uiEntity_refProjectile);
+			float rayLength = 1.0f;
+			vec3 forward    = rTransformProjectile->tForward;
+			vec3 ray        = forward * rayLength;
+			vec3 origin     = rTransformProjectile->tPosition;
+			vec3 inverseRay(1.0f / ray[0], 1.0f / ray[1], 1.0f / ray[2]);
+			bool hit        = false;
+
+			rayCandidates.clear();
+			colliderBroadphase->QueryRay(origin, ray, rayCandidates);
+			for ( unsigned int j = 0; j < rayCandidates.GetSize() && !hit; ++j ) {
+				Entity entityOther = rayCandidates[j];
+				if ( !entityManager->IsAlive(entityOther) || componentManager->GetSignature(entityOther) != geometrySignature )
+					continue;                                                ///< Only level geometry stops projectile.
+
+				const cm::transform* transformOther = componentManager->GetComponent<const cm::transform>(entityOther);
 				float otherHalfScale = transformOther->fScale * 0.5f;
-				float min = 0.0f;
-				float max = 1.0f;
-
+				ecs::BroadphaseBox box;
 				for ( int dimension = 0; dimension < 3; ++dimension ) {
-					float axis_invariant = 1.0f / ray[dimension];
-					float box_min = transformOther->tPosition[dimension] - otherHalfScale;
-					float box_max = transformOther->tPosition[dimension] + otherHalfScale;
-					
-					float delta1  = (box_min - rTransformProjectile->tPosition[dimension]) * axis_invariant;
-					float delta2  = (box_max - rTransformProjectile->tPosition[dimension]) * axis_invariant;
-
-					min = Max(min, Min(delta1, delta2));
-					max = Min(max, Max(delta1, delta2));
-					
-					if ( max < min )
-						break;
+					box.min[dimension] = transformOther->tPosition[dimension] - otherHalfScale;
+					box.max[dimension] = transformOther->tPosition[dimension] + otherHalfScale;
 				}
 
-				if ( max > min ) {
-					ecs::EntityManager* entityManager       = GLVM::ecs::EntityManager::GetInstance();
-					entityManager->RemoveEntity(uiEntity_refProjectile, componentManager);
-					/// TODO: There is a big quastion is this decrement have sence.
-//					--linkedEntitiesVectorSize;  
- 				}
+				hit = ecs::RayOverlap(box, origin, inverseRay);
 			}
+
+			if ( hit )
+				entityManager->RemoveEntity(uiEntity_refProjectile, componentManager);
 		}
 	}
 
@@ -783,6 +784,7 @@ namespace GLVM::core
 		VBOcontainer_.push_back(iVbo_);
 		VAOcontainer_.push_back(iVao_);
 		EBOcontainer_.push_back(iEbo_);
+		meshBounds.push_back(core::ComputeMeshBounds(_aVertices.data(), _aVertices.size() / 16, 16 * sizeof(float)));
 	}
 	
     void COpenglRenderer::loadWavefrontObj() {
@@ -795,9 +797,6 @@ namespace GLVM::core
 			aVertexes_.emplace_back();
             aIndices_.emplace_back();
 
-			jointMatricesPerMesh.Push({});
-			frames.Push({});
-			
             unsigned int vertexIndex = 0;
             unsigned int textureIndex = 0;
 			unsigned int normalIndex = 0;
@@ -834,43 +833,39 @@ namespace GLVM::core
         }
     }
 
-	void COpenglRenderer::EnlargeFrameAccumulator(float value) {
-		namespace cm = GLVM::ecs::components;
-		
-		ecs::ComponentManager* componentManager = GLVM::ecs::ComponentManager::GetInstance();
-		core::vector<Entity> linkedEntities = componentManager->collectLinkedEntities<cm::transform>();
-		unsigned int linkedEntitiesVectorSize = linkedEntities.GetSize();
-		for(unsigned int i = 0; i < linkedEntitiesVectorSize; ++i) {
-			Entity currentEntity                = linkedEntities[i];
-			cm::transform* transformComponent   = componentManager->GetComponent<cm::transform>(currentEntity);
-			unsigned int mesh_id                = componentManager->GetComponent<cm::mesh>(currentEntity)->handle.id;
-
-			if ( jointMatricesPerMesh.GetSize() > 0 && jointMatricesPerMesh[mesh_id].GetSize() > 0 )
-				transformComponent->frameAccumulator += value;
-		}
+	const mat4* COpenglRenderer::getJointPalette(Entity entity) const {
+		static_assert(MAX_JOINTS_NUMBER == ecs::PALETTE_JOINTS_NUMBER, "Palettes of animation system dont match shaders");
+
+		const mat4* palette = animationSystem != nullptr ? animationSystem->GetPalette(entity) : nullptr;
+		return palette != nullptr ? palette : unitPalette.data();
 	}
 	
+	void COpenglRenderer::SetInterpolationAlpha(float alpha) {
+		interpolationAlpha = alpha;
+	}
+
 	mat4 COpenglRenderer::SetModelMatrix(ecs::components::transform& transformComponent_)
 	{
+		ecs::components::transform interpolatedTransform = ecs::components::InterpolateTransform(transformComponent_, interpolationAlpha);
         mat4 rotationMatrix(1.0f);
         mat4 modelMatrix(1.0f);
         mat4 scalingMatrix(1.0f);
         mat4 translationMatrix(1.0f);
 
-        scalingMatrix[0][0] = transformComponent_.fScale;
-        scalingMatrix[1][1] = transformComponent_.fScale;
-        scalingMatrix[2][2] = transformComponent_.fScale;
+        scalingMatrix[0][0] = interpolatedTransform.fScale;
+        scalingMatrix[1][1] = interpolatedTransform.fScale;
+        scalingMatrix[2][2] = interpolatedTransform.fScale;
 		scalingMatrix[3][3] = 1.0f;
         
-        translationMatrix[3][0] = transformComponent_.tPosition[0];
-		translationMatrix[3][1] = transformComponent_.tPosition[1];
-		translationMatrix[3][2] = transformComponent_.tPosition[2];
+        translationMatrix[3][0] = interpolatedTransform.tPosition[0];
+		translationMatrix[3][1] = interpolatedTransform.tPosition[1];
+		translationMatrix[3][2] = interpolatedTransform.tPosition[2];
         translationMatrix[3][3] = 1.0f;
 
-		float sinPitch = std::sin(Radians(-transformComponent_.pitch / 2));
-		float cosPitch = std::cos(Radians(-transformComponent_.pitch / 2));
-		float sinYaw = std::sin(Radians(-(transformComponent_.yaw)  / 2));
-		float cosYaw = std::cos(Radians(-(transformComponent_.yaw)  / 2));
+		float sinPitch = std::sin(Radians(-interpolatedTransform.pitch / 2));
+		float cosPitch = std::cos(Radians(-interpolatedTransform.pitch / 2));
+		float sinYaw = std::sin(Radians(-(interpolatedTransform.yaw)  / 2));
+		float cosYaw = std::cos(Radians(-(interpolatedTransform.yaw)  / 2));
 		
 		Quaternion pitchQuat;
 		Quaternion yawQuat;
@@ -947,11 +942,12 @@ namespace GLVM::core
 			Core::CJsonParser jsonParser;
 			aVertexes_.emplace_back();
 			aIndices_.emplace_back();
-			jointMatricesPerMesh.Push({});
-			frames.Push({});
 			animationFlags.Push({});
 			uint32_t nextIndexGLTF = wavefrontObjCounter + m;
-			jsonParser.LoadGLTF(pathsGLTF_[m], aVertexes_[nextIndexGLTF], aIndices_[nextIndexGLTF], jointMatricesPerMesh[nextIndexGLTF], frames[nextIndexGLTF], animationFlags[m]);
+			core::CSkeletalAnimation skeleton;
+			jsonParser.LoadGLTF(pathsGLTF_[m], aVertexes_[nextIndexGLTF], aIndices_[nextIndexGLTF], skeleton, animationFlags[m]);
+			if ( animationSystem != nullptr )
+				animationSystem->SetSkeleton(nextIndexGLTF, std::move(skeleton));
 		}
 		for (unsigned int m = 0; m < pathsGLTF_.GetSize(); ++m) {
 			uint32_t nextIndexGLTF = wavefrontObjCounter + m;
@@ -1030,15 +1026,18 @@ namespace GLVM::core
 		forward[1] = result.y;
 		forward[2] = result.z;
         beholder.forward = Normalize(forward);
-        viewMatrix = LookAtMain(player.tPosition,
-								player.tPosition + beholder.forward,
+		vec3 eyePosition = ecs::components::InterpolateTransform(player, interpolationAlpha).tPosition;
+        viewMatrix = LookAtMain(eyePosition,
+								eyePosition + beholder.forward,
 								beholder.up);
 
+		cameraViewMatrix = viewMatrix;
 		shaderProgram->SetMat4("viewMatrix", viewMatrix);
     }
 
 	void COpenglRenderer::ComputeProjectionMatrix(Shader* shaderProgram) {
 		mat4 tProjection_Matrix = Perspective(Radians(90.0f), (float)1920 / (float)1080, 0.1f, 1000.0f);
+		cameraProjectionMatrix = tProjection_Matrix;
 		shaderProgram->SetMat4("projectionMatrix", tProjection_Matrix);
 	}
 }
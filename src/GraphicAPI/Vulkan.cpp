@@ -4,7 +4,9 @@
 // License: http://opensource.org/licenses/MIT
 
 #include "ComponentManager.hpp"
+#include "Frustum.hpp"
 #include "GraphicAPI/Vulkan.hpp"
+#include "JobSystem.hpp"
 #include "Components/ControllerComponent.hpp"
 #include "Components/MaterialComponent.hpp"
 #include "Components/TransformComponent.hpp"
@@ -83,6 +85,8 @@ namespace GLVM::core
 		}
 		
 		SetProjectionMatrix();
+		updateModelMatricesCache();
+		buildInstanceGroups();
 		// mutex0.lock();
 		// mutex1.lock();
 		// mutex2.lock();
@@ -116,9 +120,6 @@ namespace GLVM::core
             aIndices_.emplace_back();
             aVertices_.emplace_back();
 
-			frames.Push({});
-			jointMatricesPerMesh.Push({});
-            
             unsigned int vertexIndex  = 0;
             unsigned int textureIndex = 0;
 			unsigned int normalIndex  = 0;
@@ -161,26 +162,15 @@ namespace GLVM::core
             indexBufferContainer.emplace_back();
             indexBufferMemoryContaner.emplace_back();
             createIndexBuffer(indexBufferContainer[m], indexBufferMemoryContaner[m], aIndices_[m]);
+			meshBounds.push_back(core::ComputeMeshBounds(reinterpret_cast<const float*>(aVertices_[m].data()), aVertices_[m].size(), sizeof(Vertex)));
 			++wavefrontObjCounter;
         }
     }
 
-	void CVulkanRenderer::EnlargeFrameAccumulator(float value) {
-		namespace cm = GLVM::ecs::components;
-		
-		ecs::ComponentManager* componentManager = GLVM::ecs::ComponentManager::GetInstance();
-		core::vector<Entity> linkedEntities = componentManager->collectLinkedEntities<cm::transform>();
-		unsigned int linkedEntitiesVectorSize = linkedEntities.GetSize();
-		for(unsigned int i = 0; i < linkedEntitiesVectorSize; ++i) {
-			Entity currentEntity                = linkedEntities[i];
-			cm::transform* transformComponent   = componentManager->GetComponent<cm::transform>(currentEntity);
-			unsigned int mesh_id                = componentManager->GetComponent<cm::mesh>(currentEntity)->handle.id;
-
-			if ( jointMatricesPerMesh.GetSize() > 0 && jointMatricesPerMesh[mesh_id].GetSize() > 0 )
-				transformComponent->frameAccumulator += value;
-		}
+	void CVulkanRenderer::SetInterpolationAlpha(float alpha) {
+		interpolationAlpha = alpha;
 	}
-	
+
     void CVulkanRenderer::SetViewMatrix(mat4 _viewMatrix) {
         viewMatrix = _viewMatrix; // 
     }
@@ -235,8 +225,9 @@ namespace GLVM::core
 		forward[1] = result.y;
 		forward[2] = result.z;
         cameraComponent.forward = Normalize(forward);
-        viewMatrix_ = LookAtMain(_Player.tPosition,
-								_Player.tPosition + cameraComponent.forward,
+		vec3 eyePosition = ecs::components::InterpolateTransform(_Player, interpolationAlpha).tPosition;
+        viewMatrix_ = LookAtMain(eyePosition,
+								eyePosition + cameraComponent.forward,
 								cameraComponent.up);
 
 		viewMatrix = viewMatrix_;
@@ -366,9 +357,19 @@ namespace GLVM::core
 		core::vector<u32> DS_0_count;
 		DS_0_binding.Push(0);
 		DS_0_count.Push(1);
+
+		/// Instances at binding 0, joint palettes at binding 1 and visible instance indices at binding 2, last set of every pipeline.
+		core::vector<u32> SSBO_0_2_bindings;
+		core::vector<u32> SSBO_0_2_count;
+		for ( u32 i = 0; i < 3; ++i ) {
+			SSBO_0_2_bindings.Push(i);
+			SSBO_0_2_count.Push(1);
+		}
 		
-		directionalLightPipeline.addDescriptor(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+		directionalLightPipeline.addDescriptor(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
 											   DescriptorsTypes::DIRECTIONAL_LIGHT_SHADOW_MAP_MATRIX_UBO, VK_SHADER_STAGE_VERTEX_BIT, DS_0_count, DS_0_binding);
+		directionalLightPipeline.addDescriptor(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+											   DescriptorsTypes::INSTANCE_DATA_SSBO, VK_SHADER_STAGE_VERTEX_BIT, SSBO_0_2_count, SSBO_0_2_bindings);
 		
 		directionalLightPipeline.vertShader = vertShaderFlatShadowMap;
 		directionalLightPipeline.bindingDescription = Vertex::getBindingDescription();
@@ -380,8 +381,10 @@ namespace GLVM::core
 
 		spotLightNumber = spotLightLinkedEntities.GetSize();
 		spotLightShadowMapTextureSamplers.resize(spotLightNumber);
-		spotLightPipeline.addDescriptor(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+		spotLightPipeline.addDescriptor(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
 										DescriptorsTypes::SPOT_LIGHT_SHADOW_MAP_MATRIX_UBO, VK_SHADER_STAGE_VERTEX_BIT, DS_0_count, DS_0_binding);
+		spotLightPipeline.addDescriptor(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+										DescriptorsTypes::INSTANCE_DATA_SSBO, VK_SHADER_STAGE_VERTEX_BIT, SSBO_0_2_count, SSBO_0_2_bindings);
 		
 		spotLightPipeline.vertShader = vertShaderFlatShadowMap;
 		spotLightPipeline.bindingDescription = Vertex::getBindingDescription();
@@ -393,8 +396,10 @@ namespace GLVM::core
 
 		pointLightNumber = pointLightLinkedEntities.GetSize();
 		pointLightShadowMapTextureSamplers.resize(pointLightNumber);
-		pointLightPipeline.addDescriptor(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+		pointLightPipeline.addDescriptor(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
 										 DescriptorsTypes::POINT_LIGHT_SHADOW_MAP_MATRIX_UBO, VK_SHADER_STAGE_VERTEX_BIT, DS_0_count, DS_0_binding);
+		pointLightPipeline.addDescriptor(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+										 DescriptorsTypes::INSTANCE_DATA_SSBO, VK_SHADER_STAGE_VERTEX_BIT, SSBO_0_2_count, SSBO_0_2_bindings);
 		pointLightPipeline.vertShader = vertShaderCubeShadowMap;
 		pointLightPipeline.fragShader = fragShaderCubeShadowMap;
 		
@@ -409,8 +414,8 @@ namespace GLVM::core
 		actorsNumber = actorsLinkedEntities.GetSize();
 		
 
-		mainRenderScenePipeline.addDescriptor(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, DescriptorsTypes::MODEL_MATRIX_UBO, VK_SHADER_STAGE_VERTEX_BIT, DS_0_count, DS_0_binding);
-		mainRenderScenePipeline.addDescriptor(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, DescriptorsTypes::LIGHT_DATA, VK_SHADER_STAGE_FRAGMENT_BIT, DS_0_count, DS_0_binding);
+		mainRenderScenePipeline.addDescriptor(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, DescriptorsTypes::MODEL_MATRIX_UBO, VK_SHADER_STAGE_VERTEX_BIT, DS_0_count, DS_0_binding);
+		mainRenderScenePipeline.addDescriptor(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, DescriptorsTypes::LIGHT_DATA, VK_SHADER_STAGE_FRAGMENT_BIT, DS_0_count, DS_0_binding);
 		mainRenderScenePipeline.addDescriptor(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, DescriptorsTypes::SPECULAR_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT, DS_0_count, DS_0_binding);
 
 		core::vector<u32> DS_0_3_bindigs;
@@ -427,12 +432,16 @@ namespace GLVM::core
 		DS_0_3_bindigs.Push(37);
 			
 		mainRenderScenePipeline.addDescriptor(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, DescriptorsTypes::LIGHT_SAMPLERS, VK_SHADER_STAGE_FRAGMENT_BIT, DS_0_3_count, DS_0_3_bindigs);
+		mainRenderScenePipeline.addDescriptor(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, DescriptorsTypes::INSTANCE_DATA_SSBO, VK_SHADER_STAGE_VERTEX_BIT, SSBO_0_2_count, SSBO_0_2_bindings);
 
 		mainRenderScenePipeline.vertShader = vertShaderMain_;
 		mainRenderScenePipeline.fragShader = fragShaderMain_;
 
 		mainRenderScenePipeline.bindingDescription = Vertex::getBindingDescription();
 		mainRenderScenePipeline.attributeDescriptions = Vertex::getAttributeDescriptions();
+
+		cullingPipeline.addDescriptor(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, DescriptorsTypes::INSTANCE_CULLING_SSBO, VK_SHADER_STAGE_COMPUTE_BIT, SSBO_0_2_count, SSBO_0_2_bindings);
+		cullingPipeline.compShader = compShaderCulling;
 		
         initWindow();
         initVulkan();
@@ -476,11 +485,12 @@ namespace GLVM::core
 			Core::CJsonParser jsonParser;
 			aVertexesTemp_.emplace_back();
 			aIndices_.emplace_back();
-			frames.Push({});
-			jointMatricesPerMesh.Push({});
 			animationFlags.Push({});
 			uint32_t nextIndexGLTF = wavefrontObjCounter + m;
-			jsonParser.LoadGLTF(pathsGLTF_[m], aVertexesTemp_[m], aIndices_[nextIndexGLTF], jointMatricesPerMesh[nextIndexGLTF], frames[nextIndexGLTF], animationFlags[m]);
+			core::CSkeletalAnimation skeleton;
+			jsonParser.LoadGLTF(pathsGLTF_[m], aVertexesTemp_[m], aIndices_[nextIndexGLTF], skeleton, animationFlags[m]);
+			if ( animationSystem != nullptr )
+				animationSystem->SetSkeleton(nextIndexGLTF, std::move(skeleton));
 		}
 
 		for (unsigned int m = 0; m < pathsGLTF_.GetSize(); ++m) {
@@ -546,6 +556,8 @@ namespace GLVM::core
             indexBufferContainer.emplace_back();
             indexBufferMemoryContaner.emplace_back();
             createIndexBuffer(indexBufferContainer[nextIndexGLTF], indexBufferMemoryContaner[nextIndexGLTF], aIndices_[nextIndexGLTF]);
+			meshBounds.push_back(core::ComputeMeshBounds(reinterpret_cast<const float*>(aVertices_[nextIndexGLTF].data()),
+														  aVertices_[nextIndexGLTF].size(), sizeof(Vertex)));
 		}
 	}
 	
@@ -565,10 +577,12 @@ namespace GLVM::core
 		createDescriptorSetLayout(spotLightPipeline.descriptors);
 		createDescriptorSetLayout(pointLightPipeline.descriptors);
         createDescriptorSetLayout(mainRenderScenePipeline.descriptors);
+		createDescriptorSetLayout(cullingPipeline.descriptors);
         createGraphicsPipeline(directionalLightPipeline, directionalLightShadowMapRenderPass);
 		createGraphicsPipeline(spotLightPipeline, spotLightShadowMapRenderPass);
 		createGraphicsPipeline(pointLightPipeline, pointLightShadowMapRenderPass);
 		createGraphicsPipeline(mainRenderScenePipeline, renderPass);
+		createComputePipeline(cullingPipeline, sizeof(CullingConstants));
         createCommandPool(directionalLightCommandPool);
 		createCommandPool(spotLightCommandPool);
 		createCommandPool(pointLightCommandPool);
@@ -593,6 +607,7 @@ namespace GLVM::core
 		createSpotLightShadowMapDescriptorSets();
 		createPointLightShadowMapDescriptorSets();
         createMainRenderDescriptorSets();
+		createIndirectFrames();
 		setDebugObjectNames();
         createCommandBuffers(directionalLightCommandPool, directionalLightCommandBuffers);
 		createCommandBuffers(spotLightCommandPool, spotLightCommandBuffers);
@@ -649,14 +664,23 @@ namespace GLVM::core
         vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
         vkDestroyRenderPass(device, renderPass, nullptr);
 
-        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-            vkDestroyBuffer(device, modelMatrixUniformBuffers[i], nullptr);
-            vkFreeMemory(device, modelMatrixUniformBuffersMemory[i], nullptr);
-			vkDestroyBuffer(device, spotLightsUniformBuffers[i], nullptr);
-            vkFreeMemory(device, spotLightsUniformBuffersMemory[i], nullptr);
-        }
+		destroyUniformRing(viewMatrixRing);
+		destroyUniformRing(lightDataRing);
+		destroyUniformRing(shadowMapDirectionalLightModelMatrixRing);
+		destroyUniformRing(shadowMapSpotLightModelMatrixRing);
+		destroyUniformRing(shadowMapPointLightModelMatrixRing);
+		destroyInstanceBuffer(mainRenderInstanceBuffer);
+		destroyInstanceBuffer(directionalLightInstanceBuffer);
+		destroyInstanceBuffer(spotLightInstanceBuffer);
+		destroyInstanceBuffer(pointLightInstanceBuffer);
+		destroyIndirectFrames();
 
         vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+		for ( VkDescriptorPool pool : uniformDescriptorPools )
+			vkDestroyDescriptorPool(device, pool, nullptr);
+
+		uniformDescriptorPools.clear();
+		uniformPoolFreeChunks = 0;
 
         for(unsigned int i = 0; i < textureImages.size(); ++i)
         {
@@ -679,6 +703,12 @@ namespace GLVM::core
 		
 		for ( unsigned int i = 0; i < mainRenderScenePipeline.descriptors.GetSize(); ++i ) 
 			vkDestroyDescriptorSetLayout(device, mainRenderScenePipeline.descriptors[i].setLayout, nullptr);
+
+		for ( unsigned int i = 0; i < cullingPipeline.descriptors.GetSize(); ++i ) 
+			vkDestroyDescriptorSetLayout(device, cullingPipeline.descriptors[i].setLayout, nullptr);
+
+		vkDestroyPipeline(device, cullingPipeline.pipeline, nullptr);
+		vkDestroyPipelineLayout(device, cullingPipeline.pipelineLayout, nullptr);
 		
         for (size_t i = 0; i < vertexBufferContainer.size(); ++i) {
             vkDestroyBuffer(device, indexBufferContainer[i], nullptr);
@@ -1329,6 +1359,50 @@ namespace GLVM::core
 			vkDestroyShaderModule(device, fragShaderModule, nullptr);
     }
 
+	/// Push constants of compute pipeline visible only for compute stage.
+	void CVulkanRenderer::createComputePipeline(Pipeline& pipeline, uint32_t pushConstantsSize) {
+		std::vector<char> compShaderCode = readFile(pipeline.compShader);
+		VkShaderModule compShaderModule = createShaderModule(compShaderCode);
+
+		VkPipelineShaderStageCreateInfo compShaderStageInfo{};
+		compShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		compShaderStageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		compShaderStageInfo.module = compShaderModule;
+		compShaderStageInfo.pName = "main";
+
+		std::vector<VkDescriptorSetLayout> descriptorSetLayouts;
+		for (unsigned int i = 0; i < pipeline.descriptors.GetSize(); ++i)
+			descriptorSetLayouts.push_back(pipeline.descriptors[i].setLayout);
+
+		VkPushConstantRange pushConstantRange{};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushConstantRange.offset = 0;
+		pushConstantRange.size = pushConstantsSize;
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts.size());
+		pipelineLayoutInfo.pSetLayouts = descriptorSetLayouts.data();
+		pipelineLayoutInfo.pushConstantRangeCount = pushConstantsSize > 0 ? 1 : 0;
+		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+		if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &pipeline.pipelineLayout) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create pipeline layout!");
+		}
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage = compShaderStageInfo;
+		pipelineInfo.layout = pipeline.pipelineLayout;
+		pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+
+		if (vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline.pipeline) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create compute pipeline!");
+		}
+
+		vkDestroyShaderModule(device, compShaderModule, nullptr);
+	}
+
     void CVulkanRenderer::createFramebuffers() {
 		/// Main renderer frame buffers initialization
 		swapChainFramebuffers.resize(swapChainImageViews.size());
@@ -1960,363 +2034,551 @@ namespace GLVM::core
         vkFreeMemory(device, stagingBufferMemory, nullptr);
     }
 
+    /// Per draw data moved to instance buffers, rings keep one slot per frame, light or cube map face and grow for lights spawned later.
     void CVulkanRenderer::createMainRenderUniformBuffers() {
-        VkDeviceSize modelMatrixBufferSize = sizeof(ModelMatrixUBO);
-		VkDeviceSize lightDataBufferSize = sizeof(LightData);
-		VkDeviceSize lightSpaceMatrixSize = sizeof(LightSpaceMatrixUBO);
-		VkDeviceSize modelShadowMapMatrixBufferSize = sizeof(ShadowMapMatrixUBO);
-		VkDeviceSize modelCubeShadowMapMatrixBufferSize = sizeof(PointLightShadowMapMatrixUBO);
 		namespace cm = GLVM::ecs::components;
 		ecs::ComponentManager* componentManager   = ecs::ComponentManager::GetInstance();
 
-		core::vector<Entity> matrixLinkedEntities = componentManager->collectLinkedEntities<cm::transform,
-																							cm::material,
-																							cm::mesh>();
+		matrixUboDescriptorsNumber = 1;
+		createUniformRing(viewMatrixRing, sizeof(ViewMatrixUBO), matrixUboDescriptorsNumber);
+		createUniformRing(lightDataRing, sizeof(LightData), 1);
 
-		u32 memory = 0;
-		constexpr u32 UBO_multiplier = 2;
-		matrixUboDescriptorsNumber = matrixLinkedEntities.GetSize() * UBO_multiplier;
-		modelMatrixUniformBuffers.resize(MAX_FRAMES_IN_FLIGHT);
-		modelMatrixUniformBuffersMemory.resize(MAX_FRAMES_IN_FLIGHT);
+		core::vector<Entity> directionalLightLinkedEntities = componentManager->collectLinkedEntities<cm::directionalLight>();
+		directionalLightUboDescriptorsNumber = directionalLightLinkedEntities.GetSize();
+		createUniformRing(shadowMapDirectionalLightModelMatrixRing, sizeof(ShadowMapMatrixUBO),
+						  std::max<uint32_t>(directionalLightUboDescriptorsNumber, 1));
 
-		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT * matrixUboDescriptorsNumber; i++) {
-			// createBuffer(modelMatrixBufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-			// 			 modelMatrixUniformBuffers[i], modelMatrixUniformBuffersMemory[i]);
+		core::vector<Entity> spotLightLinkedEntities = componentManager->collectLinkedEntities<cm::spotLight>();
+		spotLightUboDescriptorsNumber = spotLightLinkedEntities.GetSize();
+		createUniformRing(shadowMapSpotLightModelMatrixRing, sizeof(ShadowMapMatrixUBO),
+						  std::max<uint32_t>(spotLightUboDescriptorsNumber, 1));
 
-			memory += modelMatrixBufferSize;
-		}
+		core::vector<Entity> pointLightsLinkedEntities = componentManager->collectLinkedEntities<cm::pointLight>();
 
-		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-			createBuffer(memory, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-						 modelMatrixUniformBuffers[i], modelMatrixUniformBuffersMemory[i]);
+		/// Six cube map faces per light.
+		pointLightUboDescriptorsNumber = 6 * pointLightsLinkedEntities.GetSize();
+		createUniformRing(shadowMapPointLightModelMatrixRing, sizeof(PointLightShadowMapMatrixUBO),
+						  std::max<uint32_t>(pointLightUboDescriptorsNumber, 6));
+    }
 
-//				memory += modelMatrixBufferSize;
-		}
-		memory = 0;
-		
-		lightSpaceMatrixBuffer.resize(MAX_FRAMES_IN_FLIGHT);
-        lightSpaceMatrixMemory.resize(MAX_FRAMES_IN_FLIGHT);
+	void CVulkanRenderer::createUniformRing(UniformRing& ring, VkDeviceSize slotSize, uint32_t slotsPerChunk) {
+		VkPhysicalDeviceProperties properties{};
+		vkGetPhysicalDeviceProperties(physicalDevice, &properties);
 
-		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-            createBuffer(lightSpaceMatrixSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-						 lightSpaceMatrixBuffer[i], lightSpaceMatrixMemory[i]);
+		VkDeviceSize alignment = properties.limits.minUniformBufferOffsetAlignment > 0 ? properties.limits.minUniformBufferOffsetAlignment : 1;
+		ring.slotSize = slotSize;
+		ring.stride = (slotSize + alignment - 1) / alignment * alignment;
+		ring.atomSize = properties.limits.nonCoherentAtomSize > 0 ? properties.limits.nonCoherentAtomSize : 1;
+		ring.slotsPerChunk = slotsPerChunk;
+		ring.frame = 0;
+		ring.head = 0;
 
-			memory += lightDataBufferSize;
-		}
-		memory = 0;
+		addUniformChunk(ring);
+	}
 
-		core::vector<Entity> actorsLinkedEntities = componentManager->collectLinkedEntities<cm::transform,
-																								cm::material,
-																								cm::mesh>();
-		
-		core::vector<Entity> directionalLightLinkedEntities = componentManager->collectLinkedEntities<cm::directionalLight>();
-		directionalLightUboDescriptorsNumber = (actorsLinkedEntities.GetSize() * UBO_multiplier) * directionalLightLinkedEntities.GetSize();
+	/// Memory type not forced to be coherent, flushUniformRing covers non coherent one.
+	void CVulkanRenderer::addUniformChunk(UniformRing& ring) {
+		UniformChunk chunk;
+		createBuffer(ring.stride * ring.slotsPerChunk * MAX_FRAMES_IN_FLIGHT, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+					 chunk.buffer, chunk.memory);
 
-		if ( directionalLightUboDescriptorsNumber > 0 ) {
-			shadowMapDirectionalLightModelMatrixUniformBuffers.resize(1);
-			shadowMapDirectionalLightModelMatrixUniformBuffersMemory.resize(1);
+		VkMemoryRequirements memRequirements;
+		vkGetBufferMemoryRequirements(device, chunk.buffer, &memRequirements);
+		chunk.allocationSize = memRequirements.size;
 
-			for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT * directionalLightUboDescriptorsNumber; i++) {
-				memory += modelShadowMapMatrixBufferSize;
-			}
+		VkPhysicalDeviceMemoryProperties memProperties;
+		vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+		uint32_t memoryType = findMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+		chunk.coherent = memProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
 
-			createBuffer(memory, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-						 shadowMapDirectionalLightModelMatrixUniformBuffers[0], shadowMapDirectionalLightModelMatrixUniformBuffersMemory[0]);
-		} else {
-			shadowMapDirectionalLightModelMatrixUniformBuffers.resize(1);
-			shadowMapDirectionalLightModelMatrixUniformBuffersMemory.resize(1);
+		void* data = nullptr;
+		if ( vkMapMemory(device, chunk.memory, 0, VK_WHOLE_SIZE, 0, &data) != VK_SUCCESS )
+			throw std::runtime_error("failed to map uniform buffer memory!");
 
-			createBuffer(2 * modelShadowMapMatrixBufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-						 shadowMapDirectionalLightModelMatrixUniformBuffers[0], shadowMapDirectionalLightModelMatrixUniformBuffersMemory[0]);
+		chunk.mapped = static_cast<char*>(data);
 
+		/// Chunk added while frame is recorded gets own sets, sets already used by gpu stay untouched.
+		if ( ring.setLayout != VK_NULL_HANDLE ) {
+			allocateUniformChunkDescriptorSets(ring.setLayout, chunk);
+			writeUniformChunkDescriptorSets(ring, chunk);
 		}
-		memory = 0;
-
-		core::vector<Entity> spotLightLinkedEntities = componentManager->collectLinkedEntities<cm::spotLight>();
-		spotLightUboDescriptorsNumber = (actorsLinkedEntities.GetSize() * UBO_multiplier) * spotLightLinkedEntities.GetSize();
 
-		if ( spotLightUboDescriptorsNumber > 0 ) {
-			shadowMapSpotLightModelMatrixUniformBuffers.resize(1);
-			shadowMapSpotLightModelMatrixUniformBuffersMemory.resize(1);
+		ring.chunks.push_back(std::move(chunk));
+	}
 
-			for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT * spotLightUboDescriptorsNumber; i++) {
-				memory += modelShadowMapMatrixBufferSize;
-			}
+	UniformAllocation CVulkanRenderer::allocateUniform(UniformRing& ring, const void* data, size_t size) {
+		if ( ring.head >= ring.getCapacity() )
+			addUniformChunk(ring);
 
-			createBuffer(memory, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-						 shadowMapSpotLightModelMatrixUniformBuffers[0], shadowMapSpotLightModelMatrixUniformBuffersMemory[0]);
-		} else {
-			shadowMapSpotLightModelMatrixUniformBuffers.resize(1);
-			shadowMapSpotLightModelMatrixUniformBuffersMemory.resize(1);
+		return ring.allocate(data, size);
+	}
 
-			createBuffer(2 * modelShadowMapMatrixBufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-						 shadowMapSpotLightModelMatrixUniformBuffers[0], shadowMapSpotLightModelMatrixUniformBuffersMemory[0]);
+	/// Only chunks written in current frame flushed, every chunk from begin of frame region to last used slot.
+	void CVulkanRenderer::flushUniformRing(const UniformRing& ring) {
+		for ( uint32_t i = 0; i * ring.slotsPerChunk < ring.head; ++i ) {
+			const UniformChunk& chunk = ring.chunks[i];
+			if ( chunk.coherent )
+				continue;
+
+			uint32_t usedSlots = std::min(ring.head - i * ring.slotsPerChunk, ring.slotsPerChunk);
+			VkDeviceSize regionBegin = ring.frame * ring.slotsPerChunk * ring.stride;
+			VkDeviceSize begin = regionBegin / ring.atomSize * ring.atomSize;
+			VkDeviceSize end = (regionBegin + usedSlots * ring.stride + ring.atomSize - 1) / ring.atomSize * ring.atomSize;
+
+			VkMappedMemoryRange range{};
+			range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+			range.memory = chunk.memory;
+			range.offset = begin;
+			range.size = end < chunk.allocationSize ? end - begin : VK_WHOLE_SIZE;
+			vkFlushMappedMemoryRanges(device, 1, &range);
 		}
-		memory = 0;
-
-		core::vector<Entity> pointLightsLinkedEntities = componentManager->collectLinkedEntities<cm::transform,
-																								 cm::material,
-																								 cm::mesh>();
-
-		
-		pointLightUboDescriptorsNumber = (actorsLinkedEntities.GetSize() * UBO_multiplier) * pointLightsLinkedEntities.GetSize();
-
-		if ( pointLightUboDescriptorsNumber > 0 ) {
-			shadowMapPointLightModelMatrixUniformBuffers.resize(1);
-			shadowMapPointLightModelMatrixUniformBuffersMemory.resize(1);
-
-			for (size_t i = 0; i < 6 * MAX_FRAMES_IN_FLIGHT * pointLightUboDescriptorsNumber; i++) {
-				memory += modelCubeShadowMapMatrixBufferSize;
-			}
-
-			createBuffer(memory, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-							 shadowMapPointLightModelMatrixUniformBuffers[0], shadowMapPointLightModelMatrixUniformBuffersMemory[0]);
-		} else {
-			shadowMapPointLightModelMatrixUniformBuffers.resize(1);
-			shadowMapPointLightModelMatrixUniformBuffersMemory.resize(1);
+	}
 
-			createBuffer(6 * 2 * modelCubeShadowMapMatrixBufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-						 shadowMapPointLightModelMatrixUniformBuffers[0], shadowMapPointLightModelMatrixUniformBuffersMemory[0]);
+	/// Descriptor sets freed with descriptor pool.
+	void CVulkanRenderer::destroyUniformRing(UniformRing& ring) {
+		for ( UniformChunk& chunk : ring.chunks ) {
+			vkUnmapMemory(device, chunk.memory);
+			vkDestroyBuffer(device, chunk.buffer, nullptr);
+			vkFreeMemory(device, chunk.memory, nullptr);
 		}
-		memory += modelCubeShadowMapMatrixBufferSize;			
-		
-		core::vector<Entity> viewPositionLinkedEntities = componentManager->collectLinkedEntities<cm::transform,
-																								  cm::beholder,
-																								  cm::mesh>();
-		
-		lightDataUniformBuffers.resize(MAX_FRAMES_IN_FLIGHT);
-		lightDataUniformBuffersMemory.resize(MAX_FRAMES_IN_FLIGHT);
 
-		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-			createBuffer(lightDataBufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-						 lightDataUniformBuffers[i], lightDataUniformBuffersMemory[i]);
-
-			memory += lightDataBufferSize;
-		}
-    }
+		ring = UniformRing();
+	}
 
+    /*! Size of pool depends only on textures number. Sets of uniform chunks live in own pools:
+	 *  first one sized for chunks of all rings, next one added when rings grow past it.
+	 */
     void CVulkanRenderer::createMainRenderDescriptorPool() {
-        std::array<VkDescriptorPoolSize, 2> poolSizes{};
+		uint32_t texturesNumber = initializeTextureData_.size();
+		uint32_t lightSamplersNumber = 0;
+		for ( unsigned int i = 0; i < mainRenderScenePipeline.descriptors[3].descriptorsNumber.GetSize(); ++i )
+			lightSamplersNumber += mainRenderScenePipeline.descriptors[3].descriptorsNumber[i];
 
-		uint32_t descriptorCount = 50000;
-        poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        poolSizes[0].descriptorCount = static_cast<uint32_t>(descriptorCount);
-		poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        poolSizes[1].descriptorCount = static_cast<uint32_t>(descriptorCount);
+		uint32_t samplerSetsNumber = 2 * MAX_FRAMES_IN_FLIGHT * texturesNumber;
+		uint32_t storageSetsNumber = MAX_FRAMES_IN_FLIGHT * (INSTANCE_PASSES_NUMBER + 1);    ///< And set of culling shader.
+
+        std::array<VkDescriptorPoolSize, 2> poolSizes{};
+		poolSizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        poolSizes[0].descriptorCount = MAX_FRAMES_IN_FLIGHT * texturesNumber * (1 + lightSamplersNumber);
+		if ( poolSizes[0].descriptorCount == 0 )
+			poolSizes[0].descriptorCount = 1;
+		poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		poolSizes[1].descriptorCount = 3 * storageSetsNumber;                ///< Instances, palettes or draws and visible instances.
 
         VkDescriptorPoolCreateInfo poolInfo{};
         poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
         poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
         poolInfo.pPoolSizes = poolSizes.data();
-        poolInfo.maxSets = static_cast<uint32_t>(descriptorCount);
+        poolInfo.maxSets = samplerSetsNumber + storageSetsNumber;
 
         if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &descriptorPool) != VK_SUCCESS) {
             throw std::runtime_error("failed to create descriptor pool!");
         }
+
+		/// Model matrix and light data of main pass and matrices of three shadow passes.
+		uint32_t chunksNumber = viewMatrixRing.chunks.size() + lightDataRing.chunks.size() + shadowMapDirectionalLightModelMatrixRing.chunks.size() +
+			shadowMapSpotLightModelMatrixRing.chunks.size() + shadowMapPointLightModelMatrixRing.chunks.size();
+		createUniformDescriptorPool(chunksNumber + UNIFORM_POOL_CHUNKS);
     }
 
-    void CVulkanRenderer::createDirectionalLightShadowMapDescriptorSets() {
-		core::vector<u32> dirLightBindings = directionalLightPipeline.getBindingOfDescriptor(DescriptorsTypes::DIRECTIONAL_LIGHT_SHADOW_MAP_MATRIX_UBO);
+	void CVulkanRenderer::createUniformDescriptorPool(uint32_t chunksNumber) {
+		VkDescriptorPoolSize poolSize{};
+		poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+		poolSize.descriptorCount = MAX_FRAMES_IN_FLIGHT * chunksNumber;
 
-		int directionalLightShadowMapMatrixUboBinding = dirLightBindings[0];
-		
-		unsigned int actual_size = directionalLightUboDescriptorsNumber ? directionalLightUboDescriptorsNumber : 1;
-		
-		std::vector<VkDescriptorSetLayout> matrixUboLayouts(MAX_FRAMES_IN_FLIGHT * actual_size,
-															directionalLightPipeline.descriptors[directionalLightShadowMapMatrixUboBinding].setLayout);
-		VkDescriptorSetAllocateInfo matrixUboAllocInfo{};
-		matrixUboAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-		matrixUboAllocInfo.descriptorPool = descriptorPool;
-		matrixUboAllocInfo.descriptorSetCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT *
-																	  actual_size);
-		matrixUboAllocInfo.pSetLayouts = matrixUboLayouts.data();
-			
-		shadowMapDirectionalLightDescriptorSets.resize(MAX_FRAMES_IN_FLIGHT * actual_size);
-		if (vkAllocateDescriptorSets(device, &matrixUboAllocInfo, shadowMapDirectionalLightDescriptorSets.data()) != VK_SUCCESS) {
+		VkDescriptorPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolInfo.poolSizeCount = 1;
+		poolInfo.pPoolSizes = &poolSize;
+		poolInfo.maxSets = MAX_FRAMES_IN_FLIGHT * chunksNumber;
+
+		VkDescriptorPool pool;
+		if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &pool) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create uniform descriptor pool!");
+		}
+
+		uniformDescriptorPools.push_back(pool);
+		uniformPoolFreeChunks = chunksNumber;
+	}
+
+	/// Every chunk takes one set per frame in flight, all sets of chunk from the same pool.
+	void CVulkanRenderer::allocateUniformChunkDescriptorSets(VkDescriptorSetLayout setLayout, UniformChunk& chunk) {
+		if ( uniformPoolFreeChunks == 0 )
+			createUniformDescriptorPool(UNIFORM_POOL_CHUNKS);
+
+		allocateDescriptorSets(setLayout, chunk.descriptorSets, MAX_FRAMES_IN_FLIGHT, uniformDescriptorPools.back());
+		--uniformPoolFreeChunks;
+	}
+
+	void CVulkanRenderer::allocateDescriptorSets(VkDescriptorSetLayout setLayout, std::vector<VkDescriptorSet>& descriptorSets, uint32_t setsNumber,
+												 VkDescriptorPool pool) {
+		std::vector<VkDescriptorSetLayout> layouts(setsNumber, setLayout);
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = pool != VK_NULL_HANDLE ? pool : descriptorPool;
+		allocInfo.descriptorSetCount = setsNumber;
+		allocInfo.pSetLayouts = layouts.data();
+
+		descriptorSets.resize(setsNumber);
+		if (vkAllocateDescriptorSets(device, &allocInfo, descriptorSets.data()) != VK_SUCCESS) {
 			throw std::runtime_error("failed to allocate descriptor sets!");
 		}
+	}
+
+	/// Sets of chunks created before layout was known allocated here, later chunks get them in addUniformChunk.
+	void CVulkanRenderer::setUniformRingLayout(UniformRing& ring, VkDescriptorSetLayout setLayout, uint32_t binding) {
+		ring.setLayout = setLayout;
+		ring.binding = binding;
+		for ( UniformChunk& chunk : ring.chunks ) {
+			if ( chunk.descriptorSets.empty() )
+				allocateUniformChunkDescriptorSets(setLayout, chunk);
+
+			writeUniformChunkDescriptorSets(ring, chunk);
+		}
+	}
+
+	/// Every set points on first slot of chunk, slot of draw chosen by dynamic offset in vkCmdBindDescriptorSets.
+	void CVulkanRenderer::writeUniformChunkDescriptorSets(const UniformRing& ring, const UniformChunk& chunk) {
+		for ( size_t i = 0; i < chunk.descriptorSets.size(); ++i ) {
+			VkDescriptorBufferInfo bufferInfo{};
+			bufferInfo.buffer = chunk.buffer;
+			bufferInfo.offset = 0;
+			bufferInfo.range = ring.slotSize;
 
-		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT * actual_size; ++i) {
-			VkDescriptorBufferInfo modelMatrixBufferInfo{};
-			modelMatrixBufferInfo.buffer = shadowMapDirectionalLightModelMatrixUniformBuffers[0];
-			modelMatrixBufferInfo.offset = i * sizeof(ShadowMapMatrixUBO);
-			modelMatrixBufferInfo.range = sizeof(ShadowMapMatrixUBO);
-			
 			std::array<VkWriteDescriptorSet, 1> descriptorWrites{};
-			
+
 			descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWrites[0].dstSet = shadowMapDirectionalLightDescriptorSets[i];
-			descriptorWrites[0].dstBinding = directionalLightShadowMapMatrixUboBinding;
+			descriptorWrites[0].dstSet = chunk.descriptorSets[i];
+			descriptorWrites[0].dstBinding = ring.binding;
 			descriptorWrites[0].dstArrayElement = 0;
-			descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+			descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
 			descriptorWrites[0].descriptorCount = 1;
-			descriptorWrites[0].pBufferInfo = &modelMatrixBufferInfo;
+			descriptorWrites[0].pBufferInfo = &bufferInfo;
 
 			vkUpdateDescriptorSets(device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
 		}
 	}
 
+	void CVulkanRenderer::writeUniformRingDescriptorSets(const UniformRing& ring) {
+		for ( const UniformChunk& chunk : ring.chunks )
+			writeUniformChunkDescriptorSets(ring, chunk);
+	}
+
+	/// Buffers created by first upload, when size of instances is known.
+	void CVulkanRenderer::createInstanceBuffer(InstanceBuffer& instanceBuffer, VkDescriptorSetLayout setLayout) {
+		VkPhysicalDeviceProperties properties{};
+		vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+		instanceBuffer.offsetAlignment = properties.limits.minStorageBufferOffsetAlignment > 0 ? properties.limits.minStorageBufferOffsetAlignment : 1;
+
+		std::vector<VkDescriptorSet> descriptorSets;
+		allocateDescriptorSets(setLayout, descriptorSets, MAX_FRAMES_IN_FLIGHT);
+
+		instanceBuffer.frames.resize(MAX_FRAMES_IN_FLIGHT);
+		for ( uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i )
+			instanceBuffer.frames[i].descriptorSet = descriptorSets[i];
+	}
+
+	/// Host visible buffer mapped until it is destroyed, memory type not forced to be coherent.
+	char* CVulkanRenderer::createMappedBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkBuffer& buffer, VkDeviceMemory& memory, bool& coherent) {
+		createBuffer(size, usage, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, buffer, memory);
+
+		VkMemoryRequirements memRequirements;
+		vkGetBufferMemoryRequirements(device, buffer, &memRequirements);
+		VkPhysicalDeviceMemoryProperties memProperties;
+		vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+		uint32_t memoryType = findMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+		coherent = memProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+		void* data = nullptr;
+		if ( vkMapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, &data) != VK_SUCCESS )
+			throw std::runtime_error("failed to map buffer memory!");
+
+		return static_cast<char*>(data);
+	}
+
+	/*! Buffer at least doubled when it grows, so reallocation is rare when number of actors rises.
+	 *  Visible indices written later by recordShadowMapInstances, so range of binding 2 must hold
+	 *  visible instances of every light of pass.
+	 */
+	void CVulkanRenderer::uploadInstances(InstanceBuffer& instanceBuffer, uint32_t frame, uint32_t visibleCapacity) {
+		InstanceFrame& instanceFrame = instanceBuffer.frames[frame];
+		VkDeviceSize alignment = instanceBuffer.offsetAlignment;
+		VkDeviceSize instancesSize = std::max<size_t>(instances.size(), 1) * sizeof(InstanceData);
+		VkDeviceSize palettesOffset = (instancesSize + alignment - 1) / alignment * alignment;
+		VkDeviceSize palettesSize = instancePalettes.size() * sizeof(mat4);
+		VkDeviceSize visibleOffset = (palettesOffset + palettesSize + alignment - 1) / alignment * alignment;
+		VkDeviceSize visibleSize = std::max<uint32_t>(visibleCapacity, 1) * sizeof(uint32_t);
+		VkDeviceSize size = visibleCapacity > 0 ? visibleOffset + visibleSize : palettesOffset + palettesSize;
+
+		if ( size > instanceFrame.size ) {
+			if ( instanceFrame.buffer != VK_NULL_HANDLE ) {
+				vkUnmapMemory(device, instanceFrame.memory);
+				vkDestroyBuffer(device, instanceFrame.buffer, nullptr);
+				vkFreeMemory(device, instanceFrame.memory, nullptr);
+			}
+
+			instanceFrame.size = std::max(size, instanceFrame.size * 2);
+			instanceFrame.mapped = createMappedBuffer(instanceFrame.size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+													  instanceFrame.buffer, instanceFrame.memory, instanceFrame.coherent);
+		}
+
+		memcpy(instanceFrame.mapped, instances.data(), instances.size() * sizeof(InstanceData));
+		memcpy(instanceFrame.mapped + palettesOffset, instancePalettes.data(), palettesSize);
+		instanceFrame.visibleOffset = visibleOffset;
+		instanceFrame.visibleCapacity = visibleCapacity;
+		instanceFrame.visibleNumber = 0;
+
+		/// Set of this frame not used by gpu after fence, so ranges rewritten every frame.
+		std::array<VkDescriptorBufferInfo, 3> bufferInfos{};
+		bufferInfos[0].buffer = instanceFrame.buffer;
+		bufferInfos[0].offset = 0;
+		bufferInfos[0].range = instancesSize;
+		bufferInfos[1].buffer = instanceFrame.buffer;
+		bufferInfos[1].offset = palettesOffset;
+		bufferInfos[1].range = palettesSize;
+		bufferInfos[2].buffer = instanceFrame.buffer;
+		bufferInfos[2].offset = visibleOffset;
+		bufferInfos[2].range = visibleSize;
+
+		/// Visible indices of main pass written by culling shader in buffer of uploadIndirectDraws.
+		std::array<VkWriteDescriptorSet, 3> descriptorWrites{};
+		uint32_t writesNumber = visibleCapacity > 0 ? 3 : 2;
+		for ( uint32_t i = 0; i < writesNumber; ++i ) {
+			descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			descriptorWrites[i].dstSet = instanceFrame.descriptorSet;
+			descriptorWrites[i].dstBinding = i;
+			descriptorWrites[i].dstArrayElement = 0;
+			descriptorWrites[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			descriptorWrites[i].descriptorCount = 1;
+			descriptorWrites[i].pBufferInfo = &bufferInfos[i];
+		}
+
+		vkUpdateDescriptorSets(device, writesNumber, descriptorWrites.data(), 0, nullptr);
+	}
+
+	/// After recording, visible indices of shadow passes written by then.
+	void CVulkanRenderer::flushInstances(const InstanceBuffer& instanceBuffer, uint32_t frame) {
+		const InstanceFrame& instanceFrame = instanceBuffer.frames[frame];
+		if ( instanceFrame.coherent )
+			return;
+
+		VkMappedMemoryRange range{};
+		range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+		range.memory = instanceFrame.memory;
+		range.offset = 0;
+		range.size = VK_WHOLE_SIZE;
+		vkFlushMappedMemoryRanges(device, 1, &range);
+	}
+
+	/// Descriptor sets freed with descriptor pool.
+	void CVulkanRenderer::destroyInstanceBuffer(InstanceBuffer& instanceBuffer) {
+		for ( InstanceFrame& instanceFrame : instanceBuffer.frames ) {
+			if ( instanceFrame.buffer == VK_NULL_HANDLE )
+				continue;
+
+			vkUnmapMemory(device, instanceFrame.memory);
+			vkDestroyBuffer(device, instanceFrame.buffer, nullptr);
+			vkFreeMemory(device, instanceFrame.memory, nullptr);
+		}
+
+		instanceBuffer = InstanceBuffer();
+	}
+
+	/// Buffers created by first upload, like instance buffers.
+	void CVulkanRenderer::createIndirectFrames() {
+		std::vector<VkDescriptorSet> descriptorSets;
+		allocateDescriptorSets(cullingPipeline.descriptors[0].setLayout, descriptorSets, MAX_FRAMES_IN_FLIGHT);
+
+		indirectFrames.resize(MAX_FRAMES_IN_FLIGHT);
+		for ( uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i )
+			indirectFrames[i].descriptorSet = descriptorSets[i];
+	}
+
+	/*! Draws of frame reset to zero instances and copied with instance groups of this frame.
+	 *  Buffers grow like instance buffers. Set of culling shader and set 4 of main pass
+	 *  rewritten every frame, because instance buffer of frame may be recreated.
+	 */
+	void CVulkanRenderer::uploadIndirectDraws(uint32_t frame) {
+		IndirectFrame& indirectFrame = indirectFrames[frame];
+		const InstanceFrame& instanceFrame = mainRenderInstanceBuffer.frames[frame];
+
+		VkDeviceSize drawsSize = std::max<size_t>(indirectDraws.size(), 1) * sizeof(IndirectDraw);
+		if ( drawsSize > indirectFrame.drawsSize ) {
+			if ( indirectFrame.drawsBuffer != VK_NULL_HANDLE ) {
+				vkUnmapMemory(device, indirectFrame.drawsMemory);
+				vkDestroyBuffer(device, indirectFrame.drawsBuffer, nullptr);
+				vkFreeMemory(device, indirectFrame.drawsMemory, nullptr);
+			}
+
+			indirectFrame.drawsSize = std::max(drawsSize, indirectFrame.drawsSize * 2);
+			indirectFrame.drawsMapped = createMappedBuffer(indirectFrame.drawsSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+														   indirectFrame.drawsBuffer, indirectFrame.drawsMemory, indirectFrame.drawsCoherent);
+		}
+
+		VkDeviceSize visibleSize = std::max<size_t>(instances.size(), 1) * sizeof(uint32_t);
+		if ( visibleSize > indirectFrame.visibleSize ) {
+			if ( indirectFrame.visibleBuffer != VK_NULL_HANDLE ) {
+				vkDestroyBuffer(device, indirectFrame.visibleBuffer, nullptr);
+				vkFreeMemory(device, indirectFrame.visibleMemory, nullptr);
+			}
+
+			indirectFrame.visibleSize = std::max(visibleSize, indirectFrame.visibleSize * 2);
+			createBuffer(indirectFrame.visibleSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+						 indirectFrame.visibleBuffer, indirectFrame.visibleMemory);
+		}
+
+		memcpy(indirectFrame.drawsMapped, indirectDraws.data(), indirectDraws.size() * sizeof(IndirectDraw));
+		indirectFrame.drawsNumber = static_cast<uint32_t>(indirectDraws.size());
+		indirectFrame.instancesNumber = static_cast<uint32_t>(instances.size());
+
+		if ( !indirectFrame.drawsCoherent ) {
+			VkMappedMemoryRange range{};
+			range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+			range.memory = indirectFrame.drawsMemory;
+			range.offset = 0;
+			range.size = VK_WHOLE_SIZE;
+			vkFlushMappedMemoryRanges(device, 1, &range);
+		}
+
+		std::array<VkDescriptorBufferInfo, 3> bufferInfos{};
+		bufferInfos[0].buffer = instanceFrame.buffer;
+		bufferInfos[0].offset = 0;
+		bufferInfos[0].range = std::max<size_t>(instances.size(), 1) * sizeof(InstanceData);
+		bufferInfos[1].buffer = indirectFrame.drawsBuffer;
+		bufferInfos[1].offset = 0;
+		bufferInfos[1].range = drawsSize;
+		bufferInfos[2].buffer = indirectFrame.visibleBuffer;
+		bufferInfos[2].offset = 0;
+		bufferInfos[2].range = visibleSize;
+
+		std::array<VkWriteDescriptorSet, 4> descriptorWrites{};
+		for ( uint32_t i = 0; i < descriptorWrites.size(); ++i ) {
+			descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			descriptorWrites[i].dstSet = indirectFrame.descriptorSet;
+			descriptorWrites[i].dstBinding = i;
+			descriptorWrites[i].dstArrayElement = 0;
+			descriptorWrites[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			descriptorWrites[i].descriptorCount = 1;
+			descriptorWrites[i].pBufferInfo = &bufferInfos[i];
+		}
+
+		/// Visible instances read by vertex shader of main pass.
+		descriptorWrites[3].dstSet = instanceFrame.descriptorSet;
+		descriptorWrites[3].dstBinding = 2;
+		descriptorWrites[3].pBufferInfo = &bufferInfos[2];
+
+		vkUpdateDescriptorSets(device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+	}
+
+	/// Instance counts written by culling shader in last frame that used draws buffer of frame.
+	void CVulkanRenderer::readIndirectDrawCounts(uint32_t frame) {
+		const IndirectFrame& indirectFrame = indirectFrames[frame];
+		mainPassCullingStats = core::CullingStats();
+		if ( indirectFrame.drawsNumber == 0 )
+			return;
+
+		if ( !indirectFrame.drawsCoherent ) {
+			VkMappedMemoryRange range{};
+			range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+			range.memory = indirectFrame.drawsMemory;
+			range.offset = 0;
+			range.size = VK_WHOLE_SIZE;
+			vkInvalidateMappedMemoryRanges(device, 1, &range);
+		}
+
+		const IndirectDraw* draws = reinterpret_cast<const IndirectDraw*>(indirectFrame.drawsMapped);
+		for ( uint32_t i = 0; i < indirectFrame.drawsNumber; ++i )
+			mainPassCullingStats.visible += draws[i].command.instanceCount;
+
+		mainPassCullingStats.tested = indirectFrame.instancesNumber;
+		mainPassCullingStats.culled = indirectFrame.instancesNumber - mainPassCullingStats.visible;
+	}
+
+	/// Every instance tested by one invocation, draws of main pass and host read counts only after barrier.
+	void CVulkanRenderer::recordInstanceCulling(VkCommandBuffer& commandBuffer) {
+		if ( instances.empty() )
+			return;
+
+		CullingConstants constants{};
+		core::ExtractFrustumPlanes(viewMatrix * projectionMatrix, constants.frustumPlanes);
+		constants.instancesNumber = static_cast<uint32_t>(instances.size());
+		constants.cullingEnabled = gpuCulling ? 1 : 0;
+
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, cullingPipeline.pipeline);
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, cullingPipeline.pipelineLayout,
+								0, 1, &indirectFrames[currentFrame].descriptorSet, 0, nullptr);
+		vkCmdPushConstants(commandBuffer, cullingPipeline.pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+		vkCmdDispatch(commandBuffer, (constants.instancesNumber + CULLING_GROUP_SIZE - 1) / CULLING_GROUP_SIZE, 1, 1);
+
+		VkMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_HOST_READ_BIT;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+							 VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_HOST_BIT,
+							 0, 1, &barrier, 0, nullptr, 0, nullptr);
+	}
+
+	void CVulkanRenderer::destroyIndirectFrames() {
+		for ( IndirectFrame& indirectFrame : indirectFrames ) {
+			if ( indirectFrame.drawsBuffer != VK_NULL_HANDLE ) {
+				vkUnmapMemory(device, indirectFrame.drawsMemory);
+				vkDestroyBuffer(device, indirectFrame.drawsBuffer, nullptr);
+				vkFreeMemory(device, indirectFrame.drawsMemory, nullptr);
+			}
+
+			if ( indirectFrame.visibleBuffer != VK_NULL_HANDLE ) {
+				vkDestroyBuffer(device, indirectFrame.visibleBuffer, nullptr);
+				vkFreeMemory(device, indirectFrame.visibleMemory, nullptr);
+			}
+		}
+
+		indirectFrames.clear();
+	}
+
+    void CVulkanRenderer::createDirectionalLightShadowMapDescriptorSets() {
+		core::vector<u32> dirLightBindings = directionalLightPipeline.getBindingOfDescriptor(DescriptorsTypes::DIRECTIONAL_LIGHT_SHADOW_MAP_MATRIX_UBO);
+
+		int directionalLightShadowMapMatrixUboBinding = dirLightBindings[0];
+
+		setUniformRingLayout(shadowMapDirectionalLightModelMatrixRing, directionalLightPipeline.descriptors[directionalLightShadowMapMatrixUboBinding].setLayout, directionalLightShadowMapMatrixUboBinding);
+		createInstanceBuffer(directionalLightInstanceBuffer, directionalLightPipeline.descriptors[1].setLayout);
+	}
+
     void CVulkanRenderer::createSpotLightShadowMapDescriptorSets() {
 		core::vector<u32> spotLightsBindings = spotLightPipeline.getBindingOfDescriptor(DescriptorsTypes::SPOT_LIGHT_SHADOW_MAP_MATRIX_UBO);
  
 		int spotLightShadowMapMatrixUboBinding = spotLightsBindings[0];
-		
-		unsigned int actual_size = spotLightUboDescriptorsNumber ? spotLightUboDescriptorsNumber : 1;
-		
-		std::vector<VkDescriptorSetLayout> matrixUboLayouts(MAX_FRAMES_IN_FLIGHT * actual_size,
-															spotLightPipeline.descriptors[spotLightShadowMapMatrixUboBinding].setLayout);
-		VkDescriptorSetAllocateInfo matrixUboAllocInfo{};
-		matrixUboAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-		matrixUboAllocInfo.descriptorPool = descriptorPool;
-		matrixUboAllocInfo.descriptorSetCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT *
-																	  actual_size);
-		matrixUboAllocInfo.pSetLayouts = matrixUboLayouts.data();
-			
-		shadowMapSpotLightDescriptorSets.resize(MAX_FRAMES_IN_FLIGHT * actual_size);
-		if (vkAllocateDescriptorSets(device, &matrixUboAllocInfo, shadowMapSpotLightDescriptorSets.data()) != VK_SUCCESS) {
-			throw std::runtime_error("failed to allocate descriptor sets!");
-		}
-
-		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT * actual_size; ++i) {
-			VkDescriptorBufferInfo modelMatrixBufferInfo{};
-			modelMatrixBufferInfo.buffer = shadowMapSpotLightModelMatrixUniformBuffers[0];
-			modelMatrixBufferInfo.offset = i * sizeof(ShadowMapMatrixUBO);
-			modelMatrixBufferInfo.range = sizeof(ShadowMapMatrixUBO);
-			
-			std::array<VkWriteDescriptorSet, 1> descriptorWrites{};
-			
-			descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWrites[0].dstSet = shadowMapSpotLightDescriptorSets[i];
-			descriptorWrites[0].dstBinding = spotLightShadowMapMatrixUboBinding;
-			descriptorWrites[0].dstArrayElement = 0;
-			descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-			descriptorWrites[0].descriptorCount = 1;
-			descriptorWrites[0].pBufferInfo = &modelMatrixBufferInfo;
 
-			vkUpdateDescriptorSets(device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
-		}
+		setUniformRingLayout(shadowMapSpotLightModelMatrixRing, spotLightPipeline.descriptors[spotLightShadowMapMatrixUboBinding].setLayout, spotLightShadowMapMatrixUboBinding);
+		createInstanceBuffer(spotLightInstanceBuffer, spotLightPipeline.descriptors[1].setLayout);
 	}
 
 	void CVulkanRenderer::createPointLightShadowMapDescriptorSets() {
 		core::vector<u32> pointLightBindings = pointLightPipeline.getBindingOfDescriptor(DescriptorsTypes::POINT_LIGHT_SHADOW_MAP_MATRIX_UBO);
 
 		int pointLightShadowMapMatrixUboBinding = pointLightBindings[0];
-		
-		unsigned int point_light_shadow_map_actual_size = pointLightUboDescriptorsNumber ? pointLightUboDescriptorsNumber : 1; 
-		
-		if ( pointLightShadowMapMatrixUboBinding != -1 ) {
-			std::vector<VkDescriptorSetLayout> matrixUboLayouts(6 * MAX_FRAMES_IN_FLIGHT * point_light_shadow_map_actual_size,
-																pointLightPipeline.descriptors[pointLightShadowMapMatrixUboBinding].setLayout);
-			VkDescriptorSetAllocateInfo matrixUboAllocInfo{};
-			matrixUboAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-			matrixUboAllocInfo.descriptorPool = descriptorPool;
-			matrixUboAllocInfo.descriptorSetCount = static_cast<uint32_t>(6 * MAX_FRAMES_IN_FLIGHT *
-																		  point_light_shadow_map_actual_size);
-			matrixUboAllocInfo.pSetLayouts = matrixUboLayouts.data();
-
-			shadowMapPointLightDescriptorSets.resize(6 * MAX_FRAMES_IN_FLIGHT * point_light_shadow_map_actual_size);
-			if (vkAllocateDescriptorSets(device, &matrixUboAllocInfo, shadowMapPointLightDescriptorSets.data()) != VK_SUCCESS) {
-				throw std::runtime_error("failed to allocate descriptor sets!");
-			}
-
-			for (size_t i = 0; i < 6 * MAX_FRAMES_IN_FLIGHT * point_light_shadow_map_actual_size; ++i) {
-				VkDescriptorBufferInfo modelMatrixBufferInfo{};
-				modelMatrixBufferInfo.buffer = shadowMapPointLightModelMatrixUniformBuffers[0];
-				modelMatrixBufferInfo.offset = i * sizeof(PointLightShadowMapMatrixUBO);
-				modelMatrixBufferInfo.range = sizeof(PointLightShadowMapMatrixUBO);
-			
-				std::array<VkWriteDescriptorSet, 1> descriptorWrites{};
-			
-				descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-				descriptorWrites[0].dstSet = shadowMapPointLightDescriptorSets[i];
-				descriptorWrites[0].dstBinding = pointLightShadowMapMatrixUboBinding;
-				descriptorWrites[0].dstArrayElement = 0;
-				descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-				descriptorWrites[0].descriptorCount = 1;
-				descriptorWrites[0].pBufferInfo = &modelMatrixBufferInfo;
 
-				vkUpdateDescriptorSets(device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
-			}
+		if ( pointLightShadowMapMatrixUboBinding != -1 ) {
+			setUniformRingLayout(shadowMapPointLightModelMatrixRing, pointLightPipeline.descriptors[pointLightShadowMapMatrixUboBinding].setLayout, pointLightShadowMapMatrixUboBinding);
 		}
+
+		createInstanceBuffer(pointLightInstanceBuffer, pointLightPipeline.descriptors[1].setLayout);
 	}
 	
     void CVulkanRenderer::createMainRenderDescriptorSets() {
 		core::vector<u32> modelMatrixBindings = mainRenderScenePipeline.getBindingOfDescriptor(DescriptorsTypes::MODEL_MATRIX_UBO);
 
 		int modelMatrixUboBinding = modelMatrixBindings[0];
-		
-		unsigned int model_matrix_ubo_actual_size = matrixUboDescriptorsNumber ? matrixUboDescriptorsNumber : 1; 
-		
-		std::vector<VkDescriptorSetLayout> matrixUboLayouts(MAX_FRAMES_IN_FLIGHT * model_matrix_ubo_actual_size,
-															mainRenderScenePipeline.descriptors[0].setLayout);
-		VkDescriptorSetAllocateInfo matrixUboAllocInfo{};
-		matrixUboAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-		matrixUboAllocInfo.descriptorPool = descriptorPool;
-		matrixUboAllocInfo.descriptorSetCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT * model_matrix_ubo_actual_size);
-		matrixUboAllocInfo.pSetLayouts = matrixUboLayouts.data();
-			
-		matrixUboDescriptorSets.resize(MAX_FRAMES_IN_FLIGHT * model_matrix_ubo_actual_size);
-		if (vkAllocateDescriptorSets(device, &matrixUboAllocInfo, matrixUboDescriptorSets.data()) != VK_SUCCESS) {
-			throw std::runtime_error("failed to allocate descriptor sets!");
-		}
 
-		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT * model_matrix_ubo_actual_size; ++i) {
-			VkDescriptorBufferInfo modelMatrixBufferInfo{};
-			uint32_t uboIndex = 0;
-			if ( i > MAX_FRAMES_IN_FLIGHT * model_matrix_ubo_actual_size / 2 )
-				uboIndex = 1;
-			modelMatrixBufferInfo.buffer = modelMatrixUniformBuffers[uboIndex];
-			modelMatrixBufferInfo.offset = i * sizeof(ModelMatrixUBO);
-			modelMatrixBufferInfo.range = sizeof(ModelMatrixUBO);
-			
-			std::array<VkWriteDescriptorSet, 1> descriptorWrites{};
-			
-			descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWrites[0].dstSet = matrixUboDescriptorSets[i];
-			descriptorWrites[0].dstBinding = modelMatrixUboBinding;
-			descriptorWrites[0].dstArrayElement = 0;
-			descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-			descriptorWrites[0].descriptorCount = 1;
-			descriptorWrites[0].pBufferInfo = &modelMatrixBufferInfo;
-
-			vkUpdateDescriptorSets(device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
-		}
+		setUniformRingLayout(viewMatrixRing, mainRenderScenePipeline.descriptors[0].setLayout, modelMatrixUboBinding);
+		createInstanceBuffer(mainRenderInstanceBuffer, mainRenderScenePipeline.descriptors[4].setLayout);
 
 		core::vector<u32> lightDataBindings = mainRenderScenePipeline.getBindingOfDescriptor(DescriptorsTypes::LIGHT_DATA);
 
 		int lightDataUboBinding = lightDataBindings[0];
-		
-		std::vector<VkDescriptorSetLayout> lightDataUboLayouts(MAX_FRAMES_IN_FLIGHT,
-																  mainRenderScenePipeline.descriptors[1].setLayout);
-		VkDescriptorSetAllocateInfo lightDataUboAllocInfo{};
-		lightDataUboAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-		lightDataUboAllocInfo.descriptorPool = descriptorPool;
-		lightDataUboAllocInfo.descriptorSetCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
-		lightDataUboAllocInfo.pSetLayouts = lightDataUboLayouts.data();
-			
-		lightDataUboDescriptorSets.resize(MAX_FRAMES_IN_FLIGHT);
-		if (vkAllocateDescriptorSets(device, &lightDataUboAllocInfo, lightDataUboDescriptorSets.data()) != VK_SUCCESS) {
-			throw std::runtime_error("failed to allocate descriptor sets!");
-		}
 
-		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
-			VkDescriptorBufferInfo modelMatrixBufferInfo{};
-			modelMatrixBufferInfo.buffer = lightDataUniformBuffers[i];
-			modelMatrixBufferInfo.offset = 0;
-			modelMatrixBufferInfo.range = sizeof(LightData);
-			
-			std::array<VkWriteDescriptorSet, 1> descriptorWrites{};
-			
-			descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWrites[0].dstSet = lightDataUboDescriptorSets[i];
-			descriptorWrites[0].dstBinding = lightDataUboBinding;
-			descriptorWrites[0].dstArrayElement = 0;
-			descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-			descriptorWrites[0].descriptorCount = 1;
-			descriptorWrites[0].pBufferInfo = &modelMatrixBufferInfo;
-
-			vkUpdateDescriptorSets(device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
-		}
+		setUniformRingLayout(lightDataRing, mainRenderScenePipeline.descriptors[1].setLayout, lightDataUboBinding);
 
 		core::vector<u32> specularSamplerBindigs = mainRenderScenePipeline.getBindingOfDescriptor(DescriptorsTypes::SPECULAR_SAMPLER);
  
@@ -2534,104 +2796,23 @@ namespace GLVM::core
 	}
 	
 	void CVulkanRenderer::updateDirectionalLightShadowMapDescriptorSets() {
-		core::vector<u32> directionalLightBindigs = directionalLightPipeline.getBindingOfDescriptor(DescriptorsTypes::DIRECTIONAL_LIGHT_SHADOW_MAP_MATRIX_UBO);
-		int directionalLightShadowMapMatrixUboBinding = directionalLightBindigs[0];
-		
-		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT * directionalLightUboDescriptorsNumber; ++i) {
-				VkDescriptorBufferInfo modelMatrixBufferInfo{};
-				modelMatrixBufferInfo.buffer = shadowMapDirectionalLightModelMatrixUniformBuffers[0];
-				modelMatrixBufferInfo.offset = i * sizeof(ShadowMapMatrixUBO);
-				modelMatrixBufferInfo.range = sizeof(ShadowMapMatrixUBO);
-			
-				std::array<VkWriteDescriptorSet, 1> descriptorWrites{};
-			
-				descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-				descriptorWrites[0].dstSet = shadowMapDirectionalLightDescriptorSets[i];
-				descriptorWrites[0].dstBinding = directionalLightShadowMapMatrixUboBinding;
-				descriptorWrites[0].dstArrayElement = 0;
-				descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-				descriptorWrites[0].descriptorCount = 1;
-				descriptorWrites[0].pBufferInfo = &modelMatrixBufferInfo;
-
-				vkUpdateDescriptorSets(device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
-			}
+		writeUniformRingDescriptorSets(shadowMapDirectionalLightModelMatrixRing);
 	}
 
 	void CVulkanRenderer::updateSpotLightShadowMapDescriptorSets() {
-		core::vector<u32> spotLightBindings = spotLightPipeline.getBindingOfDescriptor(DescriptorsTypes::SPOT_LIGHT_SHADOW_MAP_MATRIX_UBO);
-		int spotLightShadowMapMatrixUboBinding = spotLightBindings[0];
-		
-		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT * spotLightUboDescriptorsNumber; ++i) {
-			VkDescriptorBufferInfo modelMatrixBufferInfo{};
-			modelMatrixBufferInfo.buffer = shadowMapSpotLightModelMatrixUniformBuffers[0];
-			modelMatrixBufferInfo.offset = i * sizeof(ShadowMapMatrixUBO);
-			modelMatrixBufferInfo.range = sizeof(ShadowMapMatrixUBO);
-			
-			std::array<VkWriteDescriptorSet, 1> descriptorWrites{};
-			
-			descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWrites[0].dstSet = shadowMapSpotLightDescriptorSets[i];
-			descriptorWrites[0].dstBinding = spotLightShadowMapMatrixUboBinding;
-			descriptorWrites[0].dstArrayElement = 0;
-			descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-			descriptorWrites[0].descriptorCount = 1;
-			descriptorWrites[0].pBufferInfo = &modelMatrixBufferInfo;
-
-			vkUpdateDescriptorSets(device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
-		}
+		writeUniformRingDescriptorSets(shadowMapSpotLightModelMatrixRing);
 	}
 
 	void CVulkanRenderer::updatePointLightShadowMapDescriptorSets() {
-		core::vector<u32> pointLightBindings = pointLightPipeline.getBindingOfDescriptor(DescriptorsTypes::POINT_LIGHT_SHADOW_MAP_MATRIX_UBO);
-		int pointLightShadowMapMatrixUboBinding = pointLightBindings[0];
-		
-		for (size_t i = 0; i < 6 * MAX_FRAMES_IN_FLIGHT * pointLightUboDescriptorsNumber; ++i) {
-			VkDescriptorBufferInfo modelMatrixBufferInfo{};
-			modelMatrixBufferInfo.buffer = shadowMapPointLightModelMatrixUniformBuffers[0];
-			modelMatrixBufferInfo.offset = i * sizeof(PointLightShadowMapMatrixUBO);
-			modelMatrixBufferInfo.range = sizeof(PointLightShadowMapMatrixUBO);
-			
-			std::array<VkWriteDescriptorSet, 1> descriptorWrites{};
-			
-			descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWrites[0].dstSet = shadowMapPointLightDescriptorSets[i];
-			descriptorWrites[0].dstBinding = pointLightShadowMapMatrixUboBinding;
-			descriptorWrites[0].dstArrayElement = 0;
-			descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-			descriptorWrites[0].descriptorCount = 1;
-			descriptorWrites[0].pBufferInfo = &modelMatrixBufferInfo;
-
-			vkUpdateDescriptorSets(device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
-		}
+		writeUniformRingDescriptorSets(shadowMapPointLightModelMatrixRing);
 	}
 	
     void CVulkanRenderer::updateDescriptorSets() {
 		core::vector<u32> modelMatrixBindings = mainRenderScenePipeline.getBindingOfDescriptor(DescriptorsTypes::MODEL_MATRIX_UBO);
 		int modelMatrixUboBinding = modelMatrixBindings[0];
 		
-		if ( modelMatrixUboBinding != -1 ) {
-			for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT * matrixUboDescriptorsNumber; ++i) {
-				VkDescriptorBufferInfo modelMatrixBufferInfo{};
-				uint32_t uboIndex = 0;
-				if ( i > MAX_FRAMES_IN_FLIGHT * matrixUboDescriptorsNumber / 2 )
-					uboIndex = 1;
-				modelMatrixBufferInfo.buffer = modelMatrixUniformBuffers[uboIndex];
-				modelMatrixBufferInfo.offset = i * sizeof(ModelMatrixUBO);
-				modelMatrixBufferInfo.range = sizeof(ModelMatrixUBO);
-			
-				std::array<VkWriteDescriptorSet, 1> descriptorWrites{};
-			
-				descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-				descriptorWrites[0].dstSet = matrixUboDescriptorSets[i];
-				descriptorWrites[0].dstBinding = modelMatrixUboBinding;
-				descriptorWrites[0].dstArrayElement = 0;
-				descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-				descriptorWrites[0].descriptorCount = 1;
-				descriptorWrites[0].pBufferInfo = &modelMatrixBufferInfo;
-
-				vkUpdateDescriptorSets(device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
-			}
-		}
+		if ( modelMatrixUboBinding != -1 )
+			writeUniformRingDescriptorSets(viewMatrixRing);
 
 		core::vector<u32> specularSamplerBindigs = mainRenderScenePipeline.getBindingOfDescriptor(DescriptorsTypes::SPECULAR_SAMPLER);
  		int specularSamplerBinding = specularSamplerBindigs[0];
@@ -2659,26 +2840,8 @@ namespace GLVM::core
 		core::vector<u32> lightDataBindigs = mainRenderScenePipeline.getBindingOfDescriptor(DescriptorsTypes::LIGHT_DATA);
 		int lightDataUboBinding = lightDataBindigs[0];
 		
-		if ( lightDataUboBinding != -1 ) {
-			for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT * lightDataSize; ++i) {
-				VkDescriptorBufferInfo modelMatrixBufferInfo{};
-				modelMatrixBufferInfo.buffer = lightDataUniformBuffers[i];
-				modelMatrixBufferInfo.offset = 0;
-				modelMatrixBufferInfo.range = sizeof(LightData);
-			
-				std::array<VkWriteDescriptorSet, 1> descriptorWrites{};
-			
-				descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-				descriptorWrites[0].dstSet = lightDataUboDescriptorSets[i];
-				descriptorWrites[0].dstBinding = lightDataUboBinding;
-				descriptorWrites[0].dstArrayElement = 0;
-				descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-				descriptorWrites[0].descriptorCount = 1;
-				descriptorWrites[0].pBufferInfo = &modelMatrixBufferInfo;
-
-				vkUpdateDescriptorSets(device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
-			}
-		}
+		if ( lightDataUboBinding != -1 )
+			writeUniformRingDescriptorSets(lightDataRing);
 
 		core::vector<u32> lightsSamplersBindings = mainRenderScenePipeline.getBindingOfDescriptor(DescriptorsTypes::LIGHT_SAMPLERS);
 		int diffuseCisBinding = lightsSamplersBindings[0];
@@ -2864,11 +3027,10 @@ namespace GLVM::core
         }
 
 		namespace cm = GLVM::ecs::components;
-		core::vector<Entity> linkedEntities      = componentManager->collectLinkedEntities<cm::transform,
-																						   cm::material,
-																						   cm::mesh>();
 		
 		CreateEndDebugUtilsLabelEXT(instance, commandBuffer);
+
+		recordInstanceCulling(commandBuffer);
 		
         VkRenderPassBeginInfo renderPassInfo{};
         renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
@@ -2905,43 +3067,41 @@ namespace GLVM::core
 
 		core::vector<Entity> viewPositionLinkedEntities = componentManager->collectLinkedEntities<cm::beholder>();
 
-		cm::transform* playerTransformComponent = nullptr;
+		const cm::transform* playerTransformComponent = nullptr;
 
 		if ( viewPositionLinkedEntities.GetSize() > 0 )
-			playerTransformComponent = componentManager->GetComponent<cm::transform>(viewPositionLinkedEntities[0]);
-
-		for ( unsigned int i = 0; i < linkedEntities.GetSize(); ++i ) {
-			unsigned int uiEntity = linkedEntities[i];
-			unsigned int uiVertexId = componentManager->GetComponent<ecs::components::mesh>(uiEntity)->handle.id;
-			cm::transform* transformComponent = componentManager->GetComponent<cm::transform>(uiEntity);
-			unsigned int diffuseTextureIndex = componentManager->GetComponent<cm::material>(uiEntity)->diffuseTextureID_.id;
-			unsigned int specularTextureIndex = componentManager->GetComponent<cm::material>(uiEntity)->specularTextureID_.id;
-			cm::material* materialComponent = componentManager->GetComponent<cm::material>(uiEntity);
-				
-			unsigned int uboIndex = i;
-			updateMatrixUniformBuffer(currentFrame, uboIndex, transformComponent, uiVertexId, materialComponent);
-			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mainRenderScenePipeline.pipelineLayout,
-									0, 1, &matrixUboDescriptorSets[uboIndex], 0, nullptr);
-
-			updateViewPositionUniformBuffer(currentFrame, playerTransformComponent);
-			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mainRenderScenePipeline.pipelineLayout,
-									1, 1, &lightDataUboDescriptorSets[currentFrame], 0, nullptr);
-
-			VkBuffer vertexBuffers[] = {vertexBufferContainer[uiVertexId]};
-			VkDeviceSize offsets[] = {0};
-			vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
-
-			vkCmdBindIndexBuffer(commandBuffer, indexBufferContainer[uiVertexId], 0, VK_INDEX_TYPE_UINT32);
-
-			unsigned int indicesContainerSize = aIndices_[uiVertexId].size();
+			playerTransformComponent = componentManager->GetComponent<const cm::transform>(viewPositionLinkedEntities[0]);
+
+		/// View, projection and light data same for all draws, written and bound once per frame.
+		UniformAllocation viewMatrix = updateViewMatrixUniformBuffer();
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mainRenderScenePipeline.pipelineLayout,
+								0, 1, viewMatrixRing.getDescriptorSet(viewMatrix), 1, &viewMatrix.offset);
+
+		UniformAllocation lightData = updateViewPositionUniformBuffer(playerTransformComponent);
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mainRenderScenePipeline.pipelineLayout,
+								1, 1, lightDataRing.getDescriptorSet(lightData), 1, &lightData.offset);
+
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mainRenderScenePipeline.pipelineLayout,
+								4, 1, &mainRenderInstanceBuffer.frames[currentFrame].descriptorSet, 0, nullptr);
+
+		/// Groups sorted by mesh, so buffers bound only when mesh changes. Instance count of draw written by culling shader.
+		uint32_t boundMesh = UINT32_MAX;
+		for ( uint32_t i = 0; i < instanceGroups.size(); ++i ) {
+			const InstanceGroup& group = instanceGroups[i];
+			if ( group.mesh != boundMesh ) {
+				VkBuffer vertexBuffers[] = {vertexBufferContainer[group.mesh]};
+				VkDeviceSize offsets[] = {0};
+				vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+				vkCmdBindIndexBuffer(commandBuffer, indexBufferContainer[group.mesh], 0, VK_INDEX_TYPE_UINT32);
+				boundMesh = group.mesh;
+			}
 
-//			updateSamplersDescriptroSets(diffuseTextureIndex, specularTextureIndex);
 			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mainRenderScenePipeline.pipelineLayout, 2, 1,
-									&specularSamplerDescriptorSets[MAX_FRAMES_IN_FLIGHT * specularTextureIndex + currentFrame], 0, nullptr);
+									&specularSamplerDescriptorSets[MAX_FRAMES_IN_FLIGHT * group.specularTexture + currentFrame], 0, nullptr);
 			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mainRenderScenePipeline.pipelineLayout, 3, 1,
-									&diffuseSamplerDescriptorSets[MAX_FRAMES_IN_FLIGHT * diffuseTextureIndex + currentFrame], 0, nullptr);
-			
-			vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(indicesContainerSize), 1, 0, 0, 0);
+									&diffuseSamplerDescriptorSets[MAX_FRAMES_IN_FLIGHT * group.diffuseTexture + currentFrame], 0, nullptr);
+
+			vkCmdDrawIndexedIndirect(commandBuffer, indirectFrames[currentFrame].drawsBuffer, i * sizeof(IndirectDraw), 1, sizeof(IndirectDraw));
 		}
 
         vkCmdEndRenderPass(commandBuffer);
@@ -2992,27 +3152,11 @@ namespace GLVM::core
 		dirLightSpaceMatrix[currentLight] = viewMatrixLight * directionalProjectionMatrixLight;
 	}
 	
-    void CVulkanRenderer::updateDirectionalLightShadowMapMatrixUBO(uint32_t currentImage, [[maybe_unused]] ecs::components::transform* _transformComponent,
-																   [[maybe_unused]] uint32_t currentLight, [[maybe_unused]] u32 meshID) {
-		ShadowMapMatrixUBO modelMatrixUBO{};
-
-        modelMatrixUBO.model = computeModelMatrix(_transformComponent);
-		modelMatrixUBO.lightSpaceMatrix = dirLightSpaceMatrix[currentLight];
-
-		mat4* jointMatricesData = updateAnimationFrames(_transformComponent, meshID);
-
-		for ( unsigned int j = 0; j < MAX_JOINTS_NUMBER; ++j ) {
-			modelMatrixUBO.jointMatrices[j] = jointMatricesData[j];
-		}
+    UniformAllocation CVulkanRenderer::updateDirectionalLightShadowMapMatrixUBO(uint32_t currentLight) {
+		ShadowMapMatrixUBO lightSpaceMatrixUBO{};
+		lightSpaceMatrixUBO.lightSpaceMatrix = dirLightSpaceMatrix[currentLight];
 
-		delete [] jointMatricesData;
-		jointMatricesData = nullptr;
-		
-        void* modelMatrixData = nullptr;
-        vkMapMemory(device, shadowMapDirectionalLightModelMatrixUniformBuffersMemory[0], currentImage * sizeof(modelMatrixUBO),
-					sizeof(modelMatrixUBO), 0, &modelMatrixData);
-        memcpy(modelMatrixData, &modelMatrixUBO, sizeof(modelMatrixUBO));
-        vkUnmapMemory(device, shadowMapDirectionalLightModelMatrixUniformBuffersMemory[0]);
+        return allocateUniform(shadowMapDirectionalLightModelMatrixRing, &lightSpaceMatrixUBO, sizeof(lightSpaceMatrixUBO));
     }
 
 	void CVulkanRenderer::updateSpotLightSpaceMatrixShadowMapUBO(ecs::components::spotLight* spotLightComponent,
@@ -3032,29 +3176,15 @@ namespace GLVM::core
 		spotLightSpaceMatrix[currentLight] = viewMatrixLight * spotProjectionMatrixLight;
 	}
 	
-    void CVulkanRenderer::updateSpotLightShadowMapMatrixUBO(uint32_t currentImage, [[maybe_unused]] ecs::components::transform* _transformComponent, [[maybe_unused]] uint32_t currentLight, [[maybe_unused]] u32 meshID) {
-		ShadowMapMatrixUBO modelMatrixUBO{};
-		
-        modelMatrixUBO.model = computeModelMatrix(_transformComponent);
-		modelMatrixUBO.lightSpaceMatrix = spotLightSpaceMatrix[currentLight];
+    UniformAllocation CVulkanRenderer::updateSpotLightShadowMapMatrixUBO(uint32_t currentLight) {
+		ShadowMapMatrixUBO lightSpaceMatrixUBO{};
+		lightSpaceMatrixUBO.lightSpaceMatrix = spotLightSpaceMatrix[currentLight];
 
-		mat4* jointMatricesData = updateAnimationFrames(_transformComponent, meshID);
-		
-		for ( unsigned int j = 0; j < MAX_JOINTS_NUMBER; ++j ) {
-			modelMatrixUBO.jointMatrices[j] = jointMatricesData[j];
-		}
-
-		delete [] jointMatricesData;
-		jointMatricesData = nullptr;
-		
-        void* modelMatrixData;
-        vkMapMemory(device, shadowMapSpotLightModelMatrixUniformBuffersMemory[0], currentImage * sizeof(modelMatrixUBO),
-					sizeof(modelMatrixUBO), 0, &modelMatrixData);
-        memcpy(modelMatrixData, &modelMatrixUBO, sizeof(modelMatrixUBO));
-        vkUnmapMemory(device, shadowMapSpotLightModelMatrixUniformBuffersMemory[0]);
+        return allocateUniform(shadowMapSpotLightModelMatrixRing, &lightSpaceMatrixUBO, sizeof(lightSpaceMatrixUBO));
     }
 
-    void CVulkanRenderer::updatePointLightShadowMapMatrixUBO([[maybe_unused]] uint32_t currentImage, ecs::components::transform* _transformComponent, ecs::components::pointLight* pointLightComponent, uint32_t layer, unsigned int meshID) {
+    UniformAllocation CVulkanRenderer::updatePointLightShadowMapMatrixUBO(ecs::components::pointLight* pointLightComponent, uint32_t layer,
+																		  mat4& lightSpaceMatrix) {
 		PointLightShadowMapMatrixUBO modelMatrixUBO{};
 
 		vec3 positionVectorLight  = pointLightComponent->position;
@@ -3102,28 +3232,14 @@ namespace GLVM::core
 										  directionalVectorLight,
 										  upVector);
 
-        modelMatrixUBO.model = computeModelMatrix(_transformComponent);
-		
 //		projectionMatrixCubeShadowMap[1][1] *= -1;
 		
-		modelMatrixUBO.lightSpaceMatrix = viewMatrixLight * projectionMatrixCubeShadowMap;
+		lightSpaceMatrix = viewMatrixLight * projectionMatrixCubeShadowMap;
+		modelMatrixUBO.lightSpaceMatrix = lightSpaceMatrix;
 		modelMatrixUBO.farPlane = 100.0f;
 		modelMatrixUBO.lightPosition = positionVectorLight;
 
-		mat4* jointMatricesData = updateAnimationFrames(_transformComponent, meshID);
-		
-		for ( unsigned int j = 0; j < MAX_JOINTS_NUMBER; ++j ) {
-			modelMatrixUBO.jointMatrices[j] = jointMatricesData[j];
-		}
-		
-		delete [] jointMatricesData;
-		jointMatricesData = nullptr;
-		
-        void* modelMatrixData;
-        vkMapMemory(device, shadowMapPointLightModelMatrixUniformBuffersMemory[0], currentImage * sizeof(modelMatrixUBO),
-					sizeof(modelMatrixUBO), 0, &modelMatrixData);
-        memcpy(modelMatrixData, &modelMatrixUBO, sizeof(modelMatrixUBO));
-        vkUnmapMemory(device, shadowMapPointLightModelMatrixUniformBuffersMemory[0]);
+        return allocateUniform(shadowMapPointLightModelMatrixRing, &modelMatrixUBO, sizeof(modelMatrixUBO));
     }
 
     void CVulkanRenderer::updatePointLightShadowMapDataUBO(uint32_t currentImage, ecs::components::pointLight* pointLightComponent, float farPlane) {
@@ -3139,65 +3255,154 @@ namespace GLVM::core
         vkUnmapMemory(device, shadowMapPointLightDataUniformBuffersMemory[currentImage]);
 	}
 	
-    void CVulkanRenderer::updateMatrixUniformBuffer(uint32_t currentImage, uint32_t offset, ecs::components::transform* _transformComponent,
-													unsigned int meshID, ecs::components::material* materialComponent) {
-        ModelMatrixUBO modelMatrixUBO{};
-		
-        modelMatrixUBO.model = computeModelMatrix(_transformComponent);
-		
-        modelMatrixUBO.view = viewMatrix;
-        modelMatrixUBO.proj = projectionMatrix;
+	void CVulkanRenderer::updateModelMatricesCache() {
+		namespace cm = GLVM::ecs::components;
+		ecs::ComponentManager* componentManager  = ecs::ComponentManager::GetInstance();
+
+		unsigned int sinceVersion = modelMatricesVersion;
+		modelMatricesVersion = componentManager->AdvanceChangeVersion();
+		if ( modelMatricesCache.size() < componentManager->entityLocations.GetSize() )
+			modelMatricesCache.resize(componentManager->entityLocations.GetSize(), mat4(1.0f));
+
+		/// World matrices computed by transform system, only chunks it rewrote are copied.
+		componentManager->parallelForEachChunk<ecs::Changed<cm::worldTransform>, const cm::mesh>(
+			[this](unsigned int count, Entity* entities, const cm::worldTransform* worldTransformComponents,
+				   [[maybe_unused]] const cm::mesh* meshComponents) {
+				for ( unsigned int i = 0; i < count; ++i )
+					modelMatricesCache[ecs::GetEntityIndex(entities[i])] = worldTransformComponents[i].world;
+			}, sinceVersion);
+	}
+
+	/*! Actors sorted by mesh, diffuse and specular texture, so every group is one range of
+	 *  instances and groups of one mesh lie one after another. Shadow passes draw such groups by
+	 *  one draw. Static meshes share unit palette at offset zero.
+	 */
+	void CVulkanRenderer::buildInstanceGroups() {
+		namespace cm = GLVM::ecs::components;
+		ecs::ComponentManager* componentManager  = ecs::ComponentManager::GetInstance();
+
+		instanceKeys.clear();
+		componentManager->forEachChunk<const cm::transform, const cm::material, const cm::mesh>(
+			[this](unsigned int count, Entity* entities, [[maybe_unused]] const cm::transform* transformComponents,
+				   const cm::material* materialComponents, const cm::mesh* meshComponents) {
+				for ( unsigned int i = 0; i < count; ++i ) {
+					uint64_t diffuseTexture  = materialComponents[i].diffuseTextureID_.id;
+					uint64_t specularTexture = materialComponents[i].specularTextureID_.id;
+					assert(diffuseTexture < (1u << 20) && specularTexture < (1u << 20) && "Texture id dont fit in instance key");
+
+					uint64_t key = (static_cast<uint64_t>(meshComponents[i].handle.id) << 40) | (diffuseTexture << 20) | specularTexture;
+					instanceKeys.push_back({ key, entities[i], materialComponents[i].ambient, materialComponents[i].shininess });
+				}
+			});
+
+		std::sort(instanceKeys.begin(), instanceKeys.end(), [](const InstanceKey& first, const InstanceKey& second) {
+			return first.key < second.key || (first.key == second.key && first.entity < second.entity);
+		});
+
+		unsigned int instancesNumber = instanceKeys.size();
+		instances.resize(instancesNumber);
+		instancePaletteSources.resize(instancesNumber);
+		instanceGroups.clear();
+
+		uint32_t palettesNumber = 1;
+		for ( unsigned int i = 0; i < instancesNumber; ++i ) {
+			const InstanceKey& instanceKey = instanceKeys[i];
+			if ( i == 0 || instanceKey.key != instanceKeys[i - 1].key ) {
+				InstanceGroup group;
+				group.mesh            = static_cast<uint32_t>(instanceKey.key >> 40);
+				group.diffuseTexture  = static_cast<uint32_t>((instanceKey.key >> 20) & 0xFFFFF);
+				group.specularTexture = static_cast<uint32_t>(instanceKey.key & 0xFFFFF);
+				group.firstInstance   = i;
+				group.instancesNumber = 0;
+				instanceGroups.push_back(group);
+			}
 
-		/// Start of animation logic
-		mat4* jointMatricesData = updateAnimationFrames(_transformComponent, meshID);
+			++instanceGroups.back().instancesNumber;
 
-		for ( unsigned int j = 0; j < MAX_JOINTS_NUMBER; ++j ) {
-			modelMatrixUBO.jointMatrices[j] = jointMatricesData[j];
+			const mat4* palette = getJointPalette(instanceKey.entity);
+			bool animated = palette != unitPalette.data();
+			instancePaletteSources[i] = animated ? palette : nullptr;
+			instances[i].ambient = instanceKey.ambient;
+			instances[i].shininess = instanceKey.shininess;
+			instances[i].paletteOffset = animated ? palettesNumber++ * MAX_JOINTS_NUMBER : 0;
+			instances[i].group = instanceGroups.size() - 1;
 		}
-		
-		delete [] jointMatricesData;
-		jointMatricesData = nullptr;
-		/// End of animation logic
 
-		modelMatrixUBO.ambient = materialComponent->ambient;
-		modelMatrixUBO.shininess = materialComponent->shininess;
+		indirectDraws.resize(instanceGroups.size());
+		for ( unsigned int i = 0; i < instanceGroups.size(); ++i ) {
+			const InstanceGroup& group = instanceGroups[i];
+			IndirectDraw& draw = indirectDraws[i];
+			draw.command.indexCount    = static_cast<uint32_t>(aIndices_[group.mesh].size());
+			draw.command.instanceCount = 0;
+			draw.command.firstIndex    = 0;
+			draw.command.vertexOffset  = 0;
+			draw.command.firstInstance = group.firstInstance;
+			draw.boundingSphere        = meshBounds[group.mesh].sphere;
+		}
+
+		instancePalettes.resize(palettesNumber * MAX_JOINTS_NUMBER);
+		for ( unsigned int j = 0; j < MAX_JOINTS_NUMBER; ++j )
+			instancePalettes[j] = unitPalette[j];
+
+		/*! Palettes already sampled by animation system, instances only copy them. World bounds of
+		 *  shadow passes computed here too, skinned instances never culled like in culling shader.
+		 */
+		shadowCuller.BeginFrame(instancesNumber);
+		core::CJobSystem::GetInstance()->ParallelFor(instancesNumber, ACTORS_MATRICES_GRAIN,
+			[this](unsigned int begin, unsigned int end) {
+				for ( unsigned int i = begin; i < end; ++i ) {
+					instances[i].model = modelMatricesCache[ecs::GetEntityIndex(instanceKeys[i].entity)];
+
+					if ( instancePaletteSources[i] == nullptr ) {
+						shadowCuller.SetBounds(i, meshBounds[instanceKeys[i].key >> 40], instances[i].model);
+						continue;
+					}
+
+					shadowCuller.SetUnbounded(i);
+
+					mat4* palette = &instancePalettes[instances[i].paletteOffset];
+					for ( unsigned int j = 0; j < MAX_JOINTS_NUMBER; ++j )
+						palette[j] = instancePaletteSources[i][j];
+				}
+			});
+	}
+	
+    UniformAllocation CVulkanRenderer::updateViewMatrixUniformBuffer() {
+        ViewMatrixUBO viewMatrixUBO{};
+
+        viewMatrixUBO.view = viewMatrix;
+        viewMatrixUBO.proj = projectionMatrix;
 
 		for ( uint32_t i = 0; i < directionalLightNumber; ++i )
-			modelMatrixUBO.dirSpaceMatrix[i] = dirLightSpaceMatrix[i];
+			viewMatrixUBO.dirSpaceMatrix[i] = dirLightSpaceMatrix[i];
 
 		for ( uint32_t i = 0; i < spotLightNumber; ++i )
-			modelMatrixUBO.spotSpaceMatrix[i] = spotLightSpaceMatrix[i];
+			viewMatrixUBO.spotSpaceMatrix[i] = spotLightSpaceMatrix[i];
 		
-		modelMatrixUBO.directionalLightsNumber = directionalLightNumber;
-		modelMatrixUBO.spotLightsNumber        = spotLightNumber;
+		viewMatrixUBO.directionalLightsNumber = directionalLightNumber;
+		viewMatrixUBO.spotLightsNumber        = spotLightNumber;
 		
-        void* modelMatrixData;
-        vkMapMemory(device, modelMatrixUniformBuffersMemory[currentImage], sizeof(modelMatrixUBO) * offset,
-					sizeof(modelMatrixUBO), 0, &modelMatrixData);
-        memcpy(modelMatrixData, &modelMatrixUBO, sizeof(modelMatrixUBO));
-        vkUnmapMemory(device, modelMatrixUniformBuffersMemory[currentImage]);
+        return allocateUniform(viewMatrixRing, &viewMatrixUBO, sizeof(viewMatrixUBO));
     }
 
-	void CVulkanRenderer::updateViewPositionUniformBuffer(uint32_t currentImage, ecs::components::transform* transformComponent) {
+	UniformAllocation CVulkanRenderer::updateViewPositionUniformBuffer(const ecs::components::transform* transformComponent) {
 		namespace cm = GLVM::ecs::components;
 		ecs::ComponentManager* componentManager  = ecs::ComponentManager::GetInstance();
 		LightData lightDataUBO{};
-		core::vector<Entity> pointLightEntities = componentManager->collectLinkedEntities<GLVM::ecs::components::controller>();
-		if ( pointLightEntities.GetSize() > 0 )
+		if ( componentManager->GetQuery<cm::controller>().GetSize() > 0 )
 
-			lightDataUBO.viewPosition = transformComponent->tPosition;
+			lightDataUBO.viewPosition = cm::InterpolateTransform(*transformComponent, interpolationAlpha).tPosition;
 
 		DirectionalLight directionalLight{};
 
-		core::vector<Entity> linkedEntitiesDirLight      = componentManager->collectLinkedEntities<cm::transform,
-																						   cm::directionalLight,
-																						   cm::mesh>();
+		auto& directionalLightQuery = componentManager->GetQuery<const cm::transform, const cm::directionalLight, const cm::mesh>();
 
-		directionalLightNumber = linkedEntitiesDirLight.GetSize();
+		directionalLightNumber = directionalLightQuery.GetSize();
 		assert(directionalLightNumber <= 4 && "Directional lights number greater then 4");
 
-		for ( unsigned int i = 0; i < directionalLightNumber; ++i ) {
-			cm::directionalLight* directionalLightComponent = componentManager->GetComponent<cm::directionalLight>(linkedEntitiesDirLight[i]);
+		unsigned int i = 0;
+		for ( auto [entity, transform, directionalLightRow, mesh] : directionalLightQuery ) {
+			const cm::directionalLight* directionalLightComponent = &directionalLightRow;
 			
 			directionalLight.position  = vec4(directionalLightComponent->position[0],
 											  directionalLightComponent->position[1],
@@ -3216,18 +3421,18 @@ namespace GLVM::core
 											  directionalLightComponent->specular[2], 0.0f);
 
 			lightDataUBO.directionalLights[i] = directionalLight;			
+			++i;
 		}
 
 		lightDataUBO.directionalLightsArraySize = directionalLightNumber;
 
-		core::vector<Entity> linkedEntitiesPointLight      = componentManager->collectLinkedEntities<cm::transform,
-																						   cm::pointLight,
-																						   cm::mesh>();
+		auto& pointLightQuery = componentManager->GetQuery<const cm::transform, const cm::pointLight, const cm::mesh>();
 
-		pointLightNumber = linkedEntitiesPointLight.GetSize();
+		pointLightNumber = pointLightQuery.GetSize();
 		assert(pointLightNumber <= POINT_LIGHTS_NUMBER && "Point lights number greater than 32");
-		for ( unsigned int i = 0; i < pointLightNumber; ++i ) {
-			cm::pointLight* pointLightComponent = componentManager->GetComponent<cm::pointLight>(linkedEntitiesPointLight[i]);
+		i = 0;
+		for ( auto [entity, transform, pointLightRow, mesh] : pointLightQuery ) {
+			const cm::pointLight* pointLightComponent = &pointLightRow;
 			PointLight pointLightUBO{};
 
  			pointLightUBO.position  = vec3(pointLightComponent->position[0],
@@ -3248,20 +3453,20 @@ namespace GLVM::core
 			pointLightUBO.quadratic = pointLightComponent->quadratic;
 
 			lightDataUBO.pointLights[i] = pointLightUBO;
+			++i;
 		}
 		
 		lightDataUBO.pointLightsArraySize = pointLightNumber;
 		lightDataUBO.farPlane = 100.0f;
 
 		SpotLight spotLight{};
-		core::vector<Entity> linkedEntitiesSpotLight      = componentManager->collectLinkedEntities<cm::transform,
-																						   cm::spotLight,
-																						   cm::mesh>();
+		auto& spotLightQuery = componentManager->GetQuery<const cm::transform, const cm::spotLight, const cm::mesh>();
 
-		spotLightNumber = linkedEntitiesSpotLight.GetSize();
+		spotLightNumber = spotLightQuery.GetSize();
 		assert(spotLightNumber <= 8 && "Spot light number greater then 8");
-		for ( unsigned int i = 0; i < spotLightNumber; ++i ) {
-			cm::spotLight* spotLightComponent = componentManager->GetComponent<cm::spotLight>(linkedEntitiesSpotLight[i]);
+		i = 0;
+		for ( auto [entity, transform, spotLightRow, mesh] : spotLightQuery ) {
+			const cm::spotLight* spotLightComponent = &spotLightRow;
 			
 			spotLight.position    = spotLightComponent->position;
 			spotLight.direction   = spotLightComponent->direction;
@@ -3275,33 +3480,12 @@ namespace GLVM::core
 			spotLight.quadratic   = spotLightComponent->quadratic; 
 
 			lightDataUBO.spotLights[i] = spotLight;
+			++i;
 		}
 
 		lightDataUBO.spotLightArraySize = spotLightNumber;
 
-        void* data;
-        vkMapMemory(device, lightDataUniformBuffersMemory[currentImage], 0,
-					sizeof(lightDataUBO), 0, &data);
-        memcpy(data, &lightDataUBO, sizeof(lightDataUBO));
-        vkUnmapMemory(device, lightDataUniformBuffersMemory[currentImage]);
-	}
-
-	void CVulkanRenderer::updateDirSpaceMatrix(uint32_t currentImage) {
-		LightSpaceMatrixUBO lightUBO{};
-		for ( uint32_t i = 0; i < directionalLightNumber; ++i )
-			lightUBO.dirSpaceMatrix[i] = dirLightSpaceMatrix[i];
-
-		for ( uint32_t i = 0; i < spotLightNumber; ++i )
-			lightUBO.spotSpaceMatrix[i] = spotLightSpaceMatrix[i];
-		
-		lightUBO.directionalLightsNumber = directionalLightNumber;
-		lightUBO.spotLightsNumber        = spotLightNumber;
-		
-        void* data;
-        vkMapMemory(device, lightSpaceMatrixMemory[currentImage], 0,
-					sizeof(LightSpaceMatrixUBO), 0, &data);
-        memcpy(data, &lightUBO, sizeof(LightSpaceMatrixUBO));
-        vkUnmapMemory(device, lightSpaceMatrixMemory[currentImage]);
+        return allocateUniform(lightDataRing, &lightDataUBO, sizeof(lightDataUBO));
 	}
 
     void CVulkanRenderer::mainRenderDrawFrame() {
@@ -3326,7 +3510,15 @@ namespace GLVM::core
 
         vkResetFences(device, 1, &inFlightFences[currentFrame]);
         vkResetCommandBuffer(mainRenderCommandBuffers[currentFrame], /*VkCommandBufferResetFlagBits*/ 0);
+		viewMatrixRing.begin(currentFrame);
+		lightDataRing.begin(currentFrame);
+		readIndirectDrawCounts(currentFrame);
+		uploadInstances(mainRenderInstanceBuffer, currentFrame, 0);
+		uploadIndirectDraws(currentFrame);
         recordCommandBuffer(mainRenderCommandBuffers[currentFrame], imageIndex);
+		flushInstances(mainRenderInstanceBuffer, currentFrame);
+		flushUniformRing(viewMatrixRing);
+		flushUniformRing(lightDataRing);
 
         VkSubmitInfo submitInfo{};
         submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
@@ -3389,7 +3581,12 @@ namespace GLVM::core
 
         vkResetFences(device, 1, &directionalLightShadowMapInFlightFences[directionalLightCurrentFrame]);
         vkResetCommandBuffer(directionalLightCommandBuffers[directionalLightCurrentFrame], /*VkCommandBufferResetFlagBits*/ 0);
+		shadowMapDirectionalLightModelMatrixRing.begin(directionalLightCurrentFrame);
+		uint32_t lightsNumber = ecs::ComponentManager::GetInstance()->GetQuery<const cm::transform, const cm::directionalLight, const cm::mesh>().GetSize();
+		uploadInstances(directionalLightInstanceBuffer, directionalLightCurrentFrame, static_cast<uint32_t>(instances.size()) * lightsNumber);
         directionalLightRecordCoomandBuffer(directionalLightCommandBuffers[directionalLightCurrentFrame], imageIndex);
+		flushInstances(directionalLightInstanceBuffer, directionalLightCurrentFrame);
+		flushUniformRing(shadowMapDirectionalLightModelMatrixRing);
 
         VkSubmitInfo submitInfo{};
         submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
@@ -3454,7 +3651,12 @@ namespace GLVM::core
 
         vkResetFences(device, 1, &spotLightShadowMapInFlightFences[spotLightCurrentFrame]);
         vkResetCommandBuffer(spotLightCommandBuffers[spotLightCurrentFrame], /*VkCommandBufferResetFlagBits*/ 0);
+		shadowMapSpotLightModelMatrixRing.begin(spotLightCurrentFrame);
+		uint32_t lightsNumber = ecs::ComponentManager::GetInstance()->GetQuery<const cm::transform, const cm::spotLight, const cm::mesh>().GetSize();
+		uploadInstances(spotLightInstanceBuffer, spotLightCurrentFrame, static_cast<uint32_t>(instances.size()) * lightsNumber);
         spotLightRecordCommandBuffer(spotLightCommandBuffers[spotLightCurrentFrame], imageIndex);
+		flushInstances(spotLightInstanceBuffer, spotLightCurrentFrame);
+		flushUniformRing(shadowMapSpotLightModelMatrixRing);
 
         VkSubmitInfo submitInfo{};
         submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
@@ -3519,7 +3721,13 @@ namespace GLVM::core
 
         vkResetFences(device, 1, &pointLightShadowMapInFlightFences[pointLightCurrentFrame]);
         vkResetCommandBuffer(pointLightCommandBuffers[pointLightCurrentFrame], /*VkCommandBufferResetFlagBits*/ 0);
+		shadowMapPointLightModelMatrixRing.begin(pointLightCurrentFrame);
+		/// Every face of cube map culled by own frustum.
+		uint32_t lightsNumber = ecs::ComponentManager::GetInstance()->GetQuery<const cm::transform, const cm::pointLight, const cm::mesh>().GetSize();
+		uploadInstances(pointLightInstanceBuffer, pointLightCurrentFrame, static_cast<uint32_t>(instances.size()) * lightsNumber * 6);
         pointLightRecordCommandBuffer(pointLightCommandBuffers[pointLightCurrentFrame], imageIndex);
+		flushInstances(pointLightInstanceBuffer, pointLightCurrentFrame);
+		flushUniformRing(shadowMapPointLightModelMatrixRing);
 
         VkSubmitInfo submitInfo{};
         submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
@@ -3582,10 +3790,6 @@ namespace GLVM::core
 																									 cm::directionalLight,
 																									 cm::mesh>();
 
-		core::vector<Entity> linkedEntities      = componentManager->collectLinkedEntities<cm::transform,
-																						   cm::material,
-																						   cm::mesh>();
-
 		for ( uint32_t directionalLightCounter = 0; directionalLightCounter < directionalLightEntities.GetSize(); ++ directionalLightCounter ) {
 			VkClearValue shadowMapClearValues[1];
 			shadowMapClearValues[0].depthStencil.depth = 1.0f;
@@ -3627,27 +3831,14 @@ namespace GLVM::core
 			cm::directionalLight* directionalLightComponent = componentManager->GetComponent<cm::directionalLight>(directionalLightEntity);
 			updateDirectionalLightSpaceMatrixShadowMapUBO(directionalLightComponent, directionalLightCounter);
 
-			uint32_t actorsNumber = linkedEntities.GetSize();
-			for ( unsigned int actorCounter = 0; actorCounter < actorsNumber; ++actorCounter ) {
-				unsigned int meshOwnerEntity = linkedEntities[actorCounter];
-				unsigned int meshId = componentManager->GetComponent<ecs::components::mesh>(meshOwnerEntity)->handle.id;
-				cm::transform* meshOwnerTransformComponent = componentManager->GetComponent<cm::transform>(meshOwnerEntity);
-
-				unsigned int uboDirectionalLightIndex = directionalLightNumber * actorsNumber * directionalLightCurrentFrame +
-					actorsNumber * directionalLightCounter + actorCounter;
-
-				updateDirectionalLightShadowMapMatrixUBO(uboDirectionalLightIndex, meshOwnerTransformComponent, directionalLightCounter, meshId);
-				vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, directionalLightPipeline.pipelineLayout, 0, 1, &shadowMapDirectionalLightDescriptorSets[uboDirectionalLightIndex], 0, nullptr);
-				
-				VkBuffer vertexBuffers[] = {vertexBufferContainer[meshId]};
-				VkDeviceSize offsets[] = {0};
-				vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+			UniformAllocation ubo = updateDirectionalLightShadowMapMatrixUBO(directionalLightCounter);
+			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, directionalLightPipeline.pipelineLayout, 0, 1,
+									shadowMapDirectionalLightModelMatrixRing.getDescriptorSet(ubo), 1, &ubo.offset);
+			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, directionalLightPipeline.pipelineLayout, 1, 1,
+									&directionalLightInstanceBuffer.frames[directionalLightCurrentFrame].descriptorSet, 0, nullptr);
 
-				vkCmdBindIndexBuffer(commandBuffer, indexBufferContainer[meshId], 0, VK_INDEX_TYPE_UINT32);
-
-				unsigned int indicesContainerSize = aIndices_[meshId].size();
-				vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(indicesContainerSize), 1, 0, 0, 0);
-			}
+			recordShadowMapInstances(commandBuffer, directionalLightInstanceBuffer.frames[directionalLightCurrentFrame],
+									 dirLightSpaceMatrix[directionalLightCounter]);
 		
 			vkCmdEndRenderPass(commandBuffer);
 		}
@@ -3667,11 +3858,6 @@ namespace GLVM::core
         }
 
 		namespace cm = GLVM::ecs::components;
-		core::vector<Entity> linkedEntities      = componentManager->collectLinkedEntities<cm::transform,
-																						   cm::material,
-																						   cm::mesh>();
-
-		
 		core::vector<Entity> spotLightEntities      = componentManager->collectLinkedEntities<cm::transform,
 																							  cm::spotLight,
 																							  cm::mesh>();
@@ -3717,25 +3903,14 @@ namespace GLVM::core
 			cm::spotLight* spotLightComponent = componentManager->GetComponent<cm::spotLight>(spotLightEntity);
 			updateSpotLightSpaceMatrixShadowMapUBO(spotLightComponent, spotLightCounter);
 
-			uint32_t actorsNumber = linkedEntities.GetSize();
-			for ( unsigned int actorsCounter = 0; actorsCounter < actorsNumber; ++actorsCounter ) {
-				unsigned int meshOwnerEntity = linkedEntities[actorsCounter];
-				unsigned int meshID = componentManager->GetComponent<ecs::components::mesh>(meshOwnerEntity)->handle.id;
-				cm::transform* meshOwnerTransformComponent = componentManager->GetComponent<cm::transform>(meshOwnerEntity);
-				unsigned int uboSpotLightIndex = spotLightNumber * actorsNumber * spotLightCurrentFrame +
-					actorsNumber * spotLightCounter + actorsCounter;
-
-				updateSpotLightShadowMapMatrixUBO(uboSpotLightIndex, meshOwnerTransformComponent, spotLightCounter, meshID);
-				vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, spotLightPipeline.pipelineLayout, 0, 1, &shadowMapSpotLightDescriptorSets[uboSpotLightIndex], 0, nullptr);
-				VkBuffer vertexBuffers[] = {vertexBufferContainer[meshID]};
-				VkDeviceSize offsets[] = {0};
-				vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
-
-				vkCmdBindIndexBuffer(commandBuffer, indexBufferContainer[meshID], 0, VK_INDEX_TYPE_UINT32);
+			UniformAllocation ubo = updateSpotLightShadowMapMatrixUBO(spotLightCounter);
+			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, spotLightPipeline.pipelineLayout, 0, 1,
+									shadowMapSpotLightModelMatrixRing.getDescriptorSet(ubo), 1, &ubo.offset);
+			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, spotLightPipeline.pipelineLayout, 1, 1,
+									&spotLightInstanceBuffer.frames[spotLightCurrentFrame].descriptorSet, 0, nullptr);
 
-				unsigned int indicesContainerSize = aIndices_[meshID].size();
-				vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(indicesContainerSize), 1, 0, 0, 0);
-			}
+			recordShadowMapInstances(commandBuffer, spotLightInstanceBuffer.frames[spotLightCurrentFrame],
+									 spotLightSpaceMatrix[spotLightCounter]);
 		
 			vkCmdEndRenderPass(commandBuffer);
 		}
@@ -3755,10 +3930,6 @@ namespace GLVM::core
         }
 
 		namespace cm = GLVM::ecs::components;
-		core::vector<Entity> linkedEntities      = componentManager->collectLinkedEntities<cm::transform,
-																						   cm::material,
-																						   cm::mesh>();
-		
 		core::vector<Entity> pointLightEntities = componentManager->collectLinkedEntities<cm::transform,
 																						  cm::pointLight,
 																						  cm::mesh>();
@@ -3817,29 +3988,14 @@ namespace GLVM::core
 				
 				cm::pointLight* pointLightComponent = componentManager->GetComponent<cm::pointLight>(pointLightEntity);
 				
-				uint32_t actorsNumber = linkedEntities.GetSize();
-				for ( unsigned int actorCounter = 0; actorCounter < actorsNumber; ++actorCounter ) {
-					unsigned int meshOwnerEntity = linkedEntities[actorCounter];
-					unsigned int meshID = componentManager->GetComponent<ecs::components::mesh>(meshOwnerEntity)->handle.id;
-					cm::transform* meshOwnerTransformComponent = componentManager->GetComponent<cm::transform>(meshOwnerEntity);
-						
-					unsigned int uboIndex = pointLightNumber *
-						actorsNumber * maxCubeMapLayers * pointLightCurrentFrame +                           ///< Choose frame (first 168 or second 168)
-						actorsNumber * maxCubeMapLayers * pointLightCounter +                      ///< Choose point light (i)
-						maxCubeMapLayers * actorCounter + cubeMapLayerCounter;                     ///< Choose actor (m) and layer (j)
-
-					updatePointLightShadowMapMatrixUBO(uboIndex, meshOwnerTransformComponent, pointLightComponent, cubeMapLayerCounter, meshID);
-					vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pointLightPipeline.pipelineLayout, 0, 1, &shadowMapPointLightDescriptorSets[uboIndex], 0, nullptr);
-
-					VkBuffer vertexBuffers[] = {vertexBufferContainer[meshID]};
-					VkDeviceSize offsets[] = {0};
-					vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
-					
-					vkCmdBindIndexBuffer(commandBuffer, indexBufferContainer[meshID], 0, VK_INDEX_TYPE_UINT32);
-
-					unsigned int indicesContainerSize = aIndices_[meshID].size();
-					vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(indicesContainerSize), 1, 0, 0, 0);
-				}
+				mat4 lightSpaceMatrix;
+				UniformAllocation ubo = updatePointLightShadowMapMatrixUBO(pointLightComponent, cubeMapLayerCounter, lightSpaceMatrix);
+				vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pointLightPipeline.pipelineLayout, 0, 1,
+										shadowMapPointLightModelMatrixRing.getDescriptorSet(ubo), 1, &ubo.offset);
+				vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pointLightPipeline.pipelineLayout, 1, 1,
+										&pointLightInstanceBuffer.frames[pointLightCurrentFrame].descriptorSet, 0, nullptr);
+
+				recordShadowMapInstances(commandBuffer, pointLightInstanceBuffer.frames[pointLightCurrentFrame], lightSpaceMatrix);
 		
 				vkCmdEndRenderPass(commandBuffer);
 			}
@@ -3850,6 +4006,44 @@ namespace GLVM::core
         }
 	}
 	
+	/*! Visible instances of light appended to visible indices of frame. Instances sorted by mesh,
+	 *  so visible instances of one mesh are neighbours and drawn as one range.
+	 */
+	void CVulkanRenderer::recordShadowMapInstances(VkCommandBuffer& commandBuffer, InstanceFrame& instanceFrame, const mat4& lightSpaceMatrix) {
+		if ( shadowCulling ) {
+			vec4 planes[core::FRUSTUM_PLANES_NUMBER];
+			core::ExtractFrustumPlanes(lightSpaceMatrix, planes);
+			shadowCuller.Cull(planes, core::FRUSTUM_PLANES_NUMBER, visibleShadowInstances);
+		} else {
+			visibleShadowInstances.Resize(instances.size());
+			for ( uint32_t i = 0; i < instances.size(); ++i )
+				visibleShadowInstances[i] = i;
+		}
+
+		uint32_t visibleNumber = visibleShadowInstances.GetSize();
+		assert(instanceFrame.visibleNumber + visibleNumber <= instanceFrame.visibleCapacity && "Visible instances of lights dont fit in instance buffer");
+		uint32_t* visibleIndices = reinterpret_cast<uint32_t*>(instanceFrame.mapped + instanceFrame.visibleOffset) + instanceFrame.visibleNumber;
+		for ( uint32_t i = 0; i < visibleNumber; ++i )
+			visibleIndices[i] = visibleShadowInstances[i];
+
+		for ( uint32_t i = 0; i < visibleNumber; ) {
+			uint32_t mesh = instanceGroups[instances[visibleShadowInstances[i]].group].mesh;
+			uint32_t first = i;
+			for ( ; i < visibleNumber && instanceGroups[instances[visibleShadowInstances[i]].group].mesh == mesh; ++i )
+				;
+
+			VkBuffer vertexBuffers[] = {vertexBufferContainer[mesh]};
+			VkDeviceSize offsets[] = {0};
+			vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+			vkCmdBindIndexBuffer(commandBuffer, indexBufferContainer[mesh], 0, VK_INDEX_TYPE_UINT32);
+
+			unsigned int indicesContainerSize = aIndices_[mesh].size();
+			vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(indicesContainerSize), i - first, 0, 0, instanceFrame.visibleNumber + first);
+		}
+
+		instanceFrame.visibleNumber += visibleNumber;
+	}
+	
     VkShaderModule CVulkanRenderer::createShaderModule(const std::vector<char>& code) {
         VkShaderModuleCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
@@ -3966,7 +4160,8 @@ namespace GLVM::core
 
         int i = 0;
         for (const auto& queueFamily : queueFamilies) {
-            if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+            /// Culling shader recorded in command buffer of main pass, so graphics queue must run compute too.
+            if ((queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) && (queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT)) {
                 indices.graphicsFamily = i;
             }
 
@@ -4072,81 +4267,13 @@ namespace GLVM::core
         return VK_FALSE;
     }
 
-	[[nodiscard]] mat4* CVulkanRenderer::updateAnimationFrames(ecs::components::transform* _transformComponent, unsigned int meshID) {
-		if ( jointMatricesPerMesh.GetSize() > 0 && jointMatricesPerMesh[meshID].GetSize() > 0 &&
-			 _transformComponent->frameAccumulator >= frames[meshID][_transformComponent->currentAnimationFrame] * 1.0f ) {
-			++_transformComponent->currentAnimationFrame;
-			if ( jointMatricesPerMesh[meshID].GetSize() > 0 && _transformComponent->currentAnimationFrame == frames[meshID].GetSize() ) {
-				_transformComponent->currentAnimationFrame = 0;
-				_transformComponent->frameAccumulator = 0.0f;
-			}
-		}
-
-		unsigned int joinMatricesDataSize{};
-		if ( jointMatricesPerMesh.GetSize() > 0 )
-			joinMatricesDataSize = jointMatricesPerMesh[meshID].GetSize();
+	const mat4* CVulkanRenderer::getJointPalette(Entity entity) const {
+		static_assert(MAX_JOINTS_NUMBER == ecs::PALETTE_JOINTS_NUMBER, "Palettes of animation system dont match shaders");
 
-		mat4* jointMatricesData = nullptr;
-		if ( joinMatricesDataSize == 0 ) {
-			jointMatricesData = new mat4[MAX_JOINTS_NUMBER];
-			for ( unsigned int i = 0; i < MAX_JOINTS_NUMBER; ++i ) {
-				mat4 unitMatrix(1.0f);
-				jointMatricesData[i] = unitMatrix;
-			}
-				
-		} else {
-			jointMatricesData = new mat4[MAX_JOINTS_NUMBER];
-			for ( unsigned int i = 0; i < joinMatricesDataSize; ++i ) {
-				jointMatricesData[i] = jointMatricesPerMesh[meshID][i][_transformComponent->currentAnimationFrame];
-			}
-
-			for ( u32 j = joinMatricesDataSize; j < MAX_JOINTS_NUMBER; ++j ) {
-				mat4 unitMatrix(1.0f);
-				jointMatricesData[j] = unitMatrix;
-			}
-		}
-
-		return jointMatricesData;
+		const mat4* palette = animationSystem != nullptr ? animationSystem->GetPalette(entity) : nullptr;
+		return palette != nullptr ? palette : unitPalette.data();
 	}
 
-	mat4 CVulkanRenderer::computeModelMatrix(ecs::components::transform* _transformComponent) {
-		mat4 rotationMatrix(1.0f);
-        mat4 scalingMatrix(1.0f);
-        mat4 translationMatrix(1.0f);
-		
-		scalingMatrix[0][0] = _transformComponent->fScale;
-		scalingMatrix[1][1] = _transformComponent->fScale;
-		scalingMatrix[2][2] = _transformComponent->fScale;
-
-		translationMatrix[3][0] = _transformComponent->tPosition[0];
-		translationMatrix[3][1] = _transformComponent->tPosition[1];
-		translationMatrix[3][2] = _transformComponent->tPosition[2];
-		translationMatrix[3][3] = 1.0f;
-
-		float sinPitch = std::sin(Radians(-_transformComponent->pitch / 2));
-		float cosPitch = std::cos(Radians(-_transformComponent->pitch / 2));
-		float sinYaw = std::sin(Radians(-(_transformComponent->yaw)  / 2));
-		float cosYaw = std::cos(Radians(-(_transformComponent->yaw)  / 2));
-		
-		Quaternion pitchQuat;
-		Quaternion yawQuat;
-		pitchQuat.w = cosPitch;
-		pitchQuat.x = 0.0f;
-		pitchQuat.y = 0.0f;
-		pitchQuat.z = sinPitch;
-
-		yawQuat.w = cosYaw;
-		yawQuat.x = 0.0f;
-		yawQuat.y = sinYaw;
-		yawQuat.z = 0.0f;
-
-		Quaternion result;
-		result = multiplyQuaternion(pitchQuat, yawQuat);
-		rotationMatrix = rotateQuaternion<float, 4>(result);
-		
-        return scalingMatrix * rotationMatrix * translationMatrix;
-	}
-	
 	void CVulkanRenderer::setImageDebugObjectName(VK_Image image) {
 		VkDebugUtilsObjectNameInfoEXT imageObjectInfo{};
 		imageObjectInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT;
@@ -4308,6 +4435,7 @@ namespace GLVM::core
 		// 	SetDebugObjectName(device, &descriptorSetLayoutObjectInfo);			
 		// }
 		
+		std::vector<VkDescriptorSet>& shadowMapDirectionalLightDescriptorSets = shadowMapDirectionalLightModelMatrixRing.chunks[0].descriptorSets;
 		for ( unsigned long i = 0; i < shadowMapDirectionalLightDescriptorSets.size(); ++i ) {
 			VkDebugUtilsObjectNameInfoEXT descriptorSetObjectInfo{};
 			descriptorSetObjectInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT;
@@ -0,0 +1,147 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "JobSystem.hpp"
+
+namespace GLVM::core
+{
+	CJobSystem* CJobSystem::pInstance_ = nullptr;
+	std::mutex CJobSystem::Mutex_;
+
+	/// One hardware thread stays for main thread, it helps workers while waiting.
+	CJobSystem::CJobSystem() {
+		unsigned int hardwareThreads = std::thread::hardware_concurrency();
+		workersNumber = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+
+		for ( unsigned int i = 0; i < workersNumber + 1; ++i )
+			queues.push_back(std::make_unique<WorkerQueue>());
+
+		for ( unsigned int i = 0; i < workersNumber; ++i )
+			workers.emplace_back(&CJobSystem::WorkerLoop, this, static_cast<int>(i));
+	}
+
+	CJobSystem::~CJobSystem() {
+		{
+			std::lock_guard<std::mutex> lock(wakeMutex);
+			stopping = true;
+		}
+		wakeCondition.notify_all();
+
+		for ( unsigned int i = 0; i < workers.size(); ++i )
+			workers[i].join();
+	}
+
+	CJobSystem* CJobSystem::GetInstance() {
+		std::lock_guard<std::mutex> lock(Mutex_);
+		if ( pInstance_ == nullptr ) {
+			pInstance_ = new CJobSystem();
+		}
+		return pInstance_;
+	}
+
+	void CJobSystem::WorkerLoop(int index) {
+		workerIndex = index;
+		while ( !stopping ) {
+			if ( RunPendingJob() )
+				continue;
+
+			std::unique_lock<std::mutex> lock(wakeMutex);
+			wakeCondition.wait(lock, [this]() { return stopping || queuedJobsNumber > 0; });
+		}
+	}
+
+	void CJobSystem::Enqueue(const JobHandle& job) {
+		unsigned int index = workerIndex >= 0 ? static_cast<unsigned int>(workerIndex) : workersNumber;
+		{
+			std::lock_guard<std::mutex> lock(wakeMutex);    ///< Counter changed under lock, so sleeping worker cant miss it.
+			++queuedJobsNumber;                             ///< Counted before job is visible, so PopJob never takes it below zero.
+		}
+		{
+			std::lock_guard<std::mutex> lock(queues[index]->mutex);
+			queues[index]->jobs.push_back(job);
+		}
+		wakeCondition.notify_one();
+	}
+
+	JobHandle CJobSystem::PopJob() {
+		unsigned int queuesNumber = queues.size();
+		unsigned int ownIndex = workerIndex >= 0 ? static_cast<unsigned int>(workerIndex) : workersNumber;
+		{
+			WorkerQueue& ownQueue = *queues[ownIndex];
+			std::lock_guard<std::mutex> lock(ownQueue.mutex);
+			if ( !ownQueue.jobs.empty() ) {
+				JobHandle job = std::move(ownQueue.jobs.back());
+				ownQueue.jobs.pop_back();
+				--queuedJobsNumber;
+				return job;
+			}
+		}
+
+		for ( unsigned int i = 1; i < queuesNumber; ++i ) {
+			WorkerQueue& victimQueue = *queues[(ownIndex + i) % queuesNumber];
+			std::lock_guard<std::mutex> lock(victimQueue.mutex);
+			if ( !victimQueue.jobs.empty() ) {
+				JobHandle job = std::move(victimQueue.jobs.front());
+				victimQueue.jobs.pop_front();
+				--queuedJobsNumber;
+				return job;
+			}
+		}
+
+		return nullptr;
+	}
+
+	void CJobSystem::Execute(const JobHandle& job) {
+		job->function();
+
+		std::vector<JobHandle> dependents;
+		{
+			std::lock_guard<std::mutex> lock(job->dependentsMutex);
+			job->finished.store(true, std::memory_order_release);
+			dependents.swap(job->dependents);
+		}
+
+		for ( unsigned int i = 0; i < dependents.size(); ++i ) {
+			if ( dependents[i]->pendingDependencies.fetch_sub(1) == 1 )
+				Enqueue(dependents[i]);
+		}
+	}
+
+	bool CJobSystem::RunPendingJob() {
+		JobHandle job = PopJob();
+		if ( job == nullptr )
+			return false;
+
+		Execute(job);
+		return true;
+	}
+
+	JobHandle CJobSystem::Schedule(std::function<void()> function, const std::vector<JobHandle>& dependencies) {
+		JobHandle job = std::make_shared<Job>();
+		job->function = std::move(function);
+		job->pendingDependencies = dependencies.size() + 1;
+
+		for ( unsigned int i = 0; i < dependencies.size(); ++i ) {
+			Job& dependency = *dependencies[i];
+			std::lock_guard<std::mutex> lock(dependency.dependentsMutex);
+			if ( dependency.finished.load(std::memory_order_acquire) )
+				--job->pendingDependencies;
+			else
+				dependency.dependents.push_back(job);
+		}
+
+		if ( job->pendingDependencies.fetch_sub(1) == 1 )    ///< Release count of Schedule itself.
+			Enqueue(job);
+
+		return job;
+	}
+
+	void CJobSystem::Wait(const JobHandle& job) {
+		while ( !job->finished.load(std::memory_order_acquire) ) {
+			if ( !RunPendingJob() )
+				std::this_thread::yield();
+		}
+	}
+}
@@ -373,25 +373,16 @@ namespace GLVM::Core
 	
 	void CJsonParser::SearchInJsonObject(HashMap<JsonValue>* mapValue, const char* key_,
 										 core::vector<JsonValue>& resultVector) const {
-		for ( unsigned int i = 0; i < mapValue->GetCapacity(); ++i ) {
-			if ( mapValue->hashMap_[i] != nullptr ) {
-				Node<JsonValue>* current = mapValue->hashMap_[i];
-				while ( current != nullptr ) {
-					std::string searchKey = key_;
-					std::string currentKey = current->key_;
-					if ( currentKey == searchKey ) {
-						resultVector.Push(current->value_);
-					}
-
-					if ( current->value_.type == JSON_OBJECT )
-						SearchInJsonObject(current->value_.value.object, key_, resultVector);
+		for ( Node<JsonValue>& current : *mapValue ) {
+			if ( current.key_ == key_ ) {
+				resultVector.Push(current.value_);
+			}
 
-					if ( current->value_.type == JSON_ARRAY )
-						SearchInJsonArray(current->value_.value.array, key_, resultVector);
+			if ( current.value_.type == JSON_OBJECT )
+				SearchInJsonObject(current.value_.value.object, key_, resultVector);
 
-					current = current->next_;
-				}
-			}
+			if ( current.value_.type == JSON_ARRAY )
+				SearchInJsonArray(current.value_.value.array, key_, resultVector);
 		}
 	}		
 	
@@ -404,8 +395,7 @@ namespace GLVM::Core
 	void CJsonParser::LoadGLTF(const char* pathsGLTF_,
 							   std::vector<float>& aVertexes_,
 							   std::vector<uint32_t>& aIndices_,
-							   core::vector<core::vector<mat4>>& jointMatricesPerMesh,
-							   core::vector<float>& frames,
+							   core::CSkeletalAnimation& animation,
 							   bool& noAnimations) {
 		ReadFile(pathsGLTF_);
 		Parse();
@@ -457,113 +447,67 @@ namespace GLVM::Core
 
 		core::vector<Core::JsonValue> skins = Search("skins");
 		Core::JsonValue joints;
-		core::vector<mat4> globalTransformJointNode;
-		core::vector<mat4> inverseBindMatrixSet;
-		core::vector<core::vector<mat4>> jointMatrices;
 		core::vector<float> weightsContainer;
 		core::vector<int> jointsIndices;
-		core::vector<core::vector<int>> children;
+
+		auto jsonNumber = [](Core::JsonValue number) -> float {
+			return number.isInterger() ? number.value.iNumber : number.value.fNumber;
+		};
 			
 		if ( skins.GetSize() > 0 ) {
 			noAnimations = false;
 			joints = (*gltf)["skins"][0]["joints"];
 
+			unsigned int inverseBindMatricesIndex = (*gltf)["skins"][0]["inverseBindMatrices"].value.iNumber;
+			core::vector<float> inverseBindMatricesData = readAccessorFloats(buffer, inverseBindMatricesIndex);
+
+			/// Rest transform of joint used for properties that clip dont animate.
 			Core::JsonValue nodes = (*gltf)["nodes"];
-			for ( unsigned int i = 0; i < joints.value.array->GetSize(); ++i ) {
+			unsigned int jointsNumber = joints.value.array->GetSize();
+			for ( unsigned int i = 0; i < jointsNumber; ++i ) {
 				unsigned int index = (*joints.value.array)[i].value.iNumber;
 				Core::JsonValue node = nodes[index];
-				Quaternion rotationQuaternion;
-				mat4 rotation(1.0f);
-				mat4 scale(1.0f);
-				mat4 translation(1.0f);
-
-				if ( node.value.object->Contain("rotation") ) {
-					Core::JsonValue array = (*node.value.object)["rotation"];
-					for ( unsigned int i = 0; i < array.value.array->GetSize(); ++i ) {
-						switch(i) {
-						case 0:
-							if ( array[i].isInterger() )
-								rotationQuaternion.x = array[i].value.iNumber;
-							else if ( array[i].isFloat() )
-								rotationQuaternion.x = array[i].value.fNumber;
-						case 1:
-							if ( array[i].isInterger() )
-								rotationQuaternion.y = array[i].value.iNumber;
-							else if ( array[i].isFloat() )
-								rotationQuaternion.y = array[i].value.fNumber;
-						case 2:
-							if ( array[i].isInterger() )
-								rotationQuaternion.z = array[i].value.iNumber;
-							else if ( array[i].isFloat() )
-								rotationQuaternion.z = array[i].value.fNumber;
-						case 3:
-							if ( array[i].isInterger() )
-								rotationQuaternion.w = array[i].value.iNumber;
-							else if ( array[i].isFloat() )
-								rotationQuaternion.w = array[i].value.fNumber;
-						}
-					}
+				vec3 translation = { 0.0f, 0.0f, 0.0f };
+				Quaternion rotation = { 1.0f, 0.0f, 0.0f, 0.0f };
+				vec3 scale = { 1.0f, 1.0f, 1.0f };
 
-					rotation = rotateQuaternion<float, 4>(rotationQuaternion);
+				if ( node.value.object->Contain("translation") ) {
+					Core::JsonValue array = (*node.value.object)["translation"];
+					for ( unsigned int c = 0; c < array.value.array->GetSize() && c < 3; ++c )
+						translation[c] = jsonNumber(array[c]);
 				}
 
-				core::vector<int> local_children;
-				if ( node.value.object->Contain("children") ) {
-					Core::JsonValue array = (*node.value.object)["children"];
-					for ( unsigned int i = 0; i < array.value.array->GetSize(); ++i ) {
-						local_children.Push(array[i].value.iNumber);
-					}
-
-					children.Push(local_children);
-				}
-				else {
-					core::vector<int> emptyChildren;
-//					emptyChildren.Push(-1);
-					children.Push(emptyChildren);
+				if ( node.value.object->Contain("rotation") && (*node.value.object)["rotation"].value.array->GetSize() == 4 ) {
+					Core::JsonValue array = (*node.value.object)["rotation"];
+					rotation = { jsonNumber(array[3]), jsonNumber(array[0]), jsonNumber(array[1]), jsonNumber(array[2]) };
 				}
-				
+
 				if ( node.value.object->Contain("scale") ) {
 					Core::JsonValue array = (*node.value.object)["scale"];
-					for ( unsigned int i = 0; i < array.value.array->GetSize(); ++i ) {
-						if ( array[i].isInterger() )
-							scale[i][i] = array[i].value.iNumber;
-						else if ( array[i].isFloat() )
-							scale[i][i] = array[i].value.fNumber;
-					}
+					for ( unsigned int c = 0; c < array.value.array->GetSize() && c < 3; ++c )
+						scale[c] = jsonNumber(array[c]);
 				}
 
-				if ( node.value.object->Contain("translation") ) {
-					Core::JsonValue array = (*node.value.object)["translation"];
-					for ( unsigned int i = 0; i < array.value.array->GetSize(); ++i ) {
-						if ( array[i].isInterger() )
-							translation[3][i] = array[i].value.iNumber;
-						else if ( array[i].isFloat() )
-							translation[3][i] = array[i].value.fNumber;
-					}
-
+				mat4 inverseBindMatrix(1.0f);
+				if ( (i + 1) * 16 <= inverseBindMatricesData.GetSize() )
+					for ( unsigned int g = 0; g < 4; ++g )
+						for ( unsigned int j = 0; j < 4; ++j )
+							inverseBindMatrix[g][j] = inverseBindMatricesData[i * 16 + g * 4 + j];
 
-				}
-				
-				mat4 model = translation * scale * rotation;
-				globalTransformJointNode.Push(model);
+				animation.AddJoint(inverseBindMatrix, translation, rotation, scale);
 			}
 
-			unsigned int inverseBindMatricesIndex = (*gltf)["skins"][0]["inverseBindMatrices"].value.iNumber;
-			unsigned int bufferView = (*gltf)["accessors"][inverseBindMatricesIndex]["bufferView"].value.iNumber;
-			unsigned int byteLengthInverseBindMatrices = (*gltf)["bufferViews"][bufferView]["byteLength"].value.iNumber;
-			unsigned int byteOffsetInverseBindMatrices = (*gltf)["bufferViews"][bufferView]["byteOffset"].value.iNumber;
-
-			core::vector<float> inverseBindMatricesData;
-			for ( unsigned int i = byteOffsetInverseBindMatrices; i < byteOffsetInverseBindMatrices + byteLengthInverseBindMatrices; i += 4 )
-				inverseBindMatricesData.Push(reinterpret_cast<float &>(buffer[i]));
-
-			mat4 inverseBindMatrix(0.0f);
-			for ( unsigned int n = 0; n < joints.value.array->GetSize(); ++n ) {
-				for ( unsigned int g = 0; g < 4; ++g )
-					for ( unsigned int j = 0; j < 4; ++j )
-						inverseBindMatrix[g][j] = inverseBindMatricesData[n * 16 + g * 4 + j];
+			for ( unsigned int i = 0; i < jointsNumber; ++i ) {
+				Core::JsonValue node = nodes[(*joints.value.array)[i].value.iNumber];
+				if ( !node.value.object->Contain("children") )
+					continue;
 
-				inverseBindMatrixSet.Push(inverseBindMatrix);
+				Core::JsonValue array = (*node.value.object)["children"];
+				for ( unsigned int c = 0; c < array.value.array->GetSize(); ++c ) {
+					int childJoint = static_cast<int>(getJointIndex(joints, array[c].value.iNumber));
+					if ( childJoint >= 0 )
+						animation.SetParent(childJoint, i);
+				}
 			}
 
 			unsigned int joints_index = (*gltf)["meshes"][0]["primitives"][0]["attributes"]["JOINTS_0"].value.iNumber;
@@ -575,267 +519,48 @@ namespace GLVM::Core
 				jointsIndices.Push(reinterpret_cast<char &>(buffer[i]));
 
 			unsigned int weights_index = (*gltf)["meshes"][0]["primitives"][0]["attributes"]["WEIGHTS_0"].value.iNumber;
-			unsigned int weights_buffer_view_index = (*gltf)["accessors"][weights_index]["bufferView"].value.iNumber;
-			unsigned int weights_byte_length = (*gltf)["bufferViews"][weights_buffer_view_index]["byteLength"].value.iNumber;
-			unsigned int weights_byte_offset = (*gltf)["bufferViews"][weights_buffer_view_index]["byteOffset"].value.iNumber;
-
-			for ( unsigned int i = weights_byte_offset; i < weights_byte_offset + weights_byte_length; i += 4 )
-				weightsContainer.Push(reinterpret_cast<float &>(buffer[i]));
+			weightsContainer = readAccessorFloats(buffer, weights_index);
 		} else {
 			noAnimations = true;
 		}
 
+		/// Channels kept as keyframes, pose sampled by renderer at time of clip.
 		core::vector<Core::JsonValue> animations = Search("animations");
 
-		if ( animations.GetSize() > 0 ) {
-			core::vector<Core::JsonValue> samplerIndices;
-			core::vector<Core::JsonValue> targetNodes;
-			core::vector<Core::JsonValue> targetPaths;
+		if ( animations.GetSize() > 0 && skins.GetSize() > 0 ) {
 			Core::JsonValue channels = (*gltf)["animations"][0]["channels"];
-			for ( unsigned int i = 0; i < channels.value.array->GetSize(); ++i )
-				samplerIndices.Push(channels[i]["sampler"]);
-
-			for ( unsigned int i = 0; i < channels.value.array->GetSize(); ++i )
-				targetNodes.Push(channels[i]["target"]["node"]);
-
-			for ( unsigned int i = 0; i < channels.value.array->GetSize(); ++i )
-				targetPaths.Push(channels[i]["target"]["path"]);
-
-			core::vector<unsigned int> translationSamplerIndices;
-			core::vector<unsigned int> rotationSamplerIndices;
-			core::vector<unsigned int> scaleSamplerIndices;
-			for ( unsigned int i = 0; i < samplerIndices.GetSize(); ++i ) {
-				if ( *targetPaths[i].value.string == "translation" ) {
-					translationSamplerIndices.Push(samplerIndices[i].value.iNumber);
-				} else if ( *targetPaths[i].value.string == "rotation" ) {
-					rotationSamplerIndices.Push(samplerIndices[i].value.iNumber);
-				} else if ( *targetPaths[i].value.string == "scale" ) {
-					scaleSamplerIndices.Push(samplerIndices[i].value.iNumber);
-				}
-			}
-
 			Core::JsonValue samplers = (*gltf)["animations"][0]["samplers"];
-				
-			core::vector<unsigned int> translationInputs;
-			core::vector<unsigned int> translationOutputs;
-				
-			for ( unsigned int i = 0; i < translationSamplerIndices.GetSize(); ++i)
-				translationInputs.Push(samplers[translationSamplerIndices[i]]["input"].value.iNumber);
-
-			for ( unsigned int i = 0; i < translationSamplerIndices.GetSize(); ++i)
-				translationOutputs.Push(samplers[translationSamplerIndices[i]]["output"].value.iNumber);
-
-			core::vector<core::vector<float>> frameInputsTranslation;
-			for ( unsigned int i = 0; i < translationInputs.GetSize(); ++i) {
-				unsigned int frameBufferViewIndex =
-					(*gltf)["accessors"][translationInputs[i]]["bufferView"].value.iNumber;
-				unsigned int frameByteLength      =
-					(*gltf)["bufferViews"][frameBufferViewIndex]["byteLength"].value.iNumber;
-				unsigned int frameByteOffset      =
-					(*gltf)["bufferViews"][frameBufferViewIndex]["byteOffset"].value.iNumber;
-
-				core::vector<float> temp;
-				for ( unsigned int i = frameByteOffset; i < frameByteOffset + frameByteLength; i += 4 )
-					temp.Push(reinterpret_cast<float &>(buffer[i]));
-
-				frameInputsTranslation.Push(temp);
-			}
-
-			core::vector<core::vector<float>> translations;
-			for ( unsigned int i = 0; i < translationOutputs.GetSize(); ++i) {
-				unsigned int outputBufferViewIndex =
-					(*gltf)["accessors"][translationOutputs[i]]["bufferView"].value.iNumber;
-				unsigned int outputByteLength      =
-					(*gltf)["bufferViews"][outputBufferViewIndex]["byteLength"].value.iNumber;
-				unsigned int outputByteOffset      =
-					(*gltf)["bufferViews"][outputBufferViewIndex]["byteOffset"].value.iNumber;
-
-				core::vector<float> temp;
-				for ( unsigned int i = outputByteOffset; i < outputByteOffset + outputByteLength; i += 4 )
-					temp.Push(reinterpret_cast<float &>(buffer[i]));
-
-				translations.Push(temp);
-			}
-
-			core::vector<unsigned int> rotationInputs;
-			core::vector<unsigned int> rotationOutputs;
-				
-			for ( unsigned int i = 0; i < rotationSamplerIndices.GetSize(); ++i)
-				rotationInputs.Push(samplers[rotationSamplerIndices[i]]["input"].value.iNumber);
-
-			for ( unsigned int i = 0; i < rotationSamplerIndices.GetSize(); ++i)
-				rotationOutputs.Push(samplers[rotationSamplerIndices[i]]["output"].value.iNumber);
-
-			core::vector<core::vector<float>> frameInputsRotation;
-			for ( unsigned int i = 0; i < rotationInputs.GetSize(); ++i) {
-				unsigned int frameBufferViewIndex =
-					(*gltf)["accessors"][rotationInputs[i]]["bufferView"].value.iNumber;
-				unsigned int frameByteLength      =
-					(*gltf)["bufferViews"][frameBufferViewIndex]["byteLength"].value.iNumber;
-				unsigned int frameByteOffset      =
-					(*gltf)["bufferViews"][frameBufferViewIndex]["byteOffset"].value.iNumber;
-
-				core::vector<float> temp;
-				for ( unsigned int i = frameByteOffset; i < frameByteOffset + frameByteLength; i += 4 )
-					temp.Push(reinterpret_cast<float &>(buffer[i]));
-
-				frameInputsRotation.Push(temp);
-			}
-
-			core::vector<core::vector<float>> rotations;
-			for ( unsigned int i = 0; i < rotationOutputs.GetSize(); ++i) {
-				unsigned int outputBufferViewIndex =
-					(*gltf)["accessors"][rotationOutputs[i]]["bufferView"].value.iNumber;
-				unsigned int outputByteLength      =
-					(*gltf)["bufferViews"][outputBufferViewIndex]["byteLength"].value.iNumber;
-				unsigned int outputByteOffset      =
-					(*gltf)["bufferViews"][outputBufferViewIndex]["byteOffset"].value.iNumber;
-
-				core::vector<float> temp;
-				for ( unsigned int i = outputByteOffset; i < outputByteOffset + outputByteLength; i += 4 )
-					temp.Push(reinterpret_cast<float &>(buffer[i]));
-
-				rotations.Push(temp);
-			}
-			
-			core::vector<unsigned int> scaleInputs;
-			core::vector<unsigned int> scaleOutputs;
-				
-			for ( unsigned int i = 0; i < scaleSamplerIndices.GetSize(); ++i)
-				scaleInputs.Push(samplers[scaleSamplerIndices[i]]["input"].value.iNumber);
-
-			for ( unsigned int i = 0; i < scaleSamplerIndices.GetSize(); ++i)
-				scaleOutputs.Push(samplers[scaleSamplerIndices[i]]["output"].value.iNumber);
-
-			core::vector<core::vector<float>> frameInputsScale;
-			for ( unsigned int i = 0; i < scaleInputs.GetSize(); ++i) {
-				unsigned int frameBufferViewIndex =
-					(*gltf)["accessors"][scaleInputs[i]]["bufferView"].value.iNumber;
-				unsigned int frameByteLength      =
-					(*gltf)["bufferViews"][frameBufferViewIndex]["byteLength"].value.iNumber;
-				unsigned int frameByteOffset      =
-					(*gltf)["bufferViews"][frameBufferViewIndex]["byteOffset"].value.iNumber;
-
-				core::vector<float> temp;
-				for ( unsigned int i = frameByteOffset; i < frameByteOffset + frameByteLength; i += 4 )
-					temp.Push(reinterpret_cast<float &>(buffer[i]));
-
-				frameInputsScale.Push(temp);
-			}
-
-			core::vector<core::vector<float>> scales;
-			for ( unsigned int i = 0; i < scaleOutputs.GetSize(); ++i) {
-				unsigned int outputBufferViewIndex =
-					(*gltf)["accessors"][scaleOutputs[i]]["bufferView"].value.iNumber;
-				unsigned int outputByteLength      =
-					(*gltf)["bufferViews"][outputBufferViewIndex]["byteLength"].value.iNumber;
-				unsigned int outputByteOffset      =
-					(*gltf)["bufferViews"][outputBufferViewIndex]["byteOffset"].value.iNumber;
-
-				core::vector<float> temp;
-				for ( unsigned int i = outputByteOffset; i < outputByteOffset + outputByteLength; i += 4 )
-					temp.Push(reinterpret_cast<float &>(buffer[i]));
-
-				scales.Push(temp);
-			}
-
-			/// Searching for parent joins WITH GOAT GOTO OPERATOR!!!
-			core::vector<int> parent_joins;
-			for ( unsigned int s = 0; s < joints.value.array->GetSize(); ++s ) {
-				int current_joint = (*joints.value.array)[s].value.iNumber;
-
-				for ( unsigned w = 0; w < children.GetSize(); ++w ) {
-					for ( unsigned q = 0; q < children[w].GetSize(); ++q ) {
-						if ( children[w][q] == current_joint )
-							goto most_scary_operator_of_all_time;                                        ///< Yes. This is what we all deserve
-					}
-				}
-				parent_joins.Push(current_joint);
-				
-			  most_scary_operator_of_all_time:                                                           ///< Not so scary at all. Am i right?
-				continue;
-			}
-
-			frames = frameInputsTranslation[0];
-			core::vector<core::vector<mat4>> jointMatricesAccumulator;        ///< Delete this sheet!
-
-			core::vector<core::vector<unsigned int>> joints_bones;
-			for ( unsigned int w = 0; w < parent_joins.GetSize(); ++w ) {
-				core::vector<core::vector<unsigned int>> nodes_bones;
-				unsigned int currentNode = parent_joins[w];
-				core::stack<u32> node_stack;
-				node_stack.push(currentNode);
-
-				core::stack<u32> deepness_stack;
-				traversalBones(children, joints, node_stack, deepness_stack, nodes_bones);
+			for ( unsigned int i = 0; i < channels.value.array->GetSize(); ++i ) {
+				int joint = static_cast<int>(getJointIndex(joints, channels[i]["target"]["node"].value.iNumber));
+				std::string path = *channels[i]["target"]["path"].value.string;
+				if ( joint < 0 || (path != "translation" && path != "rotation" && path != "scale") )
+					continue;
 
-				for ( unsigned int e = 0; e < nodes_bones.GetSize(); ++e ) {
-					joints_bones.Push(nodes_bones[e]);
+				Core::JsonValue sampler = samplers[channels[i]["sampler"].value.iNumber];
+				core::AnimationSampler animationSampler;
+				if ( sampler.value.object->Contain("interpolation") ) {
+					std::string interpolation = *sampler["interpolation"].value.string;
+					if ( interpolation == "STEP" )
+						animationSampler.interpolation = core::eSTEP;
+					else if ( interpolation == "CUBICSPLINE" )
+						animationSampler.interpolation = core::eCUBICSPLINE;
 				}
-			}
 
-			for ( unsigned int j = 0; j < translations.GetSize(); ++j ) {
-				core::vector<float> boneAllFrameTranslations = translations[j];
-				core::vector<float> boneAllFrameRotations    = rotations[j];
-				core::vector<float> boneAllFrameScales;
-				if ( scales.GetSize() > 0 )
-					boneAllFrameScales       = scales[j];
-				core::vector<mat4>  globalAllFrameNodeMatrix;
-				core::vector<mat4>  globalAllFrameNodeMatrixAccumulator;
-				for ( unsigned int i = 0; i < frameInputsTranslation[0].GetSize(); ++i ) {
-					mat4 frameTranslation(1.0f);
-					mat4 frameScale(1.0f);
-					for ( unsigned int q = 0; q < 3; ++q ) {
-						frameTranslation[3][q] = boneAllFrameTranslations[i * 3 + q];
-						if ( scales.GetSize() > 0 )
-						frameScale[q][q]       = boneAllFrameScales[i * 3 + q];
-					}
-
-					Quaternion frameRotationQuaternion;
-					mat4 frameRotation(1.0f);
-					frameRotationQuaternion.x = boneAllFrameRotations[i * 4];
-					frameRotationQuaternion.y = boneAllFrameRotations[i * 4 + 1];
-					frameRotationQuaternion.z = boneAllFrameRotations[i * 4 + 2];
-					frameRotationQuaternion.w = boneAllFrameRotations[i * 4 + 3];
+				animationSampler.times  = readAccessorFloats(buffer, sampler["input"].value.iNumber);
+				animationSampler.values = readAccessorFloats(buffer, sampler["output"].value.iNumber);
 
-					frameRotation = rotateQuaternion<float, 4>(frameRotationQuaternion);
-					frameRotation.SelfTensorTranspose();
+				core::EAnimationPath animationPath = core::eSCALE;
+				if ( path == "translation" )
+					animationPath = core::eTRANSLATION;
+				else if ( path == "rotation" )
+					animationPath = core::eROTATION;
 
-					mat4 globalTransformNodeMatrix = frameScale * frameRotation * frameTranslation;
-					globalAllFrameNodeMatrixAccumulator.Push(globalTransformNodeMatrix);
-				}
-				jointMatricesAccumulator.Push(globalAllFrameNodeMatrixAccumulator);
-			}
-			
-			for ( unsigned int j = 0; j < translations.GetSize(); ++j ) {
-				core::vector<mat4>  globalAllFrameNodeMatrix;
-				
-				for ( unsigned int i = 0; i < frameInputsTranslation[0].GetSize(); ++i ) {
-					mat4 rootTransform(1.0f);
-					for ( unsigned int b = 0; b < joints_bones[j].GetSize() - 1; ++b ) {
-						rootTransform = jointMatricesAccumulator[joints_bones[j][b]][i] * rootTransform;
-					}
-					globalAllFrameNodeMatrix.Push(inverseBindMatrixSet[j] * jointMatricesAccumulator[j][i] * rootTransform);
-				}
-				jointMatrices.Push(globalAllFrameNodeMatrix);
-			}
-			int maximumJoints     = 6;
-			int unitMatricesSize = maximumJoints - jointMatrices.GetSize();
-
-			if ( unitMatricesSize > 0 ) {
-				for ( int i = 0; i < unitMatricesSize; ++i) {
-					core::vector<mat4>  globalAllFrameNodeMatrix;
-					for ( unsigned int j = 0; j < frameInputsTranslation[0].GetSize(); ++j ) {
-						mat4 unitMatrix(1.0f);
-						globalAllFrameNodeMatrix.Push(unitMatrix);
-					}
-
-					jointMatrices.Push(globalAllFrameNodeMatrix);
-				}
+				animation.AddChannel(joint, animationPath, std::move(animationSampler));
 			}
 		}
 
-		jointMatricesPerMesh = jointMatrices;
+		animation.BuildEvaluationOrder();
+		animation.Bake();
 
 		for ( uint32_t i = 0; i < indices.GetSize(); ++i ) {
 			aIndices_.push_back(i);
@@ -887,120 +612,21 @@ namespace GLVM::Core
 		buffer = nullptr;
 	}
 
-	void CJsonParser::traversalBones( core::vector<core::vector<int>> children,
-									  Core::JsonValue joints,
-									  core::stack<u32> node_stack,
-									  core::stack<u32> deepness_stack,
-									  core::vector<core::vector<u32>>& result ) {
-		u32 topJointIndex = 0;
-		if ( !node_stack.empty() ) {
-			topJointIndex = getJointIndex(joints, node_stack.top());
-		}
-		
-		if ( node_stack.size() > deepness_stack.size() ) {
-			u32 firstChild = 0;
-			deepness_stack.push(firstChild);
-		}
-
-		if ( deepness_stack.empty() )
-			return;
-
-		u32 nextNodeIndex = 0;
-		if ( !children[topJointIndex].empty() ) {
-			if ( deepness_stack.top() > 0 && deepness_stack.top() == children[topJointIndex].GetSize() ) {
-				deepness_stack.pop();
-				node_stack.pop();
-				traversalBones( children, joints, node_stack, deepness_stack, result );
-				return;
-			}
-
-			if ( deepness_stack.top() > 0 && deepness_stack.top() < children[topJointIndex].GetSize() ) {
-				nextNodeIndex = children[topJointIndex][deepness_stack.top()];
-				node_stack.push(nextNodeIndex);
-
-				core::vector<u32> current_node_indices;
-				for ( u32 i = 0; i < node_stack.size(); ++i ) {
-					u32 currentJoinIndex = getJointIndex(joints, node_stack[i]);
-					current_node_indices.Push(currentJoinIndex);
-				}
-
-				++deepness_stack.top();
-				traversalBones( children, joints, node_stack, deepness_stack, result );
-				return;
-			} else {
-				core::vector<u32> current_node_indices;
-				for ( u32 i = 0; i < node_stack.size(); ++i ) {
-					u32 currentJoinIndex = getJointIndex(joints, node_stack[i]);
-					current_node_indices.Push(currentJoinIndex);
-				}
-		
-				result.Push(current_node_indices);
-			
-				nextNodeIndex = children[topJointIndex][deepness_stack.top()];
-				node_stack.push(nextNodeIndex);
-				++deepness_stack.top();
-				traversalBones( children, joints, node_stack, deepness_stack, result );
-				return;
-			}
-		} else {
-			core::vector<u32> current_node_indices;
-			for ( u32 i = 0; i < node_stack.size(); ++i ) {
-				u32 currentJoinIndex = getJointIndex(joints, node_stack[i]);
-				current_node_indices.Push(currentJoinIndex);
-			}
-
-			result.Push(current_node_indices);
-			
-			deepness_stack.pop();
-			node_stack.pop();
-			traversalBones( children, joints, node_stack, deepness_stack, result );
-			return;
-		}
-	}
-
-	core::vector<core::vector<unsigned int>> CJsonParser::makeRenderJointsIndices(core::vector<core::vector<unsigned int>>& input) {
-		core::vector<core::vector<unsigned int>> result;
-
-		bool accumulatorFlag = false;
-		bool innerFlag  = false;
-		unsigned int accumulator = input[0][0];
-		for ( unsigned int i = 0; i < input.GetSize(); ++i ) {
-			for ( unsigned int j = 0; j < input[i].GetSize(); ++j ) {
-				core::vector<unsigned int> inner;
-				for ( unsigned int v = 0; v < j + 1; ++v ) {
-					if ( input[i][j] == accumulator && accumulatorFlag ) {
-						innerFlag = false;
-						continue;
-					} else {
-						innerFlag = true;
-						inner.Push(input[i][v]);
-
-						if ( accumulatorFlag == false )
-							accumulatorFlag = true;
-					}
-				}
+	/// Float values of accessor, whole buffer view read as other attributes of mesh.
+	core::vector<float> CJsonParser::readAccessorFloats(const char* buffer, unsigned int accessorIndex) {
+		Core::JsonValue* gltf = GetRoot();
+		unsigned int bufferViewIndex = (*gltf)["accessors"][accessorIndex]["bufferView"].value.iNumber;
+		unsigned int byteLength      = (*gltf)["bufferViews"][bufferViewIndex]["byteLength"].value.iNumber;
+		unsigned int byteOffset      = (*gltf)["bufferViews"][bufferViewIndex]["byteOffset"].value.iNumber;
 
-				if ( innerFlag )
-					result.Push(inner);
-			}
-		}
+		core::vector<float> result;
+		result.Reserve(byteLength / 4);
+		for ( unsigned int i = byteOffset; i < byteOffset + byteLength; i += 4 )
+			result.Push(reinterpret_cast<const float &>(buffer[i]));
 
 		return result;
 	}
 
-	bool CJsonParser::containsElemnt(core::vector<core::vector<unsigned int>> container, unsigned int element) {
-		bool flag = false;
-		
-		for ( unsigned int i = 0; i < container.GetSize(); ++i ) {
-			for ( unsigned int j = 0; j < container[i].GetSize(); ++j ) {
-				if ( container[i][j] == element )
-					return true;
-			}
-		}
-
-		return flag;
-	}
-	
 	u32 CJsonParser::getJointIndex(Core::JsonValue joints, i32 searchingIndex) {
 		for ( unsigned int i = 0; i < joints.value.array->GetSize(); ++i ) {
 			int currentJointIndex = (*joints.value.array)[i].value.iNumber;
@@ -0,0 +1,137 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "PoseCache.hpp"
+
+namespace GLVM::core
+{
+	CPoseCache::CPoseCache(unsigned int capacity_, unsigned int paletteSize_) : capacity(capacity_ > 0 ? capacity_ : 1), paletteSize(paletteSize_) {
+		/// Table at most half full, so probe sequences stay short.
+		unsigned int bucketsNumber = 1;
+		while ( bucketsNumber < capacity * 2 )
+			bucketsNumber *= 2;
+
+		keys.Resize(capacity);
+		slotFrames.Resize(capacity);
+		previousSlots.Resize(capacity);
+		nextSlots.Resize(capacity);
+		buckets.Resize(bucketsNumber);
+		palettes.Resize(capacity * paletteSize);
+		Clear();
+	}
+
+	unsigned int CPoseCache::HashKey(std::uint64_t key) {
+		return static_cast<unsigned int>((key * 0x9E3779B97F4A7C15ull) >> 32);
+	}
+
+	unsigned int CPoseCache::FindBucket(std::uint64_t key) const {
+		unsigned int mask = buckets.GetSize() - 1;
+		unsigned int bucket = HashKey(key) & mask;
+		while ( buckets[bucket] >= 0 && keys[buckets[bucket]] != key )
+			bucket = (bucket + 1) & mask;
+
+		return bucket;
+	}
+
+	/// Backward shift deletion, entries after removed one moved closer to their home bucket.
+	void CPoseCache::RemoveKey(std::uint64_t key) {
+		unsigned int mask = buckets.GetSize() - 1;
+		unsigned int hole = FindBucket(key);
+		if ( buckets[hole] < 0 )
+			return;
+
+		buckets[hole] = -1;
+		unsigned int bucket = hole;
+		while ( true ) {
+			bucket = (bucket + 1) & mask;
+			if ( buckets[bucket] < 0 )
+				return;
+
+			unsigned int home = HashKey(keys[buckets[bucket]]) & mask;
+			bool homeBetween = hole <= bucket ? (hole < home && home <= bucket) : (hole < home || home <= bucket);
+			if ( homeBetween )
+				continue;
+
+			buckets[hole] = buckets[bucket];
+			buckets[bucket] = -1;
+			hole = bucket;
+		}
+	}
+
+	void CPoseCache::Unlink(unsigned int slot) {
+		int previous = previousSlots[slot];
+		int next = nextSlots[slot];
+		if ( previous >= 0 )
+			nextSlots[previous] = next;
+		else
+			head = next;
+
+		if ( next >= 0 )
+			previousSlots[next] = previous;
+		else
+			tail = previous;
+	}
+
+	void CPoseCache::Touch(unsigned int slot, unsigned int frame) {
+		slotFrames[slot] = frame;
+		if ( static_cast<int>(slot) == tail )
+			return;
+
+		Unlink(slot);
+		previousSlots[slot] = tail;
+		nextSlots[slot] = -1;
+		if ( tail >= 0 )
+			nextSlots[tail] = slot;
+		else
+			head = slot;
+		tail = slot;
+	}
+
+	EPoseCacheResult CPoseCache::Acquire(std::uint64_t key, unsigned int frame, unsigned int& slot) {
+		unsigned int bucket = FindBucket(key);
+		if ( buckets[bucket] >= 0 ) {
+			slot = buckets[bucket];
+			Touch(slot, frame);
+			return ePOSE_CACHE_HIT;
+		}
+
+		EPoseCacheResult result = ePOSE_CACHE_INSERTED;
+		if ( usedSlots < capacity ) {
+			slot = usedSlots++;
+			previousSlots[slot] = tail;
+			nextSlots[slot] = -1;
+			if ( tail >= 0 )
+				nextSlots[tail] = slot;
+			else
+				head = slot;
+			tail = slot;
+		} else {
+			/// Usage list sorted by frame, so head touched in this frame means every slot was.
+			if ( slotFrames[head] == frame )
+				return ePOSE_CACHE_FULL;
+
+			slot = head;
+			RemoveKey(keys[slot]);
+			bucket = FindBucket(key);
+			result = ePOSE_CACHE_EVICTED;
+		}
+
+		keys[slot] = key;
+		buckets[bucket] = slot;
+		Touch(slot, frame);
+
+		return result;
+	}
+
+	void CPoseCache::Clear() {
+		usedSlots = 0;
+		head = -1;
+		tail = -1;
+		for ( unsigned int i = 0; i < buckets.GetSize(); ++i )
+			buckets[i] = -1;
+		for ( unsigned int i = 0; i < capacity; ++i )
+			slotFrames[i] = 0;
+	}
+}
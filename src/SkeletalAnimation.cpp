@@ -0,0 +1,389 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "SkeletalAnimation.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace GLVM::core
+{
+	unsigned int CSkeletalAnimation::AddJoint(const mat4& inverseBindMatrix, vec3 restTranslation,
+											  Quaternion restRotation, vec3 restScale) {
+		parents.Push(-1);
+		inverseBindMatrices.Push(inverseBindMatrix);
+		restTranslations.Push(restTranslation);
+		restRotations.Push(restRotation);
+		restScales.Push(restScale);
+		translationSamplers.Push(-1);
+		rotationSamplers.Push(-1);
+		scaleSamplers.Push(-1);
+
+		return parents.GetSize() - 1;
+	}
+
+	void CSkeletalAnimation::SetParent(unsigned int joint, int parent) {
+		if ( joint < parents.GetSize() && parent < static_cast<int>(parents.GetSize()) )
+			parents[joint] = parent;
+	}
+
+	/// Sampler with less values than keyframes need is dropped, joint keeps rest value.
+	void CSkeletalAnimation::AddChannel(unsigned int joint, EAnimationPath path, AnimationSampler&& sampler) {
+		unsigned int keyframesNumber = sampler.times.GetSize();
+		unsigned int components = path == eROTATION ? 4 : 3;
+		unsigned int valuesPerKeyframe = sampler.interpolation == eCUBICSPLINE ? components * 3 : components;
+		if ( joint >= parents.GetSize() || keyframesNumber == 0 || sampler.values.GetSize() < keyframesNumber * valuesPerKeyframe )
+			return;
+
+		if ( sampler.times[keyframesNumber - 1] > duration )
+			duration = sampler.times[keyframesNumber - 1];
+
+		/// Exporters usually write same input for all channels, so keyframe found once for all of them.
+		int samplerIndex = samplers.GetSize();
+		sampler.timeline = timelines.GetSize();
+		for ( unsigned int i = 0; i < timelines.GetSize(); ++i ) {
+			const core::vector<float>& times = samplers[timelines[i]].times;
+			if ( times.GetSize() != keyframesNumber )
+				continue;
+
+			unsigned int k = 0;
+			while ( k < keyframesNumber && times[k] == sampler.times[k] )
+				++k;
+
+			if ( k == keyframesNumber ) {
+				sampler.timeline = i;
+				sampler.times.clear();
+				break;
+			}
+		}
+
+		if ( sampler.timeline == timelines.GetSize() )
+			timelines.Push(samplerIndex);
+
+		samplers.Push(std::move(sampler));
+		switch ( path ) {
+		case eTRANSLATION:
+			translationSamplers[joint] = samplerIndex;
+			break;
+		case eROTATION:
+			rotationSamplers[joint] = samplerIndex;
+			break;
+		case eSCALE:
+			scaleSamplers[joint] = samplerIndex;
+			break;
+		}
+	}
+
+	/// Joints sorted by depth, parent that make cycle is dropped.
+	void CSkeletalAnimation::BuildEvaluationOrder() {
+		unsigned int jointsNumber = parents.GetSize();
+		core::vector<unsigned int> depths;
+		unsigned int maximumDepth = 0;
+		for ( unsigned int i = 0; i < jointsNumber; ++i ) {
+			unsigned int depth = 0;
+			int current = parents[i];
+			while ( current >= 0 && depth <= jointsNumber ) {
+				current = parents[current];
+				++depth;
+			}
+
+			if ( depth > jointsNumber ) {
+				parents[i] = -1;
+				depth = 0;
+			}
+
+			depths.Push(depth);
+			if ( depth > maximumDepth )
+				maximumDepth = depth;
+		}
+
+		evaluationOrder.clear();
+		for ( unsigned int depth = 0; depth <= maximumDepth; ++depth )
+			for ( unsigned int i = 0; i < jointsNumber; ++i )
+				if ( depths[i] == depth )
+					evaluationOrder.Push(i);
+	}
+
+	/// Keyframes of all timelines merged, so every channel is linear or constant between two of them.
+	bool CSkeletalAnimation::Bake() {
+		bakedTimes.clear();
+		bakedPalettes.clear();
+		if ( samplers.GetSize() == 0 || samplers[0].interpolation == eCUBICSPLINE )
+			return false;
+
+		EInterpolation interpolation = samplers[0].interpolation;
+		for ( unsigned int i = 1; i < samplers.GetSize(); ++i )
+			if ( samplers[i].interpolation != interpolation )
+				return false;
+
+		core::vector<float> allTimes;
+		for ( unsigned int i = 0; i < timelines.GetSize(); ++i ) {
+			const core::vector<float>& times = samplers[timelines[i]].times;
+			for ( unsigned int k = 0; k < times.GetSize(); ++k )
+				allTimes.Push(times[k]);
+		}
+		std::sort(allTimes.GetVectorContainer(), allTimes.GetVectorContainer() + allTimes.GetSize());
+
+		core::vector<float> keyframeTimes;
+		for ( unsigned int k = 0; k < allTimes.GetSize(); ++k )
+			if ( keyframeTimes.GetSize() == 0 || allTimes[k] != keyframeTimes[keyframeTimes.GetSize() - 1] )
+				keyframeTimes.Push(allTimes[k]);
+
+		unsigned int jointsNumber = parents.GetSize();
+		unsigned int keyframesNumber = keyframeTimes.GetSize();
+		if ( keyframesNumber * jointsNumber > MAX_BAKED_MATRICES )
+			return false;
+
+		core::vector<mat4> keyframePalettes;
+		keyframePalettes.Resize(keyframesNumber * jointsNumber);
+		for ( unsigned int k = 0; k < keyframesNumber; ++k )
+			EvaluatePose(keyframeTimes[k], &keyframePalettes[k * jointsNumber], jointsNumber);
+
+		/// Filled aside, EvaluatePose keeps sampling until bake finished.
+		core::vector<float> times;
+		core::vector<mat4> palettes;
+		for ( unsigned int k = 0; k < keyframesNumber; ++k ) {
+			times.Push(keyframeTimes[k]);
+			for ( unsigned int joint = 0; joint < jointsNumber; ++joint )
+				palettes.Push(keyframePalettes[k * jointsNumber + joint]);
+
+			if ( interpolation == eLINEAR && k + 1 < keyframesNumber &&
+				 !BakeSegment(keyframeTimes[k], &keyframePalettes[k * jointsNumber], keyframeTimes[k + 1],
+							  &keyframePalettes[(k + 1) * jointsNumber], 0, times, palettes) )
+				return false;
+		}
+
+		bakedTimes = std::move(times);
+		bakedPalettes = std::move(palettes);
+		bakedInterpolation = interpolation;
+
+		return true;
+	}
+
+	/// Middle of segment baked too if blend of its ends is too far from sampled pose, ends not written.
+	bool CSkeletalAnimation::BakeSegment(float fromTime, const mat4* fromPalette, float toTime, const mat4* toPalette,
+										 unsigned int depth, core::vector<float>& times, core::vector<mat4>& palettes) const {
+		unsigned int jointsNumber = parents.GetSize();
+		float middleTime = (fromTime + toTime) * 0.5f;
+		core::vector<mat4> middlePalette;
+		middlePalette.Resize(jointsNumber);
+		EvaluatePose(middleTime, &middlePalette[0], jointsNumber);
+
+		bool blendFits = true;
+		for ( unsigned int joint = 0; joint < jointsNumber && blendFits; ++joint )
+			for ( unsigned int row = 0; row < 4; ++row )
+				for ( unsigned int column = 0; column < 4; ++column ) {
+					float blended = (fromPalette[joint][row][column] + toPalette[joint][row][column]) * 0.5f;
+					float exact = middlePalette[joint][row][column];
+					if ( std::fabs(blended - exact) > BAKED_POSE_TOLERANCE * std::max(1.0f, std::fabs(exact)) )
+						blendFits = false;
+				}
+
+		if ( blendFits )
+			return true;
+
+		if ( depth == MAX_BAKED_SUBDIVISIONS || palettes.GetSize() + jointsNumber > MAX_BAKED_MATRICES )
+			return false;
+
+		if ( !BakeSegment(fromTime, fromPalette, middleTime, &middlePalette[0], depth + 1, times, palettes) )
+			return false;
+
+		times.Push(middleTime);
+		for ( unsigned int joint = 0; joint < jointsNumber; ++joint )
+			palettes.Push(middlePalette[joint]);
+
+		return BakeSegment(middleTime, &middlePalette[0], toTime, toPalette, depth + 1, times, palettes);
+	}
+
+	KeyframeCursor CSkeletalAnimation::FindKeyframe(const core::vector<float>& times, float time) {
+		unsigned int keyframesNumber = times.GetSize();
+		KeyframeCursor cursor{ 0, 0, 0.0f, 0.0f };
+		if ( keyframesNumber < 2 || time <= times[0] )
+			return cursor;
+
+		if ( time >= times[keyframesNumber - 1] ) {
+			cursor.keyframe     = keyframesNumber - 1;
+			cursor.nextKeyframe = keyframesNumber - 1;
+			return cursor;
+		}
+
+		unsigned int low = 0;
+		unsigned int high = keyframesNumber - 1;
+		while ( high - low > 1 ) {
+			unsigned int middle = (low + high) / 2;
+			if ( times[middle] <= time )
+				low = middle;
+			else
+				high = middle;
+		}
+
+		cursor.keyframe         = low;
+		cursor.nextKeyframe     = low + 1;
+		cursor.keyframeDuration = times[low + 1] - times[low];
+		if ( cursor.keyframeDuration > 0.0f )
+			cursor.factor = (time - times[low]) / cursor.keyframeDuration;
+
+		return cursor;
+	}
+
+	void CSkeletalAnimation::SampleComponents(const AnimationSampler& sampler, const KeyframeCursor& cursor,
+											  unsigned int components, float* result) {
+		unsigned int keyframe = cursor.keyframe;
+		unsigned int nextKeyframe = cursor.nextKeyframe;
+		float factor = cursor.factor;
+
+		switch ( sampler.interpolation ) {
+		case eSTEP:
+			for ( unsigned int c = 0; c < components; ++c )
+				result[c] = sampler.values[keyframe * components + c];
+			break;
+		case eLINEAR:
+			for ( unsigned int c = 0; c < components; ++c ) {
+				float from = sampler.values[keyframe * components + c];
+				float to   = sampler.values[nextKeyframe * components + c];
+				result[c] = from + (to - from) * factor;
+			}
+			break;
+		case eCUBICSPLINE: {
+			/// Hermite spline, tangents scaled by duration of keyframe as glTF defines.
+			float t  = factor;
+			float t2 = t * t;
+			float t3 = t2 * t;
+			float valueWeight      = 2.0f * t3 - 3.0f * t2 + 1.0f;
+			float outTangentWeight = (t3 - 2.0f * t2 + t) * cursor.keyframeDuration;
+			float nextValueWeight  = -2.0f * t3 + 3.0f * t2;
+			float inTangentWeight  = (t3 - t2) * cursor.keyframeDuration;
+			unsigned int stride = components * 3;
+			for ( unsigned int c = 0; c < components; ++c ) {
+				float value      = sampler.values[keyframe * stride + components + c];
+				float outTangent = sampler.values[keyframe * stride + components * 2 + c];
+				float nextValue  = sampler.values[nextKeyframe * stride + components + c];
+				float inTangent  = sampler.values[nextKeyframe * stride + c];
+				result[c] = valueWeight * value + outTangentWeight * outTangent + nextValueWeight * nextValue + inTangentWeight * inTangent;
+			}
+			break;
+		}
+		}
+	}
+
+	vec3 CSkeletalAnimation::SampleVector(const AnimationSampler& sampler, const KeyframeCursor& cursor) {
+		float result[3];
+		SampleComponents(sampler, cursor, 3, result);
+
+		return { result[0], result[1], result[2] };
+	}
+
+	Quaternion CSkeletalAnimation::SampleRotation(const AnimationSampler& sampler, const KeyframeCursor& cursor) {
+		if ( sampler.interpolation == eLINEAR ) {
+			const float* from = &sampler.values[cursor.keyframe * 4];
+			const float* to   = &sampler.values[cursor.nextKeyframe * 4];
+
+			return slerpQuaternion({ from[3], from[0], from[1], from[2] }, { to[3], to[0], to[1], to[2] }, cursor.factor);
+		}
+
+		float result[4];
+		SampleComponents(sampler, cursor, 4, result);
+
+		return normalizeQuaternion({ result[3], result[0], result[1], result[2] });
+	}
+
+	void CSkeletalAnimation::EvaluatePose(float time, mat4* palette, unsigned int paletteSize) const {
+		mat4* const palettes[1] = { palette };
+		EvaluatePoses(&time, palettes, 1, paletteSize);
+	}
+
+	/// Pose copied from keyframe or blended from two keyframes, no hierarchy walk.
+	void CSkeletalAnimation::EvaluateBakedPoses(const float* times, mat4* const* palettes, unsigned int count, unsigned int paletteSize) const {
+		unsigned int skeletonJoints = parents.GetSize();
+		unsigned int jointsNumber = skeletonJoints < paletteSize ? skeletonJoints : paletteSize;
+		for ( unsigned int instance = 0; instance < count; ++instance ) {
+			KeyframeCursor cursor = FindKeyframe(bakedTimes, times[instance]);
+			const mat4* from = &bakedPalettes[cursor.keyframe * skeletonJoints];
+			const mat4* to = &bakedPalettes[cursor.nextKeyframe * skeletonJoints];
+			mat4* palette = palettes[instance];
+			if ( bakedInterpolation == eSTEP || cursor.factor == 0.0f ) {
+				for ( unsigned int joint = 0; joint < jointsNumber; ++joint )
+					palette[joint] = from[joint];
+			} else {
+				float factor = cursor.factor;
+				for ( unsigned int joint = 0; joint < jointsNumber; ++joint )
+					for ( unsigned int row = 0; row < 4; ++row )
+						for ( unsigned int column = 0; column < 4; ++column )
+							palette[joint][row][column] = from[joint][row][column] + (to[joint][row][column] - from[joint][row][column]) * factor;
+			}
+
+			for ( unsigned int joint = jointsNumber; joint < paletteSize; ++joint )
+				palette[joint] = mat4(1.0f);
+		}
+	}
+
+	void CSkeletalAnimation::EvaluatePoses(const float* times, mat4* const* palettes, unsigned int count, unsigned int paletteSize) const {
+		if ( IsBaked() ) {
+			EvaluateBakedPoses(times, palettes, count, paletteSize);
+			return;
+		}
+
+		unsigned int jointsNumber = parents.GetSize() < paletteSize ? parents.GetSize() : paletteSize;
+		unsigned int cachedTimelines = timelines.GetSize() < MAX_CACHED_TIMELINES ? timelines.GetSize() : MAX_CACHED_TIMELINES;
+		KeyframeCursor cursors[MAX_POSE_BATCH][MAX_CACHED_TIMELINES];
+
+		for ( unsigned int first = 0; first < count; first += MAX_POSE_BATCH ) {
+			unsigned int batchSize = count - first < MAX_POSE_BATCH ? count - first : MAX_POSE_BATCH;
+			const float* batchTimes = times + first;
+			mat4* const* batchPalettes = palettes + first;
+
+			for ( unsigned int instance = 0; instance < batchSize; ++instance )
+				for ( unsigned int i = 0; i < cachedTimelines; ++i )
+					cursors[instance][i] = FindKeyframe(samplers[timelines[i]].times, batchTimes[instance]);
+
+			auto cursorOf = [&](const AnimationSampler& sampler, unsigned int instance) -> KeyframeCursor {
+				if ( sampler.timeline < cachedTimelines )
+					return cursors[instance][sampler.timeline];
+
+				return FindKeyframe(samplers[timelines[sampler.timeline]].times, batchTimes[instance]);
+			};
+
+			/// World matrices of joints first, parents already written when child reached.
+			for ( unsigned int i = 0; i < evaluationOrder.GetSize(); ++i ) {
+				unsigned int joint = evaluationOrder[i];
+				if ( joint >= jointsNumber )
+					continue;
+
+				int parent = parents[joint];
+				bool hasParent = parent >= 0 && static_cast<unsigned int>(parent) < jointsNumber;
+				const AnimationSampler* translationSampler = translationSamplers[joint] >= 0 ? &samplers[translationSamplers[joint]] : nullptr;
+				const AnimationSampler* rotationSampler    = rotationSamplers[joint] >= 0 ? &samplers[rotationSamplers[joint]] : nullptr;
+				const AnimationSampler* scaleSampler       = scaleSamplers[joint] >= 0 ? &samplers[scaleSamplers[joint]] : nullptr;
+
+				for ( unsigned int instance = 0; instance < batchSize; ++instance ) {
+					vec3 translation = translationSampler ? SampleVector(*translationSampler, cursorOf(*translationSampler, instance)) : restTranslations[joint];
+					Quaternion rotation = rotationSampler ? SampleRotation(*rotationSampler, cursorOf(*rotationSampler, instance)) : restRotations[joint];
+					vec3 scale = scaleSampler ? SampleVector(*scaleSampler, cursorOf(*scaleSampler, instance)) : restScales[joint];
+
+					/// scale * transposed rotation * translation without two full matrix products.
+					mat4 rotationMatrix = rotateQuaternion<float, 4>(rotation);
+					mat4 local(1.0f);
+					for ( unsigned int row = 0; row < 3; ++row ) {
+						for ( unsigned int column = 0; column < 3; ++column )
+							local[row][column] = scale[row] * rotationMatrix[column][row];
+						local[3][row] = translation[row];
+					}
+
+					mat4* palette = batchPalettes[instance];
+					palette[joint] = hasParent ? local * palette[parent] : local;
+				}
+			}
+
+			for ( unsigned int joint = 0; joint < jointsNumber; ++joint ) {
+				const mat4& inverseBindMatrix = inverseBindMatrices[joint];
+				for ( unsigned int instance = 0; instance < batchSize; ++instance )
+					batchPalettes[instance][joint] = inverseBindMatrix * batchPalettes[instance][joint];
+			}
+
+			for ( unsigned int instance = 0; instance < batchSize; ++instance )
+				for ( unsigned int joint = jointsNumber; joint < paletteSize; ++joint )
+					batchPalettes[instance][joint] = mat4(1.0f);
+		}
+	}
+}
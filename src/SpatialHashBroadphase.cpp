@@ -0,0 +1,158 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "SpatialHashBroadphase.hpp"
+#include <cmath>
+
+namespace GLVM::ecs
+{
+	std::int32_t CSpatialHashBroadphase::CellCoordinate(float coordinate) const {
+		float cell = std::floor(coordinate / currentCellSize);
+		if ( cell > 1.0e9f )                                             ///< Far away boxes share border cells, still correct because of overlap test.
+			return 1000000000;
+		if ( !(cell > -1.0e9f) )                                         ///< Also catch NaN, its box never overlap anything.
+			return -1000000000;
+
+		return static_cast<std::int32_t>(cell);
+	}
+
+	unsigned int CSpatialHashBroadphase::HashCell(std::int32_t x, std::int32_t y, std::int32_t z) {
+		return (static_cast<unsigned int>(x) * 73856093u) ^ (static_cast<unsigned int>(y) * 19349663u) ^
+			(static_cast<unsigned int>(z) * 83492791u);
+	}
+
+	/// Minimum corner of overlap lies inside both boxes, so it is inside exactly one of their shared cells.
+	bool CSpatialHashBroadphase::IsOwnerCell(const CellEntry& entry, const BroadphaseBox& first, const BroadphaseBox& second) const {
+		return entry.x == CellCoordinate(first.min[0] > second.min[0] ? first.min[0] : second.min[0]) &&
+			entry.y == CellCoordinate(first.min[1] > second.min[1] ? first.min[1] : second.min[1]) &&
+			entry.z == CellCoordinate(first.min[2] > second.min[2] ? first.min[2] : second.min[2]);
+	}
+
+	void CSpatialHashBroadphase::PushPair(core::vector<BroadphasePair>& pairs, unsigned int first, unsigned int second) const {
+		if ( entities[first] < entities[second] )
+			pairs.Push(BroadphasePair{ entities[first], entities[second] });
+		else
+			pairs.Push(BroadphasePair{ entities[second], entities[first] });
+	}
+
+	void CSpatialHashBroadphase::BeginUpdate() {
+		boxes.clear();
+		entities.clear();
+	}
+
+	void CSpatialHashBroadphase::UpdateProxy(Entity entity, const BroadphaseBox& box, const vec3& /*displacement*/) {
+		boxes.Push(box);
+		entities.Push(entity);
+	}
+
+	void CSpatialHashBroadphase::EndUpdate() {
+		Build();
+	}
+
+	void CSpatialHashBroadphase::Build() {
+		unsigned int boxesNumber = boxes.GetSize();
+		entries.clear();
+		oversizedBoxes.clear();
+
+		currentCellSize = cellSize;
+		if ( currentCellSize <= 0.0f ) {
+			float extentSum = 0.0f;
+			for ( unsigned int i = 0; i < boxesNumber; ++i )
+				extentSum += boxes[i].max[0] - boxes[i].min[0];
+
+			currentCellSize = boxesNumber > 0 ? 2.0f * extentSum / boxesNumber : 1.0f;
+			if ( !(currentCellSize > 0.0f) )
+				currentCellSize = 1.0f;
+		}
+
+		float oversizedExtent = currentCellSize * SPATIAL_HASH_OVERSIZED_CELLS;
+		for ( unsigned int i = 0; i < boxesNumber; ++i ) {
+			const BroadphaseBox& box = boxes[i];
+			if ( box.max[0] - box.min[0] > oversizedExtent || box.max[1] - box.min[1] > oversizedExtent ||
+				 box.max[2] - box.min[2] > oversizedExtent ) {
+				oversizedBoxes.Push(i);
+				continue;
+			}
+
+			std::int32_t minX = CellCoordinate(box.min[0]), maxX = CellCoordinate(box.max[0]);
+			std::int32_t minY = CellCoordinate(box.min[1]), maxY = CellCoordinate(box.max[1]);
+			std::int32_t minZ = CellCoordinate(box.min[2]), maxZ = CellCoordinate(box.max[2]);
+			for ( std::int32_t x = minX; x <= maxX; ++x )
+				for ( std::int32_t y = minY; y <= maxY; ++y )
+					for ( std::int32_t z = minZ; z <= maxZ; ++z )
+						entries.Push(CellEntry{ x, y, z, i });
+		}
+
+		/// Counting sort by bucket of cell hash, table has at least twice more buckets than entries.
+		unsigned int bucketsNumber = 16;
+		while ( bucketsNumber < entries.GetSize() * 2 )
+			bucketsNumber *= 2;
+
+		bucketStarts.clear();
+		bucketStarts.Resize(bucketsNumber + 1);
+		for ( unsigned int i = 0; i < entries.GetSize(); ++i )
+			++bucketStarts[(HashCell(entries[i].x, entries[i].y, entries[i].z) & (bucketsNumber - 1)) + 1];
+
+		for ( unsigned int i = 1; i <= bucketsNumber; ++i )
+			bucketStarts[i] += bucketStarts[i - 1];
+
+		sortedEntries.Resize(entries.GetSize());
+		core::vector<unsigned int>& writePositions = bucketStarts;       ///< Shifted by one bucket while filling and restored after.
+		for ( unsigned int i = 0; i < entries.GetSize(); ++i ) {
+			unsigned int bucket = HashCell(entries[i].x, entries[i].y, entries[i].z) & (bucketsNumber - 1);
+			sortedEntries[writePositions[bucket]++] = entries[i];
+		}
+
+		for ( unsigned int i = bucketsNumber; i > 0; --i )
+			bucketStarts[i] = bucketStarts[i - 1];
+		bucketStarts[0] = 0;
+	}
+
+	void CSpatialHashBroadphase::CollectPairs(core::vector<BroadphasePair>& pairs) const {
+		unsigned int boxesNumber = boxes.GetSize();
+		unsigned int bucketsNumber = bucketStarts.GetSize() > 0 ? bucketStarts.GetSize() - 1 : 0;
+		for ( unsigned int bucket = 0; bucket < bucketsNumber; ++bucket ) {
+			unsigned int begin = bucketStarts[bucket];
+			unsigned int end = bucketStarts[bucket + 1];
+			for ( unsigned int i = begin; i < end; ++i ) {
+				const CellEntry& entry = sortedEntries[i];
+				for ( unsigned int j = i + 1; j < end; ++j ) {
+					const CellEntry& other = sortedEntries[j];
+					if ( entry.x != other.x || entry.y != other.y || entry.z != other.z )
+						continue;                                        ///< Different cell with the same bucket.
+
+					const BroadphaseBox& first = boxes[entry.box];
+					const BroadphaseBox& second = boxes[other.box];
+					if ( BoxOverlap(first, second) && IsOwnerCell(entry, first, second) )
+						PushPair(pairs, entry.box, other.box);
+				}
+			}
+		}
+
+		/// Oversized boxes tested against every other box, grid boxes and other oversized ones.
+		for ( unsigned int i = 0; i < oversizedBoxes.GetSize(); ++i ) {
+			unsigned int oversized = oversizedBoxes[i];
+			for ( unsigned int j = 0; j < boxesNumber; ++j ) {
+				if ( j == oversized )
+					continue;
+
+				bool otherOversized = false;
+				for ( unsigned int k = 0; k < i && !otherOversized; ++k )
+					otherOversized = oversizedBoxes[k] == j;                 ///< Pair with earlier oversized box already reported.
+
+				if ( !otherOversized && BoxOverlap(boxes[oversized], boxes[j]) )
+					PushPair(pairs, oversized, j);
+			}
+		}
+	}
+
+	void CSpatialHashBroadphase::QueryRay(const vec3& origin, const vec3& ray, core::vector<Entity>& entities_) const {
+		vec3 inverseRay(1.0f / ray[0], 1.0f / ray[1], 1.0f / ray[2]);
+		for ( unsigned int i = 0; i < boxes.GetSize(); ++i ) {
+			if ( RayOverlap(boxes[i], origin, inverseRay) )
+				entities_.Push(entities[i]);
+		}
+	}
+}
@@ -0,0 +1,130 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "SweepAndPruneBroadphase.hpp"
+#include <algorithm>
+
+namespace GLVM::ecs
+{
+	void CSweepAndPruneBroadphase::UpdateProxy(Entity entity, const BroadphaseBox& box, const vec3& /*displacement*/) {
+		unsigned int entityIndex = GetEntityIndex(entity);
+		while ( proxies.GetSize() <= entityIndex )
+			proxies.Push(Proxy());
+
+		Proxy& proxy = proxies[entityIndex];
+		if ( !proxy.used ) {
+			proxy.used = true;
+			insertedEndpoints.Push(Endpoint{ box.min[axis], entityIndex << 1 });
+			insertedEndpoints.Push(Endpoint{ box.max[axis], (entityIndex << 1) | 1u });
+		}
+
+		proxy.box    = box;
+		proxy.entity = entity;                                           ///< Index may be reused by new entity.
+		proxy.frame  = frame;
+	}
+
+	void CSweepAndPruneBroadphase::EndUpdate() {
+		RemoveStaleProxies();
+		SortEndpoints();
+		Sweep();
+	}
+
+	/// Entity removed or lost collider since last update, its endpoints dropped keeping order of others.
+	void CSweepAndPruneBroadphase::RemoveStaleProxies() {
+		bool removed = false;
+		for ( unsigned int i = 0; i < proxies.GetSize(); ++i ) {
+			if ( proxies[i].used && proxies[i].frame != frame ) {
+				proxies[i].used = false;
+				removed = true;
+			}
+		}
+
+		if ( !removed )
+			return;
+
+		unsigned int kept = 0;
+		for ( unsigned int i = 0; i < endpoints.GetSize(); ++i ) {
+			if ( proxies[endpoints[i].data >> 1].used )
+				endpoints[kept++] = endpoints[i];
+		}
+		endpoints.Resize(kept);
+	}
+
+	void CSweepAndPruneBroadphase::SortEndpoints() {
+		for ( unsigned int i = 0; i < endpoints.GetSize(); ++i ) {
+			const BroadphaseBox& box = proxies[endpoints[i].data >> 1].box;
+			endpoints[i].value = (endpoints[i].data & 1u) ? box.max[axis] : box.min[axis];
+		}
+
+		/// Coherent movement leaves only few endpoints out of order, each moves few steps back.
+		for ( unsigned int i = 1; i < endpoints.GetSize(); ++i ) {
+			Endpoint endpoint = endpoints[i];
+			unsigned int j = i;
+			while ( j > 0 && Less(endpoint, endpoints[j - 1]) ) {
+				endpoints[j] = endpoints[j - 1];
+				--j;
+			}
+			endpoints[j] = endpoint;
+		}
+
+		if ( insertedEndpoints.GetSize() == 0 )
+			return;
+
+		unsigned int oldSize = endpoints.GetSize();
+		std::sort(insertedEndpoints.GetVectorContainer(),
+				  insertedEndpoints.GetVectorContainer() + insertedEndpoints.GetSize(), Less);
+		for ( unsigned int i = 0; i < insertedEndpoints.GetSize(); ++i )
+			endpoints.Push(insertedEndpoints[i]);
+		std::inplace_merge(endpoints.GetVectorContainer(), endpoints.GetVectorContainer() + oldSize,
+						   endpoints.GetVectorContainer() + endpoints.GetSize(), Less);
+		insertedEndpoints.clear();
+	}
+
+	void CSweepAndPruneBroadphase::Sweep() {
+		currentPairs.clear();
+		activeProxies.clear();
+		for ( unsigned int i = 0; i < endpoints.GetSize(); ++i ) {
+			unsigned int entityIndex = endpoints[i].data >> 1;
+			Proxy& proxy = proxies[entityIndex];
+
+			if ( endpoints[i].data & 1u ) {
+				unsigned int last = activeProxies[activeProxies.GetSize() - 1];
+				proxies[last].activeIndex = proxy.activeIndex;
+				activeProxies.SwapRemove(proxy.activeIndex);
+				continue;
+			}
+
+			for ( unsigned int j = 0; j < activeProxies.GetSize(); ++j ) {
+				const Proxy& other = proxies[activeProxies[j]];
+				if ( BoxOverlap(proxy.box, other.box) ) {
+					currentPairs.Push(proxy.entity < other.entity ? BroadphasePair{ proxy.entity, other.entity } :
+									  BroadphasePair{ other.entity, proxy.entity });
+				}
+			}
+
+			proxy.activeIndex = activeProxies.GetSize();
+			activeProxies.Push(entityIndex);
+		}
+	}
+
+	void CSweepAndPruneBroadphase::CollectPairs(core::vector<BroadphasePair>& pairs) const {
+		for ( unsigned int i = 0; i < currentPairs.GetSize(); ++i )
+			pairs.Push(currentPairs[i]);
+	}
+
+	/// Only boxes that start before far end of segment on sweep axis are tested.
+	void CSweepAndPruneBroadphase::QueryRay(const vec3& origin, const vec3& ray, core::vector<Entity>& entities) const {
+		float segmentMax = Max(origin[axis], origin[axis] + ray[axis]);
+		vec3 inverseRay(1.0f / ray[0], 1.0f / ray[1], 1.0f / ray[2]);
+		for ( unsigned int i = 0; i < endpoints.GetSize() && endpoints[i].value <= segmentMax; ++i ) {
+			if ( endpoints[i].data & 1u )
+				continue;
+
+			const Proxy& proxy = proxies[endpoints[i].data >> 1];
+			if ( RayOverlap(proxy.box, origin, inverseRay) )
+				entities.Push(proxy.entity);
+		}
+	}
+}
@@ -34,9 +34,57 @@ namespace GLVM::ecs
         ++s_iSystem_ID;
     }
 
+    unsigned int CSystemManager::BuildSchedule()
+    {
+		systemStages.Resize(s_iSystem_ID);
+		unsigned int stagesNumber = 0;
+		for ( unsigned int i = 0; i < s_iSystem_ID; ++i ) {
+			unsigned int stage = 0;
+			for ( unsigned int j = 0; j < i; ++j ) {
+				if ( tSystemContainer[i]->ConflictsWith(*tSystemContainer[j]) && systemStages[j] + 1 > stage )
+					stage = systemStages[j] + 1;
+			}
+
+			systemStages[i] = stage;
+			if ( stage + 1 > stagesNumber )
+				stagesNumber = stage + 1;
+		}
+
+		return stagesNumber;
+    }
+
     void CSystemManager::Update()
     {
-        for(unsigned int i = 0; i < s_iSystem_ID; ++i)
-            tSystemContainer[i]->Update();
+		ComponentManager* componentManager = ComponentManager::GetInstance();
+		EntityManager* entityManager = EntityManager::GetInstance();
+		unsigned int stagesNumber = BuildSchedule();
+		core::vector<ISystem*> stageSystems;
+		for ( unsigned int stage = 0; stage < stagesNumber; ++stage ) {
+			stageSystems.clear();
+			for ( unsigned int i = 0; i < s_iSystem_ID; ++i ) {
+				if ( systemStages[i] == stage )
+					stageSystems.Push(tSystemContainer[i]);
+			}
+
+			if ( serialExecution ) {
+				for ( unsigned int j = 0; j < stageSystems.GetSize(); ++j )
+					stageSystems[j]->Update();
+			} else {
+				core::CJobSystem* jobSystem = core::CJobSystem::GetInstance();
+				std::vector<core::JobHandle> jobs;                     ///< First system of stage runs on calling thread.
+				for ( unsigned int j = 1; j < stageSystems.GetSize(); ++j ) {
+					ISystem* system = stageSystems[j];
+					jobs.push_back(jobSystem->Schedule([system]() { system->Update(); }));
+				}
+
+				stageSystems[0]->Update();
+				for ( unsigned int k = 0; k < jobs.size(); ++k )
+					jobSystem->Wait(jobs[k]);
+			}
+
+			/// Sync point: nobody iterates tables now, so structural changes of stage applied here in both modes.
+			for ( unsigned int n = 0; n < stageSystems.GetSize(); ++n )
+				stageSystems[n]->commandBuffer.Playback(componentManager, entityManager);
+		}
     }
 }
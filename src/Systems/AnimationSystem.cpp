@@ -0,0 +1,251 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "Systems/AnimationSystem.hpp"
+#include "ComponentManager.hpp"
+#include "EntityManager.hpp"
+#include "JobSystem.hpp"
+#include "Components/TransformComponent.hpp"
+#include "Components/ViewComponent.hpp"
+#include <cmath>
+#include <iostream>
+
+namespace GLVM::ecs
+{
+	CAnimationSystem::CAnimationSystem() : poseCache(POSE_CACHE_CAPACITY, PALETTE_JOINTS_NUMBER) {
+		DeclareRead<components::mesh, components::transform, components::beholder>();
+		DeclareWrite<components::animation>();
+	}
+
+	void CAnimationSystem::SetSkeleton(unsigned int meshID, core::CSkeletalAnimation&& skeleton) {
+		if ( skeleton.GetJointsNumber() > PALETTE_JOINTS_NUMBER )    ///< Called once when mesh loaded, so logged once per skin.
+			std::cout << "Skin of mesh " << meshID << " has " << skeleton.GetJointsNumber() << " joints, only first "
+					  << PALETTE_JOINTS_NUMBER << " of them fit palette of shaders" << std::endl;
+
+		while ( skeletons.GetSize() <= meshID )
+			skeletons.EmplaceBack();
+
+		skeletons[meshID] = std::move(skeleton);
+
+		/// Cached poses of old skeleton dropped, no entity keeps pose of earlier frame after that.
+		poseCache.Clear();
+		for ( unsigned int i = 0; i < paletteFrames.GetSize(); ++i )
+			paletteFrames[i] = 0;
+	}
+
+	const mat4* CAnimationSystem::GetPalette(Entity entity) const {
+		unsigned int entityIndex = GetEntityIndex(entity);
+		if ( entityIndex >= paletteFrames.GetSize() || paletteFrames[entityIndex] != frame || frame == 0 ||
+			 paletteEntities[entityIndex] != entity )
+			return nullptr;
+
+		if ( paletteSlots[entityIndex] >= 0 )
+			return poseCache.GetPalette(paletteSlots[entityIndex]);
+
+		return &palettes[entityIndex * PALETTE_JOINTS_NUMBER];
+	}
+
+	/// Rows of chunk share archetype, so chunk that already has animation component is skipped whole.
+	void CAnimationSystem::AttachAnimations() {
+		namespace cm = GLVM::ecs::components;
+
+		ComponentManager* componentManager = ComponentManager::GetInstance();
+		componentManager->forEachChunk<const cm::mesh>(
+			[this, componentManager](unsigned int count, Entity* entities, const cm::mesh* meshComponents) {
+				if ( count == 0 || componentManager->multiCheckAvailability<cm::animation>(entities[0]) )
+					return;
+
+				for ( unsigned int i = 0; i < count; ++i )
+					if ( IsAnimated(meshComponents[i].handle.id) )
+						commandBuffer.AddComponent<cm::animation>(entities[i]);
+			});
+
+		commandBuffer.Playback(componentManager, EntityManager::GetInstance());
+	}
+
+	bool CAnimationSystem::FindBeholder(vec3& position) const {
+		namespace cm = GLVM::ecs::components;
+
+		bool found = false;
+		ComponentManager::GetInstance()->forEachChunk<const cm::beholder, const cm::transform>(
+			[&found, &position](unsigned int count, [[maybe_unused]] Entity* entities, [[maybe_unused]] const cm::beholder* beholderComponents,
+								const cm::transform* transformComponents) {
+				if ( found || count == 0 )
+					return;
+
+				position = transformComponents[0].tPosition;
+				found = true;
+			});
+
+		return found;
+	}
+
+	/// Pose taken from cache if other entity already asked for it in this or earlier frame.
+	void CAnimationSystem::RequestPose(unsigned int skeleton, float time, unsigned int entityIndex) {
+		if ( poseSampleRate > 0.0f ) {
+			float step = std::floor(time * poseSampleRate);
+			std::uint64_t key = (static_cast<std::uint64_t>(skeleton) << 32) | static_cast<std::uint32_t>(static_cast<int>(step));
+			unsigned int slot;
+			core::EPoseCacheResult result = poseCache.Acquire(key, frame, slot);
+			if ( result != core::ePOSE_CACHE_FULL ) {
+				paletteSlots[entityIndex] = slot;
+				if ( result == core::ePOSE_CACHE_HIT ) {
+					++frameStats.cacheHits;
+					return;
+				}
+
+				++frameStats.cacheMisses;
+				if ( result == core::ePOSE_CACHE_EVICTED )
+					++frameStats.cacheEvictions;
+
+				requestSkeletons.Push(skeleton);
+				requestTimes.Push(step / poseSampleRate);
+				requestPalettes.Push(poseCache.GetPalette(slot));
+				return;
+			}
+
+			++frameStats.cacheMisses;
+		}
+
+		paletteSlots[entityIndex] = -1;
+		requestSkeletons.Push(skeleton);
+		requestTimes.Push(time);
+		requestPalettes.Push(&palettes[entityIndex * PALETTE_JOINTS_NUMBER]);
+	}
+
+	/// Advance clip time and request pose of every animated entity that is not decimated in this frame.
+	void CAnimationSystem::CollectPoses() {
+		namespace cm = GLVM::ecs::components;
+
+		instanceSkeletons.clear();
+		instanceEntities.clear();
+		instanceTimes.clear();
+		requestSkeletons.clear();
+		requestTimes.clear();
+		requestPalettes.clear();
+
+		vec3 beholderPosition{ 0.0f, 0.0f, 0.0f };
+		bool decimation = decimationDistance > 0.0f && decimationInterval > 1 && FindBeholder(beholderPosition);
+		float decimationDistanceSquared = decimationDistance * decimationDistance;
+
+		float delta = deltaFrameTime;
+		ComponentManager::GetInstance()->forEachChunk<cm::animation, const cm::mesh, const cm::transform>(
+			[&, this](unsigned int count, Entity* entities, cm::animation* animationComponents, const cm::mesh* meshComponents,
+					  const cm::transform* transformComponents) {
+				for ( unsigned int i = 0; i < count; ++i ) {
+					unsigned int meshID = meshComponents[i].handle.id;
+					if ( !IsAnimated(meshID) )
+						continue;
+
+					cm::animation& animationComponent = animationComponents[i];
+					animationComponent.time += delta * animationComponent.speed;
+					float duration = skeletons[meshID].GetDuration();
+					if ( duration > 0.0f && (animationComponent.time >= duration || animationComponent.time < 0.0f) ) {
+						animationComponent.time = std::fmod(animationComponent.time, duration);
+						if ( animationComponent.time < 0.0f )
+							animationComponent.time += duration;
+					}
+
+					unsigned int entityIndex = GetEntityIndex(entities[i]);
+					if ( paletteEntities[entityIndex] != entities[i] ) {    ///< Index recycled, pose and slot of old owner dropped.
+						paletteEntities[entityIndex] = entities[i];
+						paletteFrames[entityIndex] = 0;
+						paletteSlots[entityIndex] = -1;
+					}
+
+					bool hadPose = paletteFrames[entityIndex] != 0 && paletteFrames[entityIndex] + 1 == frame;
+					paletteFrames[entityIndex] = frame;
+					++frameStats.animatedEntities;
+
+					if ( decimation && hadPose && (frame + entityIndex) % decimationInterval != 0 ) {
+						float distanceSquared = 0.0f;
+						for ( unsigned int axis = 0; axis < 3; ++axis ) {
+							float offset = transformComponents[i].tPosition[axis] - beholderPosition[axis];
+							distanceSquared += offset * offset;
+						}
+
+						if ( distanceSquared > decimationDistanceSquared ) {
+							if ( paletteSlots[entityIndex] >= 0 )
+								poseCache.Touch(paletteSlots[entityIndex], frame);    ///< Shared palette kept alive while entity shows it.
+
+							++frameStats.decimatedEntities;
+							continue;
+						}
+					}
+
+					instanceSkeletons.Push(meshID);
+					instanceEntities.Push(entityIndex);
+					instanceTimes.Push(animationComponent.time);
+				}
+			});
+
+		/// Slots of decimated entities touched already, so cache never evicts palette somebody still shows.
+		for ( unsigned int i = 0; i < instanceSkeletons.GetSize(); ++i )
+			RequestPose(instanceSkeletons[i], instanceTimes[i], instanceEntities[i]);
+	}
+
+	/// Counting sort of requested poses by skeleton, then every skeleton range cut into batches.
+	void CAnimationSystem::BuildBatches() {
+		unsigned int requestsNumber = requestSkeletons.GetSize();
+		unsigned int skeletonsNumber = skeletons.GetSize();
+
+		skeletonOffsets.clear();
+		skeletonOffsets.Resize(skeletonsNumber + 1);
+		for ( unsigned int i = 0; i < requestsNumber; ++i )
+			++skeletonOffsets[requestSkeletons[i] + 1];
+		for ( unsigned int s = 0; s < skeletonsNumber; ++s )
+			skeletonOffsets[s + 1] += skeletonOffsets[s];
+
+		batches.clear();
+		for ( unsigned int s = 0; s < skeletonsNumber; ++s )
+			for ( unsigned int first = skeletonOffsets[s]; first < skeletonOffsets[s + 1]; first += core::MAX_POSE_BATCH ) {
+				unsigned int count = skeletonOffsets[s + 1] - first;
+				batches.Push({ s, first, count < core::MAX_POSE_BATCH ? count : core::MAX_POSE_BATCH });
+			}
+
+		batchTimes.Resize(requestsNumber);
+		batchPalettes.Resize(requestsNumber);
+		for ( unsigned int i = 0; i < requestsNumber; ++i ) {
+			unsigned int pose = skeletonOffsets[requestSkeletons[i]]++;
+			batchTimes[pose] = requestTimes[i];
+			batchPalettes[pose] = requestPalettes[i];
+		}
+	}
+
+	void CAnimationSystem::Update() {
+		AttachAnimations();
+		++frame;
+		frameStats = AnimationStats();
+
+		/// Storage grown before pointers into it are taken.
+		unsigned int entitiesNumber = ComponentManager::GetInstance()->entityLocations.GetSize();
+		if ( paletteFrames.GetSize() < entitiesNumber ) {
+			palettes.Resize(entitiesNumber * PALETTE_JOINTS_NUMBER);
+			paletteFrames.Resize(entitiesNumber);
+			paletteSlots.Resize(entitiesNumber);
+			paletteEntities.Resize(entitiesNumber);
+		}
+
+		CollectPoses();
+		BuildBatches();
+		frameStats.evaluatedPoses = batchTimes.GetSize();
+
+		core::CJobSystem::GetInstance()->ParallelFor(batches.GetSize(), ANIMATION_BATCHES_GRAIN,
+			[this](unsigned int begin, unsigned int end) {
+				for ( unsigned int i = begin; i < end; ++i ) {
+					const AnimationBatch& batch = batches[i];
+					skeletons[batch.skeleton].EvaluatePoses(&batchTimes[batch.first], &batchPalettes[batch.first],
+															batch.count, PALETTE_JOINTS_NUMBER);
+				}
+			});
+
+		totalStats.animatedEntities  += frameStats.animatedEntities;
+		totalStats.decimatedEntities += frameStats.decimatedEntities;
+		totalStats.cacheHits         += frameStats.cacheHits;
+		totalStats.cacheMisses       += frameStats.cacheMisses;
+		totalStats.cacheEvictions    += frameStats.cacheEvictions;
+		totalStats.evaluatedPoses    += frameStats.evaluatedPoses;
+	}
+}
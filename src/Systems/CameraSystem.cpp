@@ -10,6 +10,12 @@
 
 namespace GLVM::ecs
 {
+    CCameraSystem::CCameraSystem() {
+		DeclareRead<components::transform>();
+		DeclareWrite<components::beholder>();
+		DeclareExclusiveExecution();    ///< Write global input event.
+	}
+
     void CCameraSystem::Update()
     {
 		namespace cm = GLVM::ecs::components;
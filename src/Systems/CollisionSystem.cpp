@@ -16,6 +16,7 @@
 #include "Components/RigidBodyComponent.hpp"
 #include "Components/ViewComponent.hpp"
 #include "EventsStack.hpp"
+#include "BroadphaseFactory.hpp"
 #include "Vector.hpp"
 #include "VertexMath.hpp"
 
@@ -46,94 +47,77 @@ namespace GLVM::ecs
         return false;
     }
 
+	CCollisionSystem::CCollisionSystem(core::CStack& _input_Stack, EBroadphaseType broadphaseType) :
+		broadphase(CBroadphaseFactory().CreateBroadphase(broadphaseType)), Input_Stack_(_input_Stack) {
+		DeclareRead<components::transform, components::move>();
+		DeclareWrite<components::collider>();
+	}
+
+	CCollisionSystem::~CCollisionSystem() {
+		delete broadphase;
+	}
+
 	void CCollisionSystem::Update()
 	{
 		namespace cm = GLVM::ecs::components;
 		
         ComponentManager* componentManager = ComponentManager::GetInstance();
-		core::vector<Entity> linkedEntities = componentManager->collectLinkedEntities<cm::collider,
-																					  cm::transform>();
-		
-		core::vector<Entity> linkedEntitiesWithMove = componentManager->collectLinkedEntities<cm::collider,
-																					  cm::transform,
-																					  cm::move>();
-		
-        float cameraSpeed = 5.5f * fDelta_Time_;            
-		unsigned int linkedEntitiesVectorSize = linkedEntities.GetSize();
-		unsigned int linkedEntitiesVectorSizeWithMove = linkedEntitiesWithMove.GetSize();
-		for(unsigned int i = 0; i < linkedEntitiesVectorSize; ++i) {
-			unsigned int backtrackingEntityRefCollider = linkedEntities[i];  
-			componentManager->GetComponent<cm::collider>(backtrackingEntityRefCollider)->bGround_Collision_ = false;
-			for(unsigned int j = 0; j < linkedEntitiesVectorSize; ++j) {
-				if ( i == j )
-					continue;
-				
-                unsigned int comparedEntityRefCollider     = linkedEntities[j];
-				
-				vec3 backtrackingTransform = componentManager->
-					GetComponent<cm::transform>(backtrackingEntityRefCollider)->tPosition;
-				vec3 backtrackingTransformUpper = componentManager->
-					GetComponent<cm::transform>(backtrackingEntityRefCollider)->tPosition;
-				float backtrackingScale = componentManager->
-					GetComponent<cm::transform>(backtrackingEntityRefCollider)->fScale;
-				float backtrackingGltfFlag = componentManager->
-					GetComponent<cm::transform>(backtrackingEntityRefCollider)->gltf;
-			    vec3  comparedTransform     = componentManager->
-					GetComponent<cm::transform>(comparedEntityRefCollider)->tPosition;
-				vec3 comparedTransformUpper = componentManager->
-					GetComponent<cm::transform>(comparedEntityRefCollider)->tPosition;
-				float comparedScale     = componentManager->
-					GetComponent<cm::transform>(comparedEntityRefCollider)->fScale;
-				float comparedGltfFlag = componentManager->
-					GetComponent<cm::transform>(comparedEntityRefCollider)->gltf;
-				for ( unsigned int m = 0; m < linkedEntitiesVectorSizeWithMove; ++m) {
-					if ( backtrackingEntityRefCollider == linkedEntitiesWithMove[m] ) {
-						cm::move* backtrackingMove = componentManager->
-							GetComponent<cm::move>(backtrackingEntityRefCollider);
-						backtrackingTransform += Normalize(backtrackingMove->frameMovement) * cameraSpeed;
-						backtrackingTransform += backtrackingMove->gravity;
-					}
-				}
-				for ( unsigned int n = 0; n < linkedEntitiesVectorSizeWithMove; ++n) {
-					if ( comparedEntityRefCollider == linkedEntitiesWithMove[n] ) {
-						cm::move* comparedMove     = componentManager->
-							GetComponent<cm::move>(comparedEntityRefCollider);
-						comparedTransform += Normalize(comparedMove->frameMovement) * cameraSpeed;
-						comparedTransform += comparedMove->gravity;
+        float cameraSpeed = 5.5f * fDelta_Time_;
+
+		/// Predicted position of body used for box test and current one for check of upper actor.
+		bodies.clear();
+		broadphase->BeginUpdate();
+		componentManager->forEachChunk<cm::collider, const cm::transform>(
+			[&](unsigned int count, Entity* entities, cm::collider* colliderComponents, const cm::transform* transformComponents) {
+				for ( unsigned int i = 0; i < count; ++i ) {
+					const cm::transform& transform = transformComponents[i];
+					CollisionBody body;
+					body.collider = &colliderComponents[i];
+					body.position = transform.tPosition;
+					body.predictedPosition = transform.tPosition;
+					body.scale = transform.gltf ? transform.fScale : transform.fScale / 2;
+
+					const cm::move* move = componentManager->GetComponent<const cm::move>(entities[i]);
+					if ( move != nullptr ) {
+						body.predictedPosition += Normalize(move->frameMovement) * cameraSpeed;
+						body.predictedPosition += move->gravity;
 					}
-				}
 
-				if ( !backtrackingGltfFlag ) {
-					backtrackingScale /= 2;
-				}
+					body.collider->bGround_Collision_ = false;
+					bodies.Push(body);
 
-				if ( !comparedGltfFlag ) {
-					comparedScale /= 2;
-				}
-				
-				bool boxColliderFlag;
-				bool upperActorCheckFlag = false;
-                boxColliderFlag = BoxCollider(backtrackingTransform,
-											  comparedTransform,
-											  backtrackingScale,
-											  comparedScale);
-				if ( boxColliderFlag ) {
-					upperActorCheckFlag = UpperActorCheck(backtrackingTransformUpper,
-														  comparedTransformUpper,
-														  backtrackingScale,
-														  comparedScale);
+					unsigned int entityIndex = GetEntityIndex(entities[i]);
+					while ( bodyIndices.GetSize() <= entityIndex )
+						bodyIndices.Push(0);
+					bodyIndices[entityIndex] = bodies.GetSize() - 1;
+
+					vec3 extent(body.scale, body.scale, body.scale);
+					broadphase->UpdateProxy(entities[i],
+											BroadphaseBox{ body.predictedPosition - extent, body.predictedPosition + extent },
+											body.predictedPosition - body.position);
 				}
-				
-				if(upperActorCheckFlag && boxColliderFlag) {
-                    componentManager->GetComponent<cm::collider>(backtrackingEntityRefCollider)->bGround_Collision_ = true;
-                    continue;
-                }
-                    
-                if(boxColliderFlag) {
-                    componentManager->GetComponent<cm::collider>(backtrackingEntityRefCollider)->bWall_Collision_ = true;
-                    continue;
-                }
-			}
+			});
+		broadphase->EndUpdate();
+
+		pairs.clear();
+		broadphase->CollectPairs(pairs);
+
+		/// Box test is symmetric, but check of upper actor is not, so every pair resolved for both bodies.
+		for ( unsigned int i = 0; i < pairs.GetSize(); ++i ) {
+			CollisionBody& first = bodies[bodyIndices[GetEntityIndex(pairs[i].first)]];
+			CollisionBody& second = bodies[bodyIndices[GetEntityIndex(pairs[i].second)]];
+			if ( !BoxCollider(first.predictedPosition, second.predictedPosition, first.scale, second.scale) )
+				continue;
+
+			if ( UpperActorCheck(first.position, second.position, first.scale, second.scale) )
+				first.collider->bGround_Collision_ = true;
+			else
+				first.collider->bWall_Collision_ = true;
+
+			if ( UpperActorCheck(second.position, first.position, second.scale, first.scale) )
+				second.collider->bGround_Collision_ = true;
+			else
+				second.collider->bWall_Collision_ = true;
 		}
 	}
 
@@ -12,6 +12,7 @@ namespace GLVM::ecs
 	CGUISystem::CGUISystem() {
 		_Shader_Program = new Shader("../GLshaders/GUI.vert", "../GLshaders/GUI.frag");
 		debugLines      = new Shader("../GLshaders/debugLines.vert", "../GLshaders/debugLines.frag");
+		DeclareExclusiveExecution();    ///< OpenGL calls must stay on thread that owns context.
 	}
 	
     void CGUISystem::Update()
@@ -0,0 +1,35 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "Systems/InterpolationSystem.hpp"
+#include "ComponentManager.hpp"
+#include "Components/TransformComponent.hpp"
+
+namespace GLVM::ecs
+{
+	CInterpolationSystem::CInterpolationSystem() {
+		DeclareWrite<components::transform>();
+	}
+
+	/// Only transforms that moved since last step are written, so chunks of static ones stay unchanged for renderer cache.
+	void CInterpolationSystem::Update() {
+		namespace cm = GLVM::ecs::components;
+
+		ComponentManager* componentManager = ComponentManager::GetInstance();
+		componentManager->parallelForEachChunk<const cm::transform>(
+			[componentManager](unsigned int count, Entity* entities, const cm::transform* transformComponents) {
+				for ( unsigned int i = 0; i < count; ++i ) {
+					if ( transformComponents[i].previousValid && !cm::IsInterpolated(transformComponents[i]) )
+						continue;
+
+					cm::transform* transformComponent = componentManager->GetComponent<cm::transform>(entities[i]);    ///< Row of the same chunk, so no other chunk job touch it.
+					transformComponent->previousPosition = transformComponent->tPosition;
+					transformComponent->previousYaw      = transformComponent->yaw;
+					transformComponent->previousPitch    = transformComponent->pitch;
+					transformComponent->previousValid    = true;
+				}
+			});
+	}
+}
@@ -18,9 +18,9 @@
 #include "Components/VertexComponent.hpp"
 #include "Components/ProjectileComponent.hpp"
 #include "Components/ViewComponent.hpp"
-#include "Engine.hpp"
 #include "EntityManager.hpp"
 #include "Event.hpp"
+#include "Globals.hpp"
 #include "ISoundEngine.hpp"
 #include "Vector.hpp"
 #include "VertexMath.hpp"
@@ -29,7 +29,11 @@
 namespace GLVM::ecs
 {
     CMovementSystem::CMovementSystem(core::CStack& inputStack) :
-        inputStack(inputStack) {}
+        inputStack(inputStack) {
+		namespace cm = GLVM::ecs::components;
+		DeclareRead<cm::controller, cm::collider>();
+		DeclareWrite<cm::beholder, cm::transform, cm::move, cm::rigidBody>();
+	}
         
     void CMovementSystem::Update()
     {
@@ -46,9 +50,14 @@ namespace GLVM::ecs
 			// std::cout << "i: " << i << std::endl;
 			// std::cout << "size: " << linkedEntitiesVectorSize << std::endl;
 			Entity currentEntity                = linkedEntities[i];
-			cm::beholder* beholderComponent     = componentManager->GetComponent<cm::beholder>(currentEntity);
 //			cm::transform* transformComponent   = componentManager->GetComponent<cm::transform>(currentEntity);
 //			vec3 result = { 0.0f, 0.0f, 0.0f };
+			cm::beholder* beholderComponent     = componentManager->GetComponent<cm::beholder>(currentEntity);
+			cm::move* moveComponent             = componentManager->GetComponent<cm::move>(currentEntity);
+			if ( moveComponent == nullptr ) {
+				commandBuffer.AddComponent<cm::move>(currentEntity);    ///< Move component created once on sync point, input applied from next frame.
+				continue;
+			}
 			
             for(int n = 0; n < 6; ++n) {
 				vec3 right;
@@ -57,30 +66,22 @@ namespace GLVM::ecs
                 {
                 case core::EEvents::eMOVE_LEFT:
 					right = CalculateVectorRL(*beholderComponent);
-					componentManager->CreateComponent<cm::move>(currentEntity);
-					componentManager->GetComponent<cm::move>(currentEntity)->frameMovement -=
-						right * cameraSpeed;
+					moveComponent->frameMovement -= right * cameraSpeed;
 //					result -= right * cameraSpeed;
                     break;
                 case core::EEvents::eMOVE_RIGHT:
 					right = CalculateVectorRL(*beholderComponent);
-					componentManager->CreateComponent<cm::move>(currentEntity);
-					componentManager->GetComponent<cm::move>(currentEntity)->frameMovement +=
-						right * cameraSpeed;
+					moveComponent->frameMovement += right * cameraSpeed;
 //					result += right * cameraSpeed;
                     break;
                 case core::EEvents::eMOVE_BACKWARD:
                     forward = CalculateVectorFB(*beholderComponent, g_eEvent);
-					componentManager->CreateComponent<cm::move>(currentEntity);
-					componentManager->GetComponent<cm::move>(currentEntity)->frameMovement -=
-						forward * cameraSpeed;
+					moveComponent->frameMovement -= forward * cameraSpeed;
 //					result -= forward * cameraSpeed;
                     break;
                 case core::EEvents::eMOVE_FORWARD:
 					forward = CalculateVectorFB(*beholderComponent, g_eEvent);
-					componentManager->CreateComponent<cm::move>(currentEntity);
-					componentManager->GetComponent<cm::move>(currentEntity)->frameMovement +=
-						forward * cameraSpeed;
+					moveComponent->frameMovement += forward * cameraSpeed;
 //					result += forward * cameraSpeed;
                     break;
                 case core::EEvents::eJUMP:
@@ -108,22 +109,25 @@ namespace GLVM::ecs
             }
         }
 		// FIXME: NO NEED TO HAVE SPECIAL FIELD FOR GRAVITY FRAME MOVEMENT
-        for(unsigned int n = 0; n < componentManager->GetEntityContainer<cm::rigidBody>()->GetSize(); ++n) {
-//            int iEntity_refRigidBody = (*ecs::GetEntityContainer<ecs::rigidBody>(*pComponent_Manager))[n];
-			int iEntity_refRigidBody = (*componentManager->GetEntityContainer<cm::rigidBody>())[n];
-//            ecs::transform& rTransform_Component = pComponent_Manager->GetComponent<ecs::transform>(iEntity_refRigidBody);
-			cm::transform* rTransform_Component = componentManager->GetComponent<cm::transform>(iEntity_refRigidBody);
-			cm::rigidBody* rigidBodyComponennt = componentManager->GetComponent<cm::rigidBody>(iEntity_refRigidBody);
-			componentManager->CreateComponent<cm::move>(iEntity_refRigidBody);
-			cm::move* moveComponent = componentManager->GetComponent<cm::move>(iEntity_refRigidBody);
-			rTransform_Component->GravityAccumulator += deltaFrameTime;
-			float gravity = 9.8f * rTransform_Component->GravityAccumulator
-				* rigidBodyComponennt->fMass_ * 0.0005;
-			if ( gravity > 0.2f )
-				gravity = 0.2;
+		core::vector<Entity> rigidBodyEntities = componentManager->collectLinkedEntities<cm::rigidBody>();
+        for(unsigned int n = 0; n < rigidBodyEntities.GetSize(); ++n) {
+			if ( !componentManager->multiCheckAvailability<cm::move>(rigidBodyEntities[n]) )
+				commandBuffer.AddComponent<cm::move>(rigidBodyEntities[n]);
+		}
 
-			moveComponent->gravity[1] -= gravity;
-        }
+		componentManager->parallelForEachChunk<cm::rigidBody, cm::transform, cm::move>(
+			[this](unsigned int count, [[maybe_unused]] Entity* entities, cm::rigidBody* rigidBodyComponents,
+				   cm::transform* transformComponents, cm::move* moveComponents) {
+				for ( unsigned int n = 0; n < count; ++n ) {
+					transformComponents[n].GravityAccumulator += deltaFrameTime;
+					float gravity = 9.8f * transformComponents[n].GravityAccumulator
+						* rigidBodyComponents[n].fMass_ * 0.0005;
+					if ( gravity > 0.2f )
+						gravity = 0.2;
+
+					moveComponents[n].gravity[1] -= gravity;
+				}
+			});
     }
 
     Vector<float, 3> CMovementSystem::CalculateVectorRL(components::beholder& beholder) {
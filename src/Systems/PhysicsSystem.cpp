@@ -27,39 +27,36 @@ namespace GLVM::ecs
 		namespace cm = GLVM::ecs::components;
 		
         ComponentManager* componentManager = ComponentManager::GetInstance();
-		core::vector<Entity> linkedEntities = componentManager->collectLinkedEntities<cm::collider,
-																					  cm::move,
-																					  cm::transform>();
-
 		float deltaTime = 5.5f * fDelta_Time_;
-		unsigned int linkedEntitiesVectorSize = linkedEntities.GetSize();
-        for(unsigned int i = 0; i < linkedEntitiesVectorSize; ++i)
-        {
-                unsigned int entityRefMove = linkedEntities[i];
-				cm::transform* transformComponent = componentManager->GetComponent<cm::transform>(entityRefMove);
-				cm::move* move = componentManager->GetComponent<cm::move>(entityRefMove);
-				cm::collider* collider = componentManager->GetComponent<cm::collider>(entityRefMove);
-                if(collider->bGround_Collision_) {
-					move->gravity = 0;
-					transformComponent->GravityAccumulator = 0.0f;
-                }
-                if(collider->bWall_Collision_) {
-					move->frameMovement = 0;
-                    collider->bWall_Collision_ = false;
-                }
-				transformComponent->tPosition += move->frameMovement;
-				transformComponent->tPosition += move->gravity;
-				move->gravity       = 0.0f;
-				move->frameMovement = 0.0f;
-				componentManager->RemoveComponent<cm::move>(entityRefMove);
+		/// Move component stays on entity and only reset after applying, so update dont change tables.
+		componentManager->parallelForEachChunk<cm::collider, cm::move, cm::transform>(
+			[componentManager, deltaTime](unsigned int count, Entity* entities, cm::collider* colliderComponents,
+										  cm::move* moveComponents, cm::transform* transformComponents) {
+				for ( unsigned int i = 0; i < count; ++i ) {
+					cm::transform* transformComponent = &transformComponents[i];
+					cm::move* move = &moveComponents[i];
+					cm::collider* collider = &colliderComponents[i];
+					if(collider->bGround_Collision_) {
+						move->gravity = 0;
+						transformComponent->GravityAccumulator = 0.0f;
+					}
+					if(collider->bWall_Collision_) {
+						move->frameMovement = 0;
+						collider->bWall_Collision_ = false;
+					}
+					transformComponent->tPosition += move->frameMovement;
+					transformComponent->tPosition += move->gravity;
+					move->gravity       = 0.0f;
+					move->frameMovement = 0.0f;
 
-				cm::rigidBody* rigidBody = componentManager->GetComponent<cm::rigidBody>(entityRefMove);
-				if ( rigidBody->jumpAccumulator > 0.0f ) {
-					rigidBody->jumpAccumulator -= deltaTime;
-					rigidBody->jump = vec3{ 0.0f, 5.0f, 0.0f } * deltaTime;
-					transformComponent->tPosition += rigidBody->jump;
+					cm::rigidBody* rigidBody = componentManager->GetComponent<cm::rigidBody>(entities[i]);    ///< Row of the same entity, so no other chunk job touch it.
+					if ( rigidBody != nullptr && rigidBody->jumpAccumulator > 0.0f ) {
+						rigidBody->jumpAccumulator -= deltaTime;
+						rigidBody->jump = vec3{ 0.0f, 5.0f, 0.0f } * deltaTime;
+						transformComponent->tPosition += rigidBody->jump;
+					}
 				}
-        }
+			});
     }
 }
 
@@ -16,14 +16,18 @@
 namespace GLVM::ecs
 {
     CProjectileSystem::CProjectileSystem(core::CStack& inputStack) : inputStack (inputStack)
-    {}
+    {
+		namespace cm = GLVM::ecs::components;
+		DeclareRead<cm::controller, cm::collider>();
+		DeclareWrite<cm::beholder, cm::transform, cm::pointLight, cm::material, cm::mesh, cm::projectile>();
+		DeclareExclusiveExecution();    ///< Write global input event and sound container.
+	}
     
     void CProjectileSystem::Update()
     {
 		namespace cm = GLVM::ecs::components;
 		
         ComponentManager* pComponent_Manager = GLVM::ecs::ComponentManager::GetInstance();
-        EntityManager* pEntity_Manager       = GLVM::ecs::EntityManager::GetInstance();
     
         core::vector<unsigned int>* pEntity_Container_refMove =
 			pComponent_Manager->GetEntityContainer<cm::controller>();
@@ -83,7 +87,7 @@ namespace GLVM::ecs
             unsigned int uiEntity_refProjectile = linkedEntities[i];
             if(pComponent_Manager->GetComponent<cm::collider>(uiEntity_refProjectile)->bWall_Collision_ ||
                pComponent_Manager->GetComponent<cm::collider>(uiEntity_refProjectile)->bGround_Collision_) {
-                pEntity_Manager->RemoveEntity(uiEntity_refProjectile, pComponent_Manager);
+                commandBuffer.DestroyEntity(uiEntity_refProjectile);
             }
 //			std::cout << "Size: " << linkedEntities.GetSize() << std::endl;
 //			pComponent_Manager->GetEntityContainer<cm::projectile>()->Print();
@@ -99,10 +103,7 @@ namespace GLVM::ecs
 												components::beholder& beholder) {
 		namespace cm = GLVM::ecs::components;
 
-        unsigned int uiEntity_Projectile = ecs::EntityManager::GetInstance()->CreateEntity();
-        ecs::ComponentManager::GetInstance()->CreateComponent<cm::mesh, cm::collider,
-															  cm::transform, cm::material,
-															  cm::projectile, cm::pointLight>(uiEntity_Projectile);
+        unsigned int uiEntity_Projectile = commandBuffer.CreateEntity();
 
         core::Sound::CSoundSample* pSound_Sample = new core::Sound::CSoundSample();
         pSound_Sample->kPath_to_File_ = "../laser2.wav";
@@ -110,31 +111,37 @@ namespace GLVM::ecs
         pSound_Sample->uiRate_ = 22050;
         soundEngine->GetSoundContainer().Push(pSound_Sample);
 
-		ecs::components::MeshHandle meshHandle{};
+		cm::mesh meshProjectile{};
 		if ( meshHandlers.GetSize() > 0 )
-			meshHandle = meshHandlers[0];
-		componentManager->GetComponent<cm::mesh>(uiEntity_Projectile)->handle = meshHandle;
+			meshProjectile.handle = meshHandlers[0];
 		ecs::TextureHandle textureHandle{};
 		if ( textureHandlers.GetSize() > 0 )
 			textureHandle = textureHandlers[0];
-		cm::material* rTextureProjectile = componentManager->GetComponent<cm::material>(uiEntity_Projectile);
-		*rTextureProjectile = { .diffuseTextureID_ = textureHandle, .specularTextureID_ = textureHandle, .ambient = { 0.05f, 0.05f, 0.05f },
-		.shininess = 128.0f * 0.078125f };
-        cm::transform* rTransformProjectile = componentManager->GetComponent<cm::transform>(uiEntity_Projectile);
-        rTransformProjectile->fScale = 0.1f;
+		cm::material materialProjectile = { .diffuseTextureID_ = textureHandle, .specularTextureID_ = textureHandle,
+			.ambient = { 0.05f, 0.05f, 0.05f }, .shininess = 128.0f * 0.078125f };
+        cm::transform transformProjectile{};
+        transformProjectile.fScale = 0.1f;
 		
 		cm::transform* transform = componentManager->GetComponent<cm::transform>(entityRefMove);
 		if ( transform != nullptr )
-			rTransformProjectile->tPosition = transform->tPosition;
+			transformProjectile.tPosition = transform->tPosition;
 
-        rTransformProjectile->tForward   = GetDirectionVector(beholder);
-		rTransformProjectile->yaw        = fYaw;
-		rTransformProjectile->pitch      = fPitch;
-        rTransformProjectile->tPosition += rTransformProjectile->tForward * 2.0;
+        transformProjectile.tForward   = GetDirectionVector(beholder);
+		transformProjectile.yaw        = fYaw;
+		transformProjectile.pitch      = fPitch;
+        transformProjectile.tPosition += transformProjectile.tForward * 2.0;
 		
-		*(componentManager->GetComponent<cm::pointLight>(uiEntity_Projectile)) = { .position = rTransformProjectile->tPosition,
+		cm::pointLight pointLightProjectile = { .position = transformProjectile.tPosition,
 			.ambient = { 0.1f, 0.1f, 0.1f }, .diffuse = { 0.5f, 0.5f, 0.5f }, .specular = { 1.1f, 1.2f, 1.3f },
 			.constant = 1.4f, .linear = 0.1f, .quadratic = 0.128f };
+
+		/// Projectile appears in tables on sync point after this system.
+		commandBuffer.AddComponent(uiEntity_Projectile, std::move(meshProjectile));
+		commandBuffer.AddComponent<cm::collider>(uiEntity_Projectile);
+		commandBuffer.AddComponent(uiEntity_Projectile, std::move(transformProjectile));
+		commandBuffer.AddComponent(uiEntity_Projectile, std::move(materialProjectile));
+		commandBuffer.AddComponent<cm::projectile>(uiEntity_Projectile);
+		commandBuffer.AddComponent(uiEntity_Projectile, std::move(pointLightProjectile));
     }
 
     Vector<float, 3> CProjectileSystem::GetDirectionVector(components::beholder& beholder)
@@ -0,0 +1,172 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "Systems/TransformSystem.hpp"
+#include "ComponentManager.hpp"
+#include "EntityManager.hpp"
+#include "Query.hpp"
+#include <cassert>
+#include <cmath>
+
+namespace GLVM::ecs
+{
+	CTransformSystem::CTransformSystem() {
+		DeclareRead<components::transform, components::parent>();
+		DeclareWrite<components::worldTransform>();
+	}
+
+	mat4 CTransformSystem::ComputeLocalMatrix(const components::transform& transformComponent) {
+		mat4 rotationMatrix(1.0f);
+		mat4 scalingMatrix(1.0f);
+		mat4 translationMatrix(1.0f);
+
+		scalingMatrix[0][0] = transformComponent.fScale;
+		scalingMatrix[1][1] = transformComponent.fScale;
+		scalingMatrix[2][2] = transformComponent.fScale;
+
+		translationMatrix[3][0] = transformComponent.tPosition[0];
+		translationMatrix[3][1] = transformComponent.tPosition[1];
+		translationMatrix[3][2] = transformComponent.tPosition[2];
+
+		float sinPitch = std::sin(Radians(-transformComponent.pitch / 2));
+		float cosPitch = std::cos(Radians(-transformComponent.pitch / 2));
+		float sinYaw = std::sin(Radians(-(transformComponent.yaw) / 2));
+		float cosYaw = std::cos(Radians(-(transformComponent.yaw) / 2));
+
+		Quaternion pitchQuat{ cosPitch, 0.0f, 0.0f, sinPitch };
+		Quaternion yawQuat{ cosYaw, 0.0f, sinYaw, 0.0f };
+		rotationMatrix = rotateQuaternion<float, 4>(multiplyQuaternion(pitchQuat, yawQuat));
+
+		return scalingMatrix * rotationMatrix * translationMatrix;
+	}
+
+	/// Entities with transform but without world transform are found by chunk, all rows of chunk share archetype.
+	void CTransformSystem::AttachWorldTransforms() {
+		namespace cm = GLVM::ecs::components;
+
+		ComponentManager* componentManager = ComponentManager::GetInstance();
+		componentManager->forEachChunk<const cm::transform>(
+			[this, componentManager](unsigned int count, Entity* entities, [[maybe_unused]] const cm::transform* transformComponents) {
+				if ( count == 0 || componentManager->multiCheckAvailability<cm::worldTransform>(entities[0]) )
+					return;
+
+				for ( unsigned int i = 0; i < count; ++i )
+					commandBuffer.AddComponent<cm::worldTransform>(entities[i]);
+			});
+
+		commandBuffer.Playback(componentManager, EntityManager::GetInstance());
+	}
+
+	void CTransformSystem::Update() {
+		namespace cm = GLVM::ecs::components;
+
+		AttachWorldTransforms();
+
+		ComponentManager* componentManager = ComponentManager::GetInstance();
+		unsigned int sinceVersion = transformsVersion;
+		transformsVersion = componentManager->AdvanceChangeVersion();
+		matricesNumber.store(0, std::memory_order_relaxed);
+		++frame;
+
+		unsigned int entitiesNumber = componentManager->entityLocations.GetSize();
+		while ( updatedFrames.GetSize() < entitiesNumber ) {
+			updatedFrames.Push(0);
+			resolvedFrames.Push(0);
+		}
+
+		/// New and moved rows mark whole chunk changed, so reused entity index never keep old matrix.
+		unsigned int currentFrame = frame;
+		float alpha = interpolationAlpha;
+		componentManager->parallelForEachChunk<Changed<cm::transform>, cm::worldTransform>(
+			[this, currentFrame, alpha](unsigned int count, Entity* entities, const cm::transform* transformComponents,
+										cm::worldTransform* worldTransformComponents) {
+				for ( unsigned int i = 0; i < count; ++i ) {
+					worldTransformComponents[i].local = ComputeLocalMatrix(cm::InterpolateTransform(transformComponents[i], alpha));
+					worldTransformComponents[i].world = worldTransformComponents[i].local;
+					updatedFrames[GetEntityIndex(entities[i])] = currentFrame;
+				}
+				matricesNumber.fetch_add(count, std::memory_order_relaxed);
+			}, sinceVersion);
+
+		/*! Unchanged entities that moved on last simulation step still drawn between two states, so they follow alpha.
+		 *  Chunks walked read only, column taken for write only in chunk with such entity, so static chunks
+		 *  are not marked changed every frame.
+		 */
+		if ( updatedAlpha != interpolationAlpha ) {
+			updatedAlpha = interpolationAlpha;
+			componentManager->parallelForEachChunk<const cm::transform, const cm::worldTransform>(
+				[this, componentManager, currentFrame, alpha](unsigned int count, Entity* entities, const cm::transform* transformComponents,
+															  [[maybe_unused]] const cm::worldTransform* worldTransformComponents) {
+					cm::worldTransform* writtenComponents = nullptr;
+					unsigned int computed = 0;
+					for ( unsigned int i = 0; i < count; ++i ) {
+						unsigned int entityIndex = GetEntityIndex(entities[i]);
+						if ( updatedFrames[entityIndex] == currentFrame || !cm::IsInterpolated(transformComponents[i]) )
+							continue;
+
+						if ( writtenComponents == nullptr )                  ///< Row 0 of chunk, mutable access marks this chunk only.
+							writtenComponents = componentManager->GetComponent<cm::worldTransform>(entities[0]);
+
+						writtenComponents[i].local = ComputeLocalMatrix(cm::InterpolateTransform(transformComponents[i], alpha));
+						writtenComponents[i].world = writtenComponents[i].local;
+						updatedFrames[entityIndex] = currentFrame;
+						++computed;
+					}
+					matricesNumber.fetch_add(computed, std::memory_order_relaxed);
+				});
+		}
+
+		/// Reparented children keep local matrix, but world matrix must follow new parent.
+		componentManager->forEachChunk<Changed<cm::parent>, const cm::worldTransform>(
+			[this, currentFrame](unsigned int count, Entity* entities, [[maybe_unused]] const cm::parent* parentComponents,
+								 [[maybe_unused]] const cm::worldTransform* worldTransformComponents) {
+				for ( unsigned int i = 0; i < count; ++i )
+					updatedFrames[GetEntityIndex(entities[i])] = currentFrame;
+			}, sinceVersion);
+
+		/// Parents resolved before children whatever order of tables is.
+		componentManager->forEachChunk<const cm::parent, const cm::worldTransform>(
+			[this](unsigned int count, Entity* entities, [[maybe_unused]] const cm::parent* parentComponents,
+				   [[maybe_unused]] const cm::worldTransform* worldTransformComponents) {
+				for ( unsigned int i = 0; i < count; ++i )
+					ResolveChild(entities[i], 0);
+			});
+	}
+
+	/// Return true if world matrix of entity was recomputed in this update.
+	bool CTransformSystem::ResolveChild(Entity entity, unsigned int depth) {
+		namespace cm = GLVM::ecs::components;
+
+		ComponentManager* componentManager = ComponentManager::GetInstance();
+		unsigned int entityIndex = GetEntityIndex(entity);
+		if ( resolvedFrames[entityIndex] == frame || depth >= MAX_HIERARCHY_DEPTH )
+			return updatedFrames[entityIndex] == frame;
+
+		resolvedFrames[entityIndex] = frame;
+		const cm::parent* parentComponent = componentManager->GetComponent<const cm::parent>(entity);
+		if ( parentComponent == nullptr )
+			return updatedFrames[entityIndex] == frame;
+
+		Entity parentEntity = parentComponent->entity;
+		const cm::worldTransform* parentWorldTransform = nullptr;
+		if ( EntityManager::GetInstance()->IsAlive(parentEntity) && parentEntity != entity )
+			parentWorldTransform = componentManager->GetComponent<const cm::worldTransform>(parentEntity);
+
+		if ( parentWorldTransform == nullptr ) {                         ///< Parent removed, child stays where its local transform puts it.
+			cm::worldTransform* worldTransformComponent = componentManager->GetComponent<cm::worldTransform>(entity);
+			worldTransformComponent->world = worldTransformComponent->local;
+			return updatedFrames[entityIndex] == frame;
+		}
+
+		bool parentUpdated = ResolveChild(parentEntity, depth + 1);
+		if ( !parentUpdated && updatedFrames[entityIndex] != frame )
+			return false;
+
+		cm::worldTransform* worldTransformComponent = componentManager->GetComponent<cm::worldTransform>(entity);
+		worldTransformComponent->world = worldTransformComponent->local * parentWorldTransform->world;
+		updatedFrames[entityIndex] = frame;
+		return true;
+	}
+}
@@ -0,0 +1,351 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "Test.hpp"
+#include "ComponentManager.hpp"
+#include "EntityManager.hpp"
+#include "Components/TransformComponent.hpp"
+#include "Components/ViewComponent.hpp"
+#include "Systems/AnimationSystem.hpp"
+#include "PoseCache.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace ecs = GLVM::ecs;
+namespace cm = GLVM::ecs::components;
+namespace core = GLVM::core;
+namespace test = GLVM::test;
+
+namespace
+{
+	constexpr unsigned int BENCHMARK_FRAMES_NUMBER = 30;
+
+	constexpr unsigned int SCALING_ACTORS_NUMBERS[] = {40, 500, 5000};
+
+	/// One joint moved from x = 0 to x = distance during one second, so joint matrix shows time of clip.
+	core::CSkeletalAnimation MakeSkeleton(float distance = 1.0f) {
+		core::CSkeletalAnimation skeleton;
+		skeleton.AddJoint(mat4(1.0f), vec3(0.0f, 0.0f, 0.0f), Quaternion{ 1.0f, 0.0f, 0.0f, 0.0f }, vec3(1.0f, 1.0f, 1.0f));
+		core::AnimationSampler sampler;
+		sampler.times.Push(0.0f);
+		sampler.times.Push(1.0f);
+		for ( float value : { 0.0f, 0.0f, 0.0f, distance, 0.0f, 0.0f } )
+			sampler.values.Push(value);
+		skeleton.AddChannel(0, core::eTRANSLATION, std::move(sampler));
+		skeleton.BuildEvaluationOrder();
+
+		return skeleton;
+	}
+
+	/// Chain of joints, every joint turns around z axis during one second clip, like limbs of character.
+	core::CSkeletalAnimation MakeChainSkeleton(unsigned int jointsNumber, unsigned int keyframesNumber, float phase) {
+		core::CSkeletalAnimation skeleton;
+		for ( unsigned int joint = 0; joint < jointsNumber; ++joint ) {
+			skeleton.AddJoint(mat4(1.0f), vec3(0.0f, 1.0f, 0.0f), Quaternion{ 1.0f, 0.0f, 0.0f, 0.0f }, vec3(1.0f, 1.0f, 1.0f));
+			skeleton.SetParent(joint, static_cast<int>(joint) - 1);
+		}
+
+		for ( unsigned int joint = 0; joint < jointsNumber; ++joint ) {
+			core::AnimationSampler sampler;
+			for ( unsigned int keyframe = 0; keyframe < keyframesNumber; ++keyframe ) {
+				float time = static_cast<float>(keyframe) / (keyframesNumber - 1);
+				float halfAngle = 0.25f * std::sin(6.2831853f * time + phase + joint * 0.3f);
+				sampler.times.Push(time);
+				for ( float value : { 0.0f, 0.0f, std::sin(halfAngle), std::cos(halfAngle) } )
+					sampler.values.Push(value);
+			}
+			skeleton.AddChannel(joint, core::eROTATION, std::move(sampler));
+		}
+		skeleton.BuildEvaluationOrder();
+
+		return skeleton;
+	}
+
+	Entity CreateActor(float x, unsigned int meshID = 0) {
+		Entity entity = ecs::EntityManager::GetInstance()->CreateEntity();
+		ecs::ComponentManager* componentManager = ecs::ComponentManager::GetInstance();
+		componentManager->CreateComponent<cm::mesh, cm::transform>(entity);
+		componentManager->GetComponent<cm::mesh>(entity)->handle.id = meshID;
+		componentManager->GetComponent<cm::transform>(entity)->tPosition = { x, 0.0f, 0.0f };
+
+		return entity;
+	}
+
+	/*! Distant entity that got pose in last frame keeps it, new entity on recycled index of such
+	 *  entity must not: it has no pose yet and pose of old owner is not its own.
+	 */
+	void TestRecycledIndex() {
+		ecs::EntityManager* entityManager = ecs::EntityManager::GetInstance();
+		ecs::ComponentManager* componentManager = ecs::ComponentManager::GetInstance();
+		ecs::CAnimationSystem animationSystem;
+		GLVM_CHECK(animationSystem.poseSampleRate == 0.0f);             ///< Quantised poses are opt-in.
+		animationSystem.SetSkeleton(0, MakeSkeleton());
+		animationSystem.deltaFrameTime = 0.1f;
+		animationSystem.decimationDistance = 10.0f;
+		animationSystem.decimationInterval = 64;
+
+		Entity beholder = entityManager->CreateEntity();
+		componentManager->CreateComponent<cm::beholder, cm::transform>(beholder);
+		Entity first = CreateActor(100.0f);
+		std::vector<Entity> fillers;
+		for ( unsigned int i = 0; i < ecs::MINIMUM_FREE_ENTITY_SLOTS + 8; ++i )
+			fillers.push_back(entityManager->CreateEntity());
+
+		animationSystem.Update();
+		GLVM_CHECK(animationSystem.GetFrameStats().evaluatedPoses == 1);    ///< First pose never decimated.
+		GLVM_CHECK(animationSystem.GetFrameStats().cacheHits + animationSystem.GetFrameStats().cacheMisses == 0);
+		GLVM_CHECK(animationSystem.GetPalette(first) != nullptr);
+
+		/// Enough free slots, so head of free list, index of first entity, is reused.
+		entityManager->RemoveEntity(first, componentManager);
+		for ( unsigned int i = 0; i < fillers.size(); ++i )
+			entityManager->RemoveEntity(fillers[i], componentManager);
+		Entity second = CreateActor(100.0f);
+		componentManager->CreateComponent<cm::animation>(second);
+		componentManager->GetComponent<cm::animation>(second)->speed = 3.0f;
+		GLVM_CHECK(ecs::GetEntityIndex(second) == ecs::GetEntityIndex(first));
+
+		animationSystem.Update();
+		GLVM_CHECK(animationSystem.GetFrameStats().evaluatedPoses == 1);
+		GLVM_CHECK(animationSystem.GetFrameStats().decimatedEntities == 0);
+		GLVM_CHECK(animationSystem.GetPalette(first) == nullptr);
+		const mat4* palette = animationSystem.GetPalette(second);
+		GLVM_CHECK(palette != nullptr && std::fabs(palette[0][3][0] - 0.3f) < 1e-5f);
+
+		animationSystem.Update();
+		GLVM_CHECK(animationSystem.GetFrameStats().decimatedEntities == 1);    ///< Now it has own pose to keep.
+		palette = animationSystem.GetPalette(second);
+		GLVM_CHECK(palette != nullptr && std::fabs(palette[0][3][0] - 0.3f) < 1e-5f);
+
+		entityManager->RemoveEntity(second, componentManager);
+		entityManager->RemoveEntity(beholder, componentManager);
+	}
+
+	/// Slots of two keys: free slots first, then least recently used one, never slot touched in current frame.
+	void TestPoseCacheResults() {
+		core::CPoseCache cache(2, 1);
+		unsigned int firstSlot, secondSlot, slot;
+		GLVM_CHECK(cache.Acquire(10, 1, firstSlot) == core::ePOSE_CACHE_INSERTED);
+		GLVM_CHECK(cache.Acquire(10, 1, slot) == core::ePOSE_CACHE_HIT && slot == firstSlot);
+		GLVM_CHECK(cache.Acquire(20, 1, secondSlot) == core::ePOSE_CACHE_INSERTED && secondSlot != firstSlot);
+		GLVM_CHECK(cache.Acquire(30, 1, slot) == core::ePOSE_CACHE_FULL);    ///< Both slots shown in this frame.
+		GLVM_CHECK(cache.GetUsedSlotsNumber() == 2);
+
+		GLVM_CHECK(cache.Acquire(20, 2, slot) == core::ePOSE_CACHE_HIT && slot == secondSlot);
+		GLVM_CHECK(cache.Acquire(30, 2, slot) == core::ePOSE_CACHE_EVICTED && slot == firstSlot);    ///< Key 10 not touched since frame 1.
+		GLVM_CHECK(cache.Acquire(10, 2, slot) == core::ePOSE_CACHE_FULL);
+
+		cache.Touch(secondSlot, 3);                                      ///< Decimated entity still shows pose of key 20.
+		GLVM_CHECK(cache.Acquire(10, 3, slot) == core::ePOSE_CACHE_EVICTED && slot == firstSlot);
+		GLVM_CHECK(cache.Acquire(20, 3, slot) == core::ePOSE_CACHE_HIT && slot == secondSlot);
+		GLVM_CHECK(cache.Acquire(30, 3, slot) == core::ePOSE_CACHE_FULL);
+
+		cache.Clear();
+		GLVM_CHECK(cache.GetUsedSlotsNumber() == 0);
+		GLVM_CHECK(cache.Acquire(20, 4, slot) == core::ePOSE_CACHE_INSERTED);
+	}
+
+	/*! Random keys against plain least recently used list. Few keys and small table, so probe
+	 *  chains wrap around end of buckets and backward shift erase moves them.
+	 */
+	void TestPoseCacheAgainstList() {
+		constexpr unsigned int CAPACITY = 24;
+		core::CPoseCache cache(CAPACITY, 1);
+		test::CRandom random(19);
+		struct Entry { std::uint64_t key; unsigned int slot; unsigned int frame; };
+		std::vector<Entry> entries;                                      ///< Front is least recently used.
+		bool resultsMatch = true;
+		bool slotsMatch = true;
+		bool touchedKept = true;
+		for ( unsigned int frame = 1; frame <= 400; ++frame ) {
+			for ( unsigned int request = 0; request < 20; ++request ) {
+				std::uint64_t key = static_cast<std::uint64_t>(random.Next(0.0f, 48.0f)) * 0x100000001ull;
+				auto found = std::find_if(entries.begin(), entries.end(), [key](const Entry& entry) { return entry.key == key; });
+				core::EPoseCacheResult expected;
+				unsigned int expectedSlot = 0;
+				if ( found != entries.end() ) {
+					expected = core::ePOSE_CACHE_HIT;
+					expectedSlot = found->slot;
+					entries.erase(found);
+				} else if ( entries.size() < CAPACITY ) {
+					expected = core::ePOSE_CACHE_INSERTED;
+				} else if ( entries.front().frame == frame ) {
+					expected = core::ePOSE_CACHE_FULL;
+				} else {
+					expected = core::ePOSE_CACHE_EVICTED;
+					expectedSlot = entries.front().slot;
+					entries.erase(entries.begin());
+				}
+
+				unsigned int slot = CAPACITY;
+				core::EPoseCacheResult result = cache.Acquire(key, frame, slot);
+				resultsMatch = resultsMatch && result == expected;
+				if ( result == core::ePOSE_CACHE_HIT || result == core::ePOSE_CACHE_EVICTED )
+					slotsMatch = slotsMatch && slot == expectedSlot;
+				if ( expected != core::ePOSE_CACHE_FULL ) {
+					for ( const Entry& entry : entries )
+						touchedKept = touchedKept && !(entry.slot == slot && entry.frame == frame);
+					entries.push_back({ key, slot, frame });
+				}
+			}
+		}
+
+		GLVM_CHECK(resultsMatch);
+		GLVM_CHECK(slotsMatch);
+		GLVM_CHECK(touchedKept);
+	}
+
+	/// Entities at the same quantised time of the same clip get one palette, hit counters show it.
+	void TestSharedPalettes() {
+		ecs::EntityManager* entityManager = ecs::EntityManager::GetInstance();
+		ecs::ComponentManager* componentManager = ecs::ComponentManager::GetInstance();
+		ecs::CAnimationSystem animationSystem;
+		animationSystem.SetSkeleton(0, MakeSkeleton());
+		animationSystem.poseSampleRate = 10.0f;
+		animationSystem.deltaFrameTime = 0.12f;
+
+		Entity first = CreateActor(0.0f);
+		Entity second = CreateActor(5.0f);
+		Entity other = CreateActor(9.0f);
+		componentManager->CreateComponent<cm::animation>(other);
+		componentManager->GetComponent<cm::animation>(other)->time = 0.5f;
+		animationSystem.Update();
+
+		const ecs::AnimationStats& stats = animationSystem.GetFrameStats();
+		GLVM_CHECK(stats.animatedEntities == 3);
+		GLVM_CHECK(stats.cacheHits == 1);
+		GLVM_CHECK(stats.cacheMisses == 2);
+		GLVM_CHECK(stats.evaluatedPoses == 2);
+		GLVM_CHECK(animationSystem.GetPalette(first) == animationSystem.GetPalette(second));
+		GLVM_CHECK(animationSystem.GetPalette(first) != animationSystem.GetPalette(other));
+		GLVM_CHECK(std::fabs(animationSystem.GetPalette(first)[0][3][0] - 0.1f) < 1e-5f);    ///< Time 0.12 quantised to 0.1.
+
+		animationSystem.Update();                                        ///< Poses of all three already cached.
+		GLVM_CHECK(stats.cacheHits == 1 && stats.evaluatedPoses == 2);   ///< Time 0.24 and 0.62 are new steps.
+		animationSystem.deltaFrameTime = 0.01f;
+		animationSystem.Update();
+		GLVM_CHECK(stats.cacheHits == 3 && stats.cacheMisses == 0 && stats.evaluatedPoses == 0);
+		GLVM_CHECK(animationSystem.GetTotalStats().cacheHits == 5);
+		GLVM_CHECK(std::fabs(animationSystem.GetTotalStats().GetHitRate() - 5.0f / 9.0f) < 1e-6f);
+
+		entityManager->RemoveEntity(first, componentManager);
+		entityManager->RemoveEntity(second, componentManager);
+		entityManager->RemoveEntity(other, componentManager);
+	}
+
+	/*! Instances of one mesh use skeleton stored once for mesh: poses grouped into batches per skeleton,
+	 *  and skeleton replaced once changes pose of every instance.
+	 */
+	void TestSharedSkeleton() {
+		ecs::EntityManager* entityManager = ecs::EntityManager::GetInstance();
+		ecs::ComponentManager* componentManager = ecs::ComponentManager::GetInstance();
+		ecs::CAnimationSystem animationSystem;
+		animationSystem.SetSkeleton(0, MakeSkeleton());
+		animationSystem.SetSkeleton(1, MakeChainSkeleton(3, 5, 0.0f));
+		animationSystem.deltaFrameTime = 0.25f;
+
+		std::vector<Entity> actors;
+		for ( unsigned int i = 0; i < 40; ++i )                            ///< Like 40 instances of one character.
+			actors.push_back(CreateActor(static_cast<float>(i)));
+		std::vector<Entity> others;
+		for ( unsigned int i = 0; i < 10; ++i )
+			others.push_back(CreateActor(static_cast<float>(i), 1));
+
+		animationSystem.Update();
+		GLVM_CHECK(animationSystem.GetPosesNumber() == 50);
+		GLVM_CHECK(animationSystem.GetBatchesNumber() == (40 + core::MAX_POSE_BATCH - 1) / core::MAX_POSE_BATCH +
+				   (10 + core::MAX_POSE_BATCH - 1) / core::MAX_POSE_BATCH);
+		bool samePose = true;
+		for ( unsigned int i = 0; i < actors.size(); ++i )
+			samePose = samePose && std::fabs(animationSystem.GetPalette(actors[i])[0][3][0] - 0.25f) < 1e-5f;
+		GLVM_CHECK(samePose);
+
+		animationSystem.SetSkeleton(0, MakeSkeleton(2.0f));
+		animationSystem.Update();
+		bool replacedPose = true;
+		for ( unsigned int i = 0; i < actors.size(); ++i )
+			replacedPose = replacedPose && std::fabs(animationSystem.GetPalette(actors[i])[0][3][0] - 1.0f) < 1e-5f;
+		GLVM_CHECK(replacedPose);
+		bool otherPose = true;
+		for ( unsigned int i = 1; i < others.size(); ++i )
+			otherPose = otherPose && animationSystem.GetPalette(others[i])[2][3][0] == animationSystem.GetPalette(others[0])[2][3][0];
+		GLVM_CHECK(otherPose);
+
+		for ( unsigned int i = 0; i < actors.size(); ++i )
+			entityManager->RemoveEntity(actors[i], componentManager);
+		for ( unsigned int i = 0; i < others.size(); ++i )
+			entityManager->RemoveEntity(others[i], componentManager);
+	}
+
+	/// Frames of actorsNumber actors spread over clips, time per frame in milliseconds.
+	double MeasureAnimation(unsigned int actorsNumber, unsigned int clipsNumber, float poseSampleRate, ecs::AnimationStats& stats) {
+		ecs::EntityManager* entityManager = ecs::EntityManager::GetInstance();
+		ecs::ComponentManager* componentManager = ecs::ComponentManager::GetInstance();
+		ecs::CAnimationSystem animationSystem;
+		for ( unsigned int clip = 0; clip < clipsNumber; ++clip )
+			animationSystem.SetSkeleton(clip, MakeChainSkeleton(ecs::PALETTE_JOINTS_NUMBER, 31, clip * 1.7f));
+		animationSystem.poseSampleRate = poseSampleRate;
+		animationSystem.deltaFrameTime = 1.0f / 60.0f;
+
+		test::CRandom random(actorsNumber);
+		std::vector<Entity> actors;
+		for ( unsigned int i = 0; i < actorsNumber; ++i ) {
+			actors.push_back(CreateActor(static_cast<float>(i), i % clipsNumber));
+			componentManager->CreateComponent<cm::animation>(actors.back());
+			componentManager->GetComponent<cm::animation>(actors.back())->time = random.Next(0.0f, 1.0f);
+		}
+
+		animationSystem.Update();                                        ///< Components attached and storage grown before timing.
+		animationSystem.ResetTotalStats();
+		auto start = std::chrono::steady_clock::now();
+		for ( unsigned int frame = 0; frame < BENCHMARK_FRAMES_NUMBER; ++frame )
+			animationSystem.Update();
+		auto end = std::chrono::steady_clock::now();
+		stats = animationSystem.GetTotalStats();
+
+		for ( unsigned int i = 0; i < actors.size(); ++i )
+			entityManager->RemoveEntity(actors[i], componentManager);
+
+		return std::chrono::duration<double, std::milli>(end - start).count() / BENCHMARK_FRAMES_NUMBER;
+	}
+
+	/// 1000 actors playing 4 clips with and without pose cache.
+	void BenchmarkPoseCache() {
+		ecs::AnimationStats sampledStats;
+		ecs::AnimationStats cachedStats;
+		double sampledTime = MeasureAnimation(1000, 4, 0.0f, sampledStats);
+		double cachedTime = MeasureAnimation(1000, 4, 30.0f, cachedStats);
+		GLVM_CHECK(sampledStats.evaluatedPoses == 1000 * BENCHMARK_FRAMES_NUMBER);
+		GLVM_CHECK(cachedStats.evaluatedPoses < sampledStats.evaluatedPoses);
+		std::printf("1000 actors, 4 clips: sampled %.3f ms, cached %.3f ms per frame, hit rate %.2f, %u evictions\n",
+					sampledTime, cachedTime, cachedStats.GetHitRate(), cachedStats.cacheEvictions);
+	}
+
+	/// From 40 to 5000 instances of one character, every pose sampled, CPU only.
+	void BenchmarkScaling() {
+		for ( unsigned int actorsNumber : SCALING_ACTORS_NUMBERS ) {
+			ecs::AnimationStats stats;
+			double time = MeasureAnimation(actorsNumber, 1, 0.0f, stats);
+			GLVM_CHECK(stats.evaluatedPoses == actorsNumber * BENCHMARK_FRAMES_NUMBER);
+			std::printf("%u actors, %u workers: %.3f ms per frame, %.3f us per actor\n", actorsNumber,
+						core::CJobSystem::GetInstance()->GetWorkersNumber(), time, 1000.0 * time / actorsNumber);
+		}
+	}
+}
+
+int main() {
+	TestRecycledIndex();
+	TestPoseCacheResults();
+	TestPoseCacheAgainstList();
+	TestSharedPalettes();
+	TestSharedSkeleton();
+	BenchmarkPoseCache();
+	BenchmarkScaling();
+
+	return GLVM::test::TestResult("AnimationSystemTest");
+}
@@ -0,0 +1,130 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#ifndef BROADPHASE_SCENE
+#define BROADPHASE_SCENE
+
+#include "IBroadphase.hpp"
+#include "Test.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace GLVM::test
+{
+	/*! Moving boxes for comparison of broadphases with brute force. Entity handles have generation
+	 *  bits and gaps between indices, some boxes are much larger than others and some leave scene
+	 *  for few frames, so broadphase must drop proxies that were not passed.
+	 */
+	struct BroadphaseScene
+	{
+		std::vector<ecs::BroadphaseBox> boxes;
+		std::vector<vec3> velocities;
+		std::vector<Entity> entities;
+		std::vector<bool> present;
+		CRandom random;
+
+		BroadphaseScene(unsigned int boxesNumber, float size, std::uint32_t seed) : random(seed) {
+			for ( unsigned int i = 0; i < boxesNumber; ++i ) {
+				vec3 center(random.Next(0.0f, size), random.Next(0.0f, size), random.Next(0.0f, size));
+				float halfSize = i % 97 == 0 ? random.Next(5.0f, 15.0f) : random.Next(0.25f, 1.5f);
+				ecs::BroadphaseBox box;
+				for ( int axis = 0; axis < 3; ++axis ) {
+					box.min[axis] = center[axis] - halfSize;
+					box.max[axis] = center[axis] + halfSize;
+				}
+
+				boxes.push_back(box);
+				velocities.push_back(vec3(random.Next(-0.5f, 0.5f), random.Next(-0.5f, 0.5f), random.Next(-0.5f, 0.5f)));
+				entities.push_back(ecs::MakeEntity(i * 3 + 1, i % 5));
+				present.push_back(true);
+			}
+		}
+
+		/// Move every box and let some of them leave or come back.
+		void Step() {
+			for ( unsigned int i = 0; i < boxes.size(); ++i ) {
+				for ( int axis = 0; axis < 3; ++axis ) {
+					boxes[i].min[axis] += velocities[i][axis];
+					boxes[i].max[axis] += velocities[i][axis];
+				}
+
+				if ( random.Next(0.0f, 1.0f) < 0.02f )
+					present[i] = !present[i];
+			}
+		}
+
+		void Feed(ecs::IBroadphase& broadphase) const {
+			broadphase.BeginUpdate();
+			for ( unsigned int i = 0; i < boxes.size(); ++i )
+				if ( present[i] )
+					broadphase.UpdateProxy(entities[i], boxes[i], velocities[i]);
+			broadphase.EndUpdate();
+		}
+	};
+
+	inline std::uint64_t PairKey(Entity first, Entity second) {
+		if ( second < first )
+			std::swap(first, second);
+
+		return (static_cast<std::uint64_t>(first) << 32) | second;
+	}
+
+	/// Keys of pairs sorted, duplicates kept, so caller can find them.
+	inline std::vector<std::uint64_t> SortedPairKeys(const core::vector<ecs::BroadphasePair>& pairs) {
+		std::vector<std::uint64_t> keys;
+		for ( unsigned int i = 0; i < pairs.GetSize(); ++i )
+			keys.push_back(PairKey(pairs[i].first, pairs[i].second));
+		std::sort(keys.begin(), keys.end());
+
+		return keys;
+	}
+
+	/// Every pair of present boxes that overlap, tested one by one.
+	inline std::vector<std::uint64_t> BruteForcePairKeys(const BroadphaseScene& scene) {
+		std::vector<std::uint64_t> keys;
+		for ( unsigned int i = 0; i < scene.boxes.size(); ++i ) {
+			if ( !scene.present[i] )
+				continue;
+
+			for ( unsigned int j = i + 1; j < scene.boxes.size(); ++j )
+				if ( scene.present[j] && ecs::BoxOverlap(scene.boxes[i], scene.boxes[j]) )
+					keys.push_back(PairKey(scene.entities[i], scene.entities[j]));
+		}
+		std::sort(keys.begin(), keys.end());
+
+		return keys;
+	}
+
+	inline bool HasDuplicates(const std::vector<std::uint64_t>& sortedKeys) {
+		return std::adjacent_find(sortedKeys.begin(), sortedKeys.end()) != sortedKeys.end();
+	}
+
+	inline bool Includes(const std::vector<std::uint64_t>& sortedKeys, const std::vector<std::uint64_t>& sortedSubset) {
+		return std::includes(sortedKeys.begin(), sortedKeys.end(), sortedSubset.begin(), sortedSubset.end());
+	}
+
+	inline std::vector<Entity> BruteForceRay(const BroadphaseScene& scene, const vec3& origin, const vec3& ray) {
+		vec3 inverseRay(1.0f / ray[0], 1.0f / ray[1], 1.0f / ray[2]);
+		std::vector<Entity> result;
+		for ( unsigned int i = 0; i < scene.boxes.size(); ++i )
+			if ( scene.present[i] && ecs::RayOverlap(scene.boxes[i], origin, inverseRay) )
+				result.push_back(scene.entities[i]);
+		std::sort(result.begin(), result.end());
+
+		return result;
+	}
+
+	inline std::vector<Entity> SortedEntities(const core::vector<Entity>& entities) {
+		std::vector<Entity> result;
+		for ( unsigned int i = 0; i < entities.GetSize(); ++i )
+			result.push_back(entities[i]);
+		std::sort(result.begin(), result.end());
+
+		return result;
+	}
+}
+
+#endif
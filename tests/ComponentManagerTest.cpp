@@ -0,0 +1,304 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "Test.hpp"
+#include "ComponentManager.hpp"
+#include "EntityManager.hpp"
+#include "Components/MoveComponent.hpp"
+#include <chrono>
+#include <string>
+#include <utility>
+
+namespace ecs = GLVM::ecs;
+namespace core = GLVM::core;
+namespace cm = GLVM::ecs::components;
+
+namespace
+{
+	constexpr unsigned int BENCHMARK_ENTITIES_NUMBER = 20000;
+	constexpr unsigned int QUERY_ENTITIES_NUMBER = 10000;
+	constexpr unsigned int BENCHMARK_FRAMES_NUMBER = 100;
+
+	int aliveShields = 0;
+
+	/// Component of game code, unknown to engine. Counts instances, so leaked or doubly destroyed copy is visible.
+	struct shield
+	{
+		std::string owner;
+		float strength = 0.0f;
+
+		shield() { ++aliveShields; }
+		shield(std::string owner_, float strength_) : owner(std::move(owner_)), strength(strength_) { ++aliveShields; }
+		shield(shield&& other) : owner(std::move(other.owner)), strength(other.strength) { ++aliveShields; }
+		~shield() { --aliveShields; }
+	};
+
+	/*! Custom type registered after built-in ones gets next type ID, and entity moves to other table
+	 *  and back when component added and removed by that ID, without any code that knows the type.
+	 */
+	void TestCustomComponentByTypeID(ecs::ComponentManager* componentManager, ecs::EntityManager* entityManager) {
+		unsigned int transformID = componentManager->GetComponentTypeID<cm::transform>();
+		unsigned int moveID = componentManager->GetComponentTypeID<cm::move>();
+		unsigned int shieldID = componentManager->GetComponentTypeID<shield>();
+		GLVM_CHECK(shieldID > transformID && shieldID > moveID);
+		GLVM_CHECK(componentManager->componentsInfo[shieldID].size == sizeof(shield));
+
+		Entity entity = entityManager->CreateEntity();
+		componentManager->CreateComponent<cm::transform, cm::move>(entity);
+		componentManager->GetComponent<cm::transform>(entity)->tPosition = { 3.0f, 0.0f, 0.0f };
+		ecs::Archetype* builtInTable = componentManager->entityLocations[ecs::GetEntityIndex(entity)].archetype;
+		ecs::Signature builtInSignature = componentManager->GetSignature(entity);
+		GLVM_CHECK(builtInSignature.test(transformID) && builtInSignature.test(moveID) && !builtInSignature.test(shieldID));
+
+		shield value("player", 50.0f);
+		shield* added = static_cast<shield*>(componentManager->CreateComponent(entity, shieldID, &value));
+		ecs::Archetype* shieldTable = componentManager->entityLocations[ecs::GetEntityIndex(entity)].archetype;
+		ecs::Signature shieldSignature = componentManager->GetSignature(entity);
+		GLVM_CHECK(shieldTable != builtInTable);
+		GLVM_CHECK(shieldSignature == (builtInSignature | ecs::Signature().set(shieldID)));
+		GLVM_CHECK(shieldTable->signature == shieldSignature);
+		GLVM_CHECK(added == componentManager->GetComponent<shield>(entity));
+		GLVM_CHECK(added->owner == "player" && added->strength == 50.0f && value.owner.empty());
+		GLVM_CHECK(componentManager->GetComponent<cm::transform>(entity)->tPosition[0] == 3.0f);    ///< Moved with entity.
+		GLVM_CHECK((componentManager->multiCheckAvailability<cm::transform, shield>(entity)));
+
+		shield replacement("ally", 10.0f);
+		componentManager->CreateComponent(entity, shieldID, &replacement);                          ///< Already owned, only assigned.
+		GLVM_CHECK(componentManager->entityLocations[ecs::GetEntityIndex(entity)].archetype == shieldTable);
+		GLVM_CHECK(componentManager->GetComponent<shield>(entity)->owner == "ally");
+
+		componentManager->RemoveComponent(entity, shieldID);
+		GLVM_CHECK(componentManager->entityLocations[ecs::GetEntityIndex(entity)].archetype == builtInTable);
+		GLVM_CHECK(componentManager->GetSignature(entity) == builtInSignature);
+		GLVM_CHECK(componentManager->GetComponent<shield>(entity) == nullptr);
+		GLVM_CHECK(componentManager->GetComponent<cm::transform>(entity)->tPosition[0] == 3.0f);
+		GLVM_CHECK(aliveShields == 2);                                                               ///< Only local values left.
+
+		componentManager->CreateComponent(entity, shieldID, nullptr);                                ///< Value-initialized, same table as before.
+		GLVM_CHECK(componentManager->entityLocations[ecs::GetEntityIndex(entity)].archetype == shieldTable);
+		GLVM_CHECK(componentManager->GetComponent<shield>(entity)->owner.empty());
+		entityManager->RemoveEntity(entity, componentManager);                                      ///< Custom component destroyed too.
+		GLVM_CHECK(aliveShields == 2);
+		GLVM_CHECK(componentManager->GetSignature(entity).none());
+	}
+
+	bool Contains(core::vector<Entity>& entities, Entity entity) {
+		for ( unsigned int i = 0; i < entities.GetSize(); ++i )
+			if ( entities[i] == entity )
+				return true;
+
+		return false;
+	}
+
+	/*! Snapshot of GetEntityContainer rebuilt only after structural change of tables with its type.
+	 *  Marker pushed into snapshot shows whether call returned cached container or new one.
+	 */
+	void TestEntityContainerCache(ecs::ComponentManager* componentManager, ecs::EntityManager* entityManager) {
+		Entity first = entityManager->CreateEntity();
+		Entity second = entityManager->CreateEntity();
+		Entity other = entityManager->CreateEntity();
+		componentManager->CreateComponent<shield>(first);
+		componentManager->CreateComponent<shield>(second);
+		componentManager->CreateComponent<cm::move>(other);
+
+		core::vector<Entity>* shields = componentManager->GetEntityContainer<shield>();
+		GLVM_CHECK(shields->GetSize() == 2 && Contains(*shields, first) && Contains(*shields, second));
+		const Entity marker = ~0u;
+		shields->Push(marker);
+		componentManager->GetComponent<shield>(first)->strength = 5.0f;           ///< Writes are not structural changes.
+		componentManager->CreateComponent<cm::transform>(other);                   ///< Tables without shield.
+		GLVM_CHECK(componentManager->GetEntityContainer<shield>() == shields);
+		GLVM_CHECK(shields->GetSize() == 3 && shields->GetHead() == marker);
+
+		componentManager->CreateComponent<cm::move>(first);                        ///< Entity moves between tables with shield.
+		shields = componentManager->GetEntityContainer<shield>();
+		GLVM_CHECK(shields->GetSize() == 2 && !Contains(*shields, marker));
+
+		componentManager->CreateComponent<shield>(other);
+		shields = componentManager->GetEntityContainer<shield>();
+		GLVM_CHECK(shields->GetSize() == 3 && Contains(*shields, other));
+
+		componentManager->RemoveComponent<shield>(second);
+		shields = componentManager->GetEntityContainer<shield>();
+		GLVM_CHECK(shields->GetSize() == 2 && !Contains(*shields, second));
+
+		entityManager->RemoveEntity(first, componentManager);
+		shields = componentManager->GetEntityContainer<shield>();
+		GLVM_CHECK(shields->GetSize() == 1 && Contains(*shields, other));
+
+		entityManager->RemoveEntity(second, componentManager);
+		entityManager->RemoveEntity(other, componentManager);
+		GLVM_CHECK(componentManager->GetEntityContainer<shield>()->GetSize() == 0);
+		GLVM_CHECK(aliveShields == 0);
+	}
+
+	/// Storage of one component type before archetype tables: sparse index by entity, dense entities and components.
+	template <typename componentType>
+	struct SparseSet
+	{
+		core::vector<unsigned int> sparse;
+		core::vector<Entity> dense;
+		core::vector<componentType> components;
+
+		bool Contains(Entity entity) {
+			unsigned int index = ecs::GetEntityIndex(entity);
+			return index < sparse.GetSize() && sparse[index] < dense.GetSize() && dense[sparse[index]] == entity;
+		}
+
+		void Add(Entity entity) {
+			unsigned int index = ecs::GetEntityIndex(entity);
+			if ( index >= sparse.GetSize() )
+				sparse.Resize(index + 1);
+			sparse[index] = dense.GetSize();
+			dense.Push(entity);
+			components.Push(componentType());
+		}
+
+		componentType* Get(Entity entity) {
+			return Contains(entity) ? &components[sparse[ecs::GetEntityIndex(entity)]] : nullptr;
+		}
+	};
+
+	/// Movement scene stored twice, in sparse sets like before archetype tables and in tables. 9 of every 10 entities move.
+	struct MovementScene
+	{
+		SparseSet<cm::transform> transforms;
+		SparseSet<cm::move> moves;
+		core::vector<Entity> entities;
+
+		MovementScene(ecs::ComponentManager* componentManager, ecs::EntityManager* entityManager, unsigned int entitiesNumber) {
+			for ( unsigned int i = 0; i < entitiesNumber; ++i ) {
+				Entity entity = entityManager->CreateEntity();
+				entities.Push(entity);
+				transforms.Add(entity);
+				componentManager->CreateComponent<cm::transform>(entity);
+				if ( i % 10 == 0 )
+					continue;
+
+				moves.Add(entity);
+				moves.Get(entity)->frameMovement = vec3(0.25f * static_cast<float>(i % 7), 0.0f, 0.0f);
+				componentManager->CreateComponent<cm::move>(entity);
+				componentManager->GetComponent<cm::move>(entity)->frameMovement = moves.Get(entity)->frameMovement;
+			}
+		}
+
+		/// Entities with both components, found like old collectLinkedEntities did: walk dense array of first type.
+		core::vector<Entity> CollectLinked() {
+			core::vector<Entity> linked;
+			for ( unsigned int i = 0; i < transforms.dense.GetSize(); ++i )
+				if ( moves.Contains(transforms.dense[i]) )
+					linked.Push(transforms.dense[i]);
+
+			return linked;
+		}
+
+		/// Tables must be stepped framesRatio times as many frames as sparse sets, steps exact in float.
+		bool Matches(ecs::ComponentManager* componentManager, float framesRatio) {
+			bool same = true;
+			for ( unsigned int i = 0; i < entities.GetSize(); ++i )
+				same = same && componentManager->GetComponent<const cm::transform>(entities[i])->tPosition[0] ==
+					transforms.Get(entities[i])->tPosition[0] * framesRatio;
+
+			return same;
+		}
+
+		void Destroy(ecs::ComponentManager* componentManager, ecs::EntityManager* entityManager) {
+			for ( unsigned int i = 0; i < entities.GetSize(); ++i )
+				entityManager->RemoveEntity(entities[i], componentManager);
+		}
+	};
+
+	/*! Movement of 20k entities. Sparse sets iterated like systems did it: collect entities with both
+	 *  components, then look up every component. Tables iterated by chunks, and by collectLinkedEntities
+	 *  with GetComponent, which systems not yet moved to chunks still use.
+	 */
+	void BenchmarkStorage(ecs::ComponentManager* componentManager, ecs::EntityManager* entityManager) {
+		MovementScene scene(componentManager, entityManager, BENCHMARK_ENTITIES_NUMBER);
+		SparseSet<cm::transform>& transforms = scene.transforms;
+		SparseSet<cm::move>& moves = scene.moves;
+
+		auto start = std::chrono::steady_clock::now();
+		for ( unsigned int frame = 0; frame < BENCHMARK_FRAMES_NUMBER; ++frame ) {
+			core::vector<Entity> linked = scene.CollectLinked();
+			for ( unsigned int i = 0; i < linked.GetSize(); ++i )
+				transforms.Get(linked[i])->tPosition[0] += moves.Get(linked[i])->frameMovement[0];
+		}
+		auto chunksStart = std::chrono::steady_clock::now();
+		for ( unsigned int frame = 0; frame < BENCHMARK_FRAMES_NUMBER; ++frame ) {
+			componentManager->forEachChunk<cm::transform, const cm::move>(
+				[](unsigned int count, Entity*, cm::transform* transformComponents, const cm::move* moveComponents) {
+					for ( unsigned int i = 0; i < count; ++i )
+						transformComponents[i].tPosition[0] += moveComponents[i].frameMovement[0];
+				});
+		}
+		auto linkedStart = std::chrono::steady_clock::now();
+		for ( unsigned int frame = 0; frame < BENCHMARK_FRAMES_NUMBER; ++frame ) {
+			core::vector<Entity> linked = componentManager->collectLinkedEntities<cm::transform, cm::move>();
+			for ( unsigned int i = 0; i < linked.GetSize(); ++i )
+				componentManager->GetComponent<cm::transform>(linked[i])->tPosition[0] +=
+					componentManager->GetComponent<const cm::move>(linked[i])->frameMovement[0];
+		}
+		auto end = std::chrono::steady_clock::now();
+
+		GLVM_CHECK(scene.Matches(componentManager, 2.0f));
+		scene.Destroy(componentManager, entityManager);
+
+		std::printf("%u entities, %u moving: sparse sets %.3f ms, chunks %.3f ms, collectLinkedEntities %.3f ms per frame\n",
+					BENCHMARK_ENTITIES_NUMBER, static_cast<unsigned int>(moves.dense.GetSize()),
+					std::chrono::duration<double, std::milli>(chunksStart - start).count() / BENCHMARK_FRAMES_NUMBER,
+					std::chrono::duration<double, std::milli>(linkedStart - chunksStart).count() / BENCHMARK_FRAMES_NUMBER,
+					std::chrono::duration<double, std::milli>(end - linkedStart).count() / BENCHMARK_FRAMES_NUMBER);
+	}
+
+	/*! 10k entity scene. Old way built new vector of linked entities on every call and looked up every
+	 *  component, persistent query gives matching set at once and walks chunks without allocations.
+	 */
+	void BenchmarkQuery(ecs::ComponentManager* componentManager, ecs::EntityManager* entityManager) {
+		MovementScene scene(componentManager, entityManager, QUERY_ENTITIES_NUMBER);
+		ecs::Query<cm::transform, const cm::move>& query = componentManager->GetQuery<cm::transform, const cm::move>();
+
+		unsigned int linkedNumber = 0;
+		auto start = std::chrono::steady_clock::now();
+		for ( unsigned int frame = 0; frame < BENCHMARK_FRAMES_NUMBER; ++frame )
+			linkedNumber += scene.CollectLinked().GetSize();
+		auto querySizeStart = std::chrono::steady_clock::now();
+		unsigned int queryNumber = 0;
+		for ( unsigned int frame = 0; frame < BENCHMARK_FRAMES_NUMBER; ++frame )
+			queryNumber += query.GetSize();
+		auto iterationStart = std::chrono::steady_clock::now();
+		for ( unsigned int frame = 0; frame < BENCHMARK_FRAMES_NUMBER; ++frame ) {
+			core::vector<Entity> linked = scene.CollectLinked();
+			for ( unsigned int i = 0; i < linked.GetSize(); ++i )
+				scene.transforms.Get(linked[i])->tPosition[0] += scene.moves.Get(linked[i])->frameMovement[0];
+		}
+		auto queryStart = std::chrono::steady_clock::now();
+		for ( unsigned int frame = 0; frame < BENCHMARK_FRAMES_NUMBER; ++frame )
+			for ( auto [entity, transformComponent, moveComponent] : query )
+				transformComponent.tPosition[0] += moveComponent.frameMovement[0];
+		auto end = std::chrono::steady_clock::now();
+
+		GLVM_CHECK(linkedNumber == queryNumber);
+		GLVM_CHECK(scene.Matches(componentManager, 1.0f));
+		scene.Destroy(componentManager, entityManager);
+
+		std::printf("%u entities: matching set by linked entities %.3f ms, by query %.4f ms; iteration with lookups %.3f ms, "
+					"query %.3f ms per frame\n", QUERY_ENTITIES_NUMBER,
+					std::chrono::duration<double, std::milli>(querySizeStart - start).count() / BENCHMARK_FRAMES_NUMBER,
+					std::chrono::duration<double, std::milli>(iterationStart - querySizeStart).count() / BENCHMARK_FRAMES_NUMBER,
+					std::chrono::duration<double, std::milli>(queryStart - iterationStart).count() / BENCHMARK_FRAMES_NUMBER,
+					std::chrono::duration<double, std::milli>(end - queryStart).count() / BENCHMARK_FRAMES_NUMBER);
+	}
+}
+
+int main() {
+	ecs::ComponentManager* componentManager = ecs::ComponentManager::GetInstance();
+	ecs::EntityManager* entityManager = ecs::EntityManager::GetInstance();
+	TestCustomComponentByTypeID(componentManager, entityManager);
+	TestEntityContainerCache(componentManager, entityManager);
+	BenchmarkStorage(componentManager, entityManager);
+	BenchmarkQuery(componentManager, entityManager);
+
+	return GLVM::test::TestResult("ComponentManagerTest");
+}
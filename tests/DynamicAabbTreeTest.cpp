@@ -0,0 +1,138 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "Test.hpp"
+#include "BroadphaseScene.hpp"
+#include "DynamicAabbTree.hpp"
+#include "Frustum.hpp"
+
+namespace ecs = GLVM::ecs;
+namespace test = GLVM::test;
+
+namespace
+{
+	constexpr unsigned int FRAMES_NUMBER = 8;
+	constexpr unsigned int QUERIES_NUMBER = 64;
+
+	/// Tree tests fat boxes, so it may report more than brute force, but never less and never twice.
+	void TestBroadphase() {
+		test::BroadphaseScene scene(1000, 60.0f, 11);
+		ecs::CAabbTreeBroadphase broadphase;
+		for ( unsigned int frame = 0; frame < FRAMES_NUMBER; ++frame ) {
+			scene.Feed(broadphase);
+			GLVM::core::vector<ecs::BroadphasePair> pairs;
+			broadphase.CollectPairs(pairs);
+			std::vector<std::uint64_t> keys = test::SortedPairKeys(pairs);
+			std::vector<std::uint64_t> bruteForceKeys = test::BruteForcePairKeys(scene);
+			GLVM_CHECK(!bruteForceKeys.empty());
+			GLVM_CHECK(!test::HasDuplicates(keys));
+			GLVM_CHECK(test::Includes(keys, bruteForceKeys));
+
+			unsigned int presentNumber = 0;
+			for ( unsigned int i = 0; i < scene.present.size(); ++i )
+				presentNumber += scene.present[i] ? 1 : 0;
+			GLVM_CHECK(broadphase.GetTree().GetProxiesNumber() == presentNumber);    ///< Boxes not passed in this update are dropped.
+
+			for ( unsigned int i = 0; i < QUERIES_NUMBER; ++i ) {
+				vec3 origin(scene.random.Next(0.0f, 60.0f), scene.random.Next(0.0f, 60.0f), scene.random.Next(0.0f, 60.0f));
+				vec3 ray(scene.random.Next(-30.0f, 30.0f), i % 8 == 0 ? 0.0f : scene.random.Next(-30.0f, 30.0f), scene.random.Next(-30.0f, 30.0f));
+				GLVM::core::vector<Entity> entities;
+				broadphase.QueryRay(origin, ray, entities);
+				std::vector<Entity> sortedEntities = test::SortedEntities(entities);
+				std::vector<Entity> bruteForceEntities = test::BruteForceRay(scene, origin, ray);
+				GLVM_CHECK(std::adjacent_find(sortedEntities.begin(), sortedEntities.end()) == sortedEntities.end());
+				GLVM_CHECK(std::includes(sortedEntities.begin(), sortedEntities.end(), bruteForceEntities.begin(), bruteForceEntities.end()));
+			}
+
+			scene.Step();
+		}
+	}
+
+	/// Box and frustum queries of tree itself, with proxies destroyed and moved between queries.
+	void TestTreeQueries() {
+		test::BroadphaseScene scene(1000, 60.0f, 12);
+		ecs::CDynamicAabbTree tree;
+		std::vector<unsigned int> proxies;
+		for ( unsigned int i = 0; i < scene.boxes.size(); ++i )
+			proxies.push_back(tree.CreateProxy(scene.boxes[i], i));
+
+		/// Static geometry: same box or box inside of fat box dont touch tree.
+		GLVM_CHECK(!tree.MoveProxy(proxies[0], scene.boxes[0]));
+		ecs::BroadphaseBox nudgedBox = scene.boxes[1];
+		nudgedBox.min[0] += ecs::AABB_TREE_FAT_MARGIN * 0.5f;
+		nudgedBox.max[0] += ecs::AABB_TREE_FAT_MARGIN * 0.5f;
+		GLVM_CHECK(!tree.MoveProxy(proxies[1], nudgedBox));
+		scene.boxes[1] = nudgedBox;
+
+		for ( unsigned int frame = 0; frame < FRAMES_NUMBER; ++frame ) {
+			scene.Step();
+			for ( unsigned int i = 0; i < scene.boxes.size(); ++i ) {
+				bool inTree = proxies[i] != ecs::AABB_TREE_NULL_NODE;
+				if ( scene.present[i] && !inTree ) {
+					proxies[i] = tree.CreateProxy(scene.boxes[i], i);
+				} else if ( !scene.present[i] && inTree ) {
+					tree.DestroyProxy(proxies[i]);
+					proxies[i] = ecs::AABB_TREE_NULL_NODE;
+				} else if ( inTree ) {
+					tree.MoveProxy(proxies[i], scene.boxes[i], scene.velocities[i]);
+				}
+			}
+
+			for ( unsigned int i = 0; i < scene.boxes.size(); ++i )
+				if ( proxies[i] != ecs::AABB_TREE_NULL_NODE ) {
+					const ecs::BroadphaseBox& fatBox = tree.GetFatBox(proxies[i]);
+					bool contained = true;
+					for ( int axis = 0; axis < 3; ++axis )
+						contained = contained && fatBox.min[axis] <= scene.boxes[i].min[axis] && fatBox.max[axis] >= scene.boxes[i].max[axis];
+					GLVM_CHECK(contained);                                 ///< Real box never leaves fat box after MoveProxy.
+				}
+
+			for ( unsigned int q = 0; q < QUERIES_NUMBER; ++q ) {
+				vec3 center(scene.random.Next(0.0f, 60.0f), scene.random.Next(0.0f, 60.0f), scene.random.Next(0.0f, 60.0f));
+				float range = scene.random.Next(1.0f, 15.0f);
+				ecs::BroadphaseBox queryBox;
+				vec4 planes[GLVM::core::FRUSTUM_PLANES_NUMBER + 1];
+				GLVM::core::ExtractRangePlanes(center, range, planes);
+				planes[GLVM::core::FRUSTUM_PLANES_NUMBER] = vec4(0.57735f, 0.57735f, 0.57735f, -0.57735f * (center[0] + center[1] + center[2]));
+				for ( int axis = 0; axis < 3; ++axis ) {
+					queryBox.min[axis] = center[axis] - range;
+					queryBox.max[axis] = center[axis] + range;
+				}
+
+				std::vector<unsigned int> boxResult;
+				std::vector<unsigned int> frustumResult;
+				tree.QueryBox(queryBox, [&](unsigned int proxy) { boxResult.push_back(tree.GetUserData(proxy)); return true; });
+				tree.QueryFrustum(planes, GLVM::core::FRUSTUM_PLANES_NUMBER + 1,
+								  [&](unsigned int proxy) { frustumResult.push_back(tree.GetUserData(proxy)); return true; });
+				std::sort(boxResult.begin(), boxResult.end());
+				std::sort(frustumResult.begin(), frustumResult.end());
+
+				bool boxResultComplete = true;
+				bool frustumResultComplete = true;
+				for ( unsigned int i = 0; i < scene.boxes.size(); ++i ) {
+					if ( proxies[i] == ecs::AABB_TREE_NULL_NODE )
+						continue;
+
+					if ( ecs::BoxOverlap(queryBox, scene.boxes[i]) && !std::binary_search(boxResult.begin(), boxResult.end(), i) )
+						boxResultComplete = false;
+					if ( ecs::FrustumOverlap(scene.boxes[i], planes, GLVM::core::FRUSTUM_PLANES_NUMBER + 1) &&
+						 !std::binary_search(frustumResult.begin(), frustumResult.end(), i) )
+						frustumResultComplete = false;
+				}
+
+				GLVM_CHECK(boxResultComplete);
+				GLVM_CHECK(frustumResultComplete);
+				GLVM_CHECK(std::adjacent_find(boxResult.begin(), boxResult.end()) == boxResult.end());
+			}
+		}
+	}
+}
+
+int main() {
+	TestBroadphase();
+	TestTreeQueries();
+
+	return test::TestResult("DynamicAabbTreeTest");
+}
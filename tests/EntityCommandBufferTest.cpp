@@ -0,0 +1,214 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "Test.hpp"
+#include "ComponentManager.hpp"
+#include "EntityCommandBuffer.hpp"
+#include "EntityManager.hpp"
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace ecs = GLVM::ecs;
+
+namespace
+{
+	constexpr unsigned int BENCHMARK_ENTITIES_NUMBER = 20000;
+
+	bool playingBack = false;
+	int aliveComponents = 0;
+	std::vector<int> playbackLog;                                        ///< Tags of recorded values in order they reached tables.
+
+	/// Component that logs move of recorded value during playback, moves between tables are not logged.
+	template <int kind>
+	struct LoggedComponent
+	{
+		int tag = 0;
+		bool recorded = false;
+
+		LoggedComponent() { ++aliveComponents; }
+		explicit LoggedComponent(int tag_) : tag(tag_), recorded(true) { ++aliveComponents; }
+		LoggedComponent(LoggedComponent&& other) : tag(other.tag), recorded(other.recorded && !playingBack) {
+			++aliveComponents;
+			if ( other.recorded && playingBack )
+				playbackLog.push_back(tag);
+		}
+		~LoggedComponent() { --aliveComponents; }
+	};
+
+	typedef LoggedComponent<0> first;
+	typedef LoggedComponent<1> second;
+
+	/// Command as test expects it to be applied.
+	struct ExpectedCommand
+	{
+		unsigned int componentTypeID;
+		unsigned int entityIndex;
+		int tag;
+		bool applied;
+	};
+
+	/// Record the same commands into buffer and into list of expectations, in the same order.
+	class CRecorder
+	{
+	public:
+		ecs::EntityCommandBuffer buffer;
+		std::vector<ExpectedCommand> expected;
+
+		template <typename componentType>
+		void Add(Entity entity, int tag, bool applied = true) {
+			buffer.AddComponent(entity, componentType(tag));
+			Expect<componentType>(entity, tag, applied);
+		}
+
+		template <typename componentType>
+		void Set(Entity entity, int tag, bool applied) {
+			buffer.SetComponent(entity, componentType(tag));
+			Expect<componentType>(entity, tag, applied);
+		}
+
+		template <typename componentType>
+		void Expect(Entity entity, int tag, bool applied) {
+			expected.push_back({ ecs::ComponentManager::GetInstance()->GetComponentTypeID<componentType>(),
+								 ecs::GetEntityIndex(entity), tag, applied });
+		}
+
+		/// Component type first, then entity index, then order of recording.
+		std::vector<int> ExpectedLog() {
+			std::stable_sort(expected.begin(), expected.end(), [](const ExpectedCommand& a, const ExpectedCommand& b) {
+				if ( a.componentTypeID != b.componentTypeID )
+					return a.componentTypeID < b.componentTypeID;
+				return a.entityIndex < b.entityIndex;
+			});
+
+			std::vector<int> log;
+			for ( const ExpectedCommand& command : expected )
+				if ( command.applied )
+					log.push_back(command.tag);
+
+			return log;
+		}
+	};
+
+	void TestPlaybackOrder(ecs::ComponentManager* componentManager, ecs::EntityManager* entityManager) {
+		Entity entities[6];
+		for ( unsigned int i = 0; i < 6; ++i )
+			entities[i] = entityManager->CreateEntity();
+
+		CRecorder recorder;
+		recorder.buffer.DestroyEntity(entities[5]);                      ///< Recorded first, still applied after everything else.
+		recorder.Add<first>(entities[5], 50, false);
+		recorder.Add<second>(entities[5], 51, false);
+		for ( int i = 4; i >= 0; --i )                                    ///< Reverse order, so sort by entity index is visible.
+			recorder.Add<second>(entities[i], 10 + i);
+		recorder.Set<second>(entities[0], 20, true);                      ///< Recorded after add, so applied as set.
+		recorder.Add<first>(entities[1], 30);
+		recorder.Add<first>(entities[2], 31);
+		recorder.Set<first>(entities[2], 32, true);
+		recorder.buffer.RemoveComponent<first>(entities[3]);             ///< Entity dont have it yet, nothing happens.
+		recorder.Add<first>(entities[3], 33);
+		recorder.Add<first>(entities[4], 34);
+		recorder.buffer.RemoveComponent<first>(entities[4]);
+		recorder.Set<first>(entities[0], 35, false);                      ///< Entity dont have component, set ignored.
+
+		playbackLog.clear();
+		playingBack = true;
+		recorder.buffer.Playback(componentManager, entityManager);
+		playingBack = false;
+
+		GLVM_CHECK(playbackLog == recorder.ExpectedLog());
+		GLVM_CHECK(recorder.buffer.IsEmpty());
+		GLVM_CHECK(!entityManager->IsAlive(entities[5]));
+		GLVM_CHECK(componentManager->GetComponent<second>(entities[0])->tag == 20);
+		GLVM_CHECK(componentManager->GetComponent<first>(entities[0]) == nullptr);
+		GLVM_CHECK(componentManager->GetComponent<first>(entities[2])->tag == 32);
+		GLVM_CHECK(componentManager->GetComponent<first>(entities[3]) != nullptr);
+		GLVM_CHECK(componentManager->GetComponent<first>(entities[4]) == nullptr);
+		GLVM_CHECK(componentManager->GetComponent<second>(entities[4])->tag == 14);
+
+		for ( unsigned int i = 0; i < 5; ++i )
+			entityManager->RemoveEntity(entities[i], componentManager);
+		GLVM_CHECK(aliveComponents == 0);                                ///< Values of dropped commands destroyed too.
+	}
+
+	/// Entity created by buffer lives after playback and is released by Clear without playback.
+	void TestCreatedEntities(ecs::ComponentManager* componentManager, ecs::EntityManager* entityManager) {
+		unsigned int aliveEntities = entityManager->GetAliveEntitiesNumber();
+		ecs::EntityCommandBuffer buffer;
+
+		Entity played = buffer.CreateEntity();
+		buffer.AddComponent(played, first(1));
+		buffer.Playback(componentManager, entityManager);
+		GLVM_CHECK(entityManager->IsAlive(played));
+		GLVM_CHECK(componentManager->GetComponent<first>(played) != nullptr);
+
+		Entity cleared = buffer.CreateEntity();
+		buffer.AddComponent(cleared, first(2));
+		buffer.Clear();
+		GLVM_CHECK(!entityManager->IsAlive(cleared));
+		GLVM_CHECK(entityManager->GetAliveEntitiesNumber() == aliveEntities + 1);
+
+		buffer.Playback(componentManager, entityManager);              ///< Nothing left to play back after Clear.
+		GLVM_CHECK(entityManager->IsAlive(played));
+
+		entityManager->RemoveEntity(played, componentManager);
+		GLVM_CHECK(entityManager->GetAliveEntitiesNumber() == aliveEntities);
+		GLVM_CHECK(aliveComponents == 0);
+	}
+
+	/*! Adds of two component types recorded per entity, interleaved like systems record them. Playback
+	 *  compared with immediate creation in recording order.
+	 */
+	void BenchmarkPlayback(ecs::ComponentManager* componentManager, ecs::EntityManager* entityManager) {
+		std::vector<Entity> entities(BENCHMARK_ENTITIES_NUMBER);
+		for ( unsigned int i = 0; i < BENCHMARK_ENTITIES_NUMBER; ++i )
+			entities[i] = entityManager->CreateEntity();
+
+		auto start = std::chrono::steady_clock::now();
+		for ( unsigned int i = 0; i < BENCHMARK_ENTITIES_NUMBER; ++i ) {
+			componentManager->CreateComponent<first>(entities[i]);
+			componentManager->CreateComponent<second>(entities[i]);
+		}
+		auto middle = std::chrono::steady_clock::now();
+
+		for ( unsigned int i = 0; i < BENCHMARK_ENTITIES_NUMBER; ++i ) {
+			componentManager->RemoveComponent<first>(entities[i]);
+			componentManager->RemoveComponent<second>(entities[i]);
+		}
+
+		ecs::EntityCommandBuffer buffer;
+		auto recordStart = std::chrono::steady_clock::now();
+		for ( unsigned int i = 0; i < BENCHMARK_ENTITIES_NUMBER; ++i ) {
+			buffer.AddComponent<first>(entities[i]);
+			buffer.AddComponent<second>(entities[i]);
+		}
+		auto playbackStart = std::chrono::steady_clock::now();
+		buffer.Playback(componentManager, entityManager);
+		auto end = std::chrono::steady_clock::now();
+
+		bool allAdded = true;
+		for ( unsigned int i = 0; i < BENCHMARK_ENTITIES_NUMBER; ++i ) {
+			allAdded = allAdded && componentManager->multiCheckAvailability<first, second>(entities[i]);
+			entityManager->RemoveEntity(entities[i], componentManager);
+		}
+
+		GLVM_CHECK(allAdded);
+		GLVM_CHECK(aliveComponents == 0);
+		std::printf("%u entities, %u adds: immediate %.3f ms, record %.3f ms, playback %.3f ms\n", BENCHMARK_ENTITIES_NUMBER,
+					2 * BENCHMARK_ENTITIES_NUMBER, std::chrono::duration<double, std::milli>(middle - start).count(),
+					std::chrono::duration<double, std::milli>(playbackStart - recordStart).count(),
+					std::chrono::duration<double, std::milli>(end - playbackStart).count());
+	}
+}
+
+int main() {
+	ecs::ComponentManager* componentManager = ecs::ComponentManager::GetInstance();
+	ecs::EntityManager* entityManager = ecs::EntityManager::GetInstance();
+	TestPlaybackOrder(componentManager, entityManager);
+	TestCreatedEntities(componentManager, entityManager);
+	BenchmarkPlayback(componentManager, entityManager);
+
+	return GLVM::test::TestResult("EntityCommandBufferTest");
+}
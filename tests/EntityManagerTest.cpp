@@ -0,0 +1,51 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "Test.hpp"
+#include "ComponentManager.hpp"
+#include "EntityManager.hpp"
+
+namespace ecs = GLVM::ecs;
+
+int main() {
+	ecs::EntityManager* entityManager = ecs::EntityManager::GetInstance();
+	ecs::ComponentManager* componentManager = ecs::ComponentManager::GetInstance();
+
+	/// Spawn and destroy churn like projectiles: old handle must stay stale after slot used every generation.
+	constexpr unsigned int CYCLES_NUMBER = 5000000;
+	Entity firstEntity = entityManager->CreateEntity();
+	Entity staleEntity = firstEntity;
+	entityManager->RemoveEntity(staleEntity, componentManager);
+
+	unsigned int staleAliveNumber = 0;
+	unsigned int newDeadNumber = 0;
+	unsigned int firstSlotReuses = 0;
+	for ( unsigned int i = 0; i < CYCLES_NUMBER; ++i ) {
+		Entity entity = entityManager->CreateEntity();
+		if ( !entityManager->IsAlive(entity) )
+			++newDeadNumber;
+		if ( ecs::GetEntityIndex(entity) == ecs::GetEntityIndex(firstEntity) )
+			++firstSlotReuses;
+		if ( entityManager->IsAlive(firstEntity) )
+			++staleAliveNumber;
+
+		entityManager->RemoveEntity(entity, componentManager);
+	}
+
+	GLVM_CHECK(newDeadNumber == 0);
+	GLVM_CHECK(staleAliveNumber == 0);
+	GLVM_CHECK(firstSlotReuses == ecs::ENTITY_GENERATION_MASK);            ///< Every later generation used once, then slot retired.
+	GLVM_CHECK(firstSlotReuses * ecs::MINIMUM_FREE_ENTITY_SLOTS <= CYCLES_NUMBER);
+	GLVM_CHECK(entityManager->GetAliveEntitiesNumber() == 0);
+
+	/// Removal of stale handle dont touch entity that reused the slot.
+	Entity liveEntity = entityManager->CreateEntity();
+	Entity staleCopy = firstEntity;
+	entityManager->RemoveEntity(staleCopy, componentManager);
+	GLVM_CHECK(entityManager->IsAlive(liveEntity));
+	GLVM_CHECK(entityManager->GetAliveEntitiesNumber() == 1);
+
+	return GLVM::test::TestResult("EntityManagerTest");
+}
@@ -0,0 +1,221 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "Test.hpp"
+#include "ComponentManager.hpp"
+#include "Components/ColliderComponent.hpp"
+#include "Components/ControllerComponent.hpp"
+#include "Components/RigidBodyComponent.hpp"
+#include "Components/TransformComponent.hpp"
+#include "Components/ViewComponent.hpp"
+#include "EntityManager.hpp"
+#include "EventsStack.hpp"
+#include "FixedTimestep.hpp"
+#include "Systems/CollisionSystem.hpp"
+#include "Systems/InterpolationSystem.hpp"
+#include "Systems/MovementSystem.hpp"
+#include "Systems/PhysicsSystem.hpp"
+#include <cstring>
+#include <vector>
+
+GLVM::core::CEvent g_eEvent;
+
+namespace ecs = GLVM::ecs;
+namespace cm = GLVM::ecs::components;
+namespace core = GLVM::core;
+
+namespace
+{
+	constexpr float SIMULATED_SECONDS = 4.0f;
+
+	/*! Headless copy of game loop simulation: same systems in the same order as Engine activates
+	 *  them, same parameters set before every step as Engine::Simulate does, structural changes
+	 *  played back after every system like serial execution of CSystemManager.
+	 */
+	class CSimulation
+	{
+	public:
+		core::CStack inputStack;                                         ///< Declared first, systems keep reference to it.
+
+	private:
+		float gravity = 0.0f;
+		core::CFixedTimestep fixedTimestep;
+		ecs::CInterpolationSystem interpolationSystem;
+		ecs::CMovementSystem movementSystem;
+		ecs::CCollisionSystem collisionSystem;
+		ecs::CPhysicsSystem physicsSystem;
+		std::vector<Entity> entities;
+
+		void RunSystem(ecs::ISystem& system) {
+			system.Update();
+			system.commandBuffer.Playback(ecs::ComponentManager::GetInstance(), ecs::EntityManager::GetInstance());
+		}
+
+	public:
+		Entity player;
+		std::vector<std::vector<float>> steps;                           ///< State of every transform after every step.
+
+		CSimulation() : movementSystem(inputStack), collisionSystem(inputStack), physicsSystem(gravity, inputStack) {
+			ecs::EntityManager* entityManager = ecs::EntityManager::GetInstance();
+			ecs::ComponentManager* componentManager = ecs::ComponentManager::GetInstance();
+
+			player = entityManager->CreateEntity();
+			componentManager->CreateComponent<cm::controller, cm::collider, cm::beholder, cm::transform, cm::rigidBody>(player);
+			*componentManager->GetComponent<cm::transform>(player) = { .tPosition = { 2.7f, 3.0f, 3.0f }, .fScale = 1.0f };
+			*componentManager->GetComponent<cm::rigidBody>(player) = { .gravityTime = 0.0f, .fMass_ = 6.0f, .bGravity_ = true };
+			*componentManager->GetComponent<cm::beholder>(player) = { .forward = { 0.0f, 0.0f, -1.0f }, .up = { 0.0f, 1.0f, 0.0f } };
+			entities.push_back(player);
+
+			Entity ground = entityManager->CreateEntity();
+			componentManager->CreateComponent<cm::transform, cm::collider>(ground);
+			*componentManager->GetComponent<cm::transform>(ground) = { .tPosition = { 0.0f, -20.5f, 0.0f }, .fScale = 20.2f };
+			entities.push_back(ground);
+
+			for ( unsigned int i = 0; i < 40; ++i ) {
+				Entity box = entityManager->CreateEntity();
+				componentManager->CreateComponent<cm::transform, cm::collider, cm::rigidBody>(box);
+				*componentManager->GetComponent<cm::transform>(box) = { .tPosition = { static_cast<float>(i) * 0.9f, 2.0f + 0.4f * i, -5.0f },
+					.fScale = 1.2f };
+				*componentManager->GetComponent<cm::rigidBody>(box) = { .gravityTime = 0.0f, .fMass_ = 1.0f + 0.1f * i, .bGravity_ = true };
+				entities.push_back(box);
+			}
+		}
+
+		~CSimulation() {
+			ecs::EntityManager* entityManager = ecs::EntityManager::GetInstance();
+			for ( unsigned int i = 0; i < entities.size(); ++i )
+				entityManager->RemoveEntity(entities[i], ecs::ComponentManager::GetInstance());
+		}
+
+		void Simulate(float frameTime) {
+			float step = fixedTimestep.GetStep();
+			unsigned int substeps = fixedTimestep.Advance(frameTime);
+			for ( unsigned int i = 0; i < substeps; ++i ) {
+				gravity += step;
+				movementSystem.deltaFrameTime            = step;
+				movementSystem.gravity                   = gravity;
+				collisionSystem.fDelta_Time_             = step;
+				collisionSystem.gravity                  = gravity;
+				physicsSystem.fDelta_Time_               = step;
+				physicsSystem.fAcceleration_of_Gravity_ += (step / 20);
+				physicsSystem.gravity                    = gravity;
+				RunSystem(interpolationSystem);
+				RunSystem(movementSystem);
+				RunSystem(collisionSystem);
+				RunSystem(physicsSystem);
+				inputStack.ReleaseLatched();
+
+				std::vector<float> state;
+				for ( unsigned int j = 0; j < entities.size(); ++j ) {
+					const cm::transform* transform = ecs::ComponentManager::GetInstance()->GetComponent<const cm::transform>(entities[j]);
+					state.insert(state.end(), { transform->tPosition[0], transform->tPosition[1], transform->tPosition[2] });
+				}
+				steps.push_back(state);
+			}
+		}
+	};
+
+	void PressAndRelease(core::CStack& inputStack, core::EEvents press, core::EEvents release) {
+		core::CEvent event;
+		event.SetEvent(press);
+		inputStack.ControlInput(event);
+		event.SetEvent(release);
+		inputStack.ControlInput(event);
+	}
+
+	/// Run simulation with chosen render frame times, frame time is taken from frameTimes in cycle.
+	std::vector<std::vector<float>> Run(const std::vector<float>& frameTimes) {
+		CSimulation simulation;
+		core::CEvent event;
+		event.SetEvent(core::EEvents::eMOVE_FORWARD);
+		simulation.inputStack.ControlInput(event);
+
+		float time = 0.0f;
+		for ( unsigned int frame = 0; time < SIMULATED_SECONDS; ++frame ) {
+			float frameTime = frameTimes[frame % frameTimes.size()];
+			simulation.Simulate(frameTime);
+			time += frameTime;
+		}
+
+		return simulation.steps;
+	}
+
+	/// Every step of every render rate must give the same bits as steps of first rate.
+	void TestRenderRates() {
+		std::vector<std::vector<float>> rates = {
+			{ 1.0f / 60.0f }, { 1.0f / 30.0f }, { 1.0f / 144.0f }, { 1.0f / 240.0f },
+			{ 0.004f, 0.031f, 0.016f, 0.0007f, 0.05f, 0.011f, 0.019f }    ///< Uneven frames, some of them run no step.
+		};
+
+		std::vector<std::vector<float>> reference = Run(rates[0]);
+		GLVM_CHECK(reference.size() + 2 >= static_cast<unsigned int>(SIMULATED_SECONDS / core::FIXED_TIME_STEP));
+		GLVM_CHECK(reference.front() != reference.back());                 ///< Something really moved.
+		for ( unsigned int i = 1; i < rates.size(); ++i ) {
+			std::vector<std::vector<float>> steps = Run(rates[i]);
+			unsigned int commonSteps = reference.size() < steps.size() ? reference.size() : steps.size();
+			GLVM_CHECK(commonSteps + 2 >= reference.size());
+			bool identical = true;
+			for ( unsigned int step = 0; step < commonSteps; ++step )
+				identical = identical && steps[step].size() == reference[step].size() &&
+					std::memcmp(steps[step].data(), reference[step].data(), steps[step].size() * sizeof(float)) == 0;
+			GLVM_CHECK(identical);
+		}
+	}
+
+	/// Jump pressed and released inside of frame that ran no step still reaches next step.
+	void TestLatchedInput() {
+		core::CStack inputStack;
+		PressAndRelease(inputStack, core::EEvents::eJUMP, core::EEvents::eKEYRELEASE_JUMP);
+		GLVM_CHECK(inputStack.SearchElement(core::EEvents::eJUMP) == core::EEvents::eJUMP);
+		inputStack.ReleaseLatched();
+		GLVM_CHECK(inputStack.SearchElement(core::EEvents::eJUMP) == core::EEvents::eEmpty);
+
+		/// Held key stays after step and goes away on release without waiting.
+		core::CEvent event;
+		event.SetEvent(core::EEvents::eMOUSE_LEFT_BUTTON);
+		inputStack.ControlInput(event);
+		inputStack.ReleaseLatched();
+		GLVM_CHECK(inputStack.SearchElement(core::EEvents::eMOUSE_LEFT_BUTTON) == core::EEvents::eMOUSE_LEFT_BUTTON);
+		event.SetEvent(core::EEvents::eMOUSE_LEFT_BUTTON_RELEASE);
+		inputStack.ControlInput(event);
+		GLVM_CHECK(inputStack.SearchElement(core::EEvents::eMOUSE_LEFT_BUTTON) == core::EEvents::eEmpty);
+
+		/// Press, release and press again before step: key is held after step.
+		PressAndRelease(inputStack, core::EEvents::eJUMP, core::EEvents::eKEYRELEASE_JUMP);
+		event.SetEvent(core::EEvents::eJUMP);
+		inputStack.ControlInput(event);
+		inputStack.ReleaseLatched();
+		GLVM_CHECK(inputStack.SearchElement(core::EEvents::eJUMP) == core::EEvents::eJUMP);
+
+		/// Movement keys are not latched.
+		PressAndRelease(inputStack, core::EEvents::eMOVE_LEFT, core::EEvents::eKEYRELEASE_A);
+		GLVM_CHECK(inputStack.SearchElement(core::EEvents::eMOVE_LEFT) == core::EEvents::eEmpty);
+
+		/// Same through simulation: player standing on ground jumps after tap shorter than step.
+		CSimulation simulation;
+		for ( unsigned int frame = 0; frame < 720; ++frame )
+			simulation.Simulate(1.0f / 240.0f);                            ///< Three seconds to fall and land.
+
+		ecs::ComponentManager* componentManager = ecs::ComponentManager::GetInstance();
+		GLVM_CHECK(componentManager->GetComponent<const cm::collider>(simulation.player)->bGround_Collision_);
+		float height = componentManager->GetComponent<const cm::transform>(simulation.player)->tPosition[1];
+		simulation.Simulate(core::FIXED_TIME_STEP * 0.9f);
+		simulation.Simulate(0.0f);
+		PressAndRelease(simulation.inputStack, core::EEvents::eJUMP, core::EEvents::eKEYRELEASE_JUMP);
+		simulation.Simulate(core::FIXED_TIME_STEP * 0.05f);                 ///< Frame that runs no step.
+		for ( unsigned int frame = 0; frame < 4; ++frame )
+			simulation.Simulate(core::FIXED_TIME_STEP);
+
+		GLVM_CHECK(componentManager->GetComponent<const cm::transform>(simulation.player)->tPosition[1] > height);
+		GLVM_CHECK(simulation.inputStack.SearchElement(core::EEvents::eJUMP) == core::EEvents::eEmpty);
+	}
+}
+
+int main() {
+	TestRenderRates();
+	TestLatchedInput();
+
+	return GLVM::test::TestResult("FixedTimestepTest");
+}
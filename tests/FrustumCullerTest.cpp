@@ -0,0 +1,237 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "Test.hpp"
+#include "Frustum.hpp"
+#include "FrustumCuller.hpp"
+#include "VertexMathSimd.hpp"
+#include <chrono>
+#include <limits>
+#include <vector>
+
+namespace core = GLVM::core;
+namespace test = GLVM::test;
+
+namespace
+{
+	constexpr float CUBE_RANGE = 8.0f;
+	constexpr unsigned int RANDOM_SPHERES_NUMBER = 20000;
+	constexpr unsigned int BENCHMARK_FRAMES_NUMBER = 200;
+
+	/// Spheres in separate arrays of coordinates, like CFrustumCuller keeps them.
+	struct Spheres
+	{
+		std::vector<float> x;
+		std::vector<float> y;
+		std::vector<float> z;
+		std::vector<float> radii;
+
+		void Push(float x_, float y_, float z_, float radius) {
+			x.push_back(x_);
+			y.push_back(y_);
+			z.push_back(z_);
+			radii.push_back(radius);
+		}
+
+		unsigned int GetSize() const { return static_cast<unsigned int>(radii.size()); }
+	};
+
+	std::vector<unsigned char> CullScalar(const Spheres& spheres, const vec4* planes, unsigned int planesNumber) {
+		std::vector<unsigned char> visible(spheres.GetSize());
+		for ( unsigned int i = 0; i < spheres.GetSize(); ++i )
+			visible[i] = core::SphereInFrustum(vec4(spheres.x[i], spheres.y[i], spheres.z[i], spheres.radii[i]), planes, planesNumber);
+
+		return visible;
+	}
+
+	/// Kernel run on spheres from first on, so every sphere lands in 8-wide, 4-wide and scalar part for some first.
+	std::vector<unsigned char> CullSimd(const Spheres& spheres, unsigned int first, const vec4* planes, unsigned int planesNumber) {
+		std::vector<unsigned char> visible(spheres.GetSize() - first);
+		core::simd::CullSpheres(&spheres.x[first], &spheres.y[first], &spheres.z[first], &spheres.radii[first],
+								spheres.GetSize() - first, &planes[0][0], planesNumber, visible.data());
+
+		return visible;
+	}
+
+	/// Last row of model matrix is translation, like shaders read it.
+	void Translate(mat4& model, float x, float y, float z) {
+		model[3][0] = x;
+		model[3][1] = y;
+		model[3][2] = z;
+		model[3][3] = 1.0f;
+	}
+
+	void PerspectivePlanes(vec4* planes) {
+		mat4 view = lookAtRH<float>(vec3(0.0f, 0.0f, 0.0f), vec3(0.3f, 0.1f, -1.0f), vec3(0.0f, 1.0f, 0.0f));
+		mat4 projection = Perspective<float>(1.2f, 16.0f / 9.0f, 0.1f, 60.0f);
+		core::ExtractFrustumPlanes(view * projection, planes);
+	}
+
+	Spheres RandomSpheres(std::uint32_t seed, unsigned int count) {
+		test::CRandom random(seed);
+		Spheres spheres;
+		for ( unsigned int i = 0; i < count; ++i )
+			spheres.Push(random.Next(-70.0f, 70.0f), random.Next(-70.0f, 70.0f), random.Next(-70.0f, 70.0f), random.Next(0.1f, 6.0f));
+
+		return spheres;
+	}
+
+	/*! Sphere of radius 1 on axis of every plane of cube: inside, straddling, touching from outside,
+	 *  just outside and far outside. Distances exact in float, so result known without tolerance.
+	 */
+	void TestSpheresAgainstEachPlane() {
+		vec4 planes[core::FRUSTUM_PLANES_NUMBER];
+		core::ExtractRangePlanes(vec3(0.0f, 0.0f, 0.0f), CUBE_RANGE, planes);
+
+		const float offsets[] = {-3.0f, 0.5f, 1.0f, 1.25f, 3.0f};     ///< Distance of center outside of plane.
+		const unsigned char expected[] = {1, 1, 1, 0, 0};
+		Spheres spheres;
+		std::vector<unsigned char> expectedVisible;
+		for ( unsigned int p = 0; p < core::FRUSTUM_PLANES_NUMBER; ++p ) {
+			unsigned int axis = p / 2;
+			float side = p % 2 == 0 ? -1.0f : 1.0f;                       ///< Even plane keeps x >= -range, odd one x <= range.
+			for ( unsigned int i = 0; i < 5; ++i ) {
+				float center[3] = {0.0f, 0.0f, 0.0f};
+				center[axis] = side * (CUBE_RANGE + offsets[i]);
+				spheres.Push(center[0], center[1], center[2], 1.0f);
+				expectedVisible.push_back(expected[i]);
+			}
+		}
+
+		GLVM_CHECK(CullScalar(spheres, planes, core::FRUSTUM_PLANES_NUMBER) == expectedVisible);
+		bool same = true;
+		for ( unsigned int first = 0; first < 12; ++first ) {
+			std::vector<unsigned char> tail(expectedVisible.begin() + first, expectedVisible.end());
+			same = same && CullSimd(spheres, first, planes, core::FRUSTUM_PLANES_NUMBER) == tail;
+		}
+		GLVM_CHECK(same);
+
+		std::vector<unsigned char> visible(1, 2);                          ///< No planes, everything visible.
+		core::simd::CullSpheres(&spheres.x[3], &spheres.y[3], &spheres.z[3], &spheres.radii[3], 1, &planes[0][0], 0, visible.data());
+		GLVM_CHECK(visible[0] == 1);
+	}
+
+	/// Kernel gives bit-identical distances, so it must agree with scalar test on every sphere.
+	void TestSimdMatchesScalar() {
+		vec4 planes[core::FRUSTUM_PLANES_NUMBER];
+		PerspectivePlanes(planes);
+		Spheres spheres = RandomSpheres(5, RANDOM_SPHERES_NUMBER);
+		spheres.Push(0.0f, 0.0f, 0.0f, std::numeric_limits<float>::infinity());
+
+		std::vector<unsigned char> scalar = CullScalar(spheres, planes, core::FRUSTUM_PLANES_NUMBER);
+		bool same = true;
+		for ( unsigned int first = 0; first < 9; ++first ) {
+			std::vector<unsigned char> tail(scalar.begin() + first, scalar.end());
+			same = same && CullSimd(spheres, first, planes, core::FRUSTUM_PLANES_NUMBER) == tail;
+		}
+		GLVM_CHECK(same);
+		GLVM_CHECK(scalar.back() == 1);
+
+		unsigned int visibleNumber = 0;
+		for ( unsigned char visible : scalar )
+			visibleNumber += visible;
+		GLVM_CHECK(visibleNumber > 100 && visibleNumber < RANDOM_SPHERES_NUMBER / 2);   ///< Frustum neither empty nor everything.
+	}
+
+	/// Sphere test first, box test for objects inside by sphere, unbounded objects always kept.
+	void TestCuller() {
+		vec4 planes[core::FRUSTUM_PLANES_NUMBER];
+		core::ExtractRangePlanes(vec3(0.0f, 0.0f, 0.0f), CUBE_RANGE, planes);
+
+		core::MeshBounds cube;
+		cube.min = vec3(-1.0f, -1.0f, -1.0f);
+		cube.max = vec3(1.0f, 1.0f, 1.0f);
+		cube.sphere = vec4(0.0f, 0.0f, 0.0f, 1.0f);
+		core::MeshBounds rod;                                              ///< Long along x, sphere much bigger than box.
+		rod.min = vec3(-8.0f, -0.25f, -0.25f);
+		rod.max = vec3(8.0f, 0.25f, 0.25f);
+		rod.sphere = vec4(0.0f, 0.0f, 0.0f, 8.0f);
+
+		mat4 inside(1.0f);
+		mat4 scaledNearFace(2.0f);                                         ///< Sphere radius 2, center 1.5 outside of +x face.
+		Translate(scaledNearFace, 9.5f, 0.0f, 0.0f);
+		mat4 nearFace(1.0f);
+		Translate(nearFace, 9.5f, 0.0f, 0.0f);
+		mat4 rodOutside(1.0f);                                             ///< Sphere crosses +y face, box above it.
+		Translate(rodOutside, 0.0f, 10.0f, 0.0f);
+		mat4 farAway(1.0f);
+		Translate(farAway, 0.0f, 0.0f, -40.0f);
+
+		core::CFrustumCuller culler;
+		culler.BeginFrame(6);
+		culler.SetBounds(0, cube, inside);
+		culler.SetBounds(1, cube, scaledNearFace);
+		culler.SetBounds(2, cube, nearFace);
+		culler.SetBounds(3, rod, rodOutside);
+		culler.SetBounds(4, cube, farAway);
+		culler.SetUnbounded(5);
+
+		core::vector<unsigned int> visible;
+		culler.Cull(planes, core::FRUSTUM_PLANES_NUMBER, visible);
+		GLVM_CHECK(visible.GetSize() == 3 && visible[0] == 0 && visible[1] == 1 && visible[2] == 5);
+		GLVM_CHECK(culler.GetFrameStats().tested == 6 && culler.GetFrameStats().visible == 3 && culler.GetFrameStats().culled == 3);
+
+		culler.Cull(planes, 0, visible);                                   ///< Second frustum of the same frame.
+		GLVM_CHECK(visible.GetSize() == 6);
+		GLVM_CHECK(culler.GetFrameStats().tested == 12 && culler.GetTotalStats().visible == 9);
+		culler.BeginFrame(0);
+		culler.Cull(planes, core::FRUSTUM_PLANES_NUMBER, visible);
+		GLVM_CHECK(visible.GetSize() == 0 && culler.GetFrameStats().tested == 0);
+	}
+
+	/// 20k objects against camera frustum, scalar loop compared with kernel and with whole culler.
+	void BenchmarkCulling() {
+		vec4 planes[core::FRUSTUM_PLANES_NUMBER];
+		PerspectivePlanes(planes);
+		Spheres spheres = RandomSpheres(11, RANDOM_SPHERES_NUMBER);
+
+		core::MeshBounds bounds;
+		bounds.min = vec3(-1.0f, -1.0f, -1.0f);
+		bounds.max = vec3(1.0f, 1.0f, 1.0f);
+		bounds.sphere = vec4(0.0f, 0.0f, 0.0f, 1.7320508f);
+		core::CFrustumCuller culler;
+		culler.BeginFrame(RANDOM_SPHERES_NUMBER);
+		for ( unsigned int i = 0; i < RANDOM_SPHERES_NUMBER; ++i ) {
+			mat4 model(1.0f);
+			Translate(model, spheres.x[i], spheres.y[i], spheres.z[i]);
+			culler.SetBounds(i, bounds, model);
+		}
+
+		unsigned int scalarVisible = 0;
+		auto start = std::chrono::steady_clock::now();
+		for ( unsigned int frame = 0; frame < BENCHMARK_FRAMES_NUMBER; ++frame ) {
+			std::vector<unsigned char> visible = CullScalar(spheres, planes, core::FRUSTUM_PLANES_NUMBER);
+			scalarVisible += visible[frame];
+		}
+		auto kernelStart = std::chrono::steady_clock::now();
+		unsigned int kernelVisible = 0;
+		for ( unsigned int frame = 0; frame < BENCHMARK_FRAMES_NUMBER; ++frame ) {
+			std::vector<unsigned char> visible = CullSimd(spheres, 0, planes, core::FRUSTUM_PLANES_NUMBER);
+			kernelVisible += visible[frame];
+		}
+		auto cullerStart = std::chrono::steady_clock::now();
+		core::vector<unsigned int> visibleObjects;
+		for ( unsigned int frame = 0; frame < BENCHMARK_FRAMES_NUMBER; ++frame )
+			culler.Cull(planes, core::FRUSTUM_PLANES_NUMBER, visibleObjects);
+		auto end = std::chrono::steady_clock::now();
+
+		GLVM_CHECK(scalarVisible == kernelVisible);
+		std::printf("%u spheres: scalar %.3f ms, CullSpheres %.3f ms, CFrustumCuller with boxes %.3f ms per frustum, %u visible\n",
+					RANDOM_SPHERES_NUMBER,
+					std::chrono::duration<double, std::milli>(kernelStart - start).count() / BENCHMARK_FRAMES_NUMBER,
+					std::chrono::duration<double, std::milli>(cullerStart - kernelStart).count() / BENCHMARK_FRAMES_NUMBER,
+					std::chrono::duration<double, std::milli>(end - cullerStart).count() / BENCHMARK_FRAMES_NUMBER,
+					static_cast<unsigned int>(visibleObjects.GetSize()));
+	}
+}
+
+int main() {
+	TestSpheresAgainstEachPlane();
+	TestSimdMatchesScalar();
+	TestCuller();
+	BenchmarkCulling();
+
+	return test::TestResult("FrustumCullerTest");
+}
@@ -0,0 +1,539 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#define VK_NO_PROTOTYPES
+
+#include "Test.hpp"
+#include "Frustum.hpp"
+#include "FrustumCuller.hpp"
+#include <vulkan/vulkan.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <dlfcn.h>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace core = GLVM::core;
+namespace test = GLVM::test;
+
+namespace
+{
+	constexpr const char* CULLING_SHADER = "./VKshaders/cullingShaders/compCulling.spv";
+	constexpr unsigned int GROUP_SIZE = 64;                             ///< local_size_x of culling shader.
+	constexpr unsigned int MESHES_NUMBER = 8;
+	constexpr unsigned int INSTANCES_NUMBER = 5000;
+	constexpr float BOUNDARY_TOLERANCE = 1e-3f;                          ///< Spheres touching plane closer than that may go either way.
+
+	/// Same layouts as InstanceData, IndirectDraw and CullingConstants of Vulkan renderer.
+	struct alignas(16) InstanceData {
+		mat4     model;
+		vec3     ambient;
+		float    shininess;
+		uint32_t paletteOffset;
+		uint32_t group;
+		uint32_t padding[2];
+	};
+
+	struct alignas(16) IndirectDraw {
+		VkDrawIndexedIndirectCommand command;
+		uint32_t padding[3];
+		vec4     boundingSphere;
+	};
+
+	struct CullingConstants {
+		vec4     frustumPlanes[6];
+		uint32_t instancesNumber;
+		uint32_t cullingEnabled;
+	};
+
+	static_assert(sizeof(InstanceData) == 96 && sizeof(IndirectDraw) == 48 && sizeof(CullingConstants) == 104,
+				  "Test structs dont match culling shader");
+
+#define GLVM_VK_INSTANCE_FUNCTIONS(F) F(vkDestroyInstance) F(vkEnumeratePhysicalDevices) F(vkGetPhysicalDeviceQueueFamilyProperties) \
+	F(vkGetPhysicalDeviceMemoryProperties) F(vkCreateDevice) F(vkGetDeviceProcAddr)
+#define GLVM_VK_DEVICE_FUNCTIONS(F) F(vkDestroyDevice) F(vkGetDeviceQueue) F(vkCreateBuffer) F(vkDestroyBuffer) \
+	F(vkGetBufferMemoryRequirements) F(vkAllocateMemory) F(vkFreeMemory) F(vkBindBufferMemory) F(vkMapMemory) \
+	F(vkCreateShaderModule) F(vkDestroyShaderModule) F(vkCreateDescriptorSetLayout) F(vkDestroyDescriptorSetLayout) \
+	F(vkCreatePipelineLayout) F(vkDestroyPipelineLayout) F(vkCreateComputePipelines) F(vkDestroyPipeline) \
+	F(vkCreateDescriptorPool) F(vkDestroyDescriptorPool) F(vkAllocateDescriptorSets) F(vkUpdateDescriptorSets) \
+	F(vkCreateCommandPool) F(vkDestroyCommandPool) F(vkAllocateCommandBuffers) F(vkBeginCommandBuffer) \
+	F(vkEndCommandBuffer) F(vkCmdBindPipeline) F(vkCmdBindDescriptorSets) F(vkCmdPushConstants) F(vkCmdDispatch) \
+	F(vkQueueSubmit) F(vkQueueWaitIdle)
+#define GLVM_VK_DECLARE(name) PFN_##name name = nullptr;
+
+	struct HostBuffer {
+		VkBuffer       buffer = VK_NULL_HANDLE;
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		void*          mapped = nullptr;
+		VkDeviceSize   size = 0;
+	};
+
+	/*! Headless Vulkan device with culling pipeline of renderer: same shader, same set layout
+	 *  and push constants. Loader opened at run time, so test builds and skips on machines
+	 *  without Vulkan driver.
+	 */
+	class CCullingDevice
+	{
+		void* library = nullptr;
+		PFN_vkGetInstanceProcAddr vkGetInstanceProcAddr = nullptr;
+		PFN_vkCreateInstance vkCreateInstance = nullptr;
+		GLVM_VK_INSTANCE_FUNCTIONS(GLVM_VK_DECLARE)
+		GLVM_VK_DEVICE_FUNCTIONS(GLVM_VK_DECLARE)
+
+		VkInstance instance = VK_NULL_HANDLE;
+		VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+		VkDevice device = VK_NULL_HANDLE;
+		VkQueue queue = VK_NULL_HANDLE;
+		uint32_t queueFamily = 0;
+		VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+		VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+		VkPipeline pipeline = VK_NULL_HANDLE;
+		VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+		VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+		VkCommandPool commandPool = VK_NULL_HANDLE;
+		HostBuffer buffers[3];                                           ///< Instances, draws and visible instances.
+
+		bool CreateDevice() {
+			uint32_t devicesNumber = 0;
+			vkEnumeratePhysicalDevices(instance, &devicesNumber, nullptr);
+			std::vector<VkPhysicalDevice> devices(devicesNumber);
+			vkEnumeratePhysicalDevices(instance, &devicesNumber, devices.data());
+			for ( VkPhysicalDevice candidate : devices ) {
+				uint32_t familiesNumber = 0;
+				vkGetPhysicalDeviceQueueFamilyProperties(candidate, &familiesNumber, nullptr);
+				std::vector<VkQueueFamilyProperties> families(familiesNumber);
+				vkGetPhysicalDeviceQueueFamilyProperties(candidate, &familiesNumber, families.data());
+				for ( uint32_t i = 0; i < familiesNumber && physicalDevice == VK_NULL_HANDLE; ++i ) {
+					if ( families[i].queueFlags & VK_QUEUE_COMPUTE_BIT ) {
+						physicalDevice = candidate;
+						queueFamily = i;
+					}
+				}
+			}
+			if ( physicalDevice == VK_NULL_HANDLE )
+				return false;
+
+			float priority = 1.0f;
+			VkDeviceQueueCreateInfo queueInfo{};
+			queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+			queueInfo.queueFamilyIndex = queueFamily;
+			queueInfo.queueCount = 1;
+			queueInfo.pQueuePriorities = &priority;
+
+			VkDeviceCreateInfo deviceInfo{};
+			deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+			deviceInfo.queueCreateInfoCount = 1;
+			deviceInfo.pQueueCreateInfos = &queueInfo;
+			if ( vkCreateDevice(physicalDevice, &deviceInfo, nullptr, &device) != VK_SUCCESS )
+				return false;
+
+#define GLVM_VK_LOAD_DEVICE(name) name = reinterpret_cast<PFN_##name>(vkGetDeviceProcAddr(device, #name));
+			GLVM_VK_DEVICE_FUNCTIONS(GLVM_VK_LOAD_DEVICE)
+#undef GLVM_VK_LOAD_DEVICE
+			vkGetDeviceQueue(device, queueFamily, 0, &queue);
+
+			return true;
+		}
+
+		bool CreatePipeline() {
+			std::ifstream file(CULLING_SHADER, std::ios::binary);
+			std::vector<char> code((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+			if ( code.empty() || code.size() % 4 != 0 ) {
+				std::printf("GpuCullingTest: cant read %s\n", CULLING_SHADER);
+				return false;
+			}
+
+			std::vector<uint32_t> words(code.size() / 4);
+			std::memcpy(words.data(), code.data(), code.size());
+			VkShaderModuleCreateInfo moduleInfo{};
+			moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+			moduleInfo.codeSize = code.size();
+			moduleInfo.pCode = words.data();
+			VkShaderModule module;
+			if ( vkCreateShaderModule(device, &moduleInfo, nullptr, &module) != VK_SUCCESS )
+				return false;
+
+			VkDescriptorSetLayoutBinding bindings[3]{};
+			for ( uint32_t i = 0; i < 3; ++i ) {
+				bindings[i].binding = i;
+				bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+				bindings[i].descriptorCount = 1;
+				bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+			}
+			VkDescriptorSetLayoutCreateInfo layoutInfo{};
+			layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+			layoutInfo.bindingCount = 3;
+			layoutInfo.pBindings = bindings;
+			vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &setLayout);
+
+			VkPushConstantRange pushConstantRange{};
+			pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+			pushConstantRange.size = sizeof(CullingConstants);
+			VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+			pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+			pipelineLayoutInfo.setLayoutCount = 1;
+			pipelineLayoutInfo.pSetLayouts = &setLayout;
+			pipelineLayoutInfo.pushConstantRangeCount = 1;
+			pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+			vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &pipelineLayout);
+
+			VkComputePipelineCreateInfo pipelineInfo{};
+			pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+			pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+			pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+			pipelineInfo.stage.module = module;
+			pipelineInfo.stage.pName = "main";
+			pipelineInfo.layout = pipelineLayout;
+			VkResult result = vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline);
+			vkDestroyShaderModule(device, module, nullptr);
+
+			return result == VK_SUCCESS;
+		}
+
+		/// Host visible coherent memory, so test writes and reads buffers without flushes.
+		bool CreateBuffer(HostBuffer& hostBuffer, VkDeviceSize size) {
+			VkBufferCreateInfo bufferInfo{};
+			bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+			bufferInfo.size = size;
+			bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+			bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+			if ( vkCreateBuffer(device, &bufferInfo, nullptr, &hostBuffer.buffer) != VK_SUCCESS )
+				return false;
+
+			VkMemoryRequirements requirements;
+			vkGetBufferMemoryRequirements(device, hostBuffer.buffer, &requirements);
+			VkPhysicalDeviceMemoryProperties properties;
+			vkGetPhysicalDeviceMemoryProperties(physicalDevice, &properties);
+			VkMemoryPropertyFlags flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+			uint32_t memoryType = properties.memoryTypeCount;
+			for ( uint32_t i = 0; i < properties.memoryTypeCount && memoryType == properties.memoryTypeCount; ++i )
+				if ( (requirements.memoryTypeBits & (1u << i)) && (properties.memoryTypes[i].propertyFlags & flags) == flags )
+					memoryType = i;
+			if ( memoryType == properties.memoryTypeCount )
+				return false;
+
+			VkMemoryAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+			allocInfo.allocationSize = requirements.size;
+			allocInfo.memoryTypeIndex = memoryType;
+			if ( vkAllocateMemory(device, &allocInfo, nullptr, &hostBuffer.memory) != VK_SUCCESS )
+				return false;
+
+			vkBindBufferMemory(device, hostBuffer.buffer, hostBuffer.memory, 0);
+			hostBuffer.size = size;
+
+			return vkMapMemory(device, hostBuffer.memory, 0, VK_WHOLE_SIZE, 0, &hostBuffer.mapped) == VK_SUCCESS;
+		}
+
+	public:
+		/// False when there is no loader, no device with compute queue or shader is missing.
+		bool Init() {
+			library = dlopen("libvulkan.so.1", RTLD_NOW | RTLD_LOCAL);
+			if ( library == nullptr )
+				return false;
+
+			vkGetInstanceProcAddr = reinterpret_cast<PFN_vkGetInstanceProcAddr>(dlsym(library, "vkGetInstanceProcAddr"));
+			if ( vkGetInstanceProcAddr == nullptr )
+				return false;
+
+			vkCreateInstance = reinterpret_cast<PFN_vkCreateInstance>(vkGetInstanceProcAddr(VK_NULL_HANDLE, "vkCreateInstance"));
+			VkApplicationInfo appInfo{};
+			appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+			appInfo.pApplicationName = "GpuCullingTest";
+			appInfo.apiVersion = VK_API_VERSION_1_0;
+			VkInstanceCreateInfo instanceInfo{};
+			instanceInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+			instanceInfo.pApplicationInfo = &appInfo;
+			if ( vkCreateInstance == nullptr || vkCreateInstance(&instanceInfo, nullptr, &instance) != VK_SUCCESS )
+				return false;
+
+#define GLVM_VK_LOAD_INSTANCE(name) name = reinterpret_cast<PFN_##name>(vkGetInstanceProcAddr(instance, #name));
+			GLVM_VK_INSTANCE_FUNCTIONS(GLVM_VK_LOAD_INSTANCE)
+#undef GLVM_VK_LOAD_INSTANCE
+
+			return CreateDevice() && CreatePipeline();
+		}
+
+		~CCullingDevice() {
+			if ( device != VK_NULL_HANDLE ) {
+				for ( HostBuffer& hostBuffer : buffers ) {
+					vkDestroyBuffer(device, hostBuffer.buffer, nullptr);
+					vkFreeMemory(device, hostBuffer.memory, nullptr);
+				}
+				vkDestroyCommandPool(device, commandPool, nullptr);
+				vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+				vkDestroyPipeline(device, pipeline, nullptr);
+				vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+				vkDestroyDescriptorSetLayout(device, setLayout, nullptr);
+				vkDestroyDevice(device, nullptr);
+			}
+			if ( instance != VK_NULL_HANDLE )
+				vkDestroyInstance(instance, nullptr);
+			if ( library != nullptr )
+				dlclose(library);
+		}
+
+		/*! Record culling like recordInstanceCulling of renderer, wait for it and return draws with
+		 *  instance counts and visible instances written by shader.
+		 */
+		bool Run(const std::vector<InstanceData>& instances, std::vector<IndirectDraw>& draws, const CullingConstants& constants,
+				 std::vector<uint32_t>& visibleInstances) {
+			VkDeviceSize sizes[3] = { instances.size() * sizeof(InstanceData), draws.size() * sizeof(IndirectDraw),
+									  instances.size() * sizeof(uint32_t) };
+			for ( unsigned int i = 0; i < 3; ++i )
+				if ( buffers[i].buffer == VK_NULL_HANDLE && !CreateBuffer(buffers[i], sizes[i]) )
+					return false;
+
+			std::memcpy(buffers[0].mapped, instances.data(), sizes[0]);
+			std::memcpy(buffers[1].mapped, draws.data(), sizes[1]);
+
+			if ( descriptorPool == VK_NULL_HANDLE ) {
+				VkDescriptorPoolSize poolSize{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3 };
+				VkDescriptorPoolCreateInfo poolInfo{};
+				poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+				poolInfo.maxSets = 1;
+				poolInfo.poolSizeCount = 1;
+				poolInfo.pPoolSizes = &poolSize;
+				vkCreateDescriptorPool(device, &poolInfo, nullptr, &descriptorPool);
+
+				VkCommandPoolCreateInfo commandPoolInfo{};
+				commandPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+				commandPoolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+				commandPoolInfo.queueFamilyIndex = queueFamily;
+				vkCreateCommandPool(device, &commandPoolInfo, nullptr, &commandPool);
+			}
+
+			VkDescriptorSetAllocateInfo setInfo{};
+			setInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+			setInfo.descriptorPool = descriptorPool;
+			setInfo.descriptorSetCount = 1;
+			setInfo.pSetLayouts = &setLayout;
+			if ( descriptorSet == VK_NULL_HANDLE && vkAllocateDescriptorSets(device, &setInfo, &descriptorSet) != VK_SUCCESS )
+				return false;
+
+			VkDescriptorBufferInfo bufferInfos[3]{};
+			VkWriteDescriptorSet writes[3]{};
+			for ( uint32_t i = 0; i < 3; ++i ) {
+				bufferInfos[i].buffer = buffers[i].buffer;
+				bufferInfos[i].range = VK_WHOLE_SIZE;
+				writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+				writes[i].dstSet = descriptorSet;
+				writes[i].dstBinding = i;
+				writes[i].descriptorCount = 1;
+				writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+				writes[i].pBufferInfo = &bufferInfos[i];
+			}
+			vkUpdateDescriptorSets(device, 3, writes, 0, nullptr);
+
+			VkCommandBufferAllocateInfo commandBufferInfo{};
+			commandBufferInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			commandBufferInfo.commandPool = commandPool;
+			commandBufferInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			commandBufferInfo.commandBufferCount = 1;
+			VkCommandBuffer commandBuffer;
+			vkAllocateCommandBuffers(device, &commandBufferInfo, &commandBuffer);
+
+			VkCommandBufferBeginInfo beginInfo{};
+			beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+			beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+			vkBeginCommandBuffer(commandBuffer, &beginInfo);
+			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+			vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+			vkCmdDispatch(commandBuffer, (constants.instancesNumber + GROUP_SIZE - 1) / GROUP_SIZE, 1, 1);
+			vkEndCommandBuffer(commandBuffer);
+
+			VkSubmitInfo submitInfo{};
+			submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			submitInfo.commandBufferCount = 1;
+			submitInfo.pCommandBuffers = &commandBuffer;
+			if ( vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS || vkQueueWaitIdle(queue) != VK_SUCCESS )
+				return false;
+
+			std::memcpy(draws.data(), buffers[1].mapped, sizes[1]);
+			visibleInstances.assign(static_cast<const uint32_t*>(buffers[2].mapped),
+									static_cast<const uint32_t*>(buffers[2].mapped) + instances.size());
+
+			return true;
+		}
+	};
+
+	/// Instances of several meshes scattered around camera, every seventh one skinned.
+	struct Scene {
+		core::MeshBounds meshes[MESHES_NUMBER];
+		std::vector<InstanceData> instances;
+		std::vector<IndirectDraw> draws;
+		vec4 planes[core::FRUSTUM_PLANES_NUMBER];
+
+		explicit Scene(std::uint32_t seed) {
+			test::CRandom random(seed);
+			for ( unsigned int i = 0; i < MESHES_NUMBER; ++i ) {
+				core::MeshBounds& bounds = meshes[i];
+				float radiusSquared = 0.0f;
+				for ( unsigned int j = 0; j < 3; ++j ) {
+					float center = random.Next(-1.0f, 1.0f);
+					float extent = random.Next(0.1f, 2.0f);
+					bounds.min[j] = center - extent;
+					bounds.max[j] = center + extent;
+					bounds.sphere[j] = center;
+					radiusSquared += extent * extent;
+				}
+				bounds.sphere[3] = std::sqrt(radiusSquared);
+			}
+
+			instances.resize(INSTANCES_NUMBER);
+			std::vector<uint32_t> groupSizes(MESHES_NUMBER, 0);
+			for ( unsigned int i = 0; i < INSTANCES_NUMBER; ++i ) {
+				InstanceData& instance = instances[i];
+				instance = InstanceData{};
+				instance.model = mat4(0.0f);
+				for ( unsigned int axis = 0; axis < 3; ++axis ) {
+					float scale = random.Next(0.3f, 3.0f);
+					for ( unsigned int j = 0; j < 3; ++j )
+						instance.model[axis][j] = (axis == j ? scale : 0.0f) + random.Next(-0.3f, 0.3f);
+				}
+				for ( unsigned int j = 0; j < 3; ++j )
+					instance.model[3][j] = random.Next(-80.0f, 80.0f);
+				instance.model[3][3] = 1.0f;
+				instance.paletteOffset = i % 7 == 0 ? 1 + i : 0;
+				instance.group = static_cast<uint32_t>(random.Next(0.0f, static_cast<float>(MESHES_NUMBER))) % MESHES_NUMBER;
+				++groupSizes[instance.group];
+			}
+
+			/// Regions of visible instances of groups follow each other like firstInstance of renderer.
+			draws.resize(MESHES_NUMBER);
+			uint32_t firstInstance = 0;
+			for ( unsigned int i = 0; i < MESHES_NUMBER; ++i ) {
+				draws[i] = IndirectDraw{};
+				draws[i].command.indexCount = 36;
+				draws[i].command.firstInstance = firstInstance;
+				draws[i].boundingSphere = meshes[i].sphere;
+				firstInstance += groupSizes[i];
+			}
+
+			mat4 view = lookAtRH<float>(vec3(0.0f, 0.0f, 0.0f), vec3(0.3f, 0.1f, -1.0f), vec3(0.0f, 1.0f, 0.0f));
+			mat4 projection = Perspective<float>(1.2f, 16.0f / 9.0f, 0.1f, 60.0f);
+			core::ExtractFrustumPlanes(view * projection, planes);
+		}
+
+		/// Smallest signed distance of world sphere to planes, sphere is culled when it is below zero.
+		float SphereMargin(unsigned int i) const {
+			const InstanceData& instance = instances[i];
+			const vec4& sphere = meshes[instance.group].sphere;
+			vec4 center(sphere[0], sphere[1], sphere[2], 1.0f);
+			float world[3];
+			float scaleSquared = 0.0f;
+			for ( unsigned int j = 0; j < 3; ++j ) {
+				world[j] = 0.0f;
+				for ( unsigned int k = 0; k < 4; ++k )
+					world[j] += instance.model[k][j] * center[k];
+				scaleSquared = Max(scaleSquared, instance.model[j][0] * instance.model[j][0] + instance.model[j][1] * instance.model[j][1] +
+								   instance.model[j][2] * instance.model[j][2]);
+			}
+
+			float margin = 1e30f;
+			for ( unsigned int p = 0; p < core::FRUSTUM_PLANES_NUMBER; ++p )
+				margin = Min(margin, planes[p][0] * world[0] + planes[p][1] * world[1] + planes[p][2] * world[2] + planes[p][3] +
+							 sphere[3] * std::sqrt(scaleSquared));
+
+			return margin;
+		}
+	};
+
+	/// Instances written by shader, every group read from its region by its instance count.
+	std::vector<uint32_t> CollectGpuVisible(const std::vector<IndirectDraw>& draws, const std::vector<uint32_t>& visibleInstances, bool& inRange) {
+		std::vector<uint32_t> visible;
+		inRange = true;
+		for ( const IndirectDraw& draw : draws ) {
+			uint32_t first = draw.command.firstInstance;
+			inRange = inRange && first + draw.command.instanceCount <= visibleInstances.size();
+			for ( uint32_t i = 0; inRange && i < draw.command.instanceCount; ++i )
+				visible.push_back(visibleInstances[first + i]);
+		}
+		std::sort(visible.begin(), visible.end());
+
+		return visible;
+	}
+
+	/*! Shader tests only spheres, CFrustumCuller tests boxes of objects inside by sphere too. So
+	 *  shader must keep every object CFrustumCuller keeps, and drop exactly objects whose sphere
+	 *  is outside.
+	 */
+	void TestMatchesCpuCuller(CCullingDevice& device, std::uint32_t seed) {
+		Scene scene(seed);
+		core::CFrustumCuller culler;
+		culler.BeginFrame(INSTANCES_NUMBER);
+		for ( unsigned int i = 0; i < INSTANCES_NUMBER; ++i ) {
+			if ( scene.instances[i].paletteOffset != 0 )
+				culler.SetUnbounded(i);
+			else
+				culler.SetBounds(i, scene.meshes[scene.instances[i].group], scene.instances[i].model);
+		}
+		core::vector<unsigned int> cpuVisible;
+		culler.Cull(scene.planes, core::FRUSTUM_PLANES_NUMBER, cpuVisible);
+
+		CullingConstants constants{};
+		std::memcpy(constants.frustumPlanes, scene.planes, sizeof(constants.frustumPlanes));
+		constants.instancesNumber = INSTANCES_NUMBER;
+		constants.cullingEnabled = 1;
+		std::vector<IndirectDraw> draws = scene.draws;
+		std::vector<uint32_t> visibleInstances;
+		GLVM_CHECK(device.Run(scene.instances, draws, constants, visibleInstances));
+
+		bool inRange = false;
+		std::vector<uint32_t> gpuVisible = CollectGpuVisible(draws, visibleInstances, inRange);
+		GLVM_CHECK(inRange);
+		GLVM_CHECK(std::adjacent_find(gpuVisible.begin(), gpuVisible.end()) == gpuVisible.end());
+
+		bool groupsMatch = true;
+		for ( unsigned int group = 0; group < MESHES_NUMBER; ++group )
+			for ( uint32_t i = 0; i < draws[group].command.instanceCount; ++i )
+				groupsMatch = groupsMatch && scene.instances[visibleInstances[draws[group].command.firstInstance + i]].group == group;
+		GLVM_CHECK(groupsMatch);
+
+		bool keepsCpuVisible = true;
+		for ( unsigned int i = 0; i < cpuVisible.GetSize(); ++i )
+			keepsCpuVisible = keepsCpuVisible && std::binary_search(gpuVisible.begin(), gpuVisible.end(), cpuVisible[i]);
+		GLVM_CHECK(keepsCpuVisible);
+
+		bool spheresMatch = true;
+		unsigned int sphereVisible = 0;
+		for ( unsigned int i = 0; i < INSTANCES_NUMBER; ++i ) {
+			bool skinned = scene.instances[i].paletteOffset != 0;
+			float margin = scene.SphereMargin(i);
+			bool expected = skinned || margin >= 0.0f;
+			sphereVisible += expected;
+			if ( skinned || std::fabs(margin) > BOUNDARY_TOLERANCE )
+				spheresMatch = spheresMatch && std::binary_search(gpuVisible.begin(), gpuVisible.end(), i) == expected;
+		}
+		GLVM_CHECK(spheresMatch);
+		GLVM_CHECK(cpuVisible.GetSize() > 0 && cpuVisible.GetSize() < INSTANCES_NUMBER);    ///< Scene has both visible and culled objects.
+		std::printf("%u instances: %u visible by shader, %u by spheres, %u by CFrustumCuller\n", INSTANCES_NUMBER,
+					static_cast<unsigned int>(gpuVisible.size()), sphereVisible, static_cast<unsigned int>(cpuVisible.GetSize()));
+
+		/// Culling disabled, like gpuCulling off in renderer: every instance drawn once.
+		constants.cullingEnabled = 0;
+		draws = scene.draws;
+		GLVM_CHECK(device.Run(scene.instances, draws, constants, visibleInstances));
+		gpuVisible = CollectGpuVisible(draws, visibleInstances, inRange);
+		GLVM_CHECK(inRange && gpuVisible.size() == INSTANCES_NUMBER);
+		GLVM_CHECK(std::adjacent_find(gpuVisible.begin(), gpuVisible.end()) == gpuVisible.end());
+	}
+}
+
+int main() {
+	CCullingDevice device;
+	if ( !device.Init() ) {
+		std::printf("GpuCullingTest: no Vulkan device with compute queue, skipped\n");
+		return test::TestResult("GpuCullingTest");
+	}
+
+	TestMatchesCpuCuller(device, 3);
+	TestMatchesCpuCuller(device, 17);
+
+	return test::TestResult("GpuCullingTest");
+}
@@ -0,0 +1,247 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "Test.hpp"
+#include "HashMap.hpp"
+#include "JsonParser.hpp"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace json = GLVM::Core;
+
+namespace
+{
+	constexpr unsigned int RANDOM_OPERATIONS_NUMBER = 20000;
+	constexpr unsigned int BENCHMARK_KEYS_NUMBER = 100000;
+
+	std::string MakeKey(const char* prefix, long long number) {
+		std::string key(prefix);
+		key += std::to_string(number);
+		return key;
+	}
+
+	/// Same FNV-1a as map, so test can pick keys with known home slot.
+	std::size_t HomeSlot(std::string_view key, std::size_t capacity) {
+		std::uint64_t hash = 14695981039346656037ull;
+		for ( char symbol : key ) {
+			hash ^= static_cast<unsigned char>(symbol);
+			hash *= 1099511628211ull;
+		}
+
+		return static_cast<std::size_t>(hash) & (capacity - 1);
+	}
+
+	std::vector<std::string> KeysWithHome(std::size_t home, std::size_t capacity, unsigned int count, const char* prefix) {
+		std::vector<std::string> keys;
+		for ( unsigned int i = 0; keys.size() < count; ++i ) {
+			std::string key = MakeKey(prefix, i);
+			if ( HomeSlot(key, capacity) == home )
+				keys.push_back(key);
+		}
+
+		return keys;
+	}
+
+	std::vector<std::string> TableOrder(const HashMap<int>& map) {
+		std::vector<std::string> keys;
+		for ( const Node<int>& node : map )
+			keys.push_back(node.key_);
+
+		return keys;
+	}
+
+	/*! Three keys with home in last slot wrap around to start of table and push out key with home in
+	 *  first slot. Erase of first of them must shift the rest back across the end of table.
+	 */
+	void TestWraparoundErase() {
+		std::vector<std::string> tail = KeysWithHome(7, 8, 3, "tail");
+		std::vector<std::string> head = KeysWithHome(0, 8, 1, "head");
+
+		HashMap<int> map;
+		map.Reserve(4);
+		GLVM_CHECK(map.GetCapacity() == 8);
+		map[tail[0]] = 1;
+		map[tail[1]] = 2;
+		map[tail[2]] = 3;
+		map[head[0]] = 4;
+		GLVM_CHECK((TableOrder(map) == std::vector<std::string>{tail[1], tail[2], head[0], tail[0]}));
+
+		GLVM_CHECK(map.Erase(tail[0]));
+		GLVM_CHECK(!map.Erase(tail[0]));
+		GLVM_CHECK((TableOrder(map) == std::vector<std::string>{tail[2], head[0], tail[1]}));
+		GLVM_CHECK(map.GetSize() == 3);
+		GLVM_CHECK(map.Find(tail[0]) == nullptr);
+		GLVM_CHECK(*map.Find(tail[1]) == 2 && *map.Find(tail[2]) == 3 && *map.Find(head[0]) == 4);
+
+		GLVM_CHECK(map.Erase(tail[1]));                                    ///< Key at home slot after shift.
+		GLVM_CHECK((TableOrder(map) == std::vector<std::string>{head[0], tail[2]}));
+		GLVM_CHECK(*map.Find(head[0]) == 4 && *map.Find(tail[2]) == 3);
+	}
+
+	/// Table holds 7 keys per 8 slots, next insertion doubles it. Reserve rounds to the same limit.
+	void TestLoadLimit() {
+		HashMap<int> map;
+		bool sizes = true;
+		for ( int i = 0; i < 7; ++i )
+			map[MakeKey("key", i)] = i;
+		sizes = sizes && map.GetCapacity() == 8;
+		map["key7"] = 7;
+		sizes = sizes && map.GetCapacity() == 16;
+		for ( int i = 8; i < 14; ++i )
+			map[MakeKey("key", i)] = i;
+		sizes = sizes && map.GetCapacity() == 16;
+		map["key14"] = 14;
+		sizes = sizes && map.GetCapacity() == 32;
+		GLVM_CHECK(sizes);
+
+		bool values = true;
+		for ( int i = 0; i < 15; ++i )
+			values = values && *map.Find(MakeKey("key", i)) == i;
+		GLVM_CHECK(values);
+		GLVM_CHECK(map.GetSize() == 15);
+
+		HashMap<int> reserved;
+		reserved.Reserve(7);
+		GLVM_CHECK(reserved.GetCapacity() == 8);
+		reserved.Reserve(8);
+		GLVM_CHECK(reserved.GetCapacity() == 16);
+		reserved.Reserve(14);
+		GLVM_CHECK(reserved.GetCapacity() == 16);
+		reserved.Reserve(15);
+		GLVM_CHECK(reserved.GetCapacity() == 32);
+		reserved.Reserve(3);
+		GLVM_CHECK(reserved.GetCapacity() == 32);                          ///< Reserve never shrinks.
+	}
+
+	/// Random inserts and erases compared with std::unordered_map.
+	void TestAgainstStandardMap() {
+		GLVM::test::CRandom random(17);
+		HashMap<int> map;
+		std::unordered_map<std::string, int> reference;
+		bool same = true;
+		for ( unsigned int i = 0; i < RANDOM_OPERATIONS_NUMBER; ++i ) {
+			std::string key = MakeKey("k", static_cast<int>(random.Next(0.0f, 500.0f)));
+			if ( random.Next(0.0f, 1.0f) < 0.6f ) {
+				map[key] = static_cast<int>(i);
+				reference[key] = static_cast<int>(i);
+			} else
+				same = same && map.Erase(key) == (reference.erase(key) == 1);
+		}
+
+		same = same && map.GetSize() == reference.size();
+		for ( const auto& [key, value] : reference )
+			same = same && map.Find(key) != nullptr && *map.Find(key) == value;
+		GLVM_CHECK(same);
+
+		HashMap<int> copy(map);
+		HashMap<int> moved(std::move(map));
+		GLVM_CHECK(map.GetSize() == 0 && map.Find("k1") == nullptr);
+		GLVM_CHECK(moved.GetSize() == reference.size() && copy.GetSize() == reference.size());
+		map = copy;
+		GLVM_CHECK(map.GetSize() == reference.size());
+	}
+
+	/// Lookup by view into bigger buffer, key is not null-terminated and no string allocated.
+	void TestStringViewLookup() {
+		HashMap<int> map;
+		map["position"] = 1;
+		map["rotation"] = 2;
+		const char buffer[] = "positionrotationscale";
+		std::string_view position(buffer, 8);
+		std::string_view rotation(buffer + 8, 8);
+		std::string_view scale(buffer + 16, 5);
+
+		const HashMap<int>& constMap = map;
+		GLVM_CHECK(constMap.Find(position) != nullptr && *constMap.Find(position) == 1);
+		GLVM_CHECK(map.Contain(rotation) && *map.Find(rotation) == 2);
+		GLVM_CHECK(!map.Contain(scale));
+		GLVM_CHECK(!map.Contain(std::string_view(buffer, 7)));            ///< Prefix of key is other key.
+		map[scale] = 3;
+		GLVM_CHECK(map.Find("scale") != nullptr && *map.Find("scale") == 3);
+	}
+
+	/*! Moved value owns heap data of source, so rehash of object moves pointers instead of deep copy.
+	 *  Move assignment swaps, old value destroyed with source.
+	 */
+	void TestJsonValueMove() {
+		json::JsonValue text(std::string("name of skeleton"));
+		std::string* heapString = text.value.string;
+		json::JsonValue moved(std::move(text));
+		GLVM_CHECK(text.isInvalid());
+		GLVM_CHECK(moved.isString() && moved.value.string == heapString);
+
+		json::JsonValue number(5);
+		number = std::move(moved);
+		GLVM_CHECK(number.isString() && number.value.string == heapString);
+		GLVM_CHECK(moved.isInterger() && moved.value.iNumber == 5);
+
+		json::JsonValue object;
+		object.type = json::JSON_OBJECT;
+		object.value.object = new HashMap<json::JsonValue>();
+		(*object.value.object)["first"] = json::JsonValue(std::string("first string"));
+		std::string* firstString = object["first"].value.string;
+		for ( int i = 0; i < 100; ++i )                                    ///< Several rehashes.
+			object[MakeKey("key", i)] = json::JsonValue(i);
+		GLVM_CHECK(object["first"].value.string == firstString);
+		GLVM_CHECK(object["key99"].isInterger() && object["key99"].value.iNumber == 99);
+
+		json::JsonValue copy(object);
+		GLVM_CHECK(copy["first"].value.string != firstString && *copy["first"].value.string == "first string");
+		json::JsonValue target(1.5);
+		target = std::move(copy);
+		GLVM_CHECK(target.isObject() && target.value.object->GetSize() == 101);
+		GLVM_CHECK(copy.isFloat());
+	}
+
+	/// Insert and lookup of the same keys compared with std::unordered_map.
+	void BenchmarkLookup() {
+		std::vector<std::string> keys;
+		for ( unsigned int i = 0; i < BENCHMARK_KEYS_NUMBER; ++i )
+			keys.push_back(MakeKey("component", i));
+
+		auto start = std::chrono::steady_clock::now();
+		std::unordered_map<std::string, int> standard;
+		for ( unsigned int i = 0; i < BENCHMARK_KEYS_NUMBER; ++i )
+			standard[keys[i]] = static_cast<int>(i);
+		auto standardInserted = std::chrono::steady_clock::now();
+		long long standardSum = 0;
+		for ( unsigned int round = 0; round < 10; ++round )
+			for ( unsigned int i = 0; i < BENCHMARK_KEYS_NUMBER; ++i )
+				standardSum += standard.find(keys[i])->second;
+		auto ownStart = std::chrono::steady_clock::now();
+		HashMap<int> own;
+		for ( unsigned int i = 0; i < BENCHMARK_KEYS_NUMBER; ++i )
+			own[keys[i]] = static_cast<int>(i);
+		auto ownInserted = std::chrono::steady_clock::now();
+		long long ownSum = 0;
+		for ( unsigned int round = 0; round < 10; ++round )
+			for ( unsigned int i = 0; i < BENCHMARK_KEYS_NUMBER; ++i )
+				ownSum += *own.Find(keys[i]);
+		auto end = std::chrono::steady_clock::now();
+
+		GLVM_CHECK(ownSum == standardSum);
+		std::printf("%u keys: insert std::unordered_map %.3f ms, HashMap %.3f ms; %u lookups std::unordered_map %.3f ms, HashMap %.3f ms\n",
+					BENCHMARK_KEYS_NUMBER, std::chrono::duration<double, std::milli>(standardInserted - start).count(),
+					std::chrono::duration<double, std::milli>(ownInserted - ownStart).count(), 10 * BENCHMARK_KEYS_NUMBER,
+					std::chrono::duration<double, std::milli>(ownStart - standardInserted).count(),
+					std::chrono::duration<double, std::milli>(end - ownInserted).count());
+	}
+}
+
+int main() {
+	TestWraparoundErase();
+	TestLoadLimit();
+	TestAgainstStandardMap();
+	TestStringViewLookup();
+	TestJsonValueMove();
+	BenchmarkLookup();
+
+	return GLVM::test::TestResult("HashMapTest");
+}
@@ -0,0 +1,163 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "Test.hpp"
+#include "JobSystem.hpp"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace core = GLVM::core;
+
+namespace
+{
+	constexpr unsigned int STRESS_THREADS_NUMBER = 4;
+	constexpr unsigned int STRESS_ROUNDS = 200;
+	constexpr unsigned int SCALING_ELEMENTS_NUMBER = 1 << 20;
+
+	/// Every index of range must be visited exactly once, for ranges smaller, equal and bigger than grain.
+	void TestParallelForCoverage(core::CJobSystem* jobSystem) {
+		const unsigned int counts[] = {0, 1, 7, 64, 65, 1000, 4099};
+		const unsigned int grains[] = {0, 1, 3, 64, 5000};
+		bool covered = true;
+		bool piecesInRange = true;
+		for ( unsigned int count : counts ) {
+			for ( unsigned int grain : grains ) {
+				std::vector<std::atomic<unsigned int>> visits(count);
+				jobSystem->ParallelFor(count, grain, [&](unsigned int begin, unsigned int end) {
+					if ( begin >= end || end > count )
+						piecesInRange = false;
+					for ( unsigned int i = begin; i < end; ++i )
+						visits[i].fetch_add(1);
+				});
+
+				for ( unsigned int i = 0; i < count; ++i )
+					covered = covered && visits[i] == 1;
+			}
+		}
+
+		GLVM_CHECK(covered);
+		GLVM_CHECK(piecesInRange);
+	}
+
+	/// Jobs finish after their dependencies, diamond joins both branches.
+	void TestDependencies(core::CJobSystem* jobSystem) {
+		std::atomic<unsigned int> step{0};
+		unsigned int rootStep = 0, leftStep = 0, rightStep = 0, joinStep = 0;
+		core::JobHandle root = jobSystem->Schedule([&]() { rootStep = ++step; });
+		core::JobHandle left = jobSystem->Schedule([&]() { leftStep = ++step; }, {root});
+		core::JobHandle right = jobSystem->Schedule([&]() { rightStep = ++step; }, {root});
+		core::JobHandle join = jobSystem->Schedule([&]() { joinStep = ++step; }, {left, right});
+		jobSystem->Wait(join);
+
+		GLVM_CHECK(rootStep == 1);
+		GLVM_CHECK(leftStep > rootStep && rightStep > rootStep);
+		GLVM_CHECK(joinStep == 4);
+
+		core::JobHandle late = jobSystem->Schedule([]() {}, {join});      ///< Dependency already finished.
+		jobSystem->Wait(late);
+		GLVM_CHECK(late->finished);
+	}
+
+	/// Waiting inside of job runs other jobs, so nesting deeper than workers number cant deadlock.
+	void TestNestedWaits(core::CJobSystem* jobSystem) {
+		std::atomic<unsigned int> leaves{0};
+		std::vector<core::JobHandle> outer;
+		for ( unsigned int i = 0; i < 8; ++i ) {
+			outer.push_back(jobSystem->Schedule([&]() {
+				std::vector<core::JobHandle> inner;
+				for ( unsigned int j = 0; j < 8; ++j )
+					inner.push_back(jobSystem->Schedule([&]() { leaves.fetch_add(1); }));
+				for ( unsigned int j = 0; j < inner.size(); ++j )
+					jobSystem->Wait(inner[j]);
+			}));
+		}
+
+		for ( unsigned int i = 0; i < outer.size(); ++i )
+			jobSystem->Wait(outer[i]);
+		GLVM_CHECK(leaves == 64);
+
+		std::atomic<unsigned int> nestedElements{0};
+		jobSystem->ParallelFor(16, 1, [&](unsigned int begin, unsigned int end) {
+			for ( unsigned int i = begin; i < end; ++i )
+				jobSystem->ParallelFor(100, 10, [&](unsigned int innerBegin, unsigned int innerEnd) {
+					nestedElements.fetch_add(innerEnd - innerBegin);
+				});
+		});
+		GLVM_CHECK(nestedElements == 1600);
+	}
+
+	/*! Threads outside of pool schedule chains and parallel loops at the same time, all of them share
+	 *  one queue. Built with thread sanitizer as well by "make test".
+	 */
+	void TestStress(core::CJobSystem* jobSystem) {
+		std::atomic<unsigned int> chainSteps{0};
+		std::atomic<unsigned int> loopElements{0};
+		std::atomic<bool> ordered{true};
+		std::vector<std::thread> threads;
+		for ( unsigned int t = 0; t < STRESS_THREADS_NUMBER; ++t ) {
+			threads.emplace_back([&]() {
+				for ( unsigned int round = 0; round < STRESS_ROUNDS; ++round ) {
+					unsigned int last = 0;
+					core::JobHandle previous = jobSystem->Schedule([&]() { last = 1; chainSteps.fetch_add(1); });
+					for ( unsigned int step = 2; step <= 4; ++step ) {
+						previous = jobSystem->Schedule([&, step]() {
+							if ( last != step - 1 )
+								ordered = false;
+							last = step;
+							chainSteps.fetch_add(1);
+						}, {previous});
+					}
+
+					jobSystem->ParallelFor(256, 16, [&](unsigned int begin, unsigned int end) {
+						loopElements.fetch_add(end - begin);
+					});
+					jobSystem->Wait(previous);
+				}
+			});
+		}
+
+		for ( unsigned int t = 0; t < threads.size(); ++t )
+			threads[t].join();
+
+		GLVM_CHECK(ordered);
+		GLVM_CHECK(chainSteps == STRESS_THREADS_NUMBER * STRESS_ROUNDS * 4);
+		GLVM_CHECK(loopElements == STRESS_THREADS_NUMBER * STRESS_ROUNDS * 256);
+		GLVM_CHECK(!jobSystem->RunPendingJob());                          ///< Nothing left behind.
+	}
+
+	/// Same work on calling thread alone and through ParallelFor, speedup depends on cores of machine.
+	void BenchmarkScaling(core::CJobSystem* jobSystem) {
+		std::vector<float> values(SCALING_ELEMENTS_NUMBER);
+		auto work = [&](unsigned int begin, unsigned int end) {
+			for ( unsigned int i = begin; i < end; ++i )
+				values[i] = std::sqrt(static_cast<float>(i)) * std::sin(static_cast<float>(i));
+		};
+
+		auto start = std::chrono::steady_clock::now();
+		work(0, SCALING_ELEMENTS_NUMBER);
+		auto middle = std::chrono::steady_clock::now();
+		jobSystem->ParallelFor(SCALING_ELEMENTS_NUMBER, 4096, work);
+		auto end = std::chrono::steady_clock::now();
+
+		double serial = std::chrono::duration<double, std::milli>(middle - start).count();
+		double parallel = std::chrono::duration<double, std::milli>(end - middle).count();
+		std::printf("%u workers: %u elements serial %.3f ms, ParallelFor %.3f ms, speedup %.2f\n", jobSystem->GetWorkersNumber(),
+					SCALING_ELEMENTS_NUMBER, serial, parallel, serial / parallel);
+	}
+}
+
+int main() {
+	core::CJobSystem* jobSystem = core::CJobSystem::GetInstance();
+	TestParallelForCoverage(jobSystem);
+	TestDependencies(jobSystem);
+	TestNestedWaits(jobSystem);
+	TestStress(jobSystem);
+	BenchmarkScaling(jobSystem);
+
+	return GLVM::test::TestResult("JobSystemTest");
+}
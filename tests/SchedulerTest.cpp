@@ -0,0 +1,173 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "Test.hpp"
+#include "Components/MoveComponent.hpp"
+#include "Components/TransformComponent.hpp"
+#include "ComponentManager.hpp"
+#include "EntityManager.hpp"
+#include "JobSystem.hpp"
+#include "SystemManager.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace cm = GLVM::ecs::components;
+
+namespace
+{
+	constexpr unsigned int FRAMES_NUMBER = 20;
+
+	/// Counters shared by probes, every probe holds them for the whole update.
+	struct ProbeCounters
+	{
+		std::atomic<int> transformWriters{0};
+		std::atomic<int> runningSystems{0};
+		std::atomic<int> maxRunningSystems{0};
+		std::atomic<bool> writersOverlap{false};
+	};
+
+	/// System that writes one component type and stays inside update long enough to meet other systems.
+	template <typename componentType>
+	class CProbeSystem : public GLVM::ecs::ISystem
+	{
+		ProbeCounters& counters;
+
+	public:
+		unsigned int updatesNumber = 0;
+
+		explicit CProbeSystem(ProbeCounters& counters_) : counters(counters_) {
+			DeclareWrite<componentType>();
+		}
+
+		void Update() override {
+			constexpr bool writesTransform = std::is_same_v<componentType, cm::transform>;
+			if constexpr ( writesTransform ) {
+				if ( counters.transformWriters.fetch_add(1) != 0 )
+					counters.writersOverlap = true;
+			}
+
+			int running = counters.runningSystems.fetch_add(1) + 1;
+			int maxRunning = counters.maxRunningSystems.load();
+			while ( running > maxRunning && !counters.maxRunningSystems.compare_exchange_weak(maxRunning, running) ) {}
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+			counters.runningSystems.fetch_sub(1);
+			if constexpr ( writesTransform )
+				counters.transformWriters.fetch_sub(1);
+			++updatesNumber;
+		}
+	};
+
+	/// Record one new entity with transform every update, it must appear only after stage is finished.
+	class CSpawnerSystem : public GLVM::ecs::ISystem
+	{
+	public:
+		CSpawnerSystem() {
+			DeclareRead<cm::transform>();
+		}
+
+		void Update() override {
+			Entity entity = commandBuffer.CreateEntity();
+			commandBuffer.AddComponent<cm::transform>(entity);
+		}
+	};
+
+	/// Count entities with transform, shares stage with spawner.
+	class CCounterSystem : public GLVM::ecs::ISystem
+	{
+	public:
+		std::vector<unsigned int> counts;
+
+		CCounterSystem() {
+			DeclareRead<cm::transform>();
+		}
+
+		void Update() override {
+			counts.push_back(GLVM::ecs::ComponentManager::GetInstance()->GetEntityContainer<cm::transform>()->GetSize());
+		}
+	};
+
+	/// Remove every entity with transform, so both modes start from the same world.
+	void ClearTransforms() {
+		GLVM::ecs::ComponentManager* componentManager = GLVM::ecs::ComponentManager::GetInstance();
+		GLVM::core::vector<Entity> entities = *componentManager->GetEntityContainer<cm::transform>();
+		for ( unsigned int i = 0; i < entities.GetSize(); ++i )
+			GLVM::ecs::EntityManager::GetInstance()->RemoveEntity(entities[i], componentManager);
+	}
+
+	/// Frames of one mode, counter sees what spawner recorded on earlier frames only.
+	std::vector<unsigned int> CountSpawned(bool serialExecution, CCounterSystem& counter) {
+		GLVM::ecs::CSystemManager* systemManager = GLVM::ecs::CSystemManager::GetInstance();
+		ClearTransforms();
+		counter.counts.clear();
+		systemManager->serialExecution = serialExecution;
+		for ( unsigned int frame = 0; frame < FRAMES_NUMBER; ++frame )
+			systemManager->Update();
+
+		return counter.counts;
+	}
+}
+
+int main() {
+	GLVM::ecs::CSystemManager* systemManager = GLVM::ecs::CSystemManager::GetInstance();
+	ProbeCounters counters;
+	CProbeSystem<cm::transform> firstWriter(counters);
+	CProbeSystem<cm::transform> secondWriter(counters);
+	CProbeSystem<cm::move> independentWriter(counters);
+	systemManager->ActivateSystem(&firstWriter);
+	systemManager->ActivateSystem(&secondWriter);
+	systemManager->ActivateSystem(&independentWriter);
+
+	GLVM_CHECK(firstWriter.ConflictsWith(secondWriter));
+	GLVM_CHECK(!firstWriter.ConflictsWith(independentWriter));
+	GLVM_CHECK(systemManager->BuildSchedule() == 2);
+	GLVM_CHECK(systemManager->systemStages[0] == 0);
+	GLVM_CHECK(systemManager->systemStages[1] == 1);
+	GLVM_CHECK(systemManager->systemStages[2] == 0);
+
+	/// Parallel mode: writers of transform on different stages, independent system shares stage with first one.
+	systemManager->serialExecution = false;
+	for ( unsigned int frame = 0; frame < FRAMES_NUMBER; ++frame )
+		systemManager->Update();
+
+	GLVM_CHECK(!counters.writersOverlap);
+	GLVM_CHECK(firstWriter.updatesNumber == FRAMES_NUMBER);
+	GLVM_CHECK(secondWriter.updatesNumber == FRAMES_NUMBER);
+	GLVM_CHECK(independentWriter.updatesNumber == FRAMES_NUMBER);
+	if ( GLVM::core::CJobSystem::GetInstance()->GetWorkersNumber() > 0 )
+		GLVM_CHECK(counters.maxRunningSystems > 1);                      ///< Probes really can meet, so no overlap above is not just luck.
+
+	/// Deterministic mode: nothing runs at the same time.
+	counters.maxRunningSystems = 0;
+	systemManager->serialExecution = true;
+	for ( unsigned int frame = 0; frame < FRAMES_NUMBER; ++frame )
+		systemManager->Update();
+
+	GLVM_CHECK(!counters.writersOverlap);
+	GLVM_CHECK(counters.maxRunningSystems == 1);
+	GLVM_CHECK(firstWriter.updatesNumber == 2 * FRAMES_NUMBER);
+	GLVM_CHECK(secondWriter.updatesNumber == 2 * FRAMES_NUMBER);
+	GLVM_CHECK(independentWriter.updatesNumber == 2 * FRAMES_NUMBER);
+
+	/// Both modes play command buffers back once per stage, so systems see the same world.
+	CSpawnerSystem spawner;
+	CCounterSystem counter;
+	systemManager->ActivateSystem(&spawner);
+	systemManager->ActivateSystem(&counter);
+	GLVM_CHECK(systemManager->BuildSchedule() == 3);
+	GLVM_CHECK(systemManager->systemStages[3] == systemManager->systemStages[4]);
+
+	std::vector<unsigned int> parallelCounts = CountSpawned(false, counter);
+	std::vector<unsigned int> serialCounts = CountSpawned(true, counter);
+	GLVM_CHECK(parallelCounts.size() == FRAMES_NUMBER);
+	GLVM_CHECK(parallelCounts == serialCounts);
+	GLVM_CHECK(serialCounts.back() == FRAMES_NUMBER - 1);
+
+	return GLVM::test::TestResult("SchedulerTest");
+}
@@ -0,0 +1,400 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "Test.hpp"
+#include "SkeletalAnimation.hpp"
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+namespace core = GLVM::core;
+namespace test = GLVM::test;
+
+namespace
+{
+	constexpr unsigned int JOINTS_NUMBER = 18;
+	constexpr unsigned int PALETTE_SIZE = 20;                            ///< Larger than skeleton, rest filled by unit matrices.
+	constexpr unsigned int ACTORS_NUMBER = 1000;
+	constexpr unsigned int FRAMES_NUMBER = 20;
+
+	/// Plain 4x4 matrix of glTF column vector convention, m[row][column].
+	struct Matrix
+	{
+		double m[4][4] = {};
+
+		static Matrix Unit() {
+			Matrix result;
+			for ( int i = 0; i < 4; ++i )
+				result.m[i][i] = 1.0;
+			return result;
+		}
+
+		Matrix operator*(const Matrix& other) const {
+			Matrix result;
+			for ( int row = 0; row < 4; ++row )
+				for ( int column = 0; column < 4; ++column )
+					for ( int k = 0; k < 4; ++k )
+						result.m[row][column] += m[row][k] * other.m[k][column];
+			return result;
+		}
+	};
+
+	/// Translation * rotation * scale, quaternion is x, y, z, w as glTF stores it.
+	Matrix MakeTRS(const double* translation, const double* rotation, const double* scale) {
+		double x = rotation[0], y = rotation[1], z = rotation[2], w = rotation[3];
+		double norm = std::sqrt(x * x + y * y + z * z + w * w);
+		x /= norm; y /= norm; z /= norm; w /= norm;
+		double r[3][3] = {
+			{ 1 - 2 * (y * y + z * z), 2 * (x * y - z * w), 2 * (x * z + y * w) },
+			{ 2 * (x * y + z * w), 1 - 2 * (x * x + z * z), 2 * (y * z - x * w) },
+			{ 2 * (x * z - y * w), 2 * (y * z + x * w), 1 - 2 * (x * x + y * y) }
+		};
+
+		Matrix result = Matrix::Unit();
+		for ( int row = 0; row < 3; ++row ) {
+			for ( int column = 0; column < 3; ++column )
+				result.m[row][column] = r[row][column] * scale[column];
+			result.m[row][3] = translation[row];
+		}
+
+		return result;
+	}
+
+	/// Keyframes of one channel, kept by test to sample reference pose as glTF specification defines.
+	struct Channel
+	{
+		unsigned int joint;
+		core::EAnimationPath path;
+		core::EInterpolation interpolation;
+		std::vector<float> times;
+		std::vector<float> values;
+	};
+
+	struct Joint
+	{
+		int parent = -1;
+		double translation[3] = { 0.0, 0.0, 0.0 };
+		double rotation[4] = { 0.0, 0.0, 0.0, 1.0 };
+		double scale[3] = { 1.0, 1.0, 1.0 };
+		Matrix inverseBind = Matrix::Unit();
+	};
+
+	/// Skeleton described twice: as test data for reference and as engine skeleton.
+	struct Rig
+	{
+		std::vector<Joint> joints;
+		std::vector<Channel> channels;
+		core::CSkeletalAnimation skeleton;
+	};
+
+	void SampleReference(const Channel& channel, float time, double* result) {
+		unsigned int components = channel.path == core::eROTATION ? 4 : 3;
+		unsigned int stride = channel.interpolation == core::eCUBICSPLINE ? components * 3 : components;
+		unsigned int offset = channel.interpolation == core::eCUBICSPLINE ? components : 0;
+		unsigned int last = channel.times.size() - 1;
+		auto value = [&](unsigned int keyframe, unsigned int c) { return static_cast<double>(channel.values[keyframe * stride + offset + c]); };
+		if ( time <= channel.times[0] || time >= channel.times[last] ) {
+			unsigned int keyframe = time <= channel.times[0] ? 0 : last;
+			for ( unsigned int c = 0; c < components; ++c )
+				result[c] = value(keyframe, c);
+			return;
+		}
+
+		unsigned int k = 0;
+		while ( channel.times[k + 1] <= time )
+			++k;
+
+		double duration = channel.times[k + 1] - channel.times[k];
+		double t = (time - channel.times[k]) / duration;
+		if ( channel.interpolation == core::eSTEP ) {
+			for ( unsigned int c = 0; c < components; ++c )
+				result[c] = value(k, c);
+		} else if ( channel.interpolation == core::eCUBICSPLINE ) {
+			double t2 = t * t;
+			double t3 = t2 * t;
+			for ( unsigned int c = 0; c < components; ++c ) {
+				double outTangent = channel.values[k * stride + components * 2 + c];
+				double inTangent = channel.values[(k + 1) * stride + c];
+				result[c] = (2 * t3 - 3 * t2 + 1) * value(k, c) + (t3 - 2 * t2 + t) * duration * outTangent +
+					(-2 * t3 + 3 * t2) * value(k + 1, c) + (t3 - t2) * duration * inTangent;
+			}
+		} else if ( channel.path == core::eROTATION ) {
+			double dot = 0.0;
+			double to[4];
+			for ( unsigned int c = 0; c < 4; ++c )
+				dot += value(k, c) * value(k + 1, c);
+			for ( unsigned int c = 0; c < 4; ++c )
+				to[c] = dot < 0.0 ? -value(k + 1, c) : value(k + 1, c);
+			double angle = std::acos(std::fabs(dot) > 1.0 ? 1.0 : std::fabs(dot));
+			double fromWeight = 1.0 - t;
+			double toWeight = t;
+			if ( angle > 1e-6 ) {
+				fromWeight = std::sin((1.0 - t) * angle) / std::sin(angle);
+				toWeight = std::sin(t * angle) / std::sin(angle);
+			}
+			for ( unsigned int c = 0; c < 4; ++c )
+				result[c] = fromWeight * value(k, c) + toWeight * to[c];
+		} else {
+			for ( unsigned int c = 0; c < components; ++c )
+				result[c] = value(k, c) + (value(k + 1, c) - value(k, c)) * t;
+		}
+
+		if ( channel.path == core::eROTATION ) {
+			double norm = std::sqrt(result[0] * result[0] + result[1] * result[1] + result[2] * result[2] + result[3] * result[3]);
+			for ( unsigned int c = 0; c < 4; ++c )
+				result[c] /= norm;
+		}
+	}
+
+	/// Joint matrices of glTF convention, world of joint is parent world * local, joint matrix is world * inverse bind.
+	std::vector<Matrix> ReferencePose(const Rig& rig, float time) {
+		std::vector<Joint> joints = rig.joints;
+		for ( const Channel& channel : rig.channels ) {
+			Joint& joint = joints[channel.joint];
+			double* target = channel.path == core::eTRANSLATION ? joint.translation : channel.path == core::eROTATION ? joint.rotation : joint.scale;
+			SampleReference(channel, time, target);
+		}
+
+		std::vector<Matrix> world(joints.size());
+		std::vector<Matrix> palette(joints.size());
+		for ( unsigned int i = 0; i < joints.size(); ++i ) {                ///< Parents go before children in test rigs.
+			Matrix local = MakeTRS(joints[i].translation, joints[i].rotation, joints[i].scale);
+			world[i] = joints[i].parent >= 0 ? world[joints[i].parent] * local : local;
+			palette[i] = world[i] * joints[i].inverseBind;
+		}
+
+		return palette;
+	}
+
+	/// Largest difference relative to element, engine matrix is transposed reference matrix.
+	double PoseError(const std::vector<Matrix>& reference, const mat4* palette) {
+		double error = 0.0;
+		for ( unsigned int joint = 0; joint < reference.size(); ++joint )
+			for ( int row = 0; row < 4; ++row )
+				for ( int column = 0; column < 4; ++column ) {
+					double exact = reference[joint].m[column][row];
+					double difference = std::fabs(palette[joint][row][column] - exact) / std::max(1.0, std::fabs(exact));
+					error = std::max(error, difference);
+				}
+
+		return error;
+	}
+
+	bool RestIsUnit(const mat4* palette, unsigned int jointsNumber) {
+		bool unit = true;
+		for ( unsigned int joint = jointsNumber; joint < PALETTE_SIZE; ++joint )
+			for ( int row = 0; row < 4; ++row )
+				for ( int column = 0; column < 4; ++column )
+					unit = unit && palette[joint][row][column] == (row == column ? 1.0f : 0.0f);
+
+		return unit;
+	}
+
+	void RandomQuaternion(test::CRandom& random, float maximumAngle, float* quaternion) {
+		float axis[3] = { random.Next(-1.0f, 1.0f), random.Next(-1.0f, 1.0f), random.Next(-1.0f, 1.0f) };
+		float length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]) + 1e-6f;
+		float angle = random.Next(-maximumAngle, maximumAngle);
+		for ( int c = 0; c < 3; ++c )
+			quaternion[c] = axis[c] / length * std::sin(angle / 2);
+		quaternion[3] = std::cos(angle / 2);
+	}
+
+	/*! Tree of joints with random rest pose and inverse bind matrices. Every joint gets translation,
+	 *  rotation and scale channels, half of them on second timeline. Motion between keyframes
+	 *  limited by maximumStepAngle, so dense keyframes give smooth clip.
+	 */
+	Rig MakeRig(std::uint32_t seed, core::EInterpolation interpolation, unsigned int keyframesNumber, float maximumStepAngle) {
+		test::CRandom random(seed);
+		Rig rig;
+		for ( unsigned int i = 0; i < JOINTS_NUMBER; ++i ) {
+			Joint joint;
+			joint.parent = i == 0 ? -1 : static_cast<int>(random.Next(0.0f, static_cast<float>(i) - 0.001f));
+			for ( int c = 0; c < 3; ++c )
+				joint.translation[c] = random.Next(-1.0f, 1.0f);
+			float restRotation[4];
+			RandomQuaternion(random, static_cast<float>(PI), restRotation);
+			for ( int c = 0; c < 4; ++c )
+				joint.rotation[c] = restRotation[c];
+
+			float bindRotation[4];
+			RandomQuaternion(random, static_cast<float>(PI), bindRotation);
+			double bindTranslation[3] = { random.Next(-2.0f, 2.0f), random.Next(-2.0f, 2.0f), random.Next(-2.0f, 2.0f) };
+			double bindRotationValues[4] = { bindRotation[0], bindRotation[1], bindRotation[2], bindRotation[3] };
+			double bindScale[3] = { 1.0, 1.0, 1.0 };
+			joint.inverseBind = MakeTRS(bindTranslation, bindRotationValues, bindScale);
+			rig.joints.push_back(joint);
+
+			mat4 inverseBind(1.0f);
+			for ( int row = 0; row < 4; ++row )
+				for ( int column = 0; column < 4; ++column )
+					inverseBind[row][column] = static_cast<float>(joint.inverseBind.m[column][row]);
+			rig.skeleton.AddJoint(inverseBind, vec3(joint.translation[0], joint.translation[1], joint.translation[2]),
+								  Quaternion{ restRotation[3], restRotation[0], restRotation[1], restRotation[2] }, vec3(1.0f, 1.0f, 1.0f));
+		}
+
+		for ( unsigned int i = 0; i < JOINTS_NUMBER; ++i )
+			rig.skeleton.SetParent(i, rig.joints[i].parent);
+
+		for ( unsigned int i = 0; i < JOINTS_NUMBER; ++i ) {
+			unsigned int jointKeyframes = i % 2 == 0 ? keyframesNumber : keyframesNumber * 2 / 3 + 1;
+			for ( core::EAnimationPath path : { core::eTRANSLATION, core::eROTATION, core::eSCALE } ) {
+				Channel channel{ i, path, interpolation, {}, {} };
+				unsigned int components = path == core::eROTATION ? 4 : 3;
+				float value[4] = { random.Next(-1.0f, 1.0f), random.Next(-1.0f, 1.0f), random.Next(-1.0f, 1.0f), 1.0f };
+				if ( path == core::eROTATION )
+					RandomQuaternion(random, static_cast<float>(PI), value);
+				else if ( path == core::eSCALE )
+					value[0] = value[1] = value[2] = 1.0f;
+				for ( unsigned int k = 0; k < jointKeyframes; ++k ) {
+					channel.times.push_back(static_cast<float>(k) / (jointKeyframes - 1));
+					if ( path == core::eROTATION ) {
+						float step[4];
+						RandomQuaternion(random, maximumStepAngle, step);
+						float next[4] = {
+							step[3] * value[0] + step[0] * value[3] + step[1] * value[2] - step[2] * value[1],
+							step[3] * value[1] - step[0] * value[2] + step[1] * value[3] + step[2] * value[0],
+							step[3] * value[2] + step[0] * value[1] - step[1] * value[0] + step[2] * value[3],
+							step[3] * value[3] - step[0] * value[0] - step[1] * value[1] - step[2] * value[2] };
+						for ( int c = 0; c < 4; ++c )
+							value[c] = next[c];
+					} else {
+						float range = path == core::eSCALE ? 0.05f : 0.1f;
+						for ( int c = 0; c < 3; ++c )
+							value[c] += random.Next(-range, range) * maximumStepAngle;
+					}
+
+					if ( interpolation == core::eCUBICSPLINE )
+						for ( unsigned int c = 0; c < components; ++c )
+							channel.values.push_back(random.Next(-0.5f, 0.5f));      ///< In-tangent.
+					for ( unsigned int c = 0; c < components; ++c )
+						channel.values.push_back(value[c]);
+					if ( interpolation == core::eCUBICSPLINE )
+						for ( unsigned int c = 0; c < components; ++c )
+							channel.values.push_back(random.Next(-0.5f, 0.5f));      ///< Out-tangent.
+				}
+
+				core::AnimationSampler sampler;
+				sampler.interpolation = interpolation;
+				for ( float time : channel.times )
+					sampler.times.Push(time);
+				for ( float channelValue : channel.values )
+					sampler.values.Push(channelValue);
+				rig.skeleton.AddChannel(i, path, std::move(sampler));
+				rig.channels.push_back(channel);
+			}
+		}
+
+		rig.skeleton.BuildEvaluationOrder();
+		return rig;
+	}
+
+	/// Largest error of skeleton against reference at keyframes, between them and outside of clip.
+	double CompareWithReference(const Rig& rig, const core::CSkeletalAnimation& skeleton, std::uint32_t seed, double& keyframesError) {
+		test::CRandom random(seed);
+		std::vector<float> times = { -0.5f, 0.0f, 1.0f, 1.5f };
+		for ( const Channel& channel : rig.channels )
+			times.insert(times.end(), channel.times.begin(), channel.times.end());
+		unsigned int keyframeTimes = times.size();
+		for ( unsigned int i = 0; i < 200; ++i )
+			times.push_back(random.Next(0.0f, 1.0f));
+
+		mat4 palette[PALETTE_SIZE];
+		double error = 0.0;
+		keyframesError = 0.0;
+		bool restIsUnit = true;
+		for ( unsigned int i = 0; i < times.size(); ++i ) {
+			skeleton.EvaluatePose(times[i], palette, PALETTE_SIZE);
+			double poseError = PoseError(ReferencePose(rig, times[i]), palette);
+			error = std::max(error, poseError);
+			if ( i < keyframeTimes )
+				keyframesError = std::max(keyframesError, poseError);
+			restIsUnit = restIsUnit && RestIsUnit(palette, JOINTS_NUMBER);
+		}
+		GLVM_CHECK(restIsUnit);
+
+		return error;
+	}
+
+	void TestSampledPoses() {
+		for ( core::EInterpolation interpolation : { core::eLINEAR, core::eSTEP, core::eCUBICSPLINE } ) {
+			Rig rig = MakeRig(10 + interpolation, interpolation, 31, 0.3f);
+			double keyframesError;
+			GLVM_CHECK(!rig.skeleton.IsBaked());
+			GLVM_CHECK(CompareWithReference(rig, rig.skeleton, 1, keyframesError) < 1e-4);
+		}
+	}
+
+	/// Dense smooth clip baked and close to reference, equal to it at keyframes. Step clip baked exactly.
+	void TestBakedPoses() {
+		Rig linearRig = MakeRig(20, core::eLINEAR, 31, 0.05f);
+		double keyframesError;
+		GLVM_CHECK(linearRig.skeleton.Bake());
+		GLVM_CHECK(CompareWithReference(linearRig, linearRig.skeleton, 2, keyframesError) < 2.0 * core::BAKED_POSE_TOLERANCE);
+		GLVM_CHECK(keyframesError < 1e-4);
+
+		Rig stepRig = MakeRig(21, core::eSTEP, 31, 0.3f);
+		GLVM_CHECK(stepRig.skeleton.Bake());
+		GLVM_CHECK(CompareWithReference(stepRig, stepRig.skeleton, 3, keyframesError) < 1e-4);
+
+		Rig sparseRig = MakeRig(22, core::eLINEAR, 3, 1.5f);                ///< Large rotations need more splits than allowed.
+		GLVM_CHECK(!sparseRig.skeleton.Bake());
+		GLVM_CHECK(CompareWithReference(sparseRig, sparseRig.skeleton, 4, keyframesError) < 1e-4);
+
+		Rig cubicRig = MakeRig(23, core::eCUBICSPLINE, 31, 0.05f);
+		GLVM_CHECK(!cubicRig.skeleton.Bake());
+	}
+
+	double MeasureFrame(const core::CSkeletalAnimation& skeleton, std::vector<mat4>& palettes) {
+		std::vector<mat4*> palettePointers(ACTORS_NUMBER);
+		std::vector<float> times(ACTORS_NUMBER);
+		for ( unsigned int i = 0; i < ACTORS_NUMBER; ++i )
+			palettePointers[i] = &palettes[i * PALETTE_SIZE];
+
+		auto start = std::chrono::steady_clock::now();
+		for ( unsigned int frame = 0; frame < FRAMES_NUMBER; ++frame ) {
+			for ( unsigned int i = 0; i < ACTORS_NUMBER; ++i )
+				times[i] = std::fmod(frame / 60.0f + i * 0.0137f, 1.0f);
+			for ( unsigned int first = 0; first < ACTORS_NUMBER; first += core::MAX_POSE_BATCH ) {
+				unsigned int count = ACTORS_NUMBER - first < core::MAX_POSE_BATCH ? ACTORS_NUMBER - first : core::MAX_POSE_BATCH;
+				skeleton.EvaluatePoses(&times[first], &palettePointers[first], count, PALETTE_SIZE);
+			}
+		}
+		auto end = std::chrono::steady_clock::now();
+
+		return std::chrono::duration<double>(end - start).count() * 1000.0 / FRAMES_NUMBER;
+	}
+
+	/// Same clip sampled and baked, time of one frame of all actors on one core printed.
+	void BenchmarkBakedPoses() {
+		Rig rig = MakeRig(30, core::eLINEAR, 31, 0.05f);
+		core::CSkeletalAnimation sampled = rig.skeleton;
+		GLVM_CHECK(rig.skeleton.Bake());
+
+		std::vector<mat4> sampledPalettes(ACTORS_NUMBER * PALETTE_SIZE);
+		std::vector<mat4> bakedPalettes(ACTORS_NUMBER * PALETTE_SIZE);
+		double sampledTime = MeasureFrame(sampled, sampledPalettes);
+		double bakedTime = MeasureFrame(rig.skeleton, bakedPalettes);
+
+		double error = 0.0;
+		for ( unsigned int i = 0; i < ACTORS_NUMBER; ++i )
+			for ( unsigned int joint = 0; joint < JOINTS_NUMBER; ++joint )
+				for ( int row = 0; row < 4; ++row )
+					for ( int column = 0; column < 4; ++column ) {
+						float exact = sampledPalettes[i * PALETTE_SIZE + joint][row][column];
+						float baked = bakedPalettes[i * PALETTE_SIZE + joint][row][column];
+						error = std::max(error, std::fabs(static_cast<double>(baked) - exact) / std::max(1.0, std::fabs(static_cast<double>(exact))));
+					}
+		GLVM_CHECK(error < 2.0 * core::BAKED_POSE_TOLERANCE);
+		std::printf("%u actors, %u joints: sampled %.3f ms, baked %.3f ms per frame\n", ACTORS_NUMBER, JOINTS_NUMBER, sampledTime, bakedTime);
+	}
+}
+
+int main() {
+	TestSampledPoses();
+	TestBakedPoses();
+	BenchmarkBakedPoses();
+
+	return test::TestResult("SkeletalAnimationTest");
+}
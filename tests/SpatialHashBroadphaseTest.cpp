@@ -0,0 +1,50 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "Test.hpp"
+#include "BroadphaseScene.hpp"
+#include "SpatialHashBroadphase.hpp"
+
+namespace ecs = GLVM::ecs;
+namespace test = GLVM::test;
+
+namespace
+{
+	constexpr unsigned int FRAMES_NUMBER = 8;
+	constexpr unsigned int RAYS_NUMBER = 64;
+
+	/// Grid reports every overlapping pair exactly once, so pairs must be the same as of brute force.
+	void CompareWithBruteForce(float cellSize, std::uint32_t seed) {
+		test::BroadphaseScene scene(1000, 60.0f, seed);
+		ecs::CSpatialHashBroadphase broadphase(cellSize);
+		for ( unsigned int frame = 0; frame < FRAMES_NUMBER; ++frame ) {
+			scene.Feed(broadphase);
+			GLVM::core::vector<ecs::BroadphasePair> pairs;
+			broadphase.CollectPairs(pairs);
+			std::vector<std::uint64_t> keys = test::SortedPairKeys(pairs);
+			GLVM_CHECK(!test::HasDuplicates(keys));
+			GLVM_CHECK(!keys.empty());
+			GLVM_CHECK(keys == test::BruteForcePairKeys(scene));
+
+			for ( unsigned int i = 0; i < RAYS_NUMBER; ++i ) {
+				vec3 origin(scene.random.Next(0.0f, 60.0f), scene.random.Next(0.0f, 60.0f), scene.random.Next(0.0f, 60.0f));
+				vec3 ray(scene.random.Next(-30.0f, 30.0f), scene.random.Next(-30.0f, 30.0f), i % 8 == 0 ? 0.0f : scene.random.Next(-30.0f, 30.0f));
+				GLVM::core::vector<Entity> entities;
+				broadphase.QueryRay(origin, ray, entities);
+				GLVM_CHECK(test::SortedEntities(entities) == test::BruteForceRay(scene, origin, ray));
+			}
+
+			scene.Step();
+		}
+	}
+}
+
+int main() {
+	CompareWithBruteForce(0.0f, 1);                                      ///< Cell size from average box.
+	CompareWithBruteForce(0.5f, 2);                                      ///< Small cells, most boxes cover many of them.
+	CompareWithBruteForce(8.0f, 3);                                      ///< Large cells, many boxes share one.
+
+	return test::TestResult("SpatialHashBroadphaseTest");
+}
@@ -0,0 +1,86 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "Test.hpp"
+#include "BroadphaseScene.hpp"
+#include "SweepAndPruneBroadphase.hpp"
+#include <chrono>
+
+namespace ecs = GLVM::ecs;
+namespace test = GLVM::test;
+
+namespace
+{
+	constexpr unsigned int FRAMES_NUMBER = 60;
+	constexpr unsigned int RAYS_NUMBER = 16;
+
+	/// Crowd of actors walking on plane, most of them keep direction, so endpoints stay nearly sorted.
+	test::BroadphaseScene MakeCrowd(unsigned int actorsNumber, std::uint32_t seed) {
+		test::BroadphaseScene scene(actorsNumber, 200.0f, seed);
+		for ( unsigned int i = 0; i < actorsNumber; ++i ) {
+			float height = scene.boxes[i].max[1] - scene.boxes[i].min[1];
+			scene.boxes[i].min[1] = 0.0f;
+			scene.boxes[i].max[1] = height;
+			scene.velocities[i][1] = 0.0f;
+		}
+
+		return scene;
+	}
+
+	/*! Replay the same motion with all pairs test and with sweep and prune, pairs must be the same
+	 *  set on every frame. Time of both printed, so test works as benchmark too.
+	 */
+	void ReplayCrowd(unsigned int actorsNumber, int axis) {
+		test::BroadphaseScene scene = MakeCrowd(actorsNumber, 21 + axis);
+		ecs::CSweepAndPruneBroadphase broadphase(axis);
+		double allPairsSeconds = 0.0;
+		double sweepSeconds = 0.0;
+		bool pairsMatch = true;
+		bool raysMatch = true;
+		bool duplicates = false;
+		unsigned int pairsNumber = 0;
+		for ( unsigned int frame = 0; frame < FRAMES_NUMBER; ++frame ) {
+			auto start = std::chrono::steady_clock::now();
+			std::vector<std::uint64_t> bruteForceKeys = test::BruteForcePairKeys(scene);
+			auto middle = std::chrono::steady_clock::now();
+			scene.Feed(broadphase);
+			GLVM::core::vector<ecs::BroadphasePair> pairs;
+			broadphase.CollectPairs(pairs);
+			auto end = std::chrono::steady_clock::now();
+			allPairsSeconds += std::chrono::duration<double>(middle - start).count();
+			sweepSeconds += std::chrono::duration<double>(end - middle).count();
+
+			std::vector<std::uint64_t> keys = test::SortedPairKeys(pairs);
+			duplicates = duplicates || test::HasDuplicates(keys);
+			pairsMatch = pairsMatch && keys == bruteForceKeys;
+			pairsNumber += keys.size();
+
+			for ( unsigned int i = 0; i < RAYS_NUMBER; ++i ) {
+				vec3 origin(scene.random.Next(0.0f, 200.0f), 1.0f, scene.random.Next(0.0f, 200.0f));
+				vec3 ray(scene.random.Next(-50.0f, 50.0f), 0.0f, scene.random.Next(-50.0f, 50.0f));
+				GLVM::core::vector<Entity> entities;
+				broadphase.QueryRay(origin, ray, entities);
+				raysMatch = raysMatch && test::SortedEntities(entities) == test::BruteForceRay(scene, origin, ray);
+			}
+
+			scene.Step();
+		}
+
+		GLVM_CHECK(pairsNumber > 0);
+		GLVM_CHECK(pairsMatch);
+		GLVM_CHECK(raysMatch);
+		GLVM_CHECK(!duplicates);
+		std::printf("%u actors, axis %d: all pairs %.3f ms, sweep and prune %.3f ms per frame\n", actorsNumber, axis,
+					allPairsSeconds * 1000.0 / FRAMES_NUMBER, sweepSeconds * 1000.0 / FRAMES_NUMBER);
+	}
+}
+
+int main() {
+	ReplayCrowd(500, 0);
+	ReplayCrowd(2000, 0);
+	ReplayCrowd(2000, 2);
+
+	return test::TestResult("SweepAndPruneBroadphaseTest");
+}
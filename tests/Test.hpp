@@ -0,0 +1,52 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#ifndef GLVM_TEST
+#define GLVM_TEST
+
+#include <cstdint>
+#include <cstdio>
+
+/*! Minimal checks for test executables of "make test". Failed check prints its place and
+ *  test goes on, so one run shows every broken case. Main of test returns TestResult().
+ */
+namespace GLVM::test
+{
+	inline unsigned int checksNumber = 0;
+	inline unsigned int failedChecksNumber = 0;
+
+	inline bool Check(bool condition, const char* expression, const char* file, int line) {
+		++checksNumber;
+		if ( !condition ) {
+			++failedChecksNumber;
+			std::printf("%s:%d: check failed: %s\n", file, line, expression);
+		}
+
+		return condition;
+	}
+
+	inline int TestResult(const char* testName) {
+		std::printf("%s: %u checks, %u failed\n", testName, checksNumber, failedChecksNumber);
+		return failedChecksNumber == 0 ? 0 : 1;
+	}
+
+	/// Linear congruential generator, same sequence on every platform unlike distributions of <random>.
+	class CRandom
+	{
+		std::uint32_t state;
+
+	public:
+		explicit CRandom(std::uint32_t seed) : state(seed) {}
+
+		float Next(float min, float max) {
+			state = state * 1664525u + 1013904223u;
+			return min + (max - min) * static_cast<float>(state >> 8) / static_cast<float>(1u << 24);
+		}
+	};
+}
+
+#define GLVM_CHECK(condition) GLVM::test::Check(static_cast<bool>(condition), #condition, __FILE__, __LINE__)
+
+#endif
@@ -0,0 +1,146 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "Test.hpp"
+#include "ComponentManager.hpp"
+#include "EntityManager.hpp"
+#include "Components/MoveComponent.hpp"
+#include "Systems/TransformSystem.hpp"
+#include <vector>
+
+namespace ecs = GLVM::ecs;
+namespace cm = GLVM::ecs::components;
+
+namespace
+{
+	Entity CreateTransform(float x) {
+		Entity entity = ecs::EntityManager::GetInstance()->CreateEntity();
+		ecs::ComponentManager::GetInstance()->CreateComponent<cm::transform>(entity);
+		ecs::ComponentManager::GetInstance()->GetComponent<cm::transform>(entity)->tPosition = { x, 0.0f, 0.0f };
+
+		return entity;
+	}
+
+	float WorldX(Entity entity) {
+		return ecs::ComponentManager::GetInstance()->GetComponent<const cm::worldTransform>(entity)->world[3][0];
+	}
+
+	/// Child follows new parent after reparenting, though none of transforms changed.
+	void TestReparent() {
+		ecs::ComponentManager* componentManager = ecs::ComponentManager::GetInstance();
+		ecs::CTransformSystem transformSystem;
+		Entity first = CreateTransform(1.0f);
+		Entity second = CreateTransform(5.0f);
+		Entity child = CreateTransform(1.0f);
+		componentManager->CreateComponent<cm::parent>(child);
+		componentManager->GetComponent<cm::parent>(child)->entity = first;
+
+		transformSystem.Update();
+		GLVM_CHECK(WorldX(child) == 2.0f);
+		transformSystem.Update();
+		GLVM_CHECK(transformSystem.GetMatricesNumber() == 0);           ///< Nothing changed, nothing recomputed.
+		GLVM_CHECK(WorldX(child) == 2.0f);
+
+		componentManager->GetComponent<cm::parent>(child)->entity = second;
+		transformSystem.Update();
+		GLVM_CHECK(transformSystem.GetMatricesNumber() == 0);           ///< Local matrix of child reused.
+		GLVM_CHECK(WorldX(child) == 6.0f);
+
+		ecs::EntityManager::GetInstance()->RemoveEntity(second, componentManager);
+		transformSystem.Update();
+		GLVM_CHECK(WorldX(child) == 1.0f);                              ///< Parent removed, child stays where local transform puts it.
+
+		ecs::EntityManager::GetInstance()->RemoveEntity(first, componentManager);
+		ecs::EntityManager::GetInstance()->RemoveEntity(child, componentManager);
+	}
+
+	/// Entity moved on last step follows alpha, children of it too.
+	void TestInterpolation() {
+		ecs::ComponentManager* componentManager = ecs::ComponentManager::GetInstance();
+		ecs::CTransformSystem transformSystem;
+		Entity moving = CreateTransform(2.0f);
+		Entity resting = CreateTransform(3.0f);
+		Entity child = CreateTransform(1.0f);
+		componentManager->CreateComponent<cm::parent>(child);
+		componentManager->GetComponent<cm::parent>(child)->entity = moving;
+		cm::transform* transformComponent = componentManager->GetComponent<cm::transform>(moving);
+		transformComponent->previousPosition = { 0.0f, 0.0f, 0.0f };
+		transformComponent->previousValid = true;
+
+		transformSystem.Update();
+		GLVM_CHECK(WorldX(moving) == 2.0f);
+		GLVM_CHECK(WorldX(child) == 3.0f);
+
+		transformSystem.interpolationAlpha = 0.5f;
+		transformSystem.Update();
+		GLVM_CHECK(transformSystem.GetMatricesNumber() == 1);           ///< Only moving entity recomputed.
+		GLVM_CHECK(WorldX(moving) == 1.0f);
+		GLVM_CHECK(WorldX(child) == 2.0f);
+		GLVM_CHECK(WorldX(resting) == 3.0f);
+
+		ecs::EntityManager::GetInstance()->RemoveEntity(moving, componentManager);
+		ecs::EntityManager::GetInstance()->RemoveEntity(resting, componentManager);
+		ecs::EntityManager::GetInstance()->RemoveEntity(child, componentManager);
+	}
+
+	/// Entities reported by Changed<worldTransform> since version.
+	std::vector<Entity> ChangedWorldTransforms(unsigned int sinceVersion) {
+		std::vector<Entity> changed;
+		ecs::ComponentManager::GetInstance()->forEachChunk<ecs::Changed<cm::worldTransform>>(
+			[&changed](unsigned int count, Entity* entities, [[maybe_unused]] const cm::worldTransform* worldTransformComponents) {
+				changed.insert(changed.end(), entities, entities + count);
+			}, sinceVersion);
+
+		return changed;
+	}
+
+	bool Contains(const std::vector<Entity>& entities, Entity entity) {
+		for ( Entity other : entities )
+			if ( other == entity )
+				return true;
+
+		return false;
+	}
+
+	/// Frame where only alpha moved touch chunks of interpolated entities, static subtree stays unchanged for readers.
+	void TestAlphaKeepsStaticChunks() {
+		ecs::ComponentManager* componentManager = ecs::ComponentManager::GetInstance();
+		ecs::CTransformSystem transformSystem;
+		Entity moving = CreateTransform(2.0f);
+		componentManager->CreateComponent<cm::move>(moving);             ///< Own table, like every simulated actor.
+		cm::transform* transformComponent = componentManager->GetComponent<cm::transform>(moving);
+		transformComponent->previousPosition = { 0.0f, 0.0f, 0.0f };
+		transformComponent->previousValid = true;
+		Entity staticRoot = CreateTransform(3.0f);
+		Entity staticChild = CreateTransform(1.0f);
+		componentManager->CreateComponent<cm::parent>(staticChild);
+		componentManager->GetComponent<cm::parent>(staticChild)->entity = staticRoot;
+
+		transformSystem.Update();
+		unsigned int sinceVersion = componentManager->AdvanceChangeVersion();
+		transformSystem.interpolationAlpha = 0.25f;
+		transformSystem.Update();
+
+		std::vector<Entity> changed = ChangedWorldTransforms(sinceVersion);
+		GLVM_CHECK(transformSystem.GetMatricesNumber() == 1);
+		GLVM_CHECK(Contains(changed, moving));
+		GLVM_CHECK(!Contains(changed, staticRoot));
+		GLVM_CHECK(!Contains(changed, staticChild));
+		GLVM_CHECK(WorldX(moving) == 0.5f);
+		GLVM_CHECK(WorldX(staticChild) == 4.0f);
+
+		ecs::EntityManager::GetInstance()->RemoveEntity(moving, componentManager);
+		ecs::EntityManager::GetInstance()->RemoveEntity(staticRoot, componentManager);
+		ecs::EntityManager::GetInstance()->RemoveEntity(staticChild, componentManager);
+	}
+}
+
+int main() {
+	TestReparent();
+	TestInterpolation();
+	TestAlphaKeepsStaticChunks();
+
+	return GLVM::test::TestResult("TransformSystemTest");
+}
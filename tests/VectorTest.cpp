@@ -0,0 +1,273 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "Test.hpp"
+#include "Vector.hpp"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace core = GLVM::core;
+
+namespace
+{
+	constexpr unsigned int GROWTH_PUSHES_NUMBER = 10000;
+	constexpr unsigned int BENCHMARK_ELEMENTS_NUMBER = 1 << 20;
+	constexpr unsigned int BENCHMARK_ROUNDS = 10;
+
+	int aliveElements = 0;
+	int copies = 0;
+	int moves = 0;
+
+	void ResetCounters() {
+		copies = 0;
+		moves = 0;
+	}
+
+	/// Copy and move counted, move is noexcept so relocation must move.
+	struct NoexceptMove
+	{
+		int value = 0;
+
+		NoexceptMove() { ++aliveElements; }
+		explicit NoexceptMove(int value_) : value(value_) { ++aliveElements; }
+		NoexceptMove(const NoexceptMove& other) : value(other.value) { ++aliveElements; ++copies; }
+		NoexceptMove(NoexceptMove&& other) noexcept : value(other.value) { ++aliveElements; ++moves; other.value = -1; }
+		NoexceptMove& operator=(const NoexceptMove& other) { value = other.value; ++copies; return *this; }
+		NoexceptMove& operator=(NoexceptMove&& other) noexcept { value = other.value; ++moves; other.value = -1; return *this; }
+		~NoexceptMove() { --aliveElements; }
+	};
+
+	/// Move may throw, so relocation copies and sources stay whole if copy throws (strong guarantee).
+	struct ThrowingCopy
+	{
+		static inline int copiesBeforeThrow = -1;                        ///< Negative means copy never throws.
+		int value = 0;
+
+		ThrowingCopy() { ++aliveElements; }
+		explicit ThrowingCopy(int value_) : value(value_) { ++aliveElements; }
+		ThrowingCopy(const ThrowingCopy& other) : value(other.value) {
+			if ( copiesBeforeThrow == 0 )
+				throw std::runtime_error("copy failed");
+			if ( copiesBeforeThrow > 0 )
+				--copiesBeforeThrow;
+			++aliveElements;
+			++copies;
+		}
+		ThrowingCopy(ThrowingCopy&& other) : value(other.value) { ++aliveElements; ++moves; other.value = -1; }
+		ThrowingCopy& operator=(const ThrowingCopy& other) { value = other.value; ++copies; return *this; }
+		ThrowingCopy& operator=(ThrowingCopy&& other) { value = other.value; ++moves; other.value = -1; return *this; }
+		~ThrowingCopy() { --aliveElements; }
+	};
+
+	struct alignas(32) OverAligned
+	{
+		float values[8];
+	};
+
+	static_assert(std::is_same_v<decltype(std::declval<core::vector<int>&>().GetSize()), std::size_t>);
+	static_assert(std::is_same_v<decltype(std::declval<core::vector<int>&>().GetCapacity()), std::size_t>);
+	static_assert(std::is_trivially_copyable_v<OverAligned>);
+	static_assert(!std::is_nothrow_move_constructible_v<ThrowingCopy>);
+
+	/// Every new capacity is old one plus half of it, so pushes relocate O(N) elements in total.
+	void TestGrowth() {
+		core::vector<NoexceptMove> elements;
+		ResetCounters();
+		bool growthFactor = true;
+		std::size_t capacity = elements.GetCapacity();
+		unsigned int reallocations = 0;
+		for ( unsigned int i = 0; i < GROWTH_PUSHES_NUMBER; ++i ) {
+			elements.EmplaceBack(static_cast<int>(i));
+			if ( elements.GetCapacity() != capacity ) {
+				std::size_t expected = capacity == 0 ? 8 : capacity + capacity / 2;
+				growthFactor = growthFactor && elements.GetCapacity() == expected;
+				capacity = elements.GetCapacity();
+				++reallocations;
+			}
+		}
+
+		GLVM_CHECK(growthFactor);
+		GLVM_CHECK(reallocations < 25);
+		GLVM_CHECK(moves < 3 * static_cast<int>(GROWTH_PUSHES_NUMBER));
+		GLVM_CHECK(copies == 0);
+
+		bool values = true;
+		for ( unsigned int i = 0; i < GROWTH_PUSHES_NUMBER; ++i )
+			values = values && elements[i].value == static_cast<int>(i);
+		GLVM_CHECK(values);
+
+		elements.Reserve(GROWTH_PUSHES_NUMBER * 4);
+		GLVM_CHECK(elements.GetCapacity() == GROWTH_PUSHES_NUMBER * 4);
+		GLVM_CHECK(elements.GetSize() == GROWTH_PUSHES_NUMBER);
+		elements.clear();
+		GLVM_CHECK(elements.GetCapacity() == GROWTH_PUSHES_NUMBER * 4);   ///< Capacity kept for reuse.
+		GLVM_CHECK(aliveElements == 0);
+	}
+
+	/// Relocation moves when move is noexcept and copies otherwise, copy failure leaves container untouched.
+	void TestRelocation() {
+		{
+			core::vector<NoexceptMove> elements;
+			for ( int i = 0; i < 8; ++i )
+				elements.EmplaceBack(i);
+			ResetCounters();
+			elements.EmplaceBack(8);
+			GLVM_CHECK(copies == 0 && moves == 8);
+			elements.Remove(0);
+			elements.SwapRemove(0);
+			GLVM_CHECK(copies == 0);
+			GLVM_CHECK(elements.GetSize() == 7 && elements[0].value == 8 && elements[1].value == 2);
+		}
+		GLVM_CHECK(aliveElements == 0);
+
+		{
+			core::vector<ThrowingCopy> elements;
+			for ( int i = 0; i < 8; ++i )
+				elements.EmplaceBack(i);
+			ResetCounters();
+			elements.EmplaceBack(8);
+			GLVM_CHECK(moves == 0 && copies == 8);
+
+			while ( elements.GetSize() < elements.GetCapacity() )
+				elements.EmplaceBack(static_cast<int>(elements.GetSize()));
+			std::size_t size = elements.GetSize();
+			std::size_t capacity = elements.GetCapacity();
+			ThrowingCopy::copiesBeforeThrow = 3;
+			bool thrown = false;
+			try {
+				elements.EmplaceBack(-2);
+			} catch ( const std::runtime_error& ) {
+				thrown = true;
+			}
+			ThrowingCopy::copiesBeforeThrow = -1;
+
+			bool untouched = true;
+			for ( std::size_t i = 0; i < size; ++i )
+				untouched = untouched && elements[i].value == static_cast<int>(i);
+			GLVM_CHECK(thrown);
+			GLVM_CHECK(elements.GetSize() == size && elements.GetCapacity() == capacity);
+			GLVM_CHECK(untouched);
+		}
+		GLVM_CHECK(aliveElements == 0);
+	}
+
+	/// Trivially copyable elements go through memcpy and memmove, values and alignment kept.
+	void TestTriviallyCopyable() {
+		core::vector<OverAligned> elements;
+		bool aligned = true;
+		for ( unsigned int i = 0; i < 100; ++i ) {
+			OverAligned element{};
+			for ( unsigned int j = 0; j < 8; ++j )
+				element.values[j] = static_cast<float>(i * 8 + j);
+			elements.Push(element);
+			aligned = aligned && reinterpret_cast<std::uintptr_t>(elements.GetVectorContainer()) % alignof(OverAligned) == 0;
+		}
+		GLVM_CHECK(aligned);
+
+		elements.Remove(10);
+		elements.SwapRemove(0);
+		core::vector<OverAligned> copy(elements);
+		GLVM_CHECK(copy.GetSize() == 98);
+		GLVM_CHECK(copy[0].values[0] == 99 * 8 && copy[10].values[7] == 11 * 8 + 7 && copy[97].values[0] == 98 * 8);
+
+		core::vector<int> numbers;
+		numbers.Resize(20);
+		bool zeroed = true;
+		for ( std::size_t i = 0; i < numbers.GetSize(); ++i )
+			zeroed = zeroed && numbers[i] == 0;
+		GLVM_CHECK(zeroed);
+		GLVM_CHECK(numbers.GetCapacity() == 20);
+	}
+
+	/// Move-only elements need no copy constructor for any operation except copy of container.
+	void TestMoveOnly() {
+		core::vector<std::unique_ptr<int>> elements;
+		for ( int i = 0; i < 50; ++i )
+			elements.Push(std::make_unique<int>(i));
+		elements.Remove(0);
+		elements.SwapRemove(0);
+		elements.Pop();
+		GLVM_CHECK(elements.GetSize() == 47);
+		GLVM_CHECK(*elements[0] == 49 && *elements[1] == 2 && *elements.GetHead() == 47);
+
+		core::vector<std::unique_ptr<int>> moved(std::move(elements));
+		GLVM_CHECK(elements.GetSize() == 0 && elements.GetCapacity() == 0);
+		GLVM_CHECK(moved.GetSize() == 47);
+		elements = std::move(moved);
+		GLVM_CHECK(elements.GetSize() == 47 && *elements[1] == 2);
+
+		core::vector<std::string> strings;
+		strings.EmplaceBack("first element long enough to live on the heap");
+		while ( strings.GetSize() < strings.GetCapacity() )
+			strings.EmplaceBack("x");
+		strings.EmplaceBack(strings[0]);                                 ///< Argument refers to element of full container.
+		GLVM_CHECK(strings.GetHead() == strings[0]);
+	}
+
+	/// Push of ints and of strings compared with std::vector.
+	void BenchmarkPush() {
+		std::vector<int> standard;
+		auto start = std::chrono::steady_clock::now();
+		for ( unsigned int round = 0; round < BENCHMARK_ROUNDS; ++round ) {
+			std::vector<int> elements;
+			for ( unsigned int i = 0; i < BENCHMARK_ELEMENTS_NUMBER; ++i )
+				elements.push_back(static_cast<int>(i));
+			standard = std::move(elements);
+		}
+		auto middle = std::chrono::steady_clock::now();
+		core::vector<int> own;
+		for ( unsigned int round = 0; round < BENCHMARK_ROUNDS; ++round ) {
+			core::vector<int> elements;
+			for ( unsigned int i = 0; i < BENCHMARK_ELEMENTS_NUMBER; ++i )
+				elements.Push(static_cast<int>(i));
+			own = std::move(elements);
+		}
+		auto end = std::chrono::steady_clock::now();
+		GLVM_CHECK(own.GetSize() == standard.size() && own[BENCHMARK_ELEMENTS_NUMBER - 1] == standard.back());
+
+		std::printf("%u int pushes: std::vector %.3f ms, core::vector %.3f ms\n", BENCHMARK_ELEMENTS_NUMBER,
+					std::chrono::duration<double, std::milli>(middle - start).count() / BENCHMARK_ROUNDS,
+					std::chrono::duration<double, std::milli>(end - middle).count() / BENCHMARK_ROUNDS);
+
+		const unsigned int stringsNumber = BENCHMARK_ELEMENTS_NUMBER / 8;
+		std::vector<std::string> standardStrings;
+		start = std::chrono::steady_clock::now();
+		for ( unsigned int round = 0; round < BENCHMARK_ROUNDS; ++round ) {
+			std::vector<std::string> elements;
+			for ( unsigned int i = 0; i < stringsNumber; ++i )
+				elements.emplace_back("string of component name long enough for heap");
+			standardStrings = std::move(elements);
+		}
+		middle = std::chrono::steady_clock::now();
+		core::vector<std::string> ownStrings;
+		for ( unsigned int round = 0; round < BENCHMARK_ROUNDS; ++round ) {
+			core::vector<std::string> elements;
+			for ( unsigned int i = 0; i < stringsNumber; ++i )
+				elements.EmplaceBack("string of component name long enough for heap");
+			ownStrings = std::move(elements);
+		}
+		end = std::chrono::steady_clock::now();
+		GLVM_CHECK(ownStrings.GetSize() == standardStrings.size());
+
+		std::printf("%u string pushes: std::vector %.3f ms, core::vector %.3f ms\n", stringsNumber,
+					std::chrono::duration<double, std::milli>(middle - start).count() / BENCHMARK_ROUNDS,
+					std::chrono::duration<double, std::milli>(end - middle).count() / BENCHMARK_ROUNDS);
+	}
+}
+
+int main() {
+	TestGrowth();
+	TestRelocation();
+	TestTriviallyCopyable();
+	TestMoveOnly();
+	BenchmarkPush();
+
+	return GLVM::test::TestResult("VectorTest");
+}
@@ -0,0 +1,292 @@
+// This file is part of Game Loop Versatile Modules (GLVM)
+// Copyright © 2024 Maksim Manokhin a.k.a. Yuriorkis_Scream. Contacts: <fellfrostqtw@gmail.com>
+// Author: Maksim Manokhin a.k.a. Yuriorkis_Scream
+// License: http://opensource.org/licenses/MIT
+
+#include "Test.hpp"
+#include "VertexMath.hpp"
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+namespace test = GLVM::test;
+namespace simd = GLVM::core::simd;
+
+namespace
+{
+	constexpr unsigned int CASES_NUMBER = 2000;
+	constexpr unsigned int BENCHMARK_MATRICES_NUMBER = 1024;
+	constexpr unsigned int BENCHMARK_ROUNDS = 200;
+	constexpr double EPSILON = 1e-5;
+
+	using dmat4 = Matrix<double, 4>;
+	using dvec4 = Vector<double, 4>;
+
+#if defined(GLVM_SIMD_AVX)
+	const char* SIMD_PATH = "AVX";
+#elif defined(GLVM_SIMD_SSE)
+	const char* SIMD_PATH = "SSE2";
+#else
+	const char* SIMD_PATH = "scalar";
+#endif
+
+	/// Relative difference, values near zero compared absolutely.
+	bool Near(double value, double reference, double epsilon = EPSILON) {
+		return std::fabs(value - reference) <= epsilon * (1.0 + std::fabs(reference));
+	}
+
+	mat4 RandomMatrix(test::CRandom& random) {
+		mat4 matrix;
+		for ( int i = 0; i < 4; ++i )
+			for ( int j = 0; j < 4; ++j )
+				matrix[i][j] = random.Next(-4.0f, 4.0f);
+
+		return matrix;
+	}
+
+	/// The same matrix on generic scalar path of Matrix, float kernels are not used for double.
+	dmat4 ToDouble(const mat4& matrix) {
+		dmat4 result;
+		for ( int i = 0; i < 4; ++i )
+			for ( int j = 0; j < 4; ++j )
+				result[i][j] = matrix[i][j];
+
+		return result;
+	}
+
+	Quaternion RandomQuaternion(test::CRandom& random) {
+		return normalizeQuaternion({random.Next(-1.0f, 1.0f), random.Next(-1.0f, 1.0f), random.Next(-1.0f, 1.0f), random.Next(-1.0f, 1.0f)});
+	}
+
+	/// Hamilton product written out by table, quaternions in (w, x, y, z) order.
+	void MultiplyQuaternionReference(const double* a, const double* b, double* result) {
+		result[0] = a[0] * b[0] - a[1] * b[1] - a[2] * b[2] - a[3] * b[3];
+		result[1] = a[0] * b[1] + a[1] * b[0] + a[2] * b[3] - a[3] * b[2];
+		result[2] = a[0] * b[2] - a[1] * b[3] + a[2] * b[0] + a[3] * b[1];
+		result[3] = a[0] * b[3] + a[1] * b[2] - a[2] * b[1] + a[3] * b[0];
+	}
+
+	void TestMatrixProducts() {
+		test::CRandom random(15);
+		bool matrixMatch = true;
+		bool matrixVectorMatch = true;
+		bool vectorMatrixMatch = true;
+		bool transposeMatch = true;
+		for ( unsigned int i = 0; i < CASES_NUMBER; ++i ) {
+			mat4 first = RandomMatrix(random);
+			mat4 second = RandomMatrix(random);
+			vec4 vector(random.Next(-4.0f, 4.0f), random.Next(-4.0f, 4.0f), random.Next(-4.0f, 4.0f), random.Next(-4.0f, 4.0f));
+			dvec4 vectorReference(vector[0], vector[1], vector[2], vector[3]);
+
+			mat4 product = first * second;
+			dmat4 productReference = ToDouble(first) * ToDouble(second);
+			vec4 matrixVector = first * vector;
+			dvec4 matrixVectorReference = ToDouble(first) * vectorReference;
+			vec4 vectorMatrix = vector * first;
+			dvec4 vectorMatrixReference = vectorReference * ToDouble(first);
+			mat4 transposed = Transpose(first);
+
+			for ( int row = 0; row < 4; ++row ) {
+				for ( int column = 0; column < 4; ++column ) {
+					matrixMatch = matrixMatch && Near(product[row][column], productReference[row][column]);
+					transposeMatch = transposeMatch && transposed[row][column] == first[column][row];
+				}
+
+				matrixVectorMatch = matrixVectorMatch && Near(matrixVector[row], matrixVectorReference[row]);
+				vectorMatrixMatch = vectorMatrixMatch && Near(vectorMatrix[row], vectorMatrixReference[row]);
+			}
+		}
+
+		GLVM_CHECK(matrixMatch);
+		GLVM_CHECK(matrixVectorMatch);
+		GLVM_CHECK(vectorMatrixMatch);
+		GLVM_CHECK(transposeMatch);
+	}
+
+	void TestInverse() {
+		test::CRandom random(16);
+		bool scalarMatch = true;
+		bool identity = true;
+		for ( unsigned int i = 0; i < CASES_NUMBER; ++i ) {
+			mat4 matrix = RandomMatrix(random);
+			for ( int j = 0; j < 4; ++j )
+				matrix[j][j] += 8.0f;                                        ///< Far from singular, so float error stays small.
+
+			mat4 inverse = Inverse(matrix);
+			mat4 scalarInverse(0.0f);
+			simd::InverseMatrix4Scalar(matrix[0], scalarInverse[0]);
+			dmat4 residual = ToDouble(matrix) * ToDouble(inverse);
+			for ( int row = 0; row < 4; ++row ) {
+				for ( int column = 0; column < 4; ++column ) {
+					scalarMatch = scalarMatch && Near(inverse[row][column], scalarInverse[row][column], 1e-4);
+					identity = identity && Near(residual[row][column], row == column ? 1.0 : 0.0, 1e-4);
+				}
+			}
+		}
+
+		mat4 singular(1.0f);
+		singular[3][3] = 0.0f;
+		mat4 untouched(7.0f);
+		GLVM_CHECK(scalarMatch);
+		GLVM_CHECK(identity);
+		GLVM_CHECK(!simd::InverseMatrix4(singular[0], untouched[0]));
+		GLVM_CHECK(untouched[0][0] == 7.0f && untouched[0][1] == 0.0f);
+		GLVM_CHECK(Inverse(singular)[0][0] == 0.0f);
+	}
+
+	void TestQuaternions() {
+		/// Order of components: i * j = k and j * i = -k only if w stored first.
+		Quaternion i = {0.0f, 1.0f, 0.0f, 0.0f};
+		Quaternion j = {0.0f, 0.0f, 1.0f, 0.0f};
+		Quaternion k = multiplyQuaternion(i, j);
+		Quaternion minusK = multiplyQuaternion(j, i);
+		GLVM_CHECK(k.w == 0.0f && k.x == 0.0f && k.y == 0.0f && k.z == 1.0f);
+		GLVM_CHECK(minusK.w == 0.0f && minusK.x == 0.0f && minusK.y == 0.0f && minusK.z == -1.0f);
+
+		test::CRandom random(17);
+		bool productMatch = true;
+		bool rotateMatch = true;
+		bool slerpMatch = true;
+		for ( unsigned int n = 0; n < CASES_NUMBER; ++n ) {
+			Quaternion a = RandomQuaternion(random);
+			Quaternion b = RandomQuaternion(random);
+			Quaternion product = multiplyQuaternion(a, b);
+			double first[4] = {a.w, a.x, a.y, a.z};
+			double second[4] = {b.w, b.x, b.y, b.z};
+			double productReference[4];
+			MultiplyQuaternionReference(first, second, productReference);
+			productMatch = productMatch && Near(product.w, productReference[0]) && Near(product.x, productReference[1]) &&
+				Near(product.y, productReference[2]) && Near(product.z, productReference[3]);
+
+			/// Rotation of vector by q * v * q^-1 must agree with rotation matrix of q.
+			vec4 point(random.Next(-4.0f, 4.0f), random.Next(-4.0f, 4.0f), random.Next(-4.0f, 4.0f), 1.0f);
+			Quaternion pure = {0.0f, point[0], point[1], point[2]};
+			Quaternion rotated = multiplyQuaternion(multiplyQuaternion(a, pure), inverseQuaternion(a));
+			double pureReference[4] = {0.0, point[0], point[1], point[2]};
+			double conjugate[4] = {a.w, -a.x, -a.y, -a.z};
+			double halfRotated[4];
+			double rotatedReference[4];
+			MultiplyQuaternionReference(first, pureReference, halfRotated);
+			MultiplyQuaternionReference(halfRotated, conjugate, rotatedReference);
+			vec4 matrixRotated = rotateQuaternion<float, 4>(a) * point;
+			for ( int axis = 0; axis < 3; ++axis ) {
+				float component = axis == 0 ? rotated.x : axis == 1 ? rotated.y : rotated.z;
+				rotateMatch = rotateMatch && Near(component, rotatedReference[axis + 1], 1e-4) &&
+					Near(matrixRotated[axis], rotatedReference[axis + 1], 1e-4);
+			}
+
+			/// Slerp from identity to rotation by angle around x gives rotation by factor * angle.
+			float angle = random.Next(0.1f, 3.0f);
+			float factor = random.Next(0.0f, 1.0f);
+			Quaternion identity = {1.0f, 0.0f, 0.0f, 0.0f};
+			Quaternion target = {std::cos(angle * 0.5f), std::sin(angle * 0.5f), 0.0f, 0.0f};
+			Quaternion slerp = slerpQuaternion(identity, target, factor);
+			double halfAngle = 0.5 * factor * angle;
+			slerpMatch = slerpMatch && Near(slerp.w, std::cos(halfAngle), 1e-4) && Near(slerp.x, std::sin(halfAngle), 1e-4) &&
+				Near(slerp.y, 0.0) && Near(slerp.z, 0.0);
+		}
+
+		GLVM_CHECK(productMatch);
+		GLVM_CHECK(rotateMatch);
+		GLVM_CHECK(slerpMatch);
+	}
+
+	/// Vectors and quaternions may lie at any float address, kernels must read and write them unaligned.
+	void TestUnalignedOperands() {
+		test::CRandom random(18);
+		mat4 matrix = RandomMatrix(random);
+		alignas(16) float buffer[16] {};
+		float* vector = buffer + 1;
+		float* result = buffer + 6;
+		bool vectorMatch = true;
+		bool quaternionMatch = true;
+		for ( unsigned int n = 0; n < CASES_NUMBER; ++n ) {
+			vec4 aligned(random.Next(-4.0f, 4.0f), random.Next(-4.0f, 4.0f), random.Next(-4.0f, 4.0f), random.Next(-4.0f, 4.0f));
+			for ( int i = 0; i < 4; ++i )
+				vector[i] = aligned[i];
+
+			vec4 matrixVector = matrix * aligned;
+			simd::MultiplyMatrixVector4(matrix[0], vector, result);
+			for ( int i = 0; i < 4; ++i )
+				vectorMatch = vectorMatch && result[i] == matrixVector[i];
+
+			vec4 vectorMatrix = aligned * matrix;
+			simd::MultiplyVectorMatrix4(vector, matrix[0], result);
+			for ( int i = 0; i < 4; ++i )
+				vectorMatch = vectorMatch && result[i] == vectorMatrix[i];
+
+			Quaternion other = RandomQuaternion(random);
+			Quaternion product = multiplyQuaternion({aligned[0], aligned[1], aligned[2], aligned[3]}, other);
+			simd::MultiplyQuaternion(vector, &other.w, result);
+			quaternionMatch = quaternionMatch && result[0] == product.w && result[1] == product.x &&
+				result[2] == product.y && result[3] == product.z;
+		}
+
+		GLVM_CHECK(vectorMatch);
+		GLVM_CHECK(quaternionMatch);
+	}
+
+	/// Scalar loops the kernels replaced, baseline for benchmark.
+	void MultiplyMatrix4Loop(const float* first, const float* second, float* result) {
+		for ( int i = 0; i < 4; ++i ) {
+			for ( int j = 0; j < 4; ++j ) {
+				float sum = 0.0f;
+				for ( int n = 0; n < 4; ++n )
+					sum += first[i * 4 + n] * second[n * 4 + j];
+				result[i * 4 + j] = sum;
+			}
+		}
+	}
+
+	template <typename function>
+	double NanosecondsPerCall(function call) {
+		auto start = std::chrono::steady_clock::now();
+		for ( unsigned int round = 0; round < BENCHMARK_ROUNDS; ++round )
+			for ( unsigned int i = 0; i < BENCHMARK_MATRICES_NUMBER; ++i )
+				call(i);
+		auto end = std::chrono::steady_clock::now();
+
+		return std::chrono::duration<double, std::nano>(end - start).count() / (BENCHMARK_ROUNDS * BENCHMARK_MATRICES_NUMBER);
+	}
+
+	void BenchmarkKernels() {
+		test::CRandom random(19);
+		std::vector<mat4> matrices;
+		std::vector<mat4> results(BENCHMARK_MATRICES_NUMBER);
+		for ( unsigned int i = 0; i < BENCHMARK_MATRICES_NUMBER; ++i ) {
+			matrices.push_back(RandomMatrix(random));
+			for ( int j = 0; j < 4; ++j )
+				matrices.back()[j][j] += 8.0f;
+		}
+
+		auto next = [&](unsigned int i) -> const mat4& { return matrices[(i + 1) % BENCHMARK_MATRICES_NUMBER]; };
+		double loopMultiply = NanosecondsPerCall([&](unsigned int i) {
+			MultiplyMatrix4Loop(matrices[i][0], next(i)[0], results[i][0]);
+		});
+		double kernelMultiply = NanosecondsPerCall([&](unsigned int i) {
+			simd::MultiplyMatrix4(matrices[i][0], next(i)[0], results[i][0]);
+		});
+		double scalarInverse = NanosecondsPerCall([&](unsigned int i) {
+			simd::InverseMatrix4Scalar(matrices[i][0], results[i][0]);
+		});
+		double kernelInverse = NanosecondsPerCall([&](unsigned int i) {
+			simd::InverseMatrix4(matrices[i][0], results[i][0]);
+		});
+
+		volatile float sink = 0.0f;
+		for ( const mat4& result : results )
+			sink = sink + result[0][0];
+		std::printf("%s kernels: mat4 multiply loop %.1f ns, kernel %.1f ns; inverse scalar %.1f ns, kernel %.1f ns\n",
+					SIMD_PATH, loopMultiply, kernelMultiply, scalarInverse, kernelInverse);
+	}
+}
+
+int main() {
+	TestMatrixProducts();
+	TestInverse();
+	TestQuaternions();
+	TestUnalignedOperands();
+	BenchmarkKernels();
+
+	return test::TestResult("VertexMathSimdTest");
+}